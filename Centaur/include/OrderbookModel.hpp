@@ -0,0 +1,289 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+// Created by Ricardo Romero on 17/10/26.
+// Copyright (c) 2026 Ricardo Romero.  All rights reserved.
+//
+
+#pragma once
+
+#ifndef __cplusplus
+#error "C++ compiler needed"
+#endif /*__cplusplus*/
+
+#ifndef CENTAUR_ORDERBOOKMODEL_HPP
+#define CENTAUR_ORDERBOOKMODEL_HPP
+
+#include "Centaur.hpp"
+#include <QAbstractTableModel>
+#include <QColor>
+#include <QLocale>
+#include <QMap>
+#include <QPair>
+#include <QStringList>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+BEGIN_CENTAUR_NAMESPACE
+
+/// \brief Signals the rows changed by an update of a model with one dataChanged per run of consecutive rows.
+/// The rows are given in order, each one once, and finish is called after the last one
+class ChangedRowRuns
+{
+public:
+    ChangedRowRuns(QAbstractItemModel *model, int firstColumn, int lastColumn, QList<int> roles) :
+        _model { model },
+        _firstColumn { firstColumn },
+        _lastColumn { lastColumn },
+        _roles { std::move(roles) }
+    {
+    }
+
+public:
+    void row(int row, bool changed)
+    {
+        // A row not changed, or a gap in the rows, ends the run
+        if (_first >= 0 && (!changed || row != _last + 1))
+            finish();
+
+        if (changed) {
+            if (_first < 0)
+                _first = row;
+            _last = row;
+        }
+    }
+
+    /// \brief Signal the run in progress
+    void finish()
+    {
+        if (_first < 0)
+            return;
+
+        emit _model->dataChanged(_model->index(_first, _firstColumn), _model->index(_last, _lastColumn), _roles);
+        _first = -1;
+    }
+
+protected:
+    QAbstractItemModel *_model;
+    int _firstColumn;
+    int _lastColumn;
+    QList<int> _roles;
+    int _first { -1 };
+    int _last { -1 };
+};
+
+/// \brief One side of the book. The rows are kept between updates: an update only signals the cells that changed,
+/// and the text of a row is only formatted when its level changes
+class OrderbookModel : public QAbstractTableModel
+{
+public:
+    enum class Side
+    {
+        ask,
+        bid
+    };
+
+    /// Cumulative quantity from the best price to the row, as a fraction of depthScale
+    static constexpr int DepthRole = Qt::UserRole + 1;
+
+    /// Steps of the depth. The bars are drawn in pixels: a change smaller than a step is not signaled
+    static constexpr qreal depthSteps = 512;
+
+public:
+    OrderbookModel(Side side, QStringList headers, QObject *parent = nullptr) :
+        QAbstractTableModel(parent),
+        _side { side },
+        _headers { std::move(headers) },
+        _priceColor { side == Side::ask ? QColor(0xFFA7AC) : QColor(0x9CFFB4) }
+    {
+    }
+
+public:
+    int rowCount(const QModelIndex &parent = {}) const override
+    {
+        return parent.isValid() ? 0 : static_cast<int>(_rows.size());
+    }
+
+    int columnCount(const QModelIndex &parent = {}) const override
+    {
+        return parent.isValid() ? 0 : 3;
+    }
+
+    QVariant data(const QModelIndex &index, int role) const override
+    {
+        if (!checkIndex(index, CheckIndexOption::IndexIsValid | CheckIndexOption::ParentIsInvalid))
+            return {};
+
+        const auto &row = _rows[static_cast<std::size_t>(index.row())];
+        switch (role) {
+            case Qt::DisplayRole:
+                return index.column() == 0 ? row.priceText : (index.column() == 1 ? row.quantityText : row.totalText);
+            case Qt::TextAlignmentRole:
+                return alignment(index.column());
+            case Qt::ForegroundRole:
+                return index.column() == 0 ? QVariant { _priceColor } : QVariant {};
+            case DepthRole:
+                return index.column() == 2 ? QVariant { row.depth } : QVariant {};
+            default:
+                return {};
+        }
+    }
+
+    QVariant headerData(int section, Qt::Orientation orientation, int role) const override
+    {
+        if (orientation != Qt::Horizontal || section < 0 || section >= _headers.size())
+            return {};
+
+        switch (role) {
+            case Qt::DisplayRole:
+                return _headers[section];
+            case Qt::TextAlignmentRole:
+                return section == 0 ? alignment(0) : QVariant { static_cast<int>(Qt::AlignRight | Qt::AlignVCenter) };
+            default:
+                return {};
+        }
+    }
+
+    /// \brief Replace the levels of the side
+    /// \param levels Price, and quantity and total of the level
+    /// \return true if rows were added or removed
+    bool update(const QMap<qreal, QPair<qreal, qreal>> &levels)
+    {
+        // Highest price first in both tables: the best ask is at the bottom and the best bid at the top
+        _levels.clear();
+        _levels.reserve(static_cast<std::size_t>(levels.size()));
+        for (auto iter = levels.constEnd(); iter != levels.constBegin();) {
+            --iter;
+            _levels.push_back({ .price = iter.key(), .quantity = iter.value().first, .total = iter.value().second, .depth = 0 });
+        }
+
+        const bool resized = resize(_levels.size());
+        if (_rows.empty())
+            return resized;
+
+        // The depth is relative to the quantity of the side rounded up to a power of two, not to the quantity itself:
+        // otherwise any change would move the depth of every row. The scale changes only when the quantity crosses a
+        // power of two, and the bar of the deepest level is then between a half and the whole width
+        qreal sideQuantity = 0;
+        for (const auto &level : _levels)
+            sideQuantity += level.quantity;
+
+        if (sideQuantity > _depthScale || sideQuantity <= _depthScale / 2)
+            _depthScale = sideQuantity > 0 ? std::exp2(std::ceil(std::log2(sideQuantity))) : 0;
+
+        qreal cumulative = 0;
+        const auto depth = [&cumulative, this](const Level &level) -> qreal {
+            cumulative += level.quantity;
+            return _depthScale > 0 ? std::round(cumulative / _depthScale * depthSteps) / depthSteps : 0.0;
+        };
+
+        if (_side == Side::bid) {
+            for (auto &level : _levels)
+                level.depth = depth(level);
+        }
+        else {
+            for (auto level = _levels.rbegin(); level != _levels.rend(); ++level)
+                level->depth = depth(*level);
+        }
+
+        // Only the cells that changed are repainted
+        ChangedRowRuns textRuns { this, 0, 2, { Qt::DisplayRole } };
+        ChangedRowRuns depthRuns { this, 2, 2, { DepthRole } };
+        for (std::size_t i = 0; i < _rows.size(); ++i) {
+            auto &row               = _rows[i];
+            const auto &level       = _levels[i];
+            const bool textChanged  = row.price != level.price || row.quantity != level.quantity || row.total != level.total;
+            const bool depthChanged = row.depth != level.depth;
+            if (textChanged) {
+                row.price        = level.price;
+                row.quantity     = level.quantity;
+                row.total        = level.total;
+                row.priceText    = QString("$ %1").arg(_locale.toString(row.price, 'f', 5));
+                row.quantityText = QString("$ %1").arg(_locale.toString(row.quantity, 'f', 5));
+                row.totalText    = QString("$ %1").arg(_locale.toString(row.total, 'f', 5));
+            }
+            row.depth = level.depth;
+
+            textRuns.row(static_cast<int>(i), textChanged);
+            depthRuns.row(static_cast<int>(i), depthChanged);
+        }
+        textRuns.finish();
+        depthRuns.finish();
+
+        return resized;
+    }
+
+    /// \brief Quantity of a full depth bar
+    C_NODISCARD qreal depthScale() const noexcept
+    {
+        return _depthScale;
+    }
+
+protected:
+    struct Level
+    {
+        qreal price;
+        qreal quantity;
+        qreal total;
+        qreal depth;
+    };
+
+    struct Row
+    {
+        // NaN: formatted with the first level set
+        qreal price { std::numeric_limits<qreal>::quiet_NaN() };
+        qreal quantity { 0 };
+        qreal total { 0 };
+        qreal depth { 0 };
+        QString priceText;
+        QString quantityText;
+        QString totalText;
+    };
+
+    static QVariant alignment(int column)
+    {
+        switch (column) {
+            case 0:
+                return QVariant { static_cast<int>(Qt::AlignLeft | Qt::AlignVCenter) };
+            case 1:
+                return QVariant { static_cast<int>(Qt::AlignCenter | Qt::AlignVCenter) };
+            default:
+                return QVariant { static_cast<int>(Qt::AlignRight | Qt::AlignVCenter) };
+        }
+    }
+
+    /// \brief Add or remove rows at the end of the table
+    bool resize(std::size_t rows)
+    {
+        const auto current = static_cast<int>(_rows.size());
+        const auto wanted  = static_cast<int>(rows);
+        if (wanted > current) {
+            beginInsertRows({}, current, wanted - 1);
+            _rows.resize(rows);
+            endInsertRows();
+            return true;
+        }
+        if (wanted < current) {
+            beginRemoveRows({}, wanted, current - 1);
+            _rows.resize(rows);
+            endRemoveRows();
+            return true;
+        }
+        return false;
+    }
+
+protected:
+    Side _side;
+    QStringList _headers;
+    QColor _priceColor;
+    QLocale _locale { QLocale::English };
+    std::vector<Row> _rows;
+    // Levels of the last update. Kept to reuse the memory
+    std::vector<Level> _levels;
+    qreal _depthScale { 0 };
+};
+
+END_CENTAUR_NAMESPACE
+
+#endif // CENTAUR_ORDERBOOKMODEL_HPP
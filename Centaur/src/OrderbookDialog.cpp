@@ -6,7 +6,9 @@
 
 #include "OrderbookDialog.hpp"
 #include "../ui/ui_OrderbookDialog.h"
+#include "OrderbookModel.hpp"
 #include <CentaurApp.hpp>
+#include <QLocale>
 #include <QPainter>
 #include <QSettings>
 #include <QStyledItemDelegate>
@@ -16,78 +18,53 @@ BEGIN_CENTAUR_NAMESPACE
 
 namespace
 {
+    /// \brief Draws the depth of the level behind the total
     class ProgressDelegate : public QStyledItemDelegate
     {
     public:
-        enum class Type
-        {
-            ask,
-            bid
-        };
-
-    public:
-        explicit ProgressDelegate(Type type, QObject *parent) :
+        explicit ProgressDelegate(OrderbookModel::Side side, QObject *parent) :
             QStyledItemDelegate(parent),
-            _type { type }
+            _brush { side == OrderbookModel::Side::ask ? QBrush(QColor(197, 29, 7, 128)) : QBrush(QColor(1, 185, 6, 128)) }
         {
-            switch (_type) {
-                case Type::ask:
-                    redBrush = QBrush(QColor(197, 29, 7, 128));
-                    break;
-                case Type::bid:
-                    greenBrush = QBrush(QColor(1, 185, 6, 128));
-                    break;
-            }
         }
 
         void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override
         {
-            if (index.column() == 2) {
-                QStyleOptionViewItem options = option;
-
-                initStyleOption(&options, index);
-
-                painter->save();
+            QStyleOptionViewItem options = option;
+            initStyleOption(&options, index);
 
-                QString text = options.text;
-                options.text = "";
-                options.widget->style()->drawControl(QStyle::CE_ItemViewItem, &options, painter);
+            painter->save();
 
-                qreal min   = index.data(Qt::UserRole + 1).toReal();
-                qreal max   = index.data(Qt::UserRole + 2).toReal();
-                qreal value = index.data(Qt::UserRole + 3).toReal();
+            const QString text = options.text;
+            options.text       = "";
+            options.widget->style()->drawControl(QStyle::CE_ItemViewItem, &options, painter, options.widget);
 
-                qreal percent      = (value - min) / (max - min);
-                qreal newLeft      = static_cast<qreal>(options.rect.right()) - (static_cast<qreal>(options.rect.right()) * percent);
+            // The depth is cached by the model: nothing is computed here
+            const qreal depth = index.data(OrderbookModel::DepthRole).toReal();
+            if (depth > 0) {
                 QRect progressRect = options.rect;
-                progressRect.setLeft(static_cast<int>(newLeft));
+                progressRect.setLeft(options.rect.right() - static_cast<int>(static_cast<qreal>(options.rect.width()) * depth));
 
-                painter->save();
                 painter->setPen(Qt::NoPen);
-                painter->setBrush(_type == Type::ask ? redBrush : greenBrush);
+                painter->setBrush(_brush);
                 painter->drawRect(progressRect);
-                painter->restore();
-
-                options.rect.setWidth(options.rect.width() - 10);
-                options.widget->style()->drawItemText(
-                    painter,
-                    options.rect,
-                    static_cast<int>(options.displayAlignment),
-                    options.palette,
-                    options.state & QStyle::State_Enabled,
-                    text,
-                    QPalette::Text);
-
-                painter->restore();
             }
-            else
-                QStyledItemDelegate::paint(painter, option, index);
+
+            options.rect.setWidth(options.rect.width() - 10);
+            options.widget->style()->drawItemText(
+                painter,
+                options.rect,
+                static_cast<int>(options.displayAlignment),
+                options.palette,
+                options.state & QStyle::State_Enabled,
+                text,
+                QPalette::Text);
+
+            painter->restore();
         }
 
     protected:
-        Type _type;
-        QBrush greenBrush;
-        QBrush redBrush;
+        QBrush _brush;
     };
 } // namespace
 
@@ -112,6 +89,9 @@ struct OrderbookDialog::Impl
     QString quote;
     QString source;
 
+    OrderbookModel *asksModel { nullptr };
+    OrderbookModel *bidsModel { nullptr };
+
     double oldPrice { 0.0 };
 };
 
@@ -144,17 +124,15 @@ OrderbookDialog::OrderbookDialog(QString symbol, CENTAUR_PLUGIN_NAMESPACE::IExch
         this->show();
     });
 
-    ui()->asksTable->setHorizontalHeaderLabels({ QString(tr("Price (%1)")).arg(_impl->quote), QString(tr("Amount (%1)")).arg(_impl->base), QString(tr("Total (%1)")).arg(_impl->quote) });
-    ui()->asksTable->horizontalHeaderItem(0)->setTextAlignment(Qt::AlignLeft | Qt::AlignVCenter);
-    ui()->asksTable->horizontalHeaderItem(1)->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-    ui()->asksTable->horizontalHeaderItem(2)->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-    ui()->asksTable->setItemDelegateForColumn(2, new ProgressDelegate(ProgressDelegate::Type::ask, this));
+    const QStringList headers { QString(tr("Price (%1)")).arg(_impl->quote), QString(tr("Amount (%1)")).arg(_impl->base), QString(tr("Total (%1)")).arg(_impl->quote) };
+
+    _impl->asksModel = new OrderbookModel(OrderbookModel::Side::ask, headers, this);
+    ui()->asksTable->setModel(_impl->asksModel);
+    ui()->asksTable->setItemDelegateForColumn(2, new ProgressDelegate(OrderbookModel::Side::ask, this));
 
-    ui()->bidsTable->setHorizontalHeaderLabels({ QString(tr("Price (%1)")).arg(_impl->quote), QString(tr("Amount (%1)")).arg(_impl->base), QString(tr("Total (%1)")).arg(_impl->quote) });
-    ui()->bidsTable->horizontalHeaderItem(0)->setTextAlignment(Qt::AlignLeft | Qt::AlignVCenter);
-    ui()->bidsTable->horizontalHeaderItem(1)->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-    ui()->bidsTable->horizontalHeaderItem(2)->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-    ui()->bidsTable->setItemDelegateForColumn(2, new ProgressDelegate(ProgressDelegate::Type::bid, this));
+    _impl->bidsModel = new OrderbookModel(OrderbookModel::Side::bid, headers, this);
+    ui()->bidsTable->setModel(_impl->bidsModel);
+    ui()->bidsTable->setItemDelegateForColumn(2, new ProgressDelegate(OrderbookModel::Side::bid, this));
 
     // This will connect our dialog with the emitter
     // clang-format off
@@ -189,9 +167,6 @@ OrderbookDialog::OrderbookDialog(QString symbol, CENTAUR_PLUGIN_NAMESPACE::IExch
         }
     });
 
-    ui()->asksTable->sortByColumn(0, Qt::SortOrder::DescendingOrder);
-    ui()->bidsTable->sortByColumn(0, Qt::SortOrder::AscendingOrder);
-
     _impl->source = QString::fromStdString(exchange->getPluginUUID().to_string(false));
 
     restoreInterface();
@@ -275,98 +250,11 @@ void OrderbookDialog::onOrderbookUpdate(const QString &source, const QString &sy
     if (_impl->source != source || _impl->symbol != symbol)
         return;
 
-    auto insertTable = [](const QString &text, QTableWidget *ui, int row, int col, int type) -> QTableWidgetItem * {
-        QTableWidgetItem *item = ui->item(row, col);
-        if (item == nullptr) {
-            item = new QTableWidgetItem(text);
-            switch (col) {
-                case 1:
-                    item->setTextAlignment(Qt::AlignCenter | Qt::AlignVCenter);
-                    break;
-                case 2:
-                    item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
-                    break;
-                case 0:
-                default:
-                    item->setTextAlignment(Qt::AlignLeft | Qt::AlignVCenter);
-                    if (type == 1)
-                        item->setForeground(QBrush(QColor(0xFFA7AC)));
-                    else
-                        item->setForeground(QBrush(QColor(0x9CFFB4)));
-                    break;
-            }
-
-            ui->setItem(row, col, item);
-        }
-
-        // Quite an expensive function
-        item->setText(text);
-        return item;
-    };
-
-    int nRowIndex;
-
-    double maxAskItem = 0, minAskItem = 0, maxBidItem = 0, minBidItem = 0;
-    auto maxAskItemIter = std::max_element(asks.begin(), asks.end(),
-        [](const QPair<qreal, qreal> &p, const QPair<qreal, qreal> &d) -> bool {
-            return p.first < d.first;
-        });
-    if (maxAskItemIter != asks.end())
-        maxAskItem = maxAskItemIter->first;
-
-    auto minAskItemIter = std::min_element(asks.begin(), asks.end(),
-        [](const QPair<qreal, qreal> &p, const QPair<qreal, qreal> &d) -> bool {
-            return p.first < d.first;
-        });
-    if (minAskItemIter != asks.end())
-        minAskItem = minAskItemIter->first;
-
-    auto maxBidItemIter = std::max_element(bids.begin(), bids.end(),
-        [](const QPair<qreal, qreal> &p, const QPair<qreal, qreal> &d) -> bool {
-            return p.first < d.first;
-        });
-    if (maxBidItemIter != bids.end())
-        maxBidItem = maxBidItemIter->first;
-
-    auto minBidItemIter = std::min_element(bids.begin(), bids.end(),
-        [](const QPair<qreal, qreal> &p, const QPair<qreal, qreal> &d) -> bool {
-            return p.first < d.first;
-        });
-    if (minBidItemIter != bids.end())
-        minBidItem = minBidItemIter->first;
-
-    ui()->asksTable->setRowCount(static_cast<int>(asks.size()));
-    nRowIndex = 0;
-    for (auto iter = asks.begin(); iter != asks.end(); ++iter) {
-        insertTable(QString("$ %1").arg(QLocale(QLocale::English).toString(iter.key(), 'f', 5)), ui()->asksTable, nRowIndex, 0, 1);
-        insertTable(QString("$ %1").arg(QLocale(QLocale::English).toString(iter.value().first, 'f', 5)), ui()->asksTable, nRowIndex, 1, 1);
-        auto item = insertTable(QString("$ %1").arg(QLocale(QLocale::English).toString(iter.value().second, 'f', 5)), ui()->asksTable, nRowIndex, 2, 1);
-
-        item->setData(Qt::UserRole + 1, minAskItem);
-        item->setData(Qt::UserRole + 2, maxAskItem);
-        item->setData(Qt::UserRole + 3, iter.value().first);
-
-        ++nRowIndex;
-    }
-
-    ui()->bidsTable->setRowCount(static_cast<int>(bids.size()));
-    nRowIndex = 0;
-    for (auto iter = bids.begin(); iter != bids.end(); ++iter) {
-        insertTable(QString("$ %1").arg(QLocale(QLocale::English).toString(iter.key(), 'f', 5)), ui()->bidsTable, nRowIndex, 0, 0);
-        insertTable(QString("$ %1").arg(QLocale(QLocale::English).toString(iter.value().first, 'f', 5)), ui()->bidsTable, nRowIndex, 1, 0);
-        auto item = insertTable(QString("$ %1").arg(QLocale(QLocale::English).toString(iter.value().second, 'f', 5)), ui()->bidsTable, nRowIndex, 2, 0);
-
-        item->setData(Qt::UserRole + 1, minBidItem);
-        item->setData(Qt::UserRole + 2, maxBidItem);
-        item->setData(Qt::UserRole + 3, iter.value().first);
-
-        ++nRowIndex;
-    }
-
-    if (ui()->asksTable->rowCount())
-        ui()->asksTable->scrollToItem(ui()->asksTable->item(ui()->asksTable->rowCount() - 1, 0));
-    if (ui()->bidsTable->rowCount())
-        ui()->bidsTable->scrollToItem(ui()->asksTable->item(0, 0));
+    // The best ask is kept in sight, next to the price
+    if (_impl->asksModel->update(asks))
+        ui()->asksTable->scrollToBottom();
+    if (_impl->bidsModel->update(bids))
+        ui()->bidsTable->scrollToTop();
 
     // Calculate latency
     const auto ms      = static_cast<quint64>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
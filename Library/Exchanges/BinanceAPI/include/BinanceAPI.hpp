@@ -16,10 +16,28 @@
 #include "BinanceAPIGlobal.hpp"
 //
 #include "APIException.hpp"
+#include "BinanceAPIArena.hpp"
+#include "BinanceAPIAsync.hpp"
+#include "BinanceAPICache.hpp"
+#include "BinanceAPIChannel.hpp"
+#include "BinanceAPICoalescer.hpp"
+#include "BinanceAPIConnectionPool.hpp"
+#include "BinanceAPIFixedPoint.hpp"
 #include "BinanceAPILimits.hpp"
+#include "BinanceAPIMetrics.hpp"
+#include "BinanceAPINumeric.hpp"
+#include "BinanceAPIOrderBook.hpp"
+#include "BinanceAPIParsers.hpp"
+#include "BinanceAPIScheduler.hpp"
+#include "BinanceAPISigner.hpp"
+#include "BinanceAPIStreamEvents.hpp"
 #include "Binapi.hpp"
 #include "WSFuturesBinanceAPI.hpp"
 #include "WSFuturesBinanceUser.hpp"
+#include "WSReactor.hpp"
+#include "WSSequences.hpp"
 #include "WSSpotBinanceAPI.hpp"
+#include "WSSpotMultiplexer.hpp"
+#include "WSSubscriptions.hpp"
 
 #endif // FUTURES_BINANCEAPI_HPP
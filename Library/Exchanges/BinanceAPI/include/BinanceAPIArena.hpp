@@ -0,0 +1,154 @@
+////////////////////////////////////////////////////////////////////////////////
+// Created by Ricardo Romero on 17/10/2026 for BinanceAPI.
+// Copyright (c) 2026. Ricardo Romero
+// All rights reserved.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __cplusplus
+#error "C++ compiler needed"
+#endif /*__cplusplus*/
+
+#pragma once
+
+#ifndef BINANCEAPIARENA_HPP_
+#define BINANCEAPIARENA_HPP_
+
+#include "BinanceAPIGlobal.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace BINAPI_NAMESPACE
+{
+    namespace local
+    {
+        /// \brief Memory of one REST response: the body, parsed in situ, and the buffer backing the
+        /// rapidjson::MemoryPoolAllocator of the DOM (or of the reader stack for the typed parsers).
+        /// Arenas are recycled per thread and the buffer keeps the largest size a response needed,
+        /// so once a thread has seen its biggest response the parsing takes no memory from the heap
+        class BINAPI_EXPORT ResponseArena final
+        {
+        public:
+            /// \brief Counters of the arenas of the calling thread. All the values are cumulative
+            struct Statistics
+            {
+                /// Number of responses parsed
+                uint64_t responses { 0 };
+                /// Number of responses served by a recycled arena
+                uint64_t reused { 0 };
+                /// Number of times a buffer had to grow because a response outgrew it
+                uint64_t grown { 0 };
+                /// Size in bytes of the largest buffer
+                std::size_t capacity { 0 };
+            };
+
+            /// \brief Returns the arena to the free list of the thread
+            struct Recycler
+            {
+                auto operator()(ResponseArena *arena) const noexcept -> void;
+            };
+
+            using Pointer = std::unique_ptr<ResponseArena, Recycler>;
+
+        public:
+            /// \brief Take an arena from the free list of the calling thread, or create one
+            T_NODISCARD static auto acquire() -> Pointer;
+
+            /// \brief Counters of the calling thread
+            T_NODISCARD static auto getStatistics() noexcept -> Statistics;
+
+        public:
+            ResponseArena();
+            ~ResponseArena();
+
+            ResponseArena(const ResponseArena &)                     = delete;
+            auto operator=(const ResponseArena &) -> ResponseArena & = delete;
+
+        public:
+            /// \brief Start a new response. The body is moved into the arena and the allocator is rebuilt over the buffer
+            ///
+            /// \param body The response body. Empty when the caller keeps the text
+            /// \return The allocator of the new response
+            auto prepare(std::string &&body) -> rapidjson::MemoryPoolAllocator<> *;
+
+            /// \brief Start a new response whose text stays with the caller, such as a WebSocket message
+            ///
+            /// \param textSize Size of the text
+            /// \return The allocator of the new response
+            auto prepare(std::size_t textSize) -> rapidjson::MemoryPoolAllocator<> *;
+
+            /// \brief The null-terminated mutable body, to be parsed in situ
+            T_NODISCARD auto body() noexcept -> char *;
+
+            /// \brief Initial capacity of the parser stack for the current text.
+            /// The stack holds the values of the open containers, which for the REST responses stays under an eighth of the text
+            T_NODISCARD auto stackCapacity() const noexcept -> std::size_t;
+
+        private:
+            std::string m_body;
+            std::size_t m_textSize { 0 };
+            std::unique_ptr<char[]> m_buffer;
+            std::size_t m_bufferSize { 0 };
+            std::optional<rapidjson::MemoryPoolAllocator<>> m_allocator;
+        };
+
+        /// \brief Holds the arena of a ResponseDocument. Being the first base, the arena outlives the DOM
+        struct BINAPI_HIDDEN ResponseArenaHolder
+        {
+            ResponseArena::Pointer m_arena;
+        };
+
+        /// \brief DOM of a REST response built over a ResponseArena.
+        /// The body is parsed in situ, so the strings are not copied: GetString() and jsonToView() point into the body
+        /// and may be borrowed while the document is alive.
+        /// \remarks The rapidjson::Document base is private, so the DOM can not be moved into a plain rapidjson::Document
+        /// that would outlive its memory. root() gives the document where a rapidjson::Value is expected
+        class BINAPI_EXPORT ResponseDocument final : private ResponseArenaHolder, private rapidjson::Document
+        {
+        public:
+            /// \brief Parse body in situ. Check HasParseError() as with rapidjson::Document::Parse
+            explicit ResponseDocument(std::string &&body);
+
+            /// \brief Parse text in situ without taking it. The text must be null-terminated and outlive the document
+            ///
+            /// \param text The text. It is modified by the parsing
+            /// \param size Size of the text, without the null character
+            ResponseDocument(char *text, std::size_t size);
+            ResponseDocument(ResponseDocument &&) noexcept = default;
+            ~ResponseDocument();
+
+            ResponseDocument(const ResponseDocument &)                        = delete;
+            auto operator=(const ResponseDocument &) -> ResponseDocument &    = delete;
+            auto operator=(ResponseDocument &&) noexcept -> ResponseDocument & = delete;
+
+        public:
+            using rapidjson::Document::GetErrorOffset;
+            using rapidjson::Document::GetParseError;
+            using rapidjson::Document::HasParseError;
+
+            using rapidjson::Document::Accept;
+            using rapidjson::Document::FindMember;
+            using rapidjson::Document::GetArray;
+            using rapidjson::Document::HasMember;
+            using rapidjson::Document::IsArray;
+            using rapidjson::Document::IsObject;
+            using rapidjson::Document::MemberEnd;
+            using rapidjson::Document::Size;
+            using rapidjson::Document::operator[];
+
+            /// \brief The root of the DOM. Read-only, so it can not be moved out of the document
+            T_NODISCARD auto root() const noexcept -> const rapidjson::Value &;
+        };
+    } // namespace local
+
+    /// \brief Borrow a JSON string. Valid as long as the document holding value
+    T_NODISCARD inline auto jsonToView(const rapidjson::Value &value) noexcept -> std::string_view
+    {
+        return { value.GetString(), value.GetStringLength() };
+    }
+} // namespace BINAPI_NAMESPACE
+
+#endif /*BINANCEAPIARENA_HPP_*/
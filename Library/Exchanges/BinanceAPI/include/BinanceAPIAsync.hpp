@@ -0,0 +1,160 @@
+////////////////////////////////////////////////////////////////////////////////
+// Created by Ricardo Romero on 17/10/2026 for BinanceAPI.
+// Copyright (c) 2026. Ricardo Romero
+// All rights reserved.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __cplusplus
+#error "C++ compiler needed"
+#endif /*__cplusplus*/
+
+#pragma once
+
+#ifndef BINANCEAPIASYNC_HPP_
+#define BINANCEAPIASYNC_HPP_
+
+#include "BinanceAPIGlobal.hpp"
+#include "Binapi.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace BINAPI_NAMESPACE
+{
+    /// \brief Fixed size worker pool used to run REST calls concurrently. Thread-safe
+    class BINAPI_EXPORT RequestExecutor final
+    {
+    public:
+        /// \param workers Number of threads. At least one thread is always created
+        explicit RequestExecutor(std::size_t workers);
+        /// \brief Runs all the pending tasks and joins the workers. Call discardPending() first not to run them
+        ~RequestExecutor();
+
+        RequestExecutor(const RequestExecutor &)                     = delete;
+        auto operator=(const RequestExecutor &) -> RequestExecutor & = delete;
+
+    public:
+        /// \brief Queue a task
+        ///
+        /// \param fn Any callable with no arguments
+        /// \return std::future with the result of fn. Exceptions thrown by fn are stored in the future
+        template <typename Fn>
+        auto submit(Fn &&fn) -> std::future<std::invoke_result_t<Fn>>
+        {
+            using result_t = std::invoke_result_t<Fn>;
+            // std::function needs a copyable target
+            auto task   = std::make_shared<std::packaged_task<result_t()>>(std::forward<Fn>(fn));
+            auto future = task->get_future();
+            enqueue([task] { (*task)(); });
+            return future;
+        }
+
+        T_NODISCARD auto getWorkers() const noexcept -> std::size_t;
+
+        /// \brief Number of tasks waiting for a free worker
+        T_NODISCARD auto getPending() const noexcept -> std::size_t;
+
+        /// \brief Drop the tasks waiting for a free worker, e.g. on shutdown, when their callers are going away.
+        /// The tasks running are not interrupted. The futures of the tasks dropped throw std::future_error
+        /// (broken_promise), and the callbacks of BinanceAPISpotAsync::submit are not called
+        /// \return The number of tasks dropped
+        auto discardPending() -> std::size_t;
+
+    private:
+        auto enqueue(std::function<void()> task) -> void;
+        auto run() noexcept -> void;
+
+    private:
+        mutable std::mutex m_mutex;
+        std::condition_variable m_wakeUp;
+        std::deque<std::function<void()>> m_tasks;
+        std::vector<std::thread> m_workers;
+        bool m_terminate { false };
+    };
+
+    /// \brief Asynchronous facade of BinanceAPISpot.
+    /// Every call is queued in a RequestExecutor and goes through BinanceAPI::request, so BinanceLimits is honored
+    /// exactly as in the blocking API: a call that exceeds the limits delivers an APIException(Type::limits) through its future.
+    /// Arguments are copied, so the caller does not have to keep them alive
+    class BINAPI_EXPORT BinanceAPISpotAsync final
+    {
+    public:
+        /// \param api The underlying API. Must outlive this object
+        /// \param workers Number of concurrent requests. Zero uses the number of sessions of the api connection pool.
+        ///                The connection pool of api is grown to at least this number of sessions
+        explicit BinanceAPISpotAsync(BinanceAPISpot *api, std::size_t workers = 0);
+        ~BinanceAPISpotAsync();
+
+    public:
+        /// \brief Run any BinanceAPISpot call in the worker pool
+        ///
+        /// \param fn A callable receiving a BinanceAPISpot &
+        /// \return The future with the result
+        template <typename Fn>
+        auto submit(Fn &&fn) -> std::future<std::invoke_result_t<Fn, BinanceAPISpot &>>
+        {
+            return m_executor.submit([api = m_api, fn = std::forward<Fn>(fn)]() mutable { return fn(*api); });
+        }
+
+        /// \brief Run any BinanceAPISpot call in the worker pool and deliver the result through callbacks.
+        /// The callbacks are invoked in the worker thread
+        ///
+        /// \param fn A callable receiving a BinanceAPISpot &
+        /// \param onResult Called with the result of fn (or with no arguments when fn returns void)
+        /// \param onError Called with the std::exception_ptr thrown by fn
+        template <typename Fn, typename OnResult, typename OnError>
+        auto submit(Fn &&fn, OnResult &&onResult, OnError &&onError) -> void
+        {
+            m_executor.submit([api = m_api, fn = std::forward<Fn>(fn), onResult = std::forward<OnResult>(onResult), onError = std::forward<OnError>(onError)]() mutable {
+                try
+                {
+                    if constexpr (std::is_void_v<std::invoke_result_t<Fn, BinanceAPISpot &>>)
+                    {
+                        fn(*api);
+                        onResult();
+                    }
+                    else
+                        onResult(fn(*api));
+                } catch (...)
+                {
+                    onError(std::current_exception());
+                }
+            });
+        }
+
+    public:
+        T_NODISCARD auto ping() -> std::future<void>;
+        T_NODISCARD auto checkServerTime() -> std::future<uint64_t>;
+        T_NODISCARD auto getExchangeInformation() -> std::future<SPOT::ExchangeInformation>;
+        T_NODISCARD auto getOrderBook(v_sym_t symbol, uint32_t limit = 100) -> std::future<SPOT::OrderBook>;
+        T_NODISCARD auto candlestickData(v_sym_t symbol, BinanceTimeIntervals bti, uint64_t startTime, uint64_t endTime, uint64_t limit = 500) -> std::future<std::vector<Candlestick>>;
+        T_NODISCARD auto tickerPriceChangeStatistics24hr(v_sym_t symbol) -> std::future<SPOT::TickerPriceChangeStatistics>;
+        T_NODISCARD auto tickerPriceChangeStatistics24hr(const std::vector<sym_t> &symbols) -> std::future<std::unordered_map<sym_t, SPOT::TickerPriceChangeStatistics>>;
+
+        /// \brief Fetch all the candles between startTime and endTime. The range is split with BinanceAPI::getCandlesTimesAndLimits
+        /// and every chunk is requested concurrently with RequestPriority::background
+        ///
+        /// \param symbol Symbol name
+        /// \param bti Time interval
+        /// \param startTime Start time in milliseconds
+        /// \param endTime End time in milliseconds
+        /// \return One future per chunk with candles, in chronological order. The empty trailing chunk that
+        ///         getCandlesTimesAndLimits returns when the range is a multiple of 1000 candles has no future
+        T_NODISCARD auto candlesByPeriod(v_sym_t symbol, BinanceTimeIntervals bti, uint64_t startTime, uint64_t endTime) -> std::vector<std::future<std::vector<Candlestick>>>;
+
+        T_NODISCARD auto getExecutor() noexcept -> RequestExecutor &;
+
+    private:
+        BinanceAPISpot *m_api;
+        RequestExecutor m_executor;
+    };
+} // namespace BINAPI_NAMESPACE
+
+#endif /*BINANCEAPIASYNC_HPP_*/
@@ -0,0 +1,144 @@
+////////////////////////////////////////////////////////////////////////////////
+// Created by Ricardo Romero on 17/10/2026 for BinanceAPI.
+// Copyright (c) 2026. Ricardo Romero
+// All rights reserved.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __cplusplus
+#error "C++ compiler needed"
+#endif /*__cplusplus*/
+
+#pragma once
+
+#ifndef BINANCEAPICACHE_HPP_
+#define BINANCEAPICACHE_HPP_
+
+#include "BinanceAPIGlobal.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace BINAPI_NAMESPACE
+{
+    /// \brief Keeps the bodies of the GET responses of slow-moving endpoints, such as /api/v3/exchangeInfo, for a time to live set per endpoint.
+    /// Expired entries that came with an ETag or a Last-Modified header are revalidated with a conditional request; a 304 renews them
+    /// without transferring the body again.
+    /// The cache can be saved to and loaded from a binary snapshot, so an application started again within the time to live makes no call at all.
+    /// The cache is thread-safe
+    class BINAPI_EXPORT ResponseCache final
+    {
+    public:
+        using clock = std::chrono::system_clock;
+
+        /// \brief Counters of the cache. All the values are cumulative
+        struct Metrics
+        {
+            /// Calls answered from the cache
+            uint64_t hits { 0 };
+            /// Calls that went to the server: not cached, expired or revalidated
+            uint64_t misses { 0 };
+            /// Misses answered with 304 Not Modified
+            uint64_t revalidated { 0 };
+            /// Responses stored
+            uint64_t stores { 0 };
+            /// Request weight of the calls answered from the cache
+            uint64_t weightSaved { 0 };
+
+            T_NODISCARD inline auto hitRate() const noexcept -> double
+            {
+                return hits + misses == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(hits + misses);
+            }
+        };
+
+        /// \brief Result of find
+        struct Lookup
+        {
+            /// The body. Null when the server must be called
+            std::shared_ptr<const std::string> body;
+            /// If-None-Match and If-Modified-Since of an expired entry. Empty when the entry has no validators
+            std::vector<std::pair<std::string, std::string>> conditional;
+        };
+
+    public:
+        ResponseCache() noexcept;
+        ~ResponseCache();
+
+        ResponseCache(const ResponseCache &)                     = delete;
+        auto operator=(const ResponseCache &) -> ResponseCache & = delete;
+
+    public:
+        /// \brief Cache the responses of an endpoint. A zero time to live, the default, disables the cache for it
+        ///
+        /// \param endPoint e.g. /api/v3/exchangeInfo
+        /// \param timeToLive How long a response is used without asking the server
+        auto setTimeToLive(std::string_view endPoint, std::chrono::seconds timeToLive) -> void;
+        T_NODISCARD auto getTimeToLive(std::string_view endPoint) const -> std::chrono::seconds;
+
+        /// \brief Key of a call. timestamp, recvWindow and signature are left out, the other parameters are sorted
+        ///
+        /// \param endPoint The endpoint
+        /// \param parameters Parameters of the call
+        /// \param identity For signed calls, the API key. Only a hash of it is part of the key
+        T_NODISCARD static auto makeKey(std::string_view endPoint, const std::vector<std::pair<std::string, std::string>> &parameters, std::string_view identity) -> std::string;
+
+        /// \brief Look up a call
+        ///
+        /// \param endPoint The endpoint of the key, for the time to live and the metrics
+        /// \param key Made with makeKey
+        /// \param callWeight Weight of the call, counted as saved on a hit
+        T_NODISCARD auto find(std::string_view endPoint, const std::string &key, long long callWeight, clock::time_point now = clock::now()) -> Lookup;
+
+        /// \brief Store the body of a 200 response. ETag and Last-Modified are taken from the headers when present
+        auto store(std::string_view endPoint, const std::string &key, std::string body, std::string etag, std::string lastModified, clock::time_point now = clock::now()) -> void;
+
+        /// \brief The server answered 304 Not Modified. The entry is renewed
+        /// \return The body of the entry. Null if it was removed meanwhile
+        T_NODISCARD auto revalidated(std::string_view endPoint, const std::string &key, clock::time_point now = clock::now()) -> std::shared_ptr<const std::string>;
+
+        /// \brief Remove the entries of an endpoint. An empty endPoint removes everything
+        auto invalidate(std::string_view endPoint = {}) -> void;
+
+        /// \brief Write the entries to path. The file is replaced atomically
+        ///
+        /// \param path The file
+        /// \param includeSigned Also write the responses of signed calls. They hold account data, such as the balances of
+        /// /sapi/v1/capital/config/getall, and the file is not encrypted
+        /// \return false if the file could not be written
+        auto saveSnapshot(const std::filesystem::path &path, bool includeSigned = false) const -> bool;
+
+        /// \brief Read a snapshot written by saveSnapshot. Entries keep the time they were stored, so expired ones are only used
+        /// for revalidation. Entries already in the cache that are newer are kept
+        /// \return false if the file does not exist or is not a valid snapshot. Nothing is loaded then
+        auto loadSnapshot(const std::filesystem::path &path) -> bool;
+
+        T_NODISCARD auto getMetrics() const -> Metrics;
+        T_NODISCARD auto getMetrics(std::string_view endPoint) const -> Metrics;
+
+        T_NODISCARD auto size() const -> std::size_t;
+
+    private:
+        struct Entry
+        {
+            std::shared_ptr<const std::string> body;
+            std::string etag;
+            std::string lastModified;
+            clock::time_point stored;
+        };
+
+    private:
+        mutable std::mutex m_mutex;
+        std::unordered_map<std::string, Entry> m_entries;
+        std::unordered_map<std::string, std::chrono::seconds> m_timeToLive;
+        std::unordered_map<std::string, Metrics> m_metrics;
+    };
+} // namespace BINAPI_NAMESPACE
+
+#endif /*BINANCEAPICACHE_HPP_*/
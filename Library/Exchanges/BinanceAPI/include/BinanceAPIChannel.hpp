@@ -0,0 +1,323 @@
+////////////////////////////////////////////////////////////////////////////////
+// Created by Ricardo Romero on 17/10/2026 for BinanceAPI.
+// Copyright (c) 2026. Ricardo Romero
+// All rights reserved.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __cplusplus
+#error "C++ compiler needed"
+#endif /*__cplusplus*/
+
+#pragma once
+
+#ifndef BINANCEAPICHANNEL_HPP_
+#define BINANCEAPICHANNEL_HPP_
+
+#include "BinanceAPIGlobal.hpp"
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace BINAPI_NAMESPACE
+{
+    /// \brief An immutable payload shared by reference between threads. Passing it through a channel copies a pointer
+    template <typename T>
+    using Snapshot = std::shared_ptr<const T>;
+
+    template <typename T, typename... Args>
+    auto makeSnapshot(Args &&...args) -> Snapshot<T>
+    {
+        return std::make_shared<const T>(std::forward<Args>(args)...);
+    }
+
+    namespace local
+    {
+        // Separates the members written by the producers from the ones written by the consumer
+        inline constexpr std::size_t g_cacheLineSize = 64;
+
+        /// \brief Wakes the consumer of a channel once per batch: the wake function is called by the push that finds the
+        /// consumer idle, and not again until the consumer starts draining
+        class ChannelSignal final
+        {
+        public:
+            explicit ChannelSignal(std::function<void()> wake) :
+                m_wake { std::move(wake) } { }
+
+            /// \brief Called by the producers after publishing an event
+            auto raise() -> void
+            {
+                // Pairs with the fence of clear: either the consumer sees the event or this sees the signal cleared
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (m_raised.load(std::memory_order_relaxed))
+                    return;
+                if (!m_raised.exchange(true, std::memory_order_acq_rel) && m_wake)
+                    m_wake();
+            }
+
+            /// \brief Called by the consumer before draining the channel
+            auto clear() -> void
+            {
+                m_raised.store(false, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+
+            auto setWake(std::function<void()> wake) -> void
+            {
+                m_wake = std::move(wake);
+            }
+
+        private:
+            std::function<void()> m_wake;
+            alignas(g_cacheLineSize) std::atomic_bool m_raised { false };
+        };
+
+        inline auto channelCapacity(std::size_t capacity) noexcept -> std::size_t
+        {
+            return std::bit_ceil(capacity < 2 ? std::size_t { 2 } : capacity);
+        }
+    } // namespace local
+
+    /// \brief Bounded lock-free queue between one producer thread and one consumer thread.
+    /// Pushing and popping are wait-free; the indices of the other side are cached, so the shared cache lines are only
+    /// read when the cached value says the queue is full or empty.
+    ///
+    /// The consumer is woken once per batch (see drain): the wake function, e.g. a queued call to the consumer thread,
+    /// is called by the first push after the consumer started draining.
+    /// \tparam T Default constructible and movable. Use Snapshot<X> for payloads that are expensive to copy
+    template <typename T>
+    class SPSCChannel final
+    {
+    public:
+        using value_type = T;
+
+        /// \param capacity Events the channel holds, rounded up to a power of two
+        /// \param wake Called by the producer when the consumer has to drain the channel
+        explicit SPSCChannel(std::size_t capacity, std::function<void()> wake = {}) :
+            m_slots(local::channelCapacity(capacity)),
+            m_mask { m_slots.size() - 1 },
+            m_signal { std::move(wake) }
+        {
+        }
+
+        SPSCChannel(const SPSCChannel &)                     = delete;
+        auto operator=(const SPSCChannel &) -> SPSCChannel & = delete;
+
+    public:
+        /// \brief Set the wake function. Not thread-safe: call it before the producer starts
+        auto setWake(std::function<void()> wake) -> void
+        {
+            m_signal.setWake(std::move(wake));
+        }
+
+        /// \brief Producer side
+        /// \return false if the channel is full and the event was dropped
+        auto push(T value) -> bool
+        {
+            const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+            if (tail - m_cachedHead == m_slots.size())
+            {
+                m_cachedHead = m_head.load(std::memory_order_acquire);
+                if (tail - m_cachedHead == m_slots.size())
+                {
+                    m_dropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+            }
+
+            m_slots[tail & m_mask] = std::move(value);
+            m_tail.store(tail + 1, std::memory_order_release);
+            m_signal.raise();
+            return true;
+        }
+
+        /// \brief Consumer side
+        /// \return The oldest event, or nothing if the channel is empty
+        auto pop() -> std::optional<T>
+        {
+            const std::size_t head = m_head.load(std::memory_order_relaxed);
+            if (head == m_cachedTail)
+            {
+                m_cachedTail = m_tail.load(std::memory_order_acquire);
+                if (head == m_cachedTail)
+                    return std::nullopt;
+            }
+
+            // The slot is reset, so the channel does not keep the payload alive
+            std::optional<T> value { std::exchange(m_slots[head & m_mask], T {}) };
+            m_head.store(head + 1, std::memory_order_release);
+            return value;
+        }
+
+        /// \brief Consumer side. Pop every event, calling fn with each one
+        /// \return Events delivered
+        template <typename Fn>
+        auto drain(Fn &&fn) -> std::size_t
+        {
+            m_signal.clear();
+
+            std::size_t count = 0;
+            while (auto value = pop())
+            {
+                fn(std::move(*value));
+                ++count;
+            }
+            return count;
+        }
+
+    public:
+        T_NODISCARD auto capacity() const noexcept -> std::size_t { return m_slots.size(); }
+        /// \brief Events pushed and not popped. Approximate while the other side is running
+        T_NODISCARD auto size() const noexcept -> std::size_t { return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire); }
+        /// \brief Events dropped because the channel was full
+        T_NODISCARD auto dropped() const noexcept -> uint64_t { return m_dropped.load(std::memory_order_relaxed); }
+
+    private:
+        std::vector<T> m_slots;
+        const std::size_t m_mask;
+        local::ChannelSignal m_signal;
+
+        // Written by the consumer
+        alignas(local::g_cacheLineSize) std::atomic<std::size_t> m_head { 0 };
+        std::size_t m_cachedTail { 0 };
+
+        // Written by the producer
+        alignas(local::g_cacheLineSize) std::atomic<std::size_t> m_tail { 0 };
+        std::size_t m_cachedHead { 0 };
+        std::atomic<uint64_t> m_dropped { 0 };
+    };
+
+    /// \brief Bounded lock-free queue between many producer threads and one consumer thread.
+    /// Every slot carries a sequence number (D. Vyukov's bounded queue): a producer claims a slot with one compare-and-swap
+    /// and publishes it with a store, the consumer pops without any read-modify-write.
+    ///
+    /// The consumer is woken once per batch, as SPSCChannel.
+    /// \tparam T Default constructible and movable. Use Snapshot<X> for payloads that are expensive to copy
+    template <typename T>
+    class MPSCChannel final
+    {
+    public:
+        using value_type = T;
+
+        /// \param capacity Events the channel holds, rounded up to a power of two
+        /// \param wake Called by a producer when the consumer has to drain the channel
+        explicit MPSCChannel(std::size_t capacity, std::function<void()> wake = {}) :
+            m_capacity { local::channelCapacity(capacity) },
+            m_mask { m_capacity - 1 },
+            m_cells { std::make_unique<Cell[]>(m_capacity) },
+            m_signal { std::move(wake) }
+        {
+            for (std::size_t i = 0; i < m_capacity; ++i)
+                m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        MPSCChannel(const MPSCChannel &)                     = delete;
+        auto operator=(const MPSCChannel &) -> MPSCChannel & = delete;
+
+    public:
+        /// \brief Set the wake function. Not thread-safe: call it before the producers start
+        auto setWake(std::function<void()> wake) -> void
+        {
+            m_signal.setWake(std::move(wake));
+        }
+
+        /// \brief Producer side. Thread-safe
+        /// \return false if the channel is full and the event was dropped
+        auto push(T value) -> bool
+        {
+            std::size_t tail = m_tail.load(std::memory_order_relaxed);
+            Cell *cell       = nullptr;
+            for (;;)
+            {
+                cell                       = &m_cells[tail & m_mask];
+                const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                const auto difference      = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(tail);
+
+                if (difference == 0)
+                {
+                    if (m_tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (difference < 0)
+                {
+                    // The consumer did not pop the event pushed a lap ago
+                    m_dropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                else
+                {
+                    tail = m_tail.load(std::memory_order_relaxed);
+                }
+            }
+
+            cell->value = std::move(value);
+            cell->sequence.store(tail + 1, std::memory_order_release);
+            m_signal.raise();
+            return true;
+        }
+
+        /// \brief Consumer side
+        /// \return The oldest event, or nothing if the channel is empty or the oldest event is still being pushed
+        auto pop() -> std::optional<T>
+        {
+            Cell &cell = m_cells[m_head & m_mask];
+            if (cell.sequence.load(std::memory_order_acquire) != m_head + 1)
+                return std::nullopt;
+
+            std::optional<T> value { std::exchange(cell.value, T {}) };
+            // Free for the push of the next lap
+            cell.sequence.store(m_head + m_capacity, std::memory_order_release);
+            ++m_head;
+            return value;
+        }
+
+        /// \brief Consumer side. Pop every event, calling fn with each one.
+        /// An event still being pushed stops the batch; its producer wakes the consumer again when it is done
+        /// \return Events delivered
+        template <typename Fn>
+        auto drain(Fn &&fn) -> std::size_t
+        {
+            m_signal.clear();
+
+            std::size_t count = 0;
+            while (auto value = pop())
+            {
+                fn(std::move(*value));
+                ++count;
+            }
+            return count;
+        }
+
+    public:
+        T_NODISCARD auto capacity() const noexcept -> std::size_t { return m_capacity; }
+        /// \brief Events dropped because the channel was full
+        T_NODISCARD auto dropped() const noexcept -> uint64_t { return m_dropped.load(std::memory_order_relaxed); }
+
+    private:
+        struct Cell
+        {
+            std::atomic<std::size_t> sequence;
+            T value {};
+        };
+
+        const std::size_t m_capacity;
+        const std::size_t m_mask;
+        std::unique_ptr<Cell[]> m_cells;
+        local::ChannelSignal m_signal;
+
+        // Written by the producers
+        alignas(local::g_cacheLineSize) std::atomic<std::size_t> m_tail { 0 };
+        std::atomic<uint64_t> m_dropped { 0 };
+
+        // Only used by the consumer
+        alignas(local::g_cacheLineSize) std::size_t m_head { 0 };
+    };
+} // namespace BINAPI_NAMESPACE
+
+#endif /*BINANCEAPICHANNEL_HPP_*/
@@ -0,0 +1,100 @@
+////////////////////////////////////////////////////////////////////////////////
+// Created by Ricardo Romero on 17/10/2026 for BinanceAPI.
+// Copyright (c) 2026. Ricardo Romero
+// All rights reserved.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __cplusplus
+#error "C++ compiler needed"
+#endif /*__cplusplus*/
+
+#pragma once
+
+#ifndef BINANCEAPICOALESCER_HPP_
+#define BINANCEAPICOALESCER_HPP_
+
+#include "BinanceAPIGlobal.hpp"
+#include "BinanceAPIScheduler.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace BINAPI_NAMESPACE
+{
+    /// \brief Single-flight of the REST calls. While a call is being transferred, identical calls made by other threads
+    /// wait for it and receive a copy of its response instead of calling the server, so they take no weight.
+    /// Errors of the call, APIException included, are thrown to all of them.
+    /// A call only waits for an identical one of its RequestPriority or a higher one: a call the user waits for never queues
+    /// behind a background call that is still waiting for its weight.
+    /// The coalescer is thread-safe
+    class BINAPI_EXPORT RequestCoalescer final
+    {
+    public:
+        /// \brief Counters of the coalescer. All the values are cumulative
+        struct Metrics
+        {
+            /// Calls transferred
+            uint64_t transferred { 0 };
+            /// Calls that received the response of an identical call in flight
+            uint64_t coalesced { 0 };
+            /// Request weight of the coalesced calls
+            uint64_t weightSaved { 0 };
+        };
+
+    public:
+        RequestCoalescer() noexcept;
+        ~RequestCoalescer();
+
+        RequestCoalescer(const RequestCoalescer &)                     = delete;
+        auto operator=(const RequestCoalescer &) -> RequestCoalescer & = delete;
+
+    public:
+        /// \brief Make the call or wait for an identical one
+        ///
+        /// \param endPoint The endpoint of the call, for the metrics
+        /// \param key Identifies identical calls, e.g. ResponseCache::makeKey
+        /// \param callWeight Weight of the call, counted as saved when coalesced
+        /// \param priority Class of the call
+        /// \param call Makes the transfer. Only called if no identical call of priority or a higher class is in flight
+        /// \return The response of the call
+        auto run(std::string_view endPoint, const std::string &key, long long callWeight, RequestPriority priority, const std::function<cpr::Response()> &call) -> cpr::Response;
+
+        /// \brief With the coalescer disabled every call is transferred. Default is enabled
+        auto setEnabled(bool enabled) noexcept -> void;
+        T_NODISCARD auto isEnabled() const noexcept -> bool;
+
+        T_NODISCARD auto getMetrics() const -> Metrics;
+        T_NODISCARD auto getMetrics(std::string_view endPoint) const -> Metrics;
+
+        /// \brief Calls in flight
+        T_NODISCARD auto inFlight() const -> std::size_t;
+
+    private:
+        struct Flight
+        {
+            std::promise<std::shared_ptr<const cpr::Response>> promise;
+            std::shared_future<std::shared_ptr<const cpr::Response>> response { promise.get_future().share() };
+            std::size_t followers { 0 };
+        };
+
+        /// \brief Remove the flight of class index of key. Call with m_mutex locked
+        auto land(const std::string &key, std::size_t index) -> void;
+
+    private:
+        mutable std::mutex m_mutex;
+        // The flights of a key, one per RequestPriority
+        std::unordered_map<std::string, std::array<std::shared_ptr<Flight>, RequestScheduler::classes>> m_flights;
+        std::unordered_map<std::string, Metrics> m_metrics;
+        std::atomic_bool m_enabled { true };
+    };
+} // namespace BINAPI_NAMESPACE
+
+#endif /*BINANCEAPICOALESCER_HPP_*/
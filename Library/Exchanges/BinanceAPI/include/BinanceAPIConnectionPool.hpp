@@ -0,0 +1,131 @@
+////////////////////////////////////////////////////////////////////////////////
+// Created by Ricardo Romero on 17/10/2026 for BinanceAPI.
+// Copyright (c) 2026. Ricardo Romero
+// All rights reserved.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __cplusplus
+#error "C++ compiler needed"
+#endif /*__cplusplus*/
+
+#pragma once
+
+#ifndef BINANCEAPICONNECTIONPOOL_HPP_
+#define BINANCEAPICONNECTIONPOOL_HPP_
+
+#include "BinanceAPIGlobal.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace BINAPI_NAMESPACE
+{
+    /// \brief Keeps a set of keep-alive cpr::Session per base URL.
+    /// A cpr::Session owns a CURL easy handle and CURL keeps the TCP/TLS connection alive inside the handle,
+    /// so reusing the session means the handshake is only paid when the server closes the connection.
+    /// The pool is thread-safe.
+    class BINAPI_EXPORT BinanceAPIConnectionPool final
+    {
+    public:
+        /// \brief Counters of the pool. All the values are cumulative since the creation of the pool
+        struct Statistics
+        {
+            /// Number of sessions handed to a caller
+            uint64_t checkouts { 0 };
+            /// Number of checkouts served from an idle session
+            uint64_t reused { 0 };
+            /// Number of cpr::Session created
+            uint64_t created { 0 };
+            /// Number of transfers performed with a pooled session
+            uint64_t transfers { 0 };
+            /// Number of new connections (TCP + TLS handshakes) reported by CURL
+            uint64_t handshakes { 0 };
+            /// Number of checkouts that had to wait for a session to be released
+            uint64_t waits { 0 };
+        };
+
+    private:
+        struct HostSessions
+        {
+            std::vector<std::unique_ptr<cpr::Session>> idle;
+            std::size_t total { 0 };
+        };
+
+    public:
+        /// \brief RAII handle of a pooled session. The session is returned to the pool on destruction
+        class BINAPI_EXPORT Lease final
+        {
+        public:
+            Lease(BinanceAPIConnectionPool *pool, HostSessions *host, std::unique_ptr<cpr::Session> session) noexcept;
+            Lease(Lease &&lease) noexcept;
+            Lease(const Lease &)                     = delete;
+            auto operator=(const Lease &) -> Lease & = delete;
+            auto operator=(Lease &&) -> Lease &      = delete;
+            ~Lease();
+
+        public:
+            T_NODISCARD inline auto operator*() const noexcept -> cpr::Session & { return *m_session; }
+            T_NODISCARD inline auto operator->() const noexcept -> cpr::Session * { return m_session.get(); }
+
+            /// \brief Must be called after a transfer was made with the session. Updates the handshake/transfer counters
+            auto transferred() noexcept -> void;
+
+        private:
+            BinanceAPIConnectionPool *m_pool { nullptr };
+            HostSessions *m_host { nullptr };
+            std::unique_ptr<cpr::Session> m_session;
+        };
+
+    public:
+        /// \brief Construct the pool
+        ///
+        /// \param maxSessions Maximum number of sessions per base URL. Callers will wait for a session when all of them are checked out
+        explicit BinanceAPIConnectionPool(std::size_t maxSessions = 8) noexcept;
+        ~BinanceAPIConnectionPool();
+
+    public:
+        /// \brief Checkout a session for baseURL. If all sessions are in use the call blocks until one is released
+        ///
+        /// \param baseURL The base URL. e.g. https://api.binance.com
+        /// \return Lease The session handle
+        T_NODISCARD auto acquire(std::string_view baseURL) -> Lease;
+
+        /// \brief Change the maximum number of sessions per base URL. Sessions already created above the new size are destroyed when released
+        auto setMaxSessions(std::size_t maxSessions) noexcept -> void;
+        T_NODISCARD auto getMaxSessions() const noexcept -> std::size_t;
+
+        /// \brief Enable or disable the peer SSL verification on newly created sessions. Default is true
+        /// \remarks Only intended for local endpoints with self-signed certificates
+        auto setVerifySsl(bool verify) noexcept -> void;
+
+        /// \brief Destroy all idle sessions. Their connections are closed
+        auto clear() noexcept -> void;
+
+        T_NODISCARD auto getStatistics() const noexcept -> Statistics;
+
+    private:
+        auto release(HostSessions *host, std::unique_ptr<cpr::Session> session) noexcept -> void;
+
+    private:
+        mutable std::mutex m_mutex;
+        std::condition_variable m_released;
+        std::unordered_map<std::string, HostSessions> m_hosts;
+        std::size_t m_maxSessions;
+        bool m_verifySsl { true };
+
+        std::atomic_uint64_t m_checkouts { 0 };
+        std::atomic_uint64_t m_reused { 0 };
+        std::atomic_uint64_t m_created { 0 };
+        std::atomic_uint64_t m_transfers { 0 };
+        std::atomic_uint64_t m_handshakes { 0 };
+        std::atomic_uint64_t m_waits { 0 };
+    };
+} // namespace BINAPI_NAMESPACE
+
+#endif /*BINANCEAPICONNECTIONPOOL_HPP_*/
@@ -13,6 +13,8 @@
 #ifndef BINDEFS_HPP_
 #define BINDEFS_HPP_
 
+#include "BinanceAPIFixedPoint.hpp"
+
 #include <bitset>
 #include <map>
 #include <set>
@@ -443,6 +445,7 @@ namespace BINAPI_NAMESPACE
                 currency_t minPrice { 0 };
                 currency_t maxPrice { 0 };
                 quantity_t tickSize { 0 };
+                DecimalScale tickScale {};
             };
 
             struct PercentPrice
@@ -460,6 +463,7 @@ namespace BINAPI_NAMESPACE
                 quantity_t minQty { 0 };
                 quantity_t maxQty { 0 };
                 quantity_t stepSize { 0 };
+                DecimalScale stepScale {};
                 bool present { false };
             };
 
@@ -482,6 +486,7 @@ namespace BINAPI_NAMESPACE
                 quantity_t minQty { 0 };
                 quantity_t maxQty { 0 };
                 quantity_t stepSize { 0 };
+                DecimalScale stepScale {};
                 bool present { false };
             };
 
@@ -1287,14 +1292,20 @@ namespace BINAPI_NAMESPACE
         uint64_t tradeTime;
     };
 
+    struct PriceLevel
+    {
+        currency_t price {};
+        quantity_t quantity {};
+    };
+
     struct StreamDepthUpdate
     {
         uint64_t transactionTime; // Transaction Time is not available on Spot
         uint64_t firstUpdateId;
         uint64_t finalUpdateId;
-        uint64_t finalUpdateIdLastStream;      // Final Update Id is not available on Spot
-        std::map<currency_t, currency_t> bids; // FIRST: price level; SECOND: quantity
-        std::map<currency_t, currency_t> asks; // FIRST: price level; SECOND: quantity
+        uint64_t finalUpdateIdLastStream; // Final Update Id is not available on Spot
+        std::vector<PriceLevel> bids;     // As received: sorted by the exchange, best price first. A quantity of zero removes the level
+        std::vector<PriceLevel> asks;     // As received: sorted by the exchange, best price first. A quantity of zero removes the level
     };
 
     struct StreamBLVTInfo
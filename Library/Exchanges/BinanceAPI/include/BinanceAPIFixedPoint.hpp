@@ -0,0 +1,515 @@
+////////////////////////////////////////////////////////////////////////////////
+// Created by Ricardo Romero on 17/10/2026 for BinanceAPI.
+// Copyright (c) 2026. Ricardo Romero
+// All rights reserved.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __cplusplus
+#error "C++ compiler needed"
+#endif /*__cplusplus*/
+
+#pragma once
+
+#ifndef BINANCEAPIFIXEDPOINT_HPP_
+#define BINANCEAPIFIXEDPOINT_HPP_
+
+#include "BinanceAPIGlobal.hpp"
+
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <compare>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace BINAPI_NAMESPACE
+{
+    namespace local
+    {
+        // clang-format off
+        inline constexpr std::array<int64_t, 19> g_powersOf10Int = {
+            1ll,
+            10ll,
+            100ll,
+            1'000ll,
+            10'000ll,
+            100'000ll,
+            1'000'000ll,
+            10'000'000ll,
+            100'000'000ll,
+            1'000'000'000ll,
+            10'000'000'000ll,
+            100'000'000'000ll,
+            1'000'000'000'000ll,
+            10'000'000'000'000ll,
+            100'000'000'000'000ll,
+            1'000'000'000'000'000ll,
+            10'000'000'000'000'000ll,
+            100'000'000'000'000'000ll,
+            1'000'000'000'000'000'000ll
+        };
+        // clang-format on
+
+        /// \brief Division rounding half away from zero
+        constexpr auto roundedDivision(int64_t value, int64_t divisor) noexcept -> int64_t
+        {
+            const int64_t quotient  = value / divisor;
+            const int64_t remainder = value % divisor;
+            if (remainder == 0)
+                return quotient;
+
+            // |remainder| * 2 >= divisor without overflowing
+            const int64_t absRemainder = remainder < 0 ? -remainder : remainder;
+            if (absRemainder >= divisor - absRemainder)
+                return value < 0 ? quotient - 1 : quotient + 1;
+            return quotient;
+        }
+
+        /// \brief value * 10^exponent throwing std::out_of_range on overflow
+        constexpr auto scaleUp(int64_t value, int32_t exponent) -> int64_t
+        {
+            const int64_t factor = g_powersOf10Int[static_cast<std::size_t>(exponent)];
+            if (value > std::numeric_limits<int64_t>::max() / factor || value < std::numeric_limits<int64_t>::min() / factor)
+                throw std::out_of_range("fixed point overflow");
+            return value * factor;
+        }
+
+        /// \brief a + b throwing std::out_of_range on overflow
+        constexpr auto checkedAdd(int64_t a, int64_t b) -> int64_t
+        {
+            if ((b > 0 && a > std::numeric_limits<int64_t>::max() - b) || (b < 0 && a < std::numeric_limits<int64_t>::min() - b))
+                throw std::out_of_range("fixed point overflow");
+            return a + b;
+        }
+
+        /// \brief a * b. Returns false on overflow
+        constexpr auto multiplyFits(int64_t a, int64_t b, int64_t &result) noexcept -> bool
+        {
+            constexpr int64_t max = std::numeric_limits<int64_t>::max();
+            constexpr int64_t min = std::numeric_limits<int64_t>::min();
+            if (a == 0 || b == 0)
+            {
+                result = 0;
+                return true;
+            }
+            if (a > 0 ? (b > 0 ? a > max / b : b < min / a) : (b > 0 ? a < min / b : a < max / b))
+                return false;
+            result = a * b;
+            return true;
+        }
+
+#if defined(__SIZEOF_INT128__)
+        // A GCC and clang extension: __extension__ keeps -Wpedantic and -Wlanguage-extension-token quiet
+        __extension__ typedef __int128 int128_t;
+#endif /*defined(__SIZEOF_INT128__)*/
+    } // namespace local
+
+    class FixedDecimal;
+
+    /// \brief Decimal grid of a price or a quantity as defined by the PRICE_FILTER tickSize and the LOT_SIZE stepSize.
+    /// A value on the grid is a multiple of step * 10^-decimals.
+    /// A tickSize of "0.01000000" is {2, 1}, "0.05000000" is {2, 5} and "10.00000000" is {0, 10}
+    struct DecimalScale
+    {
+        int32_t decimals { 0 };
+        /// Zero when the filter is disabled (Binance sends a tickSize/stepSize of 0)
+        int64_t step { 0 };
+
+        /// \brief Build the scale from the string sent by Binance
+        ///
+        /// \param size The tickSize or stepSize string
+        /// \return The scale
+        /// \remarks Throws std::invalid_argument on malformed data
+        T_NODISCARD static auto fromString(std::string_view size) -> DecimalScale;
+
+        /// \brief Build the scale from an already parsed tickSize/stepSize. Binance never sends more than 8 decimals
+        T_NODISCARD static auto fromDouble(double size) -> DecimalScale;
+
+        /// \brief The tick or step as a double
+        T_NODISCARD auto toDouble() const noexcept -> double
+        {
+            return static_cast<double>(step) / static_cast<double>(local::g_powersOf10Int[static_cast<std::size_t>(decimals)]);
+        }
+
+        auto operator==(const DecimalScale &) const noexcept -> bool = default;
+    };
+
+    /// \brief Exact decimal stored as a 64-bit integer number of 10^-decimals units.
+    /// Values with the same number of decimals compare and add as plain integers, which makes them suitable as the keys
+    /// of an order book, where two prices on the same tick must always be the same key.
+    /// Mixed operations align both operands to the larger number of decimals.
+    /// Overflows throw std::out_of_range
+    class FixedDecimal
+    {
+    public:
+        using raw_t = int64_t;
+
+        /// The int64 range holds 18 full decimal digits
+        static constexpr int32_t maxDecimals = 18;
+
+    public:
+        constexpr FixedDecimal() noexcept = default;
+        constexpr FixedDecimal(raw_t raw, int32_t decimals) noexcept :
+            m_raw { raw },
+            m_decimals { decimals } { }
+
+    public:
+        /// \brief Parse a plain decimal string ("-19143.21000000") with no allocation and no intermediate double.
+        /// Digits beyond the requested decimals are rounded half away from zero; for data sent by Binance with the
+        /// symbol scale those digits are always zero
+        ///
+        /// \param str The number
+        /// \param decimals Decimals of the result
+        /// \return The value
+        /// \remarks Throws std::invalid_argument on malformed data and std::out_of_range if the value does not fit
+        T_NODISCARD static constexpr auto parse(std::string_view str, int32_t decimals) -> FixedDecimal
+        {
+            checkDecimals(decimals);
+
+            const char *it  = str.data();
+            const char *end = it + str.size();
+
+            bool negative = false;
+            if (it != end && (*it == '-' || *it == '+'))
+            {
+                negative = *it == '-';
+                ++it;
+            }
+
+            int64_t value       = 0;
+            int32_t fractional  = 0;
+            int32_t roundDigit  = 0;
+            bool decimalPoint   = false;
+            bool anyDigit       = false;
+            bool roundDigitSeen = false;
+
+            for (; it != end; ++it)
+            {
+                const char c = *it;
+                if (c >= '0' && c <= '9')
+                {
+                    anyDigit    = true;
+                    const int d = c - '0';
+                    if (decimalPoint && fractional == decimals)
+                    {
+                        // Only the first dropped digit decides the rounding
+                        if (!roundDigitSeen)
+                        {
+                            roundDigit     = d;
+                            roundDigitSeen = true;
+                        }
+                        continue;
+                    }
+                    if (value > (std::numeric_limits<int64_t>::max() - d) / 10)
+                        throw std::out_of_range(std::string { "fixed point overflow: " }.append(str));
+                    value = value * 10 + d;
+                    if (decimalPoint)
+                        ++fractional;
+                }
+                else if (c == '.' && !decimalPoint)
+                    decimalPoint = true;
+                else
+                    throw std::invalid_argument(std::string { "invalid decimal: " }.append(str));
+            }
+
+            if (!anyDigit)
+                throw std::invalid_argument(std::string { "invalid decimal: " }.append(str));
+
+            value = local::scaleUp(value, decimals - fractional);
+            if (roundDigit >= 5)
+            {
+                if (value == std::numeric_limits<int64_t>::max())
+                    throw std::out_of_range(std::string { "fixed point overflow: " }.append(str));
+                ++value;
+            }
+
+            return { negative ? -value : value, decimals };
+        }
+
+        /// \brief Parse a string using the decimals of the symbol scale
+        T_NODISCARD static constexpr auto parse(std::string_view str, const DecimalScale &scale) -> FixedDecimal
+        {
+            return parse(str, scale.decimals);
+        }
+
+        /// \brief Convert a double rounding to the nearest unit
+        T_NODISCARD static auto fromDouble(double value, int32_t decimals) -> FixedDecimal
+        {
+            checkDecimals(decimals);
+            const double scaled = std::round(value * static_cast<double>(local::g_powersOf10Int[static_cast<std::size_t>(decimals)]));
+            if (!(std::abs(scaled) < 9.2e18))
+                throw std::out_of_range("fixed point overflow");
+            return { static_cast<raw_t>(scaled), decimals };
+        }
+
+        /// \brief The product of two values (price * quantity) computed exactly and rounded to decimals
+        T_NODISCARD static auto multiply(const FixedDecimal &lhs, const FixedDecimal &rhs, int32_t decimals) -> FixedDecimal
+        {
+            checkDecimals(decimals);
+            const int32_t productDecimals = lhs.m_decimals + rhs.m_decimals;
+#if defined(__SIZEOF_INT128__)
+            local::int128_t product = static_cast<local::int128_t>(lhs.m_raw) * rhs.m_raw;
+            if (productDecimals > decimals)
+            {
+                // productDecimals can reach 36; divide in steps the table can hold
+                for (int32_t pending = productDecimals - decimals; pending > 0;)
+                {
+                    const int32_t step             = pending > maxDecimals ? maxDecimals : pending;
+                    const local::int128_t divisor  = local::g_powersOf10Int[static_cast<std::size_t>(step)];
+                    const local::int128_t quotient = product / divisor;
+                    local::int128_t remainder      = product % divisor;
+                    if (remainder < 0)
+                        remainder = -remainder;
+                    product = remainder >= divisor - remainder ? (product < 0 ? quotient - 1 : quotient + 1) : quotient;
+                    pending -= step;
+                }
+            }
+            else
+                product *= local::g_powersOf10Int[static_cast<std::size_t>(decimals - productDecimals)];
+
+            if (product > std::numeric_limits<raw_t>::max() || product < std::numeric_limits<raw_t>::min())
+                throw std::out_of_range("fixed point overflow");
+            return { static_cast<raw_t>(product), decimals };
+#else
+            // MSVC has no 128-bit integer; long double keeps the result exact for the usual price/quantity magnitudes
+            const long double product = static_cast<long double>(lhs.m_raw) * static_cast<long double>(rhs.m_raw);
+            const long double scaled  = product * std::pow(10.0L, decimals - productDecimals);
+            if (!(std::fabs(scaled) < 9.2e18L))
+                throw std::out_of_range("fixed point overflow");
+            return { static_cast<raw_t>(std::llroundl(scaled)), decimals };
+#endif
+        }
+
+    public:
+        T_NODISCARD constexpr auto raw() const noexcept -> raw_t { return m_raw; }
+        T_NODISCARD constexpr auto decimals() const noexcept -> int32_t { return m_decimals; }
+        T_NODISCARD constexpr auto isZero() const noexcept -> bool { return m_raw == 0; }
+
+        /// \brief Correctly rounded as long as |raw| <= 2^53
+        T_NODISCARD auto toDouble() const noexcept -> double
+        {
+            return static_cast<double>(m_raw) / static_cast<double>(local::g_powersOf10Int[static_cast<std::size_t>(m_decimals)]);
+        }
+
+        /// \brief Change the number of decimals, rounding half away from zero when decimals are dropped
+        T_NODISCARD constexpr auto rescale(int32_t decimals) const -> FixedDecimal
+        {
+            checkDecimals(decimals);
+            if (decimals == m_decimals)
+                return *this;
+            if (decimals > m_decimals)
+                return { local::scaleUp(m_raw, decimals - m_decimals), decimals };
+            return { local::roundedDivision(m_raw, local::g_powersOf10Int[static_cast<std::size_t>(m_decimals - decimals)]), decimals };
+        }
+
+        /// \brief Round to the nearest multiple of the tick/step. The result has the decimals of the scale
+        T_NODISCARD constexpr auto roundToStep(const DecimalScale &scale) const -> FixedDecimal
+        {
+            const FixedDecimal value = rescale(scale.decimals);
+            if (scale.step <= 1)
+                return value;
+            return { local::roundedDivision(value.m_raw, scale.step) * scale.step, scale.decimals };
+        }
+
+        /// \brief Round toward zero to a multiple of the tick/step. Use it for order quantities, so they never exceed the balance
+        T_NODISCARD constexpr auto truncateToStep(const DecimalScale &scale) const -> FixedDecimal
+        {
+            const FixedDecimal value = scale.decimals < m_decimals
+                                           ? FixedDecimal { m_raw / local::g_powersOf10Int[static_cast<std::size_t>(m_decimals - scale.decimals)], scale.decimals }
+                                           : rescale(scale.decimals);
+            if (scale.step <= 1)
+                return value;
+            return { value.m_raw / scale.step * scale.step, scale.decimals };
+        }
+
+        /// \brief Write the value with exactly decimals() fractional digits ("19143.21"). No allocation
+        ///
+        /// \param first Start of the buffer
+        /// \param last End of the buffer. 22 characters are always enough
+        /// \return One past the last character written, or nullptr if the buffer is too small
+        auto toChars(char *first, char *last) const noexcept -> char *
+        {
+            const uint64_t magnitude = m_raw < 0 ? 0ull - static_cast<uint64_t>(m_raw) : static_cast<uint64_t>(m_raw);
+            const auto divisor       = static_cast<uint64_t>(local::g_powersOf10Int[static_cast<std::size_t>(m_decimals)]);
+
+            if (m_raw < 0)
+            {
+                if (first == last)
+                    return nullptr;
+                *first++ = '-';
+            }
+
+            const auto [ptr, ec] = std::to_chars(first, last, magnitude / divisor);
+            if (ec != std::errc {})
+                return nullptr;
+            first = ptr;
+
+            if (m_decimals == 0)
+                return first;
+            if (last - first < m_decimals + 1)
+                return nullptr;
+
+            *first++          = '.';
+            uint64_t fraction = magnitude % divisor;
+            for (char *digit = first + m_decimals - 1; digit >= first; --digit)
+            {
+                *digit = static_cast<char>('0' + fraction % 10);
+                fraction /= 10;
+            }
+            return first + m_decimals;
+        }
+
+        T_NODISCARD auto toString() const -> std::string
+        {
+            char buffer[24];
+            return { buffer, toChars(buffer, buffer + sizeof(buffer)) };
+        }
+
+    public:
+        constexpr auto operator-() const -> FixedDecimal
+        {
+            if (m_raw == std::numeric_limits<raw_t>::min())
+                throw std::out_of_range("fixed point overflow");
+            return { -m_raw, m_decimals };
+        }
+
+        constexpr auto operator+=(const FixedDecimal &rhs) -> FixedDecimal &
+        {
+            align(rhs);
+            m_raw = local::checkedAdd(m_raw, rhs.rescale(m_decimals).m_raw);
+            return *this;
+        }
+
+        constexpr auto operator-=(const FixedDecimal &rhs) -> FixedDecimal &
+        {
+            align(rhs);
+            m_raw = local::checkedAdd(m_raw, (-rhs).rescale(m_decimals).m_raw);
+            return *this;
+        }
+
+        constexpr auto operator*=(int64_t factor) -> FixedDecimal &
+        {
+            if (!local::multiplyFits(m_raw, factor, m_raw))
+                throw std::out_of_range("fixed point overflow");
+            return *this;
+        }
+
+        friend constexpr auto operator+(FixedDecimal lhs, const FixedDecimal &rhs) -> FixedDecimal { return lhs += rhs; }
+        friend constexpr auto operator-(FixedDecimal lhs, const FixedDecimal &rhs) -> FixedDecimal { return lhs -= rhs; }
+        friend constexpr auto operator*(FixedDecimal lhs, int64_t factor) -> FixedDecimal { return lhs *= factor; }
+
+        friend constexpr auto operator==(const FixedDecimal &lhs, const FixedDecimal &rhs) -> bool
+        {
+            if (lhs.m_decimals == rhs.m_decimals)
+                return lhs.m_raw == rhs.m_raw;
+            return lhs <=> rhs == std::strong_ordering::equal;
+        }
+
+        friend constexpr auto operator<=>(const FixedDecimal &lhs, const FixedDecimal &rhs) -> std::strong_ordering
+        {
+            if (lhs.m_decimals == rhs.m_decimals)
+                return lhs.m_raw <=> rhs.m_raw;
+
+            // Values that overflow when aligned are necessarily larger in magnitude than the other operand
+            const bool lhsFirst           = lhs.m_decimals < rhs.m_decimals;
+            const FixedDecimal &low       = lhsFirst ? lhs : rhs;
+            const FixedDecimal &high      = lhsFirst ? rhs : lhs;
+            const int64_t factor          = local::g_powersOf10Int[static_cast<std::size_t>(high.m_decimals - low.m_decimals)];
+            std::strong_ordering ordering = std::strong_ordering::equal;
+            int64_t aligned               = 0;
+            if (!local::multiplyFits(low.m_raw, factor, aligned))
+                ordering = low.m_raw < 0 ? std::strong_ordering::less : std::strong_ordering::greater;
+            else
+                ordering = aligned <=> high.m_raw;
+
+            if (lhsFirst)
+                return ordering;
+            return 0 <=> ordering;
+        }
+
+    private:
+        static constexpr auto checkDecimals(int32_t decimals) -> void
+        {
+            if (decimals < 0 || decimals > maxDecimals)
+                throw std::out_of_range("fixed point: invalid number of decimals");
+        }
+
+        /// \brief Make this value at least as precise as rhs
+        constexpr auto align(const FixedDecimal &rhs) -> void
+        {
+            if (rhs.m_decimals > m_decimals)
+                *this = rescale(rhs.m_decimals);
+        }
+
+    private:
+        raw_t m_raw { 0 };
+        int32_t m_decimals { 0 };
+    };
+
+    inline auto DecimalScale::fromString(std::string_view size) -> DecimalScale
+    {
+        const auto point = size.find('.');
+
+        int32_t fractionDigits = 0;
+        int32_t decimals       = 0;
+        if (point != std::string_view::npos)
+        {
+            fractionDigits    = static_cast<int32_t>(size.size() - point - 1);
+            const auto lastNZ = size.find_last_not_of('0');
+            decimals          = lastNZ > point ? static_cast<int32_t>(lastNZ - point) : 0;
+        }
+
+        if (fractionDigits > FixedDecimal::maxDecimals)
+            throw std::invalid_argument(std::string { "invalid tick or step size: " }.append(size));
+
+        const FixedDecimal step = FixedDecimal::parse(size, decimals);
+        if (step.raw() < 0)
+            throw std::invalid_argument(std::string { "invalid tick or step size: " }.append(size));
+
+        // A disabled filter keeps the precision Binance uses for the numbers
+        if (step.isZero())
+            return { fractionDigits, 0 };
+
+        return { decimals, step.raw() };
+    }
+
+    inline auto DecimalScale::fromDouble(double size) -> DecimalScale
+    {
+        const FixedDecimal value = FixedDecimal::fromDouble(size, 8);
+        if (value.raw() < 0)
+            throw std::invalid_argument("invalid tick or step size");
+        if (value.isZero())
+            return { 8, 0 };
+
+        DecimalScale scale { 8, value.raw() };
+        while (scale.decimals > 0 && scale.step % 10 == 0)
+        {
+            scale.step /= 10;
+            --scale.decimals;
+        }
+        return scale;
+    }
+} // namespace BINAPI_NAMESPACE
+
+template <>
+struct std::hash<BINAPI_NAMESPACE::FixedDecimal>
+{
+    /// Values equal with different decimals (1.5 and 1.50) hash the same: the trailing zeros are dropped first
+    auto operator()(const BINAPI_NAMESPACE::FixedDecimal &value) const noexcept -> std::size_t
+    {
+        int64_t raw      = value.raw();
+        int32_t decimals = value.decimals();
+        while (decimals > 0 && raw % 10 == 0)
+        {
+            raw /= 10;
+            --decimals;
+        }
+        return std::hash<int64_t> {}(raw) ^ (static_cast<std::size_t>(decimals) << 1);
+    }
+};
+
+#endif /*BINANCEAPIFIXEDPOINT_HPP_*/
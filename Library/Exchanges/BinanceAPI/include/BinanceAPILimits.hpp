@@ -14,16 +14,143 @@
 #define LIMITS_HPP_
 
 #include "BinanceAPIGlobal.hpp"
+#include "BinanceAPIScheduler.hpp"
+#include <array>
+#include <atomic>
 #include <chrono>
-#include <mutex>
+#include <cstdint>
 
 namespace BINAPI_NAMESPACE
 {
     /**
-     * BinanceLimits is thread safe
+     * Sliding window limit of weight per interval.
+     * The window is split in slots aligned to the epoch, as the Binance windows are, so the weight counted at any time
+     * includes everything the server counts in its current fixed window: staying under the limit here never breaks the
+     * server one. A token bucket would not do, since refilling while the server window is still open lets up to
+     * 2 x limit through.
+     * Taking weight is a fetch-and-add on the current slot and a scan of the slots; when the sum goes over the limit the
+     * weight is given back.
+     * SlidingWindowLimit is thread safe and lock-free
+     */
+    class BINAPI_EXPORT SlidingWindowLimit final
+    {
+    public:
+        using clock = std::chrono::system_clock;
+
+        static constexpr int64_t slots = 20;
+
+    public:
+        SlidingWindowLimit(long long limit, std::chrono::nanoseconds interval) noexcept;
+
+    public:
+        /**
+         * Change the limit. The weight counted so far is discarded
+         */
+        void setLimit(long long limit, std::chrono::nanoseconds interval) noexcept;
+
+        /**
+         * Take weight
+         * @param reserved Weight at the top of the limit that this call may not use
+         * @return zero if taken, otherwise the time until it may fit. std::chrono::nanoseconds::max() if it never will
+         */
+        std::chrono::nanoseconds tryAcquire(long long weight, clock::time_point now = clock::now(), long long reserved = 0) noexcept;
+
+        /**
+         * The time tryAcquire would return, without taking the weight
+         * @return zero if the weight fits now
+         */
+        T_NODISCARD std::chrono::nanoseconds waitFor(long long weight, clock::time_point now = clock::now()) const noexcept;
+
+        /**
+         * Give back weight taken with tryAcquire that was not used
+         */
+        void release(long long weight, clock::time_point now = clock::now()) noexcept;
+
+        /**
+         * Set the weight the server reports as used in its current fixed window
+         * @param authoritative When false the count is only allowed to grow; used to ignore stale reports.
+         * When true the weight of the previous windows, which the server no longer counts, is also discarded
+         */
+        void synchronize(long long used, bool authoritative, clock::time_point now = clock::now()) noexcept;
+
+        /**
+         * No weight is available until the time point
+         */
+        void block(clock::time_point until) noexcept;
+
+        /**
+         * Weight counted in the window
+         */
+        T_NODISCARD long long used(clock::time_point now = clock::now()) const noexcept;
+
+        /**
+         * Time until all the weight counted leaves the window
+         */
+        T_NODISCARD std::chrono::nanoseconds untilClear(clock::time_point now = clock::now()) const noexcept;
+
+        /**
+         * Time left until the block ends. Zero if the limit is not blocked
+         */
+        T_NODISCARD std::chrono::nanoseconds blockedFor(clock::time_point now = clock::now()) const noexcept;
+
+        T_NODISCARD inline long long getLimit() const noexcept
+        {
+            return m_limit.load(std::memory_order_relaxed);
+        }
+
+        T_NODISCARD inline std::chrono::nanoseconds getInterval() const noexcept
+        {
+            return std::chrono::nanoseconds { m_slotLength.load(std::memory_order_relaxed) * slots };
+        }
+
+    private:
+        void add(int64_t slot, long long weight) noexcept;
+        T_NODISCARD long long sum(int64_t current, int64_t first) const noexcept;
+        /// Time until the oldest slots holding excess leave the window
+        T_NODISCARD std::chrono::nanoseconds untilFree(long long excess, int64_t current, int64_t nowNs) const noexcept;
+
+    private:
+        // Slot number (low 32 bits) and weight (high 32 bits) of every slot. A slot is reused once it leaves the window
+        std::array<std::atomic<uint64_t>, slots> m_slots {};
+        std::atomic<int64_t> m_slotLength { 0 };
+        std::atomic<long long> m_limit { 0 };
+        std::atomic<int64_t> m_blockedUntil { 0 };
+    };
+
+    /**
+     * BinanceLimits is thread safe and lock-free, except for acquire which may sleep
      */
     struct BINAPI_EXPORT BinanceLimits
     {
+    public:
+        /**
+         * Marks a call that has taken its weight as in flight until it completes.
+         * The server counts of a response are only allowed to lower the local ones when no other call is in flight.
+         * Destroying the object without calling completed, as when an exception is thrown during the call, just ends the call
+         */
+        class BINAPI_EXPORT Admission final
+        {
+        public:
+            Admission(BinanceLimits &limits, long long callWeight, bool isOrderCall) noexcept;
+            ~Admission();
+
+            Admission(const Admission &)                     = delete;
+            auto operator=(const Admission &) -> Admission & = delete;
+
+        public:
+            /**
+             * Report the end of the call. The limits are re-synchronized from the X-MBX-USED-WEIGHT-*, X-MBX-ORDER-COUNT-*
+             * and, on 418 and 429 responses, Retry-After headers. Only the first call has any effect
+             */
+            void completed(const cpr::Header &headers, long statusCode) noexcept;
+
+        private:
+            BinanceLimits *m_limits;
+            long long m_callWeight;
+            bool m_isOrderCall;
+            bool m_inFlight { true };
+        };
+
     public:
         /**
          * Called to secure an API call
@@ -37,117 +164,161 @@ namespace BINAPI_NAMESPACE
          */
         bool secureOrderCall(const long long &callWeight);
 
+        /**
+         * Take the weight of a call and, for orders, the order count. Nothing is taken if any of the limits is reached
+         * Meant for asynchronous callers that schedule a retry. The call is not in flight until an Admission is made for it
+         * @param reserved Request weight at the top of the limit kept for calls of a higher RequestPriority
+         * @return zero if taken, otherwise the time until it may be. std::chrono::nanoseconds::max() if it never will
+         */
+        std::chrono::nanoseconds tryAcquire(const long long &callWeight, bool isOrderCall, long long reserved = 0) noexcept;
+
+        /**
+         * Time until the order count lets an order call of callWeight through. Nothing is taken
+         * @return zero if the order count is not what holds the call
+         */
+        T_NODISCARD std::chrono::nanoseconds getOrdersWait(const long long &callWeight) const noexcept;
+
+        /**
+         * Like tryAcquire but waits for the capacity until deadline
+         * @return false if the capacity will not be available before deadline
+         */
+        bool acquire(const long long &callWeight, bool isOrderCall, std::chrono::steady_clock::time_point deadline);
+
     public:
+        /**
+         * How long BinanceAPI waits for capacity before throwing APIException(limits). Zero, the default, fails at once
+         */
+        void setWaitForCapacity(std::chrono::milliseconds maxWait) noexcept;
+
+        T_NODISCARD inline std::chrono::milliseconds getWaitForCapacity() const noexcept
+        {
+            return std::chrono::milliseconds { m_waitForCapacity.load(std::memory_order_relaxed) };
+        }
+
+        /**
+         * Orders the calls waiting for these limits by RequestPriority and client
+         */
+        T_NODISCARD inline RequestScheduler &getScheduler() noexcept
+        {
+            return m_scheduler;
+        }
+
         T_NODISCARD inline long long getMaxAPIRequestWeight() const noexcept
         {
-            return m_maxApiRequestsWeight;
+            return m_requests.getLimit();
         }
 
         T_NODISCARD inline long long getMaxAPIRequestInterval() const noexcept
         {
-            return m_maxApiRequestsTsInterval;
+            return std::chrono::duration_cast<std::chrono::seconds>(m_requests.getInterval()).count();
         }
 
         void setAPIRequestsLimits(const long long &max, const long long &interval) noexcept;
 
         T_NODISCARD inline long long getMaxAPIOrdersLow() const noexcept
         {
-            return m_maxApiOrdersLow;
+            return m_ordersLow.getLimit();
         }
 
         T_NODISCARD inline long long getMaxAPIOrdersLowInterval() const noexcept
         {
-            return m_maxApiOrdersTsIntervalLow;
+            return std::chrono::duration_cast<std::chrono::seconds>(m_ordersLow.getInterval()).count();
         }
 
         void setAPIOrderLimitLow(const long long &max, const long long &interval) noexcept;
 
         T_NODISCARD inline long long getMaxAPIOrdersHigh() const noexcept
         {
-            return m_maxApiOrdersHigh;
+            return m_ordersHigh.getLimit();
         }
 
         T_NODISCARD inline long long getMaxAPIOrdersHighInterval() const noexcept
         {
-            return m_maxApiOrdersTsIntervalHigh;
+            return std::chrono::duration_cast<std::chrono::seconds>(m_ordersHigh.getInterval()).count();
         }
 
         void setAPIOrderLimitHigh(const long long &max, const long long &interval) noexcept;
 
+        /**
+         * Weight in use in the window
+         */
         T_NODISCARD inline long long getAPIRequests() const noexcept
         {
-            return m_apiRequests;
+            return m_requests.used();
         }
 
         T_NODISCARD inline long long getTotalAPIRequests() const noexcept
         {
-            return m_totalRequests;
+            return m_totalRequests.load(std::memory_order_relaxed);
         }
 
+        /**
+         * Seconds until all the weight counted leaves the window
+         */
         T_NODISCARD inline long long getAPIRequestSeconds() const noexcept
         {
-            return m_requestsSeconds;
+            return std::chrono::duration_cast<std::chrono::seconds>(m_requests.untilClear()).count();
+        }
+
+        /**
+         * Time until the API requests may be made again after a 429 or 418 response, taken from its Retry-After.
+         * Zero if they may be made now
+         */
+        T_NODISCARD inline std::chrono::nanoseconds getRetryAfter() const noexcept
+        {
+            return m_requests.blockedFor();
         }
 
         T_NODISCARD inline long long getAPIOrdersLow() const noexcept
         {
-            return m_apiOrdersLow;
+            return m_ordersLow.used();
         }
 
         T_NODISCARD inline long long getTotalAPIOrdersLow() const noexcept
         {
-            return m_totalOrdersLow;
+            return m_totalOrders.load(std::memory_order_relaxed);
         }
 
         T_NODISCARD inline long long getAPIOrdersLowSeconds() const noexcept
         {
-            return m_lowRequestsSeconds;
+            return std::chrono::duration_cast<std::chrono::seconds>(m_ordersLow.untilClear()).count();
         }
 
         T_NODISCARD inline long long getAPIOrdersHigh() const noexcept
         {
-            return m_apiOrdersHigh;
+            return m_ordersHigh.used();
         }
 
         T_NODISCARD inline long long getTotalAPIOrdersHigh() const noexcept
         {
-            return m_totalOrdersHigh;
+            return m_totalOrders.load(std::memory_order_relaxed);
         }
 
         T_NODISCARD inline long long getAPIOrdersHighSeconds() const noexcept
         {
-            return m_highRequestsSeconds;
+            return std::chrono::duration_cast<std::chrono::seconds>(m_ordersHigh.untilClear()).count();
         }
 
     private:
-        std::mutex m_secureRequest;
-        std::mutex m_orderRequest;
+        void synchronize(bool weightAuthoritative, bool ordersAuthoritative, const cpr::Header &headers, long statusCode) noexcept;
 
-        std::chrono::seconds m_secondsNow { 0 };
-
-        long long m_apiRequests { 0 };
-        long long m_totalRequests { 0 };
-        long long m_requestsSeconds { 0 };
+    private:
+        // INITIAL VALUES ARE TEMPORARY. They are replaced with the exchange information
+        SlidingWindowLimit m_requests { 1000, std::chrono::seconds { 60 } };
+        SlidingWindowLimit m_ordersHigh { 20, std::chrono::seconds { 20 } };
+        SlidingWindowLimit m_ordersLow { 20, std::chrono::seconds { 20 } };
 
-        std::chrono::seconds m_secondsNowOrderLow { 0 };
-        long long m_apiOrdersLow { 0 };
-        long long m_totalOrdersLow { 0 };
-        long long m_lowRequestsSeconds { 0 };
-        std::chrono::seconds m_secondsNowOrderHigh { 0 };
-        long long m_apiOrdersHigh { 0 };
-        long long m_totalOrdersHigh { 0 };
-        long long m_highRequestsSeconds { 0 };
+        std::atomic<long long> m_totalRequests { 0 };
+        std::atomic<long long> m_totalOrders { 0 };
 
-        // INITIAL 20 VALUE IS TEMPORARY
-        long long m_maxApiRequestsWeight { 1000 };
-        long long m_maxApiRequestsTsInterval { 60 };
+        // Weight and orders of the Admission objects alive
+        std::atomic<long long> m_inFlightWeight { 0 };
+        std::atomic<long long> m_inFlightOrders { 0 };
 
-        long long m_maxApiOrdersHigh { 20 };
-        long long m_maxApiOrdersTsIntervalHigh { 20 };
+        std::atomic<int64_t> m_waitForCapacity { 0 };
 
-        long long m_maxApiOrdersLow { 20 };
-        long long m_maxApiOrdersTsIntervalLow { 20 };
+        RequestScheduler m_scheduler { this };
     };
-} // namespace trader::api
+} // namespace BINAPI_NAMESPACE
 
 #endif /*LIMITS_HPP_*/
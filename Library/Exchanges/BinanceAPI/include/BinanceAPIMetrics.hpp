@@ -0,0 +1,326 @@
+////////////////////////////////////////////////////////////////////////////////
+// Created by Ricardo Romero on 17/10/2026 for BinanceAPI.
+// Copyright (c) 2026. Ricardo Romero
+// All rights reserved.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __cplusplus
+#error "C++ compiler needed"
+#endif /*__cplusplus*/
+
+#pragma once
+
+#ifndef BINANCEAPIMETRICS_HPP_
+#define BINANCEAPIMETRICS_HPP_
+
+#include "BinanceAPIGlobal.hpp"
+#include "APIException.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace BINAPI_NAMESPACE
+{
+    /// \brief Histogram of durations in microseconds with a bounded relative error, as HdrHistogram does.
+    /// Each power of two is split in 16 buckets, so a value is off by 6.25% at most. Values of more than 134 seconds are
+    /// counted as 134 seconds.
+    /// Recording and reading are lock-free. A snapshot taken while values are recorded may miss some of them
+    class BINAPI_EXPORT LatencyHistogram final
+    {
+    public:
+        static constexpr uint32_t subBucketBits = 4;
+        static constexpr uint32_t subBuckets    = 1u << subBucketBits;
+        /// Values up to 2^27 - 1 microseconds
+        static constexpr uint32_t maxBits        = 27;
+        static constexpr std::size_t bucketCount = (maxBits - subBucketBits + 1) * subBuckets;
+
+        /// \brief Copy of the counters
+        struct BINAPI_EXPORT Snapshot
+        {
+            std::array<uint64_t, bucketCount> counts {};
+            /// Values recorded
+            uint64_t count { 0 };
+            /// Sum of the values in microseconds
+            uint64_t total { 0 };
+            /// Largest value in microseconds
+            uint64_t max { 0 };
+
+            /// \brief Upper bound of the bucket that holds the value at the quantile
+            /// \param quantile From 0 to 1, e.g. 0.99
+            T_NODISCARD auto percentile(double quantile) const noexcept -> std::chrono::microseconds;
+            T_NODISCARD auto mean() const noexcept -> std::chrono::microseconds;
+        };
+
+    public:
+        auto record(std::chrono::microseconds value) noexcept -> void;
+        T_NODISCARD auto snapshot() const noexcept -> Snapshot;
+
+    public:
+        T_NODISCARD static auto bucketOf(uint64_t value) noexcept -> std::size_t;
+        /// \brief Smallest value of a bucket
+        T_NODISCARD static auto lowerBound(std::size_t bucket) noexcept -> uint64_t;
+        /// \brief Largest value of a bucket
+        T_NODISCARD static auto upperBound(std::size_t bucket) noexcept -> uint64_t;
+
+    private:
+        std::array<std::atomic<uint64_t>, bucketCount> m_counts {};
+        std::atomic<uint64_t> m_total { 0 };
+        std::atomic<uint64_t> m_max { 0 };
+    };
+
+    /// \brief Parts of the time of a REST call
+    enum class RequestPhase : uint32_t
+    {
+        /// Name resolution. Zero when the connection is reused
+        dns = 0,
+        /// TCP handshake. Zero when the connection is reused
+        connect,
+        /// TLS handshake. Zero when the connection is reused
+        tls,
+        /// From sending the request to the first byte of the response: the exchange and the round trip
+        wait,
+        /// Download of the response
+        transfer,
+        /// JSON parsing and validation
+        parse,
+        /// The whole call as seen by the caller: waiting for the limits, the transfer and the parsing.
+        /// Calls answered by the ResponseCache or by an identical call in flight are counted too
+        total
+    };
+
+    constexpr std::size_t requestPhases  = static_cast<std::size_t>(RequestPhase::total) + 1;
+    constexpr std::size_t exceptionTypes = static_cast<std::size_t>(APIException::Type::schema) + 1;
+
+    /// \brief Times of a transfer, taken from CURL
+    struct TransferTimings
+    {
+        std::chrono::microseconds dns { 0 };
+        std::chrono::microseconds connect { 0 };
+        std::chrono::microseconds tls { 0 };
+        std::chrono::microseconds wait { 0 };
+        std::chrono::microseconds transfer { 0 };
+    };
+
+    /// \brief Copy of the metrics of an endpoint
+    struct BINAPI_EXPORT EndpointMetricsSnapshot
+    {
+        std::string endPoint;
+        std::array<LatencyHistogram::Snapshot, requestPhases> latency;
+        /// Calls that reached the server
+        uint64_t transfers { 0 };
+        /// Request weight of those calls
+        uint64_t weight { 0 };
+        /// Errors by APIException::Type
+        std::array<uint64_t, exceptionTypes> errors {};
+
+        T_NODISCARD inline auto phase(RequestPhase phase) const noexcept -> const LatencyHistogram::Snapshot &
+        {
+            return latency[static_cast<std::size_t>(phase)];
+        }
+
+        T_NODISCARD inline auto errorCount(APIException::Type type) const noexcept -> uint64_t
+        {
+            return errors[static_cast<std::size_t>(type)];
+        }
+    };
+
+    /// \brief Latency, weight and errors of the REST calls, by endpoint.
+    /// Endpoints are added the first time they are used and are never removed. Everything is lock-free: calls record
+    /// with relaxed atomic increments and snapshots read the same counters while the calls go on
+    class BINAPI_EXPORT RequestMetrics final
+    {
+    public:
+        /// Endpoints that can be tracked. The calls of any other endpoint are not recorded
+        static constexpr std::size_t maxEndPoints = 256;
+
+    public:
+        RequestMetrics() noexcept;
+        ~RequestMetrics();
+
+        RequestMetrics(const RequestMetrics &)                     = delete;
+        auto operator=(const RequestMetrics &) -> RequestMetrics & = delete;
+
+    public:
+        /// \brief A call reached the server
+        auto recordTransfer(std::string_view endPoint, const TransferTimings &timings, long long callWeight) noexcept -> void;
+        auto recordPhase(std::string_view endPoint, RequestPhase phase, std::chrono::microseconds value) noexcept -> void;
+        auto recordError(std::string_view endPoint, APIException::Type type) noexcept -> void;
+
+        /// \brief Metrics of all the endpoints used so far
+        T_NODISCARD auto snapshot() const -> std::vector<EndpointMetricsSnapshot>;
+        /// \brief Metrics of an endpoint. Nothing if it was not used
+        T_NODISCARD auto snapshot(std::string_view endPoint) const -> std::optional<EndpointMetricsSnapshot>;
+
+    private:
+        struct Endpoint
+        {
+            explicit Endpoint(std::string_view name) :
+                name { name } { }
+
+            const std::string name;
+            std::array<LatencyHistogram, requestPhases> latency;
+            std::atomic<uint64_t> transfers { 0 };
+            std::atomic<uint64_t> weight { 0 };
+            std::array<std::atomic<uint64_t>, exceptionTypes> errors {};
+        };
+
+        /// \brief Find the endpoint, adding it if needed
+        /// \return nullptr if there is no room for it
+        auto endPoint(std::string_view name) noexcept -> Endpoint *;
+        T_NODISCARD auto find(std::string_view name) const noexcept -> const Endpoint *;
+
+        static auto copy(const Endpoint &endPoint) -> EndpointMetricsSnapshot;
+
+    private:
+        // Open addressing. A slot is written once, from null to its endpoint
+        std::array<std::atomic<Endpoint *>, maxEndPoints> m_endPoints {};
+    };
+
+    /// \brief Offset between the clock of the exchange and the local wall clock, estimated from the server time calls.
+    /// A call answered at server time S, sent at t0 and received at t1, gives S - (t0 + t1) / 2, wrong by half the round
+    /// trip at most. Of the last samplesKept calls, the one with the shortest round trip is used, as NTP does.
+    /// Thread-safe
+    class BINAPI_EXPORT ClockOffset final
+    {
+    public:
+        static constexpr std::size_t samplesKept = 8;
+
+    public:
+        /// \param serverTime Server time in milliseconds
+        /// \param sent Local time the call was sent
+        /// \param received Local time the answer was received
+        auto sample(uint64_t serverTime, std::chrono::system_clock::time_point sent, std::chrono::system_clock::time_point received) noexcept -> void;
+
+        /// \brief Server time minus local time. Nothing until a call was sampled
+        T_NODISCARD auto offset() const noexcept -> std::optional<std::chrono::microseconds>;
+        /// \brief Round trip of the sample used. Half of it bounds the error of the offset
+        T_NODISCARD auto roundTrip() const noexcept -> std::optional<std::chrono::microseconds>;
+        /// \brief Local wall clock time of an exchange time
+        /// \param exchangeTime Time of the exchange in milliseconds, e.g. the event time of a stream
+        T_NODISCARD auto toLocal(uint64_t exchangeTime) const noexcept -> std::chrono::system_clock::time_point;
+
+    private:
+        struct Sample
+        {
+            std::chrono::microseconds offset { 0 };
+            std::chrono::microseconds roundTrip { 0 };
+        };
+
+        std::mutex m_mutex;
+        std::array<Sample, samplesKept> m_samples {};
+        std::size_t m_samplesTaken { 0 };
+
+        // Published for the readers. A negative round trip is no sample yet
+        std::atomic<int64_t> m_offset { 0 };
+        std::atomic<int64_t> m_roundTrip { -1 };
+    };
+
+    /// \brief Stages of an event of a stream, from the exchange to the screen
+    enum class StreamStage : uint32_t
+    {
+        /// From the event time to the first fragment received, corrected with the ClockOffset: the exchange and the network
+        network = 0,
+        /// From the reception to the event parsed: reassembly and JSON parsing
+        parse,
+        /// From parsed to taken by the consumer: queueing between threads
+        dispatch,
+        /// Drawing the event
+        render,
+        /// From the event time to rendered, corrected with the ClockOffset
+        total
+    };
+
+    constexpr std::size_t streamStages = static_cast<std::size_t>(StreamStage::total) + 1;
+
+    /// \brief Timestamps of an event of a stream. Travels with the event to its consumer
+    struct StreamTimings
+    {
+        /// Event time of the exchange in milliseconds
+        uint64_t eventTime { 0 };
+        /// Local wall clock when the first fragment was received. Compared with the event time
+        std::chrono::system_clock::time_point received;
+        /// The same instant in the steady clock. The stages are measured in it
+        std::chrono::steady_clock::time_point receivedSteady;
+        std::chrono::steady_clock::time_point parsed;
+        /// Zero until the consumer takes the event
+        std::chrono::steady_clock::time_point dispatched;
+    };
+
+    /// \brief Copy of the metrics of a stream
+    struct BINAPI_EXPORT StreamMetricsSnapshot
+    {
+        std::string stream;
+        std::array<LatencyHistogram::Snapshot, streamStages> latency;
+        /// Events parsed
+        uint64_t events { 0 };
+
+        T_NODISCARD inline auto stage(StreamStage stage) const noexcept -> const LatencyHistogram::Snapshot &
+        {
+            return latency[static_cast<std::size_t>(stage)];
+        }
+    };
+
+    /// \brief Latency of the events of the streams by stage and stream, e.g. BTCUSDT@depthUpdate.
+    /// Lock-free as RequestMetrics. The network and total stages are recorded only when a ClockOffset with a sample is set,
+    /// so the skew of the local clock is not counted as latency
+    class BINAPI_EXPORT StreamMetrics final
+    {
+    public:
+        /// Streams that can be tracked. The events of any other stream are not recorded
+        static constexpr std::size_t maxStreams = 1024;
+
+    public:
+        StreamMetrics() noexcept;
+        ~StreamMetrics();
+
+        StreamMetrics(const StreamMetrics &)                     = delete;
+        auto operator=(const StreamMetrics &) -> StreamMetrics & = delete;
+
+    public:
+        /// \brief Clock used for the network and total stages. Must outlive this object
+        auto setClockOffset(const ClockOffset *clock) noexcept -> void;
+
+        /// \brief The event was parsed: records the network and parse stages
+        auto recordParsed(std::string_view stream, const StreamTimings &timings) noexcept -> void;
+        /// \brief The consumer took the event: records the dispatch stage
+        auto recordDispatched(std::string_view stream, const StreamTimings &timings) noexcept -> void;
+        /// \brief The event was drawn: records the render and total stages
+        /// \param rendered End of the drawing
+        auto recordRendered(std::string_view stream, const StreamTimings &timings, std::chrono::steady_clock::time_point rendered) noexcept -> void;
+        auto record(std::string_view stream, StreamStage stage, std::chrono::microseconds value) noexcept -> void;
+
+        /// \brief Metrics of all the streams received so far
+        T_NODISCARD auto snapshot() const -> std::vector<StreamMetricsSnapshot>;
+        /// \brief Metrics of a stream. Nothing if it was not received
+        T_NODISCARD auto snapshot(std::string_view stream) const -> std::optional<StreamMetricsSnapshot>;
+
+    private:
+        struct Stream
+        {
+            explicit Stream(std::string_view name) :
+                name { name } { }
+
+            const std::string name;
+            std::array<LatencyHistogram, streamStages> latency;
+            std::atomic<uint64_t> events { 0 };
+        };
+
+        /// \brief Exchange time to reception, if the clock offset is known
+        auto network(const StreamTimings &timings) const noexcept -> std::optional<std::chrono::microseconds>;
+
+        static auto copy(const Stream &stream) -> StreamMetricsSnapshot;
+
+    private:
+        std::atomic<const ClockOffset *> m_clock { nullptr };
+        std::array<std::atomic<Stream *>, maxStreams> m_streams {};
+    };
+} // namespace BINAPI_NAMESPACE
+
+#endif /*BINANCEAPIMETRICS_HPP_*/
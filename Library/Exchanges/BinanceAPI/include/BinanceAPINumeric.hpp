@@ -0,0 +1,164 @@
+////////////////////////////////////////////////////////////////////////////////
+// Created by Ricardo Romero on 17/10/2026 for BinanceAPI.
+// Copyright (c) 2026. Ricardo Romero
+// All rights reserved.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __cplusplus
+#error "C++ compiler needed"
+#endif /*__cplusplus*/
+
+#pragma once
+
+#ifndef BINANCEAPINUMERIC_HPP_
+#define BINANCEAPINUMERIC_HPP_
+
+#include "BinanceAPIDefs.hpp"
+#include "BinanceAPIFixedPoint.hpp"
+#include "BinanceAPIGlobal.hpp"
+
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace BINAPI_NAMESPACE
+{
+    namespace local
+    {
+        // clang-format off
+        inline constexpr std::array<double, 23> g_exactPowersOf10 = {
+            1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+        // clang-format on
+
+        /// \brief Slow path. Only reached by exponents, very long mantissas, leading spaces or invalid data
+        inline auto parseDecimalFallback(std::string_view str) -> double
+        {
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+            // std::stod skipped leading whitespace and took a '+' sign. std::from_chars takes neither
+            const auto first = str.find_first_not_of(" \t\n\v\f\r");
+            auto number      = first == std::string_view::npos ? std::string_view {} : str.substr(first);
+            if (number.size() > 1 && number[0] == '+' && number[1] != '-' && number[1] != '+')
+                number.remove_prefix(1);
+
+            double value {};
+            const auto [ptr, ec] = std::from_chars(number.data(), number.data() + number.size(), value);
+            if (ec != std::errc {} || ptr != number.data() + number.size())
+                throw std::invalid_argument(std::string { "invalid decimal: " }.append(str));
+            return value;
+#else
+            const std::string copy { str };
+            char *end          = nullptr;
+            const double value = std::strtod(copy.c_str(), &end);
+            if (end != copy.c_str() + copy.size())
+                throw std::invalid_argument(std::string { "invalid decimal: " }.append(str));
+            return value;
+#endif
+        }
+    } // namespace local
+
+    /// \brief Parse a plain decimal string as sent by Binance ("-123.45600000") with no allocation and no locale.
+    /// The fast path computes mantissa / 10^decimals which is correctly rounded because both values are exact doubles
+    /// (mantissa <= 2^53 and decimals <= 22). Anything else goes through std::from_chars
+    ///
+    /// \param str The number
+    /// \return The value
+    /// \remarks Throws std::invalid_argument on malformed data, just like std::stod. Leading whitespace and a '+' sign are
+    ///          accepted as std::stod does, but unlike it any trailing character, whitespace included, is rejected
+    T_NODISCARD inline auto parseDecimal(std::string_view str) -> double
+    {
+        const char *it  = str.data();
+        const char *end = it + str.size();
+
+        bool negative = false;
+        if (it != end && (*it == '-' || *it == '+'))
+        {
+            negative = *it == '-';
+            ++it;
+        }
+
+        uint64_t mantissa         = 0;
+        std::size_t digits        = 0;
+        std::size_t decimalDigits = 0;
+        bool decimalPoint         = false;
+        bool anyDigit             = false;
+
+        for (; it != end; ++it)
+        {
+            const auto c = static_cast<unsigned char>(*it);
+            if (c >= '0' && c <= '9')
+            {
+                anyDigit = true;
+                // Leading zeros do not count toward the significant digits
+                if (mantissa != 0 || c != '0')
+                    ++digits;
+                if (digits > 19)
+                    return local::parseDecimalFallback(str);
+                mantissa = mantissa * 10 + (c - '0');
+                if (decimalPoint)
+                    ++decimalDigits;
+            }
+            else if (c == '.' && !decimalPoint)
+                decimalPoint = true;
+            else
+                return local::parseDecimalFallback(str); // Exponents, spaces, garbage
+        }
+
+        if (!anyDigit)
+            throw std::invalid_argument(std::string { "invalid decimal: " }.append(str));
+
+        constexpr uint64_t maxExactMantissa = 1ull << 53;
+        if (mantissa > maxExactMantissa || decimalDigits >= local::g_exactPowersOf10.size())
+            return local::parseDecimalFallback(str);
+
+        const double value = static_cast<double>(mantissa) / local::g_exactPowersOf10[decimalDigits];
+        return negative ? -value : value;
+    }
+
+    /// \brief Parse a JSON string value holding a decimal
+    T_NODISCARD inline auto jsonToDouble(const rapidjson::Value &value) -> double
+    {
+        return parseDecimal({ value.GetString(), value.GetStringLength() });
+    }
+
+    /// \brief Parse the member of a JSON object holding a decimal
+    T_NODISCARD inline auto jsonToDouble(const rapidjson::Value &object, const char *member) -> double
+    {
+        return jsonToDouble(object[member]);
+    }
+
+    /// \brief Parse the levels of a depth message, an array of [price, quantity] string pairs, in the order received.
+    /// The levels are stored contiguously with a single allocation
+    T_NODISCARD inline auto jsonToPriceLevels(const rapidjson::Value &levels) -> std::vector<PriceLevel>
+    {
+        std::vector<PriceLevel> result;
+        result.reserve(levels.Size());
+        for (const auto &level : levels.GetArray())
+            result.push_back({ .price = jsonToDouble(level[0]), .quantity = jsonToDouble(level[1]) });
+        return result;
+    }
+
+    /// \brief Parse a JSON string value holding a decimal as an exact fixed point number
+    ///
+    /// \param value The JSON string
+    /// \param scale Scale of the symbol; usually ExchangeInformationSymbol::eifPrice.tickScale for prices and
+    ///              ExchangeInformationSymbol::eifLotSize.stepScale for quantities
+    T_NODISCARD inline auto jsonToFixed(const rapidjson::Value &value, const DecimalScale &scale) -> FixedDecimal
+    {
+        return FixedDecimal::parse({ value.GetString(), value.GetStringLength() }, scale);
+    }
+
+    /// \brief Parse a JSON string value holding a tickSize or stepSize
+    T_NODISCARD inline auto jsonToDecimalScale(const rapidjson::Value &value) -> DecimalScale
+    {
+        return DecimalScale::fromString({ value.GetString(), value.GetStringLength() });
+    }
+} // namespace BINAPI_NAMESPACE
+
+#endif /*BINANCEAPINUMERIC_HPP_*/
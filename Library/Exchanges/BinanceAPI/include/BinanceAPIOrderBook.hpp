@@ -0,0 +1,292 @@
+////////////////////////////////////////////////////////////////////////////////
+// Created by Ricardo Romero on 17/10/2026 for BinanceAPI.
+// Copyright (c) 2026. Ricardo Romero
+// All rights reserved.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __cplusplus
+#error "C++ compiler needed"
+#endif /*__cplusplus*/
+
+#pragma once
+
+#ifndef BINANCEAPIORDERBOOK_HPP_
+#define BINANCEAPIORDERBOOK_HPP_
+
+#include "BinanceAPIChannel.hpp"
+#include "BinanceAPIDefs.hpp"
+#include "BinanceAPIGlobal.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace BINAPI_NAMESPACE
+{
+    enum class BookSide : uint32_t
+    {
+        bids = 0,
+        asks
+    };
+
+    /// \brief Price levels of one side of a book, in a sorted array with the best price at the end.
+    /// Most changes happen near the best price, so they move few levels, and no level is allocated on its own.
+    /// The best level is read in O(1) and the best k levels in O(k)
+    class BINAPI_EXPORT OrderBookSide final
+    {
+    public:
+        /// Iterates from the best price to the worst
+        using const_iterator = std::vector<PriceLevel>::const_reverse_iterator;
+
+    public:
+        explicit OrderBookSide(BookSide side) noexcept;
+
+    public:
+        /// \brief Set the quantity of a price level. A quantity of zero removes the level
+        auto set(currency_t price, quantity_t quantity) -> void;
+        auto clear() noexcept -> void;
+        auto reserve(std::size_t levels) -> void;
+
+    public:
+        /// \brief Best level. Nothing if the side is empty
+        T_NODISCARD auto best() const noexcept -> std::optional<PriceLevel>;
+        /// \brief The best levels, best first. Fewer if the side has fewer. Valid until the side changes
+        T_NODISCARD auto top(std::size_t levels) const noexcept -> std::ranges::subrange<const_iterator>;
+        /// \brief Quantity of a price level. Zero if there is no such level
+        T_NODISCARD auto quantity(currency_t price) const noexcept -> quantity_t;
+
+        T_NODISCARD auto side() const noexcept -> BookSide;
+        T_NODISCARD auto size() const noexcept -> std::size_t;
+        T_NODISCARD auto empty() const noexcept -> bool;
+        T_NODISCARD auto begin() const noexcept -> const_iterator;
+        T_NODISCARD auto end() const noexcept -> const_iterator;
+
+    private:
+        /// \brief Position of the level of the price, or where it goes
+        T_NODISCARD auto position(currency_t price) const noexcept -> std::size_t;
+
+    private:
+        BookSide m_side;
+        // Worst price first
+        std::vector<PriceLevel> m_levels;
+    };
+
+    /// \brief How the diffs of a depth stream are chained
+    enum class OrderBookSequencing : uint32_t
+    {
+        /// Spot: U of a diff is u of the previous one plus one
+        spot = 0,
+        /// USD-M and COIN-M futures: pu of a diff is u of the previous one
+        futures
+    };
+
+    /// \brief Result of OrderBook::update
+    enum class OrderBookStatus : uint32_t
+    {
+        /// The diff was applied to the book
+        applied = 0,
+        /// There is no snapshot yet. The diff is kept until there is one
+        buffered,
+        /// The book is newer than the diff. It was dropped
+        stale,
+        /// The diff does not follow the last one: updates were lost. The book was cleared and needs a new snapshot,
+        /// the diff is kept for it
+        outOfSync
+    };
+
+    /// \brief Local copy of the book of a symbol, kept with a REST snapshot and the diffs of the depth stream.
+    ///
+    /// Follows the procedure of Binance: the diffs are buffered until the snapshot is loaded; then the diffs older than
+    /// the snapshot are dropped, the first one applied must contain the snapshot update id, and every diff after it must
+    /// follow the previous one. When a diff does not, the book is cleared and a new snapshot is needed.
+    /// \remarks Not thread-safe
+    class BINAPI_EXPORT OrderBook final
+    {
+    public:
+        /// \param sequencing How the diffs are chained
+        /// \param maxBuffered Diffs kept while there is no snapshot. The oldest are dropped
+        explicit OrderBook(OrderBookSequencing sequencing = OrderBookSequencing::spot, std::size_t maxBuffered = 1000);
+
+    public:
+        /// \brief Apply or buffer a diff of the depth stream
+        auto update(Snapshot<StreamDepthUpdate> diff) -> OrderBookStatus;
+
+        /// \brief Load a snapshot of the book and apply the buffered diffs that follow it
+        /// \param book Snapshot, e.g. BinanceAPISpot::getOrderBook
+        /// \return true if the book is synchronized. False if the buffered diffs do not reach the snapshot, so updates
+        ///         between them were lost: the book needs a newer snapshot
+        auto snapshot(const SPOT::OrderBook &book) -> bool;
+
+        /// \brief Clear the book and the buffered diffs
+        auto reset() -> void;
+
+    public:
+        /// \brief The book has a snapshot and every diff since then
+        T_NODISCARD auto synchronized() const noexcept -> bool;
+        /// \brief Update id of the last diff applied, or of the snapshot
+        T_NODISCARD auto lastUpdateId() const noexcept -> uint64_t;
+        /// \brief Diffs waiting for a snapshot
+        T_NODISCARD auto buffered() const noexcept -> std::size_t;
+
+        T_NODISCARD auto bids() const noexcept -> const OrderBookSide &;
+        T_NODISCARD auto asks() const noexcept -> const OrderBookSide &;
+        T_NODISCARD auto bestBid() const noexcept -> std::optional<PriceLevel>;
+        T_NODISCARD auto bestAsk() const noexcept -> std::optional<PriceLevel>;
+
+    private:
+        /// \brief The diff is older than the book
+        T_NODISCARD auto isStale(const StreamDepthUpdate &diff) const noexcept -> bool;
+        /// \brief The diff is the next one of the book
+        T_NODISCARD auto follows(const StreamDepthUpdate &diff) const noexcept -> bool;
+        auto apply(const StreamDepthUpdate &diff) -> void;
+        auto clearLevels() noexcept -> void;
+
+    private:
+        const OrderBookSequencing m_sequencing;
+        const std::size_t m_maxBuffered;
+
+        OrderBookSide m_bids { BookSide::bids };
+        OrderBookSide m_asks { BookSide::asks };
+        std::deque<Snapshot<StreamDepthUpdate>> m_buffer;
+
+        bool m_synchronized { false };
+        // No diff was applied since the snapshot: the next one must contain its update id
+        bool m_first { true };
+        uint64_t m_lastUpdateId { 0 };
+    };
+
+    /// \brief Bookkeeping of the REST snapshots requested for the books of several symbols.
+    ///
+    /// At most one request per symbol is in flight, and each one has a number, so the result of a request made before the
+    /// symbol was erased, e.g. when its book is stopped or reopened, is told apart and discarded. After a failed request
+    /// the next one waits, doubling the delay with every failure in a row, or longer if the server asked for it with a
+    /// Retry-After header.
+    /// \remarks Not thread-safe: use it in the thread of the books
+    class BINAPI_EXPORT OrderBookSnapshots final
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+    public:
+        /// \param initialDelay Wait after the first failure of a symbol
+        /// \param maxDelay Longest wait after a failure, when no Retry-After is longer
+        explicit OrderBookSnapshots(std::chrono::milliseconds initialDelay = std::chrono::milliseconds { 500 },
+            std::chrono::milliseconds maxDelay                             = std::chrono::seconds { 30 }) noexcept;
+
+    public:
+        /// \brief Start a request for the snapshot of symbol
+        /// \return The number of the request. Nothing if one is in flight or the delay after the last failure did not elapse
+        auto request(const std::string &symbol, clock::time_point now = clock::now()) -> std::optional<uint64_t>;
+
+        /// \brief The request returned the snapshot. The failures of the symbol are forgotten
+        /// \return false if the request is not the one in flight for symbol: its result must be discarded
+        auto completed(const std::string &symbol, uint64_t request) -> bool;
+
+        /// \brief The request failed. The next one waits the backoff delay or retryAfter, whichever is longer
+        /// \param retryAfter Time the server asked to wait, e.g. BinanceLimits::getRetryAfter
+        /// \return false if the request is not the one in flight for symbol: the failure must be ignored
+        auto failed(const std::string &symbol, uint64_t request, clock::time_point now = clock::now(), std::chrono::nanoseconds retryAfter = {}) -> bool;
+
+        /// \brief Forget symbol. The results of its request in flight will be discarded
+        auto erase(const std::string &symbol) -> void;
+
+    public:
+        /// \brief Number of the request in flight for symbol. Nothing if there is none
+        T_NODISCARD auto pending(const std::string &symbol) const -> std::optional<uint64_t>;
+        /// \brief When a new request for symbol may be made after its last failure. Nothing if its last request did not fail
+        T_NODISCARD auto retryAt(const std::string &symbol) const -> std::optional<clock::time_point>;
+
+    private:
+        struct Symbol
+        {
+            // Zero when no request is in flight
+            uint64_t request { 0 };
+            uint32_t failures { 0 };
+            clock::time_point retryAt {};
+        };
+
+        const std::chrono::milliseconds m_initialDelay;
+        const std::chrono::milliseconds m_maxDelay;
+        std::unordered_map<std::string, Symbol> m_symbols;
+        uint64_t m_lastRequest { 0 };
+    };
+
+    /// \brief The best levels of a book at one moment. Immutable once published: it is shared by every subscriber
+    struct BookTop
+    {
+        uint64_t lastUpdateId { 0 };
+        /// Event time of the last diff applied
+        uint64_t eventTime { 0 };
+        /// Best price first
+        std::vector<PriceLevel> bids;
+        /// Best price first
+        std::vector<PriceLevel> asks;
+    };
+
+    /// \brief Publishes the top levels of a book to its subscribers, each one at its own rate.
+    ///
+    /// The book is not copied on every change: a change only marks the subscribers, and a BookTop is built when one is
+    /// due. The latest state wins, so the work is bound by the rates of the subscribers and not by the rate of the
+    /// stream, and a slow subscriber never gets a backlog.
+    /// \remarks Not thread-safe: use it in the thread of the book. The subscribers are called in that thread and must not
+    ///          subscribe or unsubscribe from the call. A BookTop may be passed to other threads
+    class BINAPI_EXPORT BookConflator final
+    {
+    public:
+        using Subscriber = std::function<void(const Snapshot<BookTop> &)>;
+        using clock      = std::chrono::steady_clock;
+
+    public:
+        /// \param book The book published. Must outlive the conflator
+        explicit BookConflator(const OrderBook &book) noexcept;
+
+    public:
+        /// \param levels Levels of each side
+        /// \param interval Minimum time between two updates. Zero publishes every change
+        /// \return Id for unsubscribe
+        auto subscribe(std::size_t levels, std::chrono::milliseconds interval, Subscriber subscriber) -> uint32_t;
+        auto unsubscribe(uint32_t id) -> void;
+
+        /// \brief The book changed. The subscribers with no interval are updated now; the others when poll finds them due
+        /// \param eventTime Event time of the diff applied
+        auto changed(uint64_t eventTime, clock::time_point now = clock::now()) -> void;
+
+        /// \brief Update the subscribers whose interval elapsed since their last update
+        /// \return When the next subscriber waiting for a change will be due. Nothing if none is waiting
+        auto poll(clock::time_point now = clock::now()) -> std::optional<clock::time_point>;
+
+    public:
+        T_NODISCARD auto subscribers() const noexcept -> std::size_t;
+
+    private:
+        /// \brief The top of the book with these levels; subscribers updated together with the same levels share it
+        auto top(std::size_t levels) -> Snapshot<BookTop>;
+
+    private:
+        struct Subscription
+        {
+            uint32_t id;
+            std::size_t levels;
+            std::chrono::milliseconds interval;
+            Subscriber subscriber;
+            clock::time_point published {};
+            bool pending { false };
+        };
+
+        const OrderBook &m_book;
+        std::vector<Subscription> m_subscriptions;
+        uint32_t m_lastId { 0 };
+        uint64_t m_eventTime { 0 };
+        // Last BookTop built, reused until the book changes
+        Snapshot<BookTop> m_top;
+        std::size_t m_topLevels { 0 };
+    };
+} // namespace BINAPI_NAMESPACE
+
+#endif /*BINANCEAPIORDERBOOK_HPP_*/
@@ -0,0 +1,228 @@
+////////////////////////////////////////////////////////////////////////////////
+// Created by Ricardo Romero on 17/10/2026 for BinanceAPI.
+// Copyright (c) 2026. Ricardo Romero
+// All rights reserved.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __cplusplus
+#error "C++ compiler needed"
+#endif /*__cplusplus*/
+
+#pragma once
+
+#ifndef BINANCEAPIPARSERS_HPP_
+#define BINANCEAPIPARSERS_HPP_
+
+#include "BinanceAPIGlobal.hpp"
+//////
+#include "BinanceAPIDefs.hpp"
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace BINAPI_NAMESPACE
+{
+    /// \brief How much of the REST responses are checked against the endpoint JSON schema
+    enum class SchemaValidation
+    {
+        /// Every response is validated
+        full,
+        /// One of every N responses is validated. See BinanceAPI::setSchemaValidation
+        sampled,
+        /// Only the structural checks of the typed parsers
+        off
+    };
+
+    namespace local
+    {
+        /// \brief Base of the typed SAX handlers.
+        /// The handlers fill the API structures while the response is being read, so no rapidjson::Document is built.
+        /// A handler may be chained behind a rapidjson::GenericSchemaValidator, which validates in the same pass.
+        /// Handlers check the structure they rely on (types and required members) even with no schema
+        class BINAPI_EXPORT TypedHandler
+        {
+        public:
+            virtual ~TypedHandler();
+
+        public:
+            // rapidjson Handler concept
+            auto Null() -> bool;
+            auto Bool(bool b) -> bool;
+            auto Int(int i) -> bool;
+            auto Uint(unsigned u) -> bool;
+            auto Int64(int64_t i) -> bool;
+            auto Uint64(uint64_t u) -> bool;
+            auto Double(double d) -> bool;
+            auto RawNumber(const char *str, rapidjson::SizeType length, bool copy) -> bool;
+            auto String(const char *str, rapidjson::SizeType length, bool copy) -> bool;
+            auto StartObject() -> bool;
+            auto Key(const char *str, rapidjson::SizeType length, bool copy) -> bool;
+            auto EndObject(rapidjson::SizeType memberCount) -> bool;
+            auto StartArray() -> bool;
+            auto EndArray(rapidjson::SizeType elementCount) -> bool;
+
+        public:
+            /// \brief Why the handler stopped the parsing. Empty if it did not
+            T_NODISCARD auto getError() const noexcept -> const std::string &;
+
+        protected:
+            struct Scalar
+            {
+                enum class Type
+                {
+                    null,
+                    boolean,
+                    integer,
+                    real,
+                    string
+                };
+
+                Type type { Type::null };
+                bool boolean { false };
+                int64_t integer { 0 };
+                double real { 0 };
+                std::string_view string {};
+            };
+
+            /// \brief A scalar value was read. Use depth(), key() and index() to know where
+            virtual auto onValue(const Scalar &value) -> bool = 0;
+            /// \brief An object or array starts. The path still points to the slot holding it
+            virtual auto onStart(bool isArray) -> bool = 0;
+            /// \brief An object or array ended. The path points again to the slot holding it
+            virtual auto onEnd(bool isArray, rapidjson::SizeType count) -> bool = 0;
+
+        protected:
+            /// \brief Number of containers currently open. A value read at depth() == 0 is the root
+            T_NODISCARD auto depth() const noexcept -> std::size_t;
+            /// \brief Last key read in the object at level
+            T_NODISCARD auto key(std::size_t level) const noexcept -> std::string_view;
+            /// \brief Index of the current element in the array at level
+            T_NODISCARD auto index(std::size_t level) const noexcept -> uint32_t;
+            /// \brief Slot of the current value in the innermost object
+            T_NODISCARD auto currentKey() const noexcept -> std::string_view;
+
+            /// \brief Stop the parsing
+            auto fail(std::string_view reason) -> bool;
+
+            // Conversions that fail on a type mismatch
+            auto get(const Scalar &value, std::string &out) -> bool;
+            auto get(const Scalar &value, double &out) -> bool;
+            auto get(const Scalar &value, bool &out) -> bool;
+            template <typename Integer>
+            auto get(const Scalar &value, Integer &out) -> bool
+            {
+                if (value.type != Scalar::Type::integer)
+                    return fail("integer expected");
+                out = static_cast<Integer>(value.integer);
+                return true;
+            }
+
+        private:
+            auto scalar(const Scalar &value) -> bool;
+
+        private:
+            struct Frame
+            {
+                std::string key;
+                uint32_t index { 0 };
+                bool isArray { false };
+            };
+
+            std::vector<Frame> m_frames;
+            std::size_t m_depth { 0 };
+            std::string m_error;
+        };
+
+        /// \brief Parse json with handler in a single pass
+        ///
+        /// \param json The response
+        /// \param handler The typed handler
+        /// \param schema When not null the document is also validated against the schema
+        /// \param error On failure the reason
+        /// \return true on success
+        BINAPI_EXPORT auto parseTyped(std::string_view json, TypedHandler &handler, const rapidjson::SchemaDocument *schema, std::string &error) -> bool;
+
+        /// \brief /api/v3/klines
+        class BINAPI_EXPORT CandlestickHandler final : public TypedHandler
+        {
+        public:
+            explicit CandlestickHandler(std::size_t expected = 0);
+
+            T_NODISCARD auto take() noexcept -> std::vector<Candlestick>;
+
+        protected:
+            auto onValue(const Scalar &value) -> bool override;
+            auto onStart(bool isArray) -> bool override;
+            auto onEnd(bool isArray, rapidjson::SizeType count) -> bool override;
+
+        private:
+            std::vector<Candlestick> m_candles;
+            Candlestick m_current {};
+        };
+
+        /// \brief /api/v3/exchangeInfo
+        class BINAPI_EXPORT ExchangeInformationHandler final : public TypedHandler
+        {
+        public:
+            T_NODISCARD auto take() noexcept -> SPOT::ExchangeInformation;
+
+        protected:
+            auto onValue(const Scalar &value) -> bool override;
+            auto onStart(bool isArray) -> bool override;
+            auto onEnd(bool isArray, rapidjson::SizeType count) -> bool override;
+
+        private:
+            auto rateLimitValue(const Scalar &value) -> bool;
+            auto symbolValue(const Scalar &value) -> bool;
+            auto applyRateLimit() -> void;
+            auto applyFilter() -> bool;
+
+        private:
+            /// Members of a filter are kept until the object ends, since filterType is not guaranteed to come first
+            struct FilterMember
+            {
+                std::string key;
+                Scalar::Type type { Scalar::Type::null };
+                std::string text;
+                int64_t integer { 0 };
+                bool boolean { false };
+            };
+
+            SPOT::ExchangeInformation m_info;
+            SPOT::ExchangeInformationSymbol m_symbol;
+            std::string m_rateLimitType;
+            std::string m_rateLimitInterval;
+            uint32_t m_rateLimitNumber { 0 };
+            uint32_t m_rateLimit { 0 };
+            std::vector<FilterMember> m_filter;
+            std::size_t m_filterSize { 0 };
+            bool m_hasTimezone { false };
+            bool m_hasSymbols { false };
+        };
+
+        /// \brief /sapi/v1/capital/config/getall
+        class BINAPI_EXPORT AllCoinsInformationHandler final : public TypedHandler
+        {
+        public:
+            T_NODISCARD auto take() noexcept -> std::unordered_map<sym_t, SPOT::CoinInformation>;
+
+        protected:
+            auto onValue(const Scalar &value) -> bool override;
+            auto onStart(bool isArray) -> bool override;
+            auto onEnd(bool isArray, rapidjson::SizeType count) -> bool override;
+
+        private:
+            auto coinValue(const Scalar &value) -> bool;
+            auto networkValue(const Scalar &value) -> bool;
+
+        private:
+            std::unordered_map<sym_t, SPOT::CoinInformation> m_coins;
+            SPOT::CoinInformation m_coin {};
+            SPOT::CoinInformation::NetworkList m_network {};
+        };
+    } // namespace local
+} // namespace BINAPI_NAMESPACE
+
+#endif /*BINANCEAPIPARSERS_HPP_*/
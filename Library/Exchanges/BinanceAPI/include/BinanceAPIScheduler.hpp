@@ -0,0 +1,163 @@
+////////////////////////////////////////////////////////////////////////////////
+// Created by Ricardo Romero on 17/10/2026 for BinanceAPI.
+// Copyright (c) 2026. Ricardo Romero
+// All rights reserved.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __cplusplus
+#error "C++ compiler needed"
+#endif /*__cplusplus*/
+
+#pragma once
+
+#ifndef BINANCEAPISCHEDULER_HPP_
+#define BINANCEAPISCHEDULER_HPP_
+
+#include "BinanceAPIGlobal.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace BINAPI_NAMESPACE
+{
+    struct BinanceLimits;
+
+    /// \brief Class of a REST call. Lower values go first
+    enum class RequestPriority : uint32_t
+    {
+        /// Orders. The order endpoints always use this class
+        trading = 0,
+        /// Calls a user is waiting for. The default
+        interactive,
+        /// Synchronization, backfills and heavy snapshots
+        background
+    };
+
+    /// \brief Sets the RequestPriority of the REST calls made by the current thread while it is alive
+    class BINAPI_EXPORT RequestPriorityScope final
+    {
+    public:
+        explicit RequestPriorityScope(RequestPriority priority) noexcept;
+        ~RequestPriorityScope();
+
+        RequestPriorityScope(const RequestPriorityScope &)                     = delete;
+        auto operator=(const RequestPriorityScope &) -> RequestPriorityScope & = delete;
+
+    public:
+        /// \brief The priority of the innermost scope of the thread, if any
+        T_NODISCARD static auto current() noexcept -> std::optional<RequestPriority>;
+
+    private:
+        std::optional<RequestPriority> m_previous;
+    };
+
+    /// \brief Decides which REST call takes the weight of a BinanceLimits.
+    /// Every class may only use the weight the higher classes leave reserved, so a backfill can not starve orders or the UI.
+    /// While nobody waits a call is admitted with a single BinanceLimits::tryAcquire. When calls have to wait, the capacity goes
+    /// to the highest class first and, inside a class, to the client that has received the least weight while waiting,
+    /// so two plugins sharing the BinanceLimits get the same share. An order call held by the order count, not by the weight,
+    /// steps aside until the count lets it through, so the calls behind it that only need weight are not blocked. Thread-safe
+    class BINAPI_EXPORT RequestScheduler final
+    {
+    public:
+        static constexpr std::size_t classes = 3;
+
+        /// \brief Counters of a class
+        struct Metrics
+        {
+            /// Calls waiting right now
+            uint64_t depth { 0 };
+            /// Highest number of calls waiting at the same time
+            uint64_t maxDepth { 0 };
+            /// Calls admitted
+            uint64_t admitted { 0 };
+            /// Calls admitted after waiting
+            uint64_t delayed { 0 };
+            /// Calls that did not get the weight before their deadline
+            uint64_t rejected { 0 };
+            /// Total time waited by the admitted calls
+            std::chrono::nanoseconds waited { 0 };
+        };
+
+    public:
+        explicit RequestScheduler(BinanceLimits *limits) noexcept;
+        ~RequestScheduler();
+
+        RequestScheduler(const RequestScheduler &)                     = delete;
+        auto operator=(const RequestScheduler &) -> RequestScheduler & = delete;
+
+    public:
+        /// \brief Share of the request weight that the classes below priority can not use.
+        /// Defaults are 10% for trading and 10% for interactive: background calls use up to 80% of the weight and
+        /// interactive ones up to 90%
+        ///
+        /// \param priority trading or interactive. The share of background is ignored
+        /// \param share From 0 to 1
+        auto setReservedShare(RequestPriority priority, double share) noexcept -> void;
+        T_NODISCARD auto getReservedShare(RequestPriority priority) const noexcept -> double;
+
+        /// \brief Wait for the weight of a call
+        ///
+        /// \param callWeight Weight of the call
+        /// \param isOrderCall The call also counts as an order
+        /// \param priority Class of the call
+        /// \param client Identifies the caller for the fairness. Each BinanceAPI uses its own
+        /// \param deadline Do not wait beyond this time. A deadline already passed tries once and never queues
+        /// \return false if the weight was not available before the deadline
+        auto admit(long long callWeight, bool isOrderCall, RequestPriority priority, uint64_t client, std::chrono::steady_clock::time_point deadline) -> bool;
+
+        T_NODISCARD auto getMetrics(RequestPriority priority) const noexcept -> Metrics;
+
+        /// \brief Calls of the class waiting right now
+        T_NODISCARD auto getQueueDepth(RequestPriority priority) const noexcept -> std::size_t;
+
+    private:
+        struct Ticket
+        {
+            RequestPriority priority;
+            uint64_t client;
+            uint64_t sequence;
+            // Until then the order count holds the call and it can not be the head
+            std::chrono::steady_clock::time_point ordersFreeAt {};
+        };
+
+        struct ClassCounters
+        {
+            std::atomic<uint64_t> depth { 0 };
+            std::atomic<uint64_t> maxDepth { 0 };
+            std::atomic<uint64_t> admitted { 0 };
+            std::atomic<uint64_t> delayed { 0 };
+            std::atomic<uint64_t> rejected { 0 };
+            std::atomic<int64_t> waited { 0 };
+        };
+
+        /// \brief Request weight kept for the classes above priority
+        T_NODISCARD auto reservedWeight(RequestPriority priority) const noexcept -> long long;
+        /// \brief Whether a call of priority or above is waiting
+        T_NODISCARD auto waitingAtOrAbove(RequestPriority priority) const noexcept -> bool;
+        /// \brief The ticket that takes the next capacity. Call with m_mutex locked
+        T_NODISCARD auto head(std::chrono::steady_clock::time_point now) const noexcept -> const Ticket *;
+        auto dequeue(const Ticket *ticket) -> void;
+
+    private:
+        BinanceLimits *m_limits;
+        std::array<std::atomic<double>, classes> m_reservedShare {};
+        std::array<ClassCounters, classes> m_counters {};
+
+        std::mutex m_mutex;
+        std::condition_variable m_changed;
+        std::vector<const Ticket *> m_queue;
+        // Weight admitted per client since the queue was last empty
+        std::unordered_map<uint64_t, long long> m_served;
+        uint64_t m_sequence { 0 };
+    };
+} // namespace BINAPI_NAMESPACE
+
+#endif /*BINANCEAPISCHEDULER_HPP_*/
@@ -0,0 +1,68 @@
+////////////////////////////////////////////////////////////////////////////////
+// Created by Ricardo Romero on 17/10/2026 for BinanceAPI.
+// Copyright (c) 2026. Ricardo Romero
+// All rights reserved.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __cplusplus
+#error "C++ compiler needed"
+#endif /*__cplusplus*/
+
+#pragma once
+
+#ifndef BINANCEAPISIGNER_HPP_
+#define BINANCEAPISIGNER_HPP_
+
+#include "BinanceAPIGlobal.hpp"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// OpenSSL EVP_MD_CTX
+struct evp_md_ctx_st;
+
+namespace BINAPI_NAMESPACE
+{
+    namespace local
+    {
+        /// \brief HMAC-SHA256 of the signed requests with the key schedule done once.
+        /// The SHA-256 states after the inner and outer pads are computed when the signer is created and copied on every
+        /// signature, so signing costs the hashing of the message only.
+        /// A signer is not thread safe; use forThread to get the one of the calling thread
+        class BINAPI_EXPORT HMACSigner final
+        {
+        public:
+            /// Hexadecimal characters of a signature, without the null character
+            static constexpr std::size_t signatureSize = 64;
+
+        public:
+            explicit HMACSigner(std::string_view key);
+            ~HMACSigner();
+
+            HMACSigner(const HMACSigner &)                     = delete;
+            auto operator=(const HMACSigner &) -> HMACSigner & = delete;
+
+        public:
+            /// \brief The signer of the calling thread for key. Signers are kept for the last keys used by the thread,
+            /// so every BinanceKeys shares one per thread
+            T_NODISCARD static auto forThread(std::string_view key) -> HMACSigner &;
+
+            /// \brief Sign message
+            ///
+            /// \param message Text to sign
+            /// \param out At least signatureSize + 1 chars. Receives the lowercase hexadecimal signature, null-terminated
+            auto sign(std::string_view message, char *out) noexcept -> void;
+
+            T_NODISCARD auto isKey(std::string_view key) const noexcept -> bool;
+
+        private:
+            evp_md_ctx_st *m_inner { nullptr };
+            evp_md_ctx_st *m_outer { nullptr };
+            evp_md_ctx_st *m_work { nullptr };
+            std::string m_key;
+        };
+    } // namespace local
+} // namespace BINAPI_NAMESPACE
+
+#endif /*BINANCEAPISIGNER_HPP_*/
@@ -0,0 +1,193 @@
+////////////////////////////////////////////////////////////////////////////////
+// Created by Ricardo Romero on 17/10/2026 for BinanceAPI.
+// Copyright (c) 2026. Ricardo Romero
+// All rights reserved.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __cplusplus
+#error "C++ compiler needed"
+#endif /*__cplusplus*/
+
+#pragma once
+
+#ifndef BINANCEAPISTREAMEVENTS_HPP_
+#define BINANCEAPISTREAMEVENTS_HPP_
+
+#include "BinanceAPIDefs.hpp"
+#include "BinanceAPIGlobal.hpp"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+namespace BINAPI_NAMESPACE
+{
+    namespace local
+    {
+        /// \brief Map of a few names known at compile time, looked up with a perfect hash.
+        /// The hash is made of the length and the first, middle and last characters of the name, multiplied by a seed
+        /// searched at compile time so that no two names share a slot. A lookup is the hash, one load from a table
+        /// of 64 bytes and a single comparison, whatever the number of names
+        template <typename T, std::size_t N>
+        class StaticNameMap final
+        {
+        public:
+            using Entry = std::pair<std::string_view, T>;
+
+            static constexpr uint32_t slotBits = 6;
+            static constexpr std::size_t slots = std::size_t { 1 } << slotBits;
+
+            static_assert(N > 0 && N < slots / 2, "StaticNameMap: too many names for the table");
+
+        public:
+            /// \brief Fails to compile if two names have the same key or no seed is found
+            consteval explicit StaticNameMap(const std::array<Entry, N> &entries) :
+                m_entries { entries }
+            {
+                for (uint32_t seed = 0x9E37'79B1u, attempt = 0; attempt < 1u << 16; seed += 2, ++attempt)
+                {
+                    if (build(seed))
+                    {
+                        m_seed = seed;
+                        return;
+                    }
+                }
+                throw "StaticNameMap: no perfect hash was found for the names";
+            }
+
+        public:
+            /// \brief The value of name, or nothing if it is not in the map
+            T_NODISCARD constexpr auto find(std::string_view name) const noexcept -> std::optional<T>
+            {
+                const auto index = m_index[slotOf(name, m_seed)];
+                if (index == emptySlot || m_entries[index].first != name)
+                    return std::nullopt;
+                return m_entries[index].second;
+            }
+
+            T_NODISCARD constexpr auto entries() const noexcept -> const std::array<Entry, N> &
+            {
+                return m_entries;
+            }
+
+        private:
+            static constexpr uint8_t emptySlot = 0xFF;
+
+            T_NODISCARD static constexpr auto keyOf(std::string_view name) noexcept -> uint32_t
+            {
+                if (name.empty())
+                    return 0;
+
+                return static_cast<uint32_t>(name.size() & 0xFF)
+                     | static_cast<uint32_t>(static_cast<uint8_t>(name.front())) << 8
+                     | static_cast<uint32_t>(static_cast<uint8_t>(name[name.size() / 2])) << 16
+                     | static_cast<uint32_t>(static_cast<uint8_t>(name.back())) << 24;
+            }
+
+            T_NODISCARD static constexpr auto slotOf(std::string_view name, uint32_t seed) noexcept -> std::size_t
+            {
+                return static_cast<std::size_t>((keyOf(name) * seed) >> (32 - slotBits));
+            }
+
+            constexpr auto build(uint32_t seed) -> bool
+            {
+                m_index.fill(emptySlot);
+                for (std::size_t i = 0; i < N; ++i)
+                {
+                    auto &slot = m_index[slotOf(m_entries[i].first, seed)];
+                    if (slot != emptySlot)
+                        return false;
+                    slot = static_cast<uint8_t>(i);
+                }
+                return true;
+            }
+
+        private:
+            std::array<Entry, N> m_entries;
+            std::array<uint8_t, slots> m_index {};
+            uint32_t m_seed { 0 };
+        };
+    } // namespace local
+
+    namespace ws
+    {
+        /// \brief Value of the "e" member of the market stream messages, spot and futures
+        enum class StreamEvent : uint8_t
+        {
+            /// Not a known event, or a message without "e"
+            unknown = 0,
+            aggTrade,
+            trade,
+            kline,
+            continuousKline,
+            miniTicker,
+            ticker,
+            bookTicker,
+            depthUpdate,
+            markPriceUpdate,
+            forceOrder,
+            nav,
+            compositeIndex
+        };
+    } // namespace ws
+
+    namespace local
+    {
+        // clang-format off
+        inline constexpr StaticNameMap g_streamEvents { std::to_array<std::pair<std::string_view, ws::StreamEvent>>({
+            { "aggTrade",         ws::StreamEvent::aggTrade },
+            { "trade",            ws::StreamEvent::trade },
+            { "kline",            ws::StreamEvent::kline },
+            { "continuous_kline", ws::StreamEvent::continuousKline },
+            { "24hrMiniTicker",   ws::StreamEvent::miniTicker },
+            { "24hrTicker",       ws::StreamEvent::ticker },
+            { "bookTicker",       ws::StreamEvent::bookTicker },
+            { "depthUpdate",      ws::StreamEvent::depthUpdate },
+            { "markPriceUpdate",  ws::StreamEvent::markPriceUpdate },
+            { "forceOrder",       ws::StreamEvent::forceOrder },
+            { "nav",              ws::StreamEvent::nav },
+            { "compositeIndex",   ws::StreamEvent::compositeIndex }
+        }) };
+
+        inline constexpr StaticNameMap g_timeIntervals { std::to_array<std::pair<std::string_view, BinanceTimeIntervals>>({
+            { "1m",  BinanceTimeIntervals::i1m },
+            { "3m",  BinanceTimeIntervals::i3m },
+            { "5m",  BinanceTimeIntervals::i5m },
+            { "15m", BinanceTimeIntervals::i15m },
+            { "30m", BinanceTimeIntervals::i30m },
+            { "1h",  BinanceTimeIntervals::i1h },
+            { "2h",  BinanceTimeIntervals::i2h },
+            { "4h",  BinanceTimeIntervals::i4h },
+            { "6h",  BinanceTimeIntervals::i6h },
+            { "8h",  BinanceTimeIntervals::i8h },
+            { "12h", BinanceTimeIntervals::i12h },
+            { "1d",  BinanceTimeIntervals::i1d },
+            { "3d",  BinanceTimeIntervals::i3d },
+            { "1w",  BinanceTimeIntervals::i1w },
+            { "1M",  BinanceTimeIntervals::i1M }
+        }) };
+        // clang-format on
+    } // namespace local
+
+    namespace ws
+    {
+        /// \brief Event of a stream message
+        /// \param name The "e" member, e.g. depthUpdate
+        T_NODISCARD constexpr auto streamEventOf(std::string_view name) noexcept -> StreamEvent
+        {
+            return local::g_streamEvents.find(name).value_or(StreamEvent::unknown);
+        }
+
+        /// \brief Interval of a kline message
+        /// \param name The "i" member of the kline, e.g. 15m
+        /// \return Nothing if the interval is unknown
+        T_NODISCARD constexpr auto timeIntervalOf(std::string_view name) noexcept -> std::optional<BinanceTimeIntervals>
+        {
+            return local::g_timeIntervals.find(name);
+        }
+    } // namespace ws
+} // namespace BINAPI_NAMESPACE
+
+#endif /*BINANCEAPISTREAMEVENTS_HPP_*/
@@ -14,10 +14,18 @@
 #define BINAPI_HPP_
 
 #include "BinanceAPIGlobal.hpp"
+#include "BinanceAPIArena.hpp"
+#include "BinanceAPICache.hpp"
+#include "BinanceAPICoalescer.hpp"
+#include "BinanceAPIConnectionPool.hpp"
 #include "BinanceAPILimits.hpp"
+#include "BinanceAPIMetrics.hpp"
+#include "BinanceAPIParsers.hpp"
+#include "BinanceAPIScheduler.hpp"
 //////
 #include "BinanceAPIDefs.hpp"
 
+#include <atomic>
 #include <exception>
 #include <optional>
 #include <string>
@@ -170,7 +178,7 @@ namespace BINAPI_NAMESPACE
         ///
         /// \param key API Key
         /// \param plainText Plain text to cipher
-        /// \param out A char array of at least EVP_MAX_MD_SIZE size
+        /// \param out A char array of at least local::HMACSigner::signatureSize + 1 size
         static auto HMAC256(const std::string &key, const std::string &plainText, char *out) noexcept -> void;
 
         auto getKeys() const noexcept -> BinanceKeys *;
@@ -182,10 +190,64 @@ namespace BINAPI_NAMESPACE
         /// \param params Parameters of the call. There is no guarantee this remains intact
         /// \param secure Will call ExchangeAPI::secure to ensure a secure request
         /// \param timeLog On success a JSON Document otherwise will throw
-        /// \return rapidjson::Document ExchangeAPIError on error
-        auto request(const local::BinanceAPIRequest &request, const eparams &params, bool secure = false, double *const timeLog = nullptr) -> rapidjson::Document;
+        /// \return The document, parsed in situ over the arena of the calling thread. ExchangeAPIError on error
+        auto request(const local::BinanceAPIRequest &request, const eparams &params, bool secure = false, double *const timeLog = nullptr) -> local::ResponseDocument;
+
+        /// \brief Make an API rest request and read the response with a typed SAX handler. No rapidjson::Document is built.
+        /// The response is validated against request.docSchema in the same pass, as set by setSchemaValidation
+        ///
+        /// \param request Request parameters
+        /// \param params Parameters of the call
+        /// \param handler Receives the data
+        /// \param secure Will call ExchangeAPI::secure to ensure a secure request
+        /// \param timeLog Time of the transfer
+        /// \remarks Error bodies and malformed responses throw the same APIException as the DOM overload
+        auto request(const local::BinanceAPIRequest &request, const eparams &params, local::TypedHandler &handler, bool secure = false, double *const timeLog = nullptr) -> void;
 
     private:
+        /// \brief request without the metrics of the whole call
+        auto requestDocument(const local::BinanceAPIRequest &request, const eparams &params, bool secure, double *const timeLog) -> local::ResponseDocument;
+        auto requestTyped(const local::BinanceAPIRequest &request, const eparams &params, local::TypedHandler &handler, bool secure, double *const timeLog) -> void;
+
+        /// \brief Honor the limits, make the transfer and handle the transport and HTTP errors
+        ///
+        /// \param conditional Validators of a cached response. With them a 304 is not an error
+        auto performRequest(const local::BinanceAPIRequest &request, const eparams &params, bool secure, double *const timeLog, const cpr::Header &conditional = {}) -> cpr::Response;
+
+        /// \brief RequestPriority of a call made now by this thread
+        T_NODISCARD auto priorityOf(const local::BinanceAPIRequest &request) const noexcept -> RequestPriority;
+
+        /// \brief performRequest through the RequestCoalescer. Identical GET calls made at the same time share one transfer
+        ///
+        /// \param conditional Validators of a cached response. With them a 304 is not an error
+        auto transfer(const local::BinanceAPIRequest &request, const eparams &params, bool secure, double *const timeLog, const cpr::Header &conditional = {}) -> cpr::Response;
+
+        /// \brief transfer through the ResponseCache, for the GET endpoints with a time to live
+        ///
+        /// \param key Key of the call in the cache
+        /// \param cached Receives the cached body on a hit or on a 304. Nothing was transferred then
+        auto cachedRequest(const local::BinanceAPIRequest &request, const eparams &params, bool secure, double *const timeLog, const std::string &key, std::shared_ptr<const std::string> &cached) -> cpr::Response;
+
+        /// \brief Whether the responses of the request go through the ResponseCache
+        auto isCached(const local::BinanceAPIRequest &request) const -> bool;
+
+        /// \brief Key of the call in the ResponseCache
+        auto cacheKey(const local::BinanceAPIRequest &request, const eparams &params, bool secure) const -> std::string;
+
+        /// \brief Store a 200 response in the ResponseCache
+        auto storeResponse(const local::BinanceAPIRequest &request, const std::string &key, std::string body, const cpr::Header &headers) -> void;
+
+        /// \brief Parse a response into a document, reporting API errors and schema violations.
+        /// The callers record RequestPhase::parse, so a response is timed once whichever path parses it
+        ///
+        /// \param request Request parameters
+        /// \param response The response. The body is moved into the document
+        /// \param validate Validate against request.docSchema
+        auto parseResponse(const local::BinanceAPIRequest &request, cpr::Response &response, bool validate) -> local::ResponseDocument;
+
+        /// \brief Whether the next response must be validated against its schema
+        auto validateNextResponse() noexcept -> bool;
+
         auto secureRequest(cpr::Session &session, cpr::Parameters &parameters, const cpr::CurlHolder &cprCurlHolder, bool preventSignature) noexcept -> void;
 
         /// \brief Handle an API Error request
@@ -210,22 +272,32 @@ namespace BINAPI_NAMESPACE
         ///
         /// \param requests Request data
         /// \param secure Secure or not
-        /// \return rapidjson::Document The JSON Document
-        auto apiRequest(const local::BinanceAPIRequest &requests, bool secure = false) -> rapidjson::Document;
+        /// \return The JSON Document. Its strings may be borrowed with jsonToView while it is alive
+        auto apiRequest(const local::BinanceAPIRequest &requests, bool secure = false) -> local::ResponseDocument;
 
         /// \brief Wrapper for a request with parameters
         ///
         /// \param requests Request data
         /// \param parameters Parameters to pass
         /// \param secure Secure or not
-        /// \return rapidjson::Document The JSON Document
-        auto apiRequest(const local::BinanceAPIRequest &requests, const eparams &parameters, bool secure = false) -> rapidjson::Document;
+        /// \return The JSON Document. Its strings may be borrowed with jsonToView while it is alive
+        auto apiRequest(const local::BinanceAPIRequest &requests, const eparams &parameters, bool secure = false) -> local::ResponseDocument;
+
+        /// \brief Wrapper for a request read by a typed handler
+        ///
+        /// \param requests Request data
+        /// \param parameters Parameters to pass
+        /// \param handler Receives the data
+        /// \param secure Secure or not
+        auto apiRequest(const local::BinanceAPIRequest &requests, const eparams &parameters, local::TypedHandler &handler, bool secure = false) -> void;
 
     public:
         /// \brief Get the last api call the time to retrieve the data from the internet
         ///
         /// \return double A double with the seconds
         /// \remarks This time does not include the time taken to parse the actual JSON data
+        /// \remarks With concurrent calls this is the time of whichever call finished last
+        /// \remarks getRequestMetrics keeps the times of every call, by endpoint
         T_NODISCARD auto getLastCallTime() const noexcept -> double;
 
         /// \brief Retrieve UTC time
@@ -245,6 +317,39 @@ namespace BINAPI_NAMESPACE
         /// \return setted value
         T_NODISCARD auto getRecvWindow() const noexcept -> uint32_t;
 
+        /// \brief Access the keep-alive sessions used by the REST calls
+        /// \return The pool. Use it to change the number of sessions or read the reuse statistics
+        T_NODISCARD auto getConnectionPool() const noexcept -> BinanceAPIConnectionPool *;
+
+        /// \brief Access the cache of the GET responses
+        /// \return The cache. Use it to change the time to live of the endpoints, to save or load a snapshot or to read the hit rates
+        T_NODISCARD auto getResponseCache() const noexcept -> ResponseCache *;
+
+        /// \brief Access the single-flight of the GET calls
+        /// \return The coalescer. Use it to disable it or to read the weight saved
+        T_NODISCARD auto getRequestCoalescer() const noexcept -> RequestCoalescer *;
+
+        /// \brief Access the latency, weight and error counts of the REST calls by endpoint
+        /// \return The metrics. Snapshots can be taken from any thread while the calls are made
+        T_NODISCARD auto getRequestMetrics() const noexcept -> RequestMetrics *;
+
+        /// \brief Access the estimate of the offset between the clock of the exchange and the local clock
+        /// \return The estimate. Every checkServerTime call adds a sample. Pass it to StreamMetrics::setClockOffset
+        T_NODISCARD auto getClockOffset() const noexcept -> ClockOffset *;
+
+        /// \brief Choose how the responses are checked against the endpoint JSON schemas. Default is SchemaValidation::full
+        ///
+        /// \param validation The mode
+        /// \param sampling With SchemaValidation::sampled one of every sampling responses is validated
+        /// \remarks Responses that do not match what the parsers expect are always reported, whatever the mode
+        auto setSchemaValidation(SchemaValidation validation, uint32_t sampling = 100) noexcept -> void;
+        T_NODISCARD auto getSchemaValidation() const noexcept -> SchemaValidation;
+
+        /// \brief RequestPriority of the calls of this object made outside a RequestPriorityScope. Default is RequestPriority::interactive
+        /// \remarks Order calls always go as RequestPriority::trading
+        auto setDefaultPriority(RequestPriority priority) noexcept -> void;
+        T_NODISCARD auto getDefaultPriority() const noexcept -> RequestPriority;
+
     public:
         /// \brief Binance API for candlesticks support only a max of 1000 candles retrieve from the exchange per API call
         /// This function returns a vector with the list of times from
@@ -290,8 +395,19 @@ namespace BINAPI_NAMESPACE
         std::string_view m_userAgent;
         BinanceKeys *m_binanceKeys { nullptr };
         BinanceLimits *m_binanceLimits { nullptr };
-        double m_lastCallSeconds { 0.0 };
+        std::atomic<double> m_lastCallSeconds { 0.0 };
         uint32_t m_recvWindow { 5000 };
+        std::unique_ptr<BinanceAPIConnectionPool> m_connectionPool;
+        std::unique_ptr<ResponseCache> m_responseCache;
+        std::unique_ptr<RequestCoalescer> m_requestCoalescer;
+        std::unique_ptr<RequestMetrics> m_requestMetrics;
+        std::unique_ptr<ClockOffset> m_clockOffset;
+        std::atomic<SchemaValidation> m_schemaValidation { SchemaValidation::full };
+        std::atomic<uint32_t> m_validationSampling { 100 };
+        std::atomic<uint64_t> m_validationCounter { 0 };
+        std::atomic<RequestPriority> m_defaultPriority { RequestPriority::interactive };
+        // Identifies this object in the RequestScheduler of the limits, which may be shared with other objects
+        const uint64_t m_schedulerClient;
     };
 
     // Spot/Margin/Savings/Mining enp-oints wrapper
@@ -300,6 +416,9 @@ namespace BINAPI_NAMESPACE
     public:
         BinanceAPISpot(std::string_view userAgent, BinanceKeys *keys, BinanceLimits *exl);
         BinanceAPISpot(BinanceKeys *keys, BinanceLimits *exl);
+        /// \brief Use a different server. e.g. https://testnet.binance.vision
+        /// \remarks baseURL is not copied and must outlive the object
+        BinanceAPISpot(std::string_view baseURL, std::string_view userAgent, BinanceKeys *keys, BinanceLimits *exl);
         ~BinanceAPISpot() override;
 
         // WALLET ENDPOINTS
@@ -507,7 +626,7 @@ namespace BINAPI_NAMESPACE
         /// \brief Test for server ping. In case a ping failure happens. The function will throw an exception
         auto ping() -> void;
 
-        /// \brief Check for server time
+        /// \brief Check for server time. The call is a sample of getClockOffset
         /// \return Server time
         T_NODISCARD auto checkServerTime() -> uint64_t;
 
@@ -554,7 +673,7 @@ namespace BINAPI_NAMESPACE
         /// \param bti Time interval for the candle
         /// \param startTime Start time ignored if set to 0
         /// \param endTime  End time ignored if set to 0
-        /// \param limit default is 500; max is 1000
+        /// \param limit default is 500; clamped to [1, 1000]
         /// \return A candle list
         T_NODISCARD auto candlestickData(v_sym_t symbol, BinanceTimeIntervals bti, uint64_t startTime, uint64_t endTime, uint64_t limit = 500) -> std::vector<Candlestick>;
 
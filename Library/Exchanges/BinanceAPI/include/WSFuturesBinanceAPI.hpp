@@ -13,7 +13,10 @@
 
 #include "BinanceAPIGlobal.hpp"
 //
+#include "BinanceAPIChannel.hpp"
 #include "BinanceAPIDefs.hpp"
+#include "WSSequences.hpp"
+#include "WSSubscriptions.hpp"
 #include "WSThread.hpp"
 
 namespace BINAPI_NAMESPACE::ws
@@ -33,20 +36,12 @@ namespace BINAPI_NAMESPACE::ws
         WSFuturesBinanceAPI(std::string endPoint);
         ~WSFuturesBinanceAPI() override = default;
 
-    protected:
-        /// \brief Subscribe to a stream. thread-safe
-        ///
-        /// \param stream stream name
-        /// \param id stream id. This id will be passed to void subscribe(const bool &result, const int &id) function to confirmed success of failure of the subscription
-        /// \remark If you override subscribe, make sure to call the parent function in order to remove the id from the ids
-        void subscribe(const std::string &stream, int id);
+    public:
+        /// \brief (Un)subscriptions of the connection and the state of the streams. See WSSpotBinanceAPI::subscriptions
+        auto subscriptions() noexcept -> WSSubscriptions &;
 
-        /// \brief Unsubscribe to a streams. thread-safe
-        ///
-        /// \param stream stream name
-        /// \param id stream id. This id will be passed to void unsubscribe(const bool &result, const int &id) function to confirmed success of failure of the unsubscription
-        /// \remark If you override subscribe, make sure to call the parent function in order to remove the id from the ids
-        void unsubscribe(const std::string &stream, int id);
+        /// Incoming messages per second accepted by the server on a connection, pings included
+        static constexpr uint32_t messageRateLimit = 10;
 
     public:
         /// \brief Blocking function to start receiving the Exchange streams
@@ -137,8 +132,14 @@ namespace BINAPI_NAMESPACE::ws
         virtual void liquidationOrder(const std::string &symbol, uint64_t eventTime, const StreamLiquidationOrder &slo);
         /// depthUpdate handles 'Partial Book Depth Streams' and 'Diff. Book Depth Streams'
         virtual void depthUpdate(const std::string &symbol, uint64_t eventTime, const StreamDepthUpdate &sdp);
+        /// \brief The depth update as an immutable payload that can be handed to other threads without copying it.
+        /// The default calls depthUpdate
+        virtual void sharedDepthUpdate(const std::string &symbol, uint64_t eventTime, Snapshot<StreamDepthUpdate> sdp);
         virtual void blvtInfo(const std::string &blvtName, uint64_t eventTime, const StreamBLVTInfo &blvt);
         virtual void compositeIndex(const std::string &symbol, uint64_t eventTime, currency_t price, const std::vector<StreamCompositionIndex> &sci);
+        /// \brief Events of a sequenced stream were lost, e.g. while the connection was reconnecting: an order book built
+        /// from the depth updates must be synchronized again. Called before the first event after the gap is delivered
+        virtual void sequenceGap(const std::string &symbol, SequencedStream stream, const SequenceGap &gap);
 
         /// All subscription methods are thread-safe
     public:
@@ -286,8 +287,13 @@ namespace BINAPI_NAMESPACE::ws
         std::variant<std::string, int> subscribeCompositeIndexSymbolInformation(const std::string &symbol);
 
     private:
-        std::set<int> m_subscribeIds;
-        std::set<int> m_unsubscribeIds;
+        auto nextMessage() -> std::optional<std::string> override;
+        auto disconnected(bool reconnecting) noexcept -> void override;
+
+    private:
+        WSSubscriptions m_subscriptions;
+        // Only used by the thread receiving the events
+        WSSequences m_sequences;
     };
 } // namespace BINAPI_NAMESPACE::ws
 #endif // WSFUTURESBINANCEAPI_HPP
@@ -0,0 +1,163 @@
+////////////////////////////////////////////////////////////////////////////////
+// Created by Ricardo Romero on 17/10/2026 for BinanceAPI.
+// Copyright (c) 2026. Ricardo Romero
+// All rights reserved.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __cplusplus
+#error "C++ compiler needed"
+#endif /*__cplusplus*/
+
+#pragma once
+
+#ifndef WSREACTOR_HPP_
+#define WSREACTOR_HPP_
+
+#include "BinanceAPIGlobal.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace BINAPI_NAMESPACE::ws
+{
+    /// \brief Event loop shared by many WebSocket client connections: one lws_context serviced by a fixed number of threads.
+    /// Connections are kept in a registry and each one delivers its events to its own Handler.
+    /// The threads, the wakeups and the SSL initialization depend on the number of cores, not on the number of streams.
+    ///
+    /// libwebsockets is not thread-safe: connecting, writing and closing are queued by the calling thread and done
+    /// by the service thread that owns the connection, woken with lws_cancel_service.
+    ///
+    /// Handlers run on the service threads and must never block: a handler that waits holds back every connection of its thread.
+    /// In particular a handler must not wait for a connection of the reactor to finish (WSThread::wait, destroying a WSThread
+    /// that is not finished), since the service thread that would finish it is the one waiting; WSThread::wait throws
+    /// std::logic_error when called from a service thread. Closing, detaching another connection and sending do not block.
+    /// \remarks libwebsockets built with LWS_MAX_SMP=1, the default, services a context with one thread whatever the
+    /// number requested; threads() returns the number in use. Then all the connections share that thread
+    class BINAPI_EXPORT WSReactor final
+    {
+    public:
+        using ConnectionId = uint64_t;
+
+        /// \brief Where to connect
+        struct Endpoint
+        {
+            std::string address;
+            std::string path;
+            int32_t port { 443 };
+            bool ssl { true };
+            /// Messages written in any second, at most. Zero is no limit
+            uint32_t messagesPerSecond { 0 };
+        };
+
+        /// \brief Receives the events of a connection. The calls come from the service thread of the connection, one at a time
+        class BINAPI_EXPORT Handler
+        {
+        public:
+            virtual ~Handler();
+
+            /// \brief An event of the connection, as the libwebsockets protocol callback receives it
+            /// \return Non-zero to close the connection
+            virtual auto event(lws *wsi, lws_callback_reasons reason, void *in, std::size_t len) -> int = 0;
+
+            /// \brief The connection is gone: closed, failed to connect or closed before connecting. It is the last call
+            virtual auto finished() noexcept -> void = 0;
+
+            /// \brief The connection can write a message and has none queued by send.
+            /// The message is built when it is written, so the handler can merge what it was asked meanwhile
+            /// \return The message to write, or nothing
+            virtual auto pull() -> std::optional<std::string>;
+        };
+
+    public:
+        /// \param threads Service threads. Zero uses one per core
+        explicit WSReactor(std::size_t threads = 0);
+        ~WSReactor();
+
+        WSReactor(const WSReactor &)                     = delete;
+        auto operator=(const WSReactor &) -> WSReactor & = delete;
+
+        /// \brief The reactor of the streams of the library, created on first use with one thread per core
+        static auto shared() -> WSReactor &;
+
+    public:
+        /// \brief Open a connection. Thread-safe
+        ///
+        /// \param endpoint Where to connect
+        /// \param handler Receives the events. It must be alive until finished() is called or the connection is detached
+        /// \param delay Time to wait before connecting. The connection can be closed or detached meanwhile
+        /// \return Identifies the connection
+        auto connect(Endpoint endpoint, Handler *handler, std::chrono::milliseconds delay = std::chrono::milliseconds::zero()) -> ConnectionId;
+
+        /// \brief Queue a text message. Messages are written in order, when the connection is writable. Thread-safe
+        /// \return false if the connection does not exist
+        auto send(ConnectionId id, const std::string &message) -> bool;
+
+        /// \brief Ask the handler for messages (see Handler::pull) as soon as the rate limit of the connection allows it. Thread-safe
+        auto wake(ConnectionId id) -> void;
+
+        /// \brief Close a connection. The handler still receives the closing events and finished(). A connection still in the
+        /// handshake is dropped without waiting for it. Thread-safe
+        auto close(ConnectionId id) -> void;
+
+        /// \brief Close a connection without calling its handler again. If the handler is being called, waits for it to return.
+        /// Must not be called from the handler of the connection
+        auto detach(ConnectionId id) -> void;
+
+        /// \brief Connections in the registry, connecting or connected
+        T_NODISCARD auto connections() const -> std::size_t;
+
+        /// \brief Service threads in use
+        T_NODISCARD auto threads() const noexcept -> std::size_t;
+
+        /// \brief The calling thread is a service thread of a reactor, so it may be running a handler
+        T_NODISCARD static auto isServiceThread() noexcept -> bool;
+
+    private:
+        struct Connection;
+
+        static auto callback(lws *wsi, lws_callback_reasons reason, void *user, void *in, std::size_t len) -> int;
+
+        auto dispatch(Connection &connection, lws *wsi, lws_callback_reasons reason, void *in, std::size_t len) -> int;
+        /// \brief Connect, write and close what the other threads asked for
+        auto serviceRequests(int thread) -> void;
+        /// \brief Remove the connection and tell its handler
+        auto finish(ConnectionId id) noexcept -> void;
+        /// \brief Write the next message of the connection, if its rate limit allows it
+        auto write(Connection &connection, lws *wsi) -> int;
+        /// \brief Open the connections whose delay expired, and request the writable callback of connections whose rate
+        /// limit delayed a message
+        auto runTimers() -> void;
+        auto find(ConnectionId id) const -> std::shared_ptr<Connection>;
+
+    private:
+        lws_protocols m_protocols[2] {};
+        lws_context *m_context { nullptr };
+        std::vector<std::thread> m_threads;
+        std::atomic_bool m_stop { false };
+
+        // Connections to open when their delay expires, or to write when their rate limit allows it, by time. Guarded by m_mutex
+        std::multimap<std::chrono::steady_clock::time_point, std::shared_ptr<Connection>> m_timers;
+        std::condition_variable m_timersCondition;
+        std::thread m_timersThread;
+
+        mutable std::mutex m_mutex;
+        std::unordered_map<ConnectionId, std::shared_ptr<Connection>> m_connections;
+        // Connections to open, by any thread
+        std::vector<std::shared_ptr<Connection>> m_pending;
+        // Connections with messages to write or to be closed, by the thread that owns them
+        std::vector<std::shared_ptr<Connection>> m_requests;
+        ConnectionId m_nextId { 1 };
+    };
+} // namespace BINAPI_NAMESPACE::ws
+
+#endif /*WSREACTOR_HPP_*/
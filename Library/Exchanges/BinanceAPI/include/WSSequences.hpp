@@ -0,0 +1,75 @@
+////////////////////////////////////////////////////////////////////////////////
+// Created by Ricardo Romero on 17/10/2026 for BinanceAPI.
+// Copyright (c) 2026. Ricardo Romero
+// All rights reserved.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __cplusplus
+#error "C++ compiler needed"
+#endif /*__cplusplus*/
+
+#pragma once
+
+#ifndef WSSEQUENCES_HPP_
+#define WSSEQUENCES_HPP_
+
+#include "BinanceAPIGlobal.hpp"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace BINAPI_NAMESPACE::ws
+{
+    /// \brief Streams whose events are numbered, so a lost event can be detected
+    enum class SequencedStream
+    {
+        /// Diff. book depth: the update ids of an event follow the final update id of the previous one
+        depthUpdate,
+        /// Aggregate trades: the ids are consecutive
+        aggregateTrade
+    };
+
+    /// \brief Events of a stream were lost: the event received does not follow the last one
+    struct SequenceGap
+    {
+        /// Id of the last event received before the gap
+        uint64_t lastReceived;
+        /// Id of the event the one received follows
+        uint64_t follows;
+    };
+
+    /// \brief Last id received of the sequenced streams of each symbol.
+    /// The ids are kept when the connection is lost, so the first events of a new connection are checked against the
+    /// last ones of the old: a reconnection quick enough to miss nothing does not require the consumers to resynchronize.
+    /// \remarks Not thread-safe. It is used by the thread receiving the events of a connection.
+    /// A connection carries one diff. book depth stream per symbol: the events of @depth and @depth@100ms are not told apart
+    class BINAPI_EXPORT WSSequences final
+    {
+    public:
+        /// \brief Record an event
+        ///
+        /// \param stream Stream of the event
+        /// \param symbol Symbol of the event
+        /// \param follows Id of the event the new one follows: U - 1 of a spot depth update, pu of a futures one,
+        ///                the aggregate trade id - 1 of a trade
+        /// \param last Id of the event, the one the next event follows: u of a depth update, the aggregate trade id of a trade
+        /// \return The gap, if the last event received of the symbol is not the one followed. Nothing for the first event of a symbol
+        auto received(SequencedStream stream, const std::string &symbol, uint64_t follows, uint64_t last) -> std::optional<SequenceGap>;
+
+        /// \brief Forget the last event of a symbol. The next event is not checked
+        auto forget(SequencedStream stream, const std::string &symbol) -> void;
+        /// \brief Forget everything
+        auto clear() -> void;
+
+        /// \brief Last id received of a symbol
+        T_NODISCARD auto last(SequencedStream stream, const std::string &symbol) const -> std::optional<uint64_t>;
+
+    private:
+        std::array<std::unordered_map<std::string, uint64_t>, 2> m_last;
+    };
+} // namespace BINAPI_NAMESPACE::ws
+
+#endif /*WSSEQUENCES_HPP_*/
@@ -13,7 +13,10 @@
 
 #include "BinanceAPIGlobal.hpp"
 //
+#include "BinanceAPIChannel.hpp"
 #include "BinanceAPIDefs.hpp"
+#include "WSSequences.hpp"
+#include "WSSubscriptions.hpp"
 #include "WSThread.hpp"
 
 namespace BINAPI_NAMESPACE::ws
@@ -22,23 +25,19 @@ namespace BINAPI_NAMESPACE::ws
     class BINAPI_EXPORT WSSpotBinanceAPI : public WSThread
     {
     public:
-        WSSpotBinanceAPI(std::string endpoint);
+        /// \param endpoint Path of the streams, see constructEndPoint
+        /// \param reactor Services the connection
+        WSSpotBinanceAPI(std::string endpoint, WSReactor &reactor = WSReactor::shared());
         ~WSSpotBinanceAPI() override = default;
 
-    protected:
-        /// \brief Subscribe to a stream. thread-safe
-        ///
-        /// \param stream stream name
-        /// \param id stream id. This id will be passed to void subscribe(const bool &result, const int &id) function to confirmed success of failure of the subscription
-        /// \remark If you override subscribe, make sure to call the parent function in order to remove the id from the ids
-        void subscribe(const std::string &stream, int id);
+    public:
+        /// \brief (Un)subscriptions of the connection and the state of the streams.
+        /// Requests made while the connection waits for its message rate are sent together. The ids of the tickets are the ones
+        /// passed to subscribe(bool, int) and unsubscribe(bool, int), and returned by the subscribeXXX methods
+        auto subscriptions() noexcept -> WSSubscriptions &;
 
-        /// \brief Unsubscribe to a streams. thread-safe
-        ///
-        /// \param stream stream name
-        /// \param id stream id. This id will be passed to void unsubscribe(const bool &result, const int &id) function to confirmed success of failure of the unsubscription
-        /// \remark If you override subscribe, make sure to call the parent function in order to remove the id from the ids
-        void unsubscribe(const std::string &stream, int id);
+        /// Incoming messages per second accepted by the server on a connection, pings included
+        static constexpr uint32_t messageRateLimit = 5;
 
     public:
         /// \brief Blocking function to start receiving the Exchange streams
@@ -72,6 +71,13 @@ namespace BINAPI_NAMESPACE::ws
         virtual void bookTicker(const std::string &symbol, uint64_t eventTime, const StreamBookTicker &ticker);
         /// depthUpdate handles 'Partial Book Depth Streams' and 'Diff. Book Depth Streams'
         virtual void depthUpdate(const std::string &symbol, uint64_t eventTime, const StreamDepthUpdate &sdp);
+        /// \brief The depth update as an immutable payload that can be handed to other threads without copying it.
+        /// The default calls depthUpdate
+        virtual void sharedDepthUpdate(const std::string &symbol, uint64_t eventTime, Snapshot<StreamDepthUpdate> sdp);
+        virtual void aggregateTradeStream(const std::string &symbol, uint64_t eventTime, const StreamAggregateTrade &as);
+        /// \brief Events of a sequenced stream were lost, e.g. while the connection was reconnecting: an order book built
+        /// from the depth updates must be synchronized again. Called before the first event after the gap is delivered
+        virtual void sequenceGap(const std::string &symbol, SequencedStream stream, const SequenceGap &gap);
 
     public:
 #ifdef __clang__
@@ -151,6 +157,19 @@ namespace BINAPI_NAMESPACE::ws
                 /// \brief Called when the WebSocket failed to connect
                 virtual void connectionError() = 0;*/
 
+        /// Stream names. The symbol can be uppercase, however, the functions will convert it to lowercase
+    public:
+        static auto klineStreamName(const std::string &symbol, BinanceTimeIntervals interval) -> std::string;
+        static auto individualMiniTickerStreamName(const std::string &symbol) -> std::string;
+        static auto individualSymbolTickerStreamName(const std::string &symbol) -> std::string;
+        static auto individualSymbolBookTickerStreamName(const std::string &symbol) -> std::string;
+        /// \param levels Valid are 5, 10, or 20.
+        /// \param update Valid are 100ms or 1000ms
+        static auto partialBookDepthStreamName(const std::string &symbol, int levels, int update) -> std::string;
+        /// \param update Valid are 100ms or 1000ms
+        static auto diffBookDepthStreamName(const std::string &symbol, int update) -> std::string;
+        static auto aggregateTradeStreamName(const std::string &symbol) -> std::string;
+
         /// All subscription methods are thread-safe
     public:
         /// \brief The Kline/Candlestick Stream push updates to the current klines/candlestick every 250 milliseconds (if existing)
@@ -236,14 +255,28 @@ namespace BINAPI_NAMESPACE::ws
         ///
         int unsubscribeDiffBookDepth(const std::string &symbol, int update);
 
+        /// \brief Trades aggregated by price, taker side and order, pushed in real time
+        ///
+        /// \param symbol The symbol can be uppercase, however, the method will convert to lowercase
+        /// \return std::variant<std::string, int> see subscribeMarkPriceStream return and remarks documentation subsection
+        std::variant<std::string, int> subscribeAggregateTrade(const std::string &symbol);
+
+        /// \brief Stop receiving the aggregate trades of the symbol
+        /// \param symbol Symbol name
+        /// \return The unsubscription ID
+        int unsubscribeAggregateTrade(const std::string &symbol);
+
     private:
         std::atomic_bool m_combined { false };
-        std::set<int> m_subscribeIds;
-        std::set<int> m_unsubscribeIds;
+        WSSubscriptions m_subscriptions;
+        // Only used by the thread receiving the events
+        WSSequences m_sequences;
 
     private:
         //    void sendData(const std::string &msg);
         auto receivedData() -> void override;
+        auto nextMessage() -> std::optional<std::string> override;
+        auto disconnected(bool reconnecting) noexcept -> void override;
         //    int randNumber(const bool &subscribe = true);
         //    static int eventManager(struct lws *wsi, enum lws_callback_reasons reason, void *user, void *in, size_t len);
     };
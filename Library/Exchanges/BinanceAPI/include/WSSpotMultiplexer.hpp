@@ -0,0 +1,188 @@
+////////////////////////////////////////////////////////////////////////////////
+// Created by Ricardo Romero on 17/10/2026 for BinanceAPI.
+// Copyright (c) 2026. Ricardo Romero
+// All rights reserved.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __cplusplus
+#error "C++ compiler needed"
+#endif /*__cplusplus*/
+
+#pragma once
+
+#ifndef WSSPOTMULTIPLEXER_HPP_
+#define WSSPOTMULTIPLEXER_HPP_
+
+#include "BinanceAPIChannel.hpp"
+#include "BinanceAPIDefs.hpp"
+#include "BinanceAPIGlobal.hpp"
+#include "BinanceAPIMetrics.hpp"
+#include "WSReactor.hpp"
+#include "WSSequences.hpp"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace BINAPI_NAMESPACE::ws
+{
+    /// \brief Spot market streams spread over several connections.
+    /// Binance limits the streams and the messages per second of a connection, so a single WSSpotBinanceAPI cannot
+    /// carry every symbol. The streams are grouped by symbol and each symbol is assigned to a connection with
+    /// rendezvous hashing: all the streams of a symbol arrive in order on the same connection, and adding or removing
+    /// a connection only moves the symbols that go to, or were on, that connection.
+    /// Connections are opened and closed as the streams come and go. The symbols are packed in three quarters of
+    /// streamsPerConnection, so the new streams of a symbol fit in its connection; a connection only carries more when
+    /// no other has room for a symbol. A connection lost is opened again with its streams.
+    /// A stream moved to another connection is unsubscribed from the old one once the new one confirms it, and a
+    /// connection left over is closed once all its streams are confirmed elsewhere: for a moment the stream arrives twice
+    /// instead of not arriving. A subscription the server rejects is sent again; a stream rejected subscriptionAttempts
+    /// times in a row is forgotten and reported to subscriptionFailed().
+    ///
+    /// The data is delivered to the same callbacks as WSSpotBinanceAPI. They are called from the threads of the reactor,
+    /// concurrently for streams of different connections. The callbacks may subscribe and unsubscribe.
+    /// \remarks Derived classes call terminate() in their destructor, so no callback runs while they are destroyed
+    class BINAPI_EXPORT WSSpotMultiplexer
+    {
+    public:
+        /// Subscriptions sent for a stream the server keeps rejecting before it is forgotten
+        static constexpr std::size_t subscriptionAttempts = 3;
+
+    public:
+        /// \param connections Connections kept open while there are streams, at least
+        /// \param streamsPerConnection Streams a connection can carry. Binance accepts 1024
+        /// \param reactor Services the connections
+        explicit WSSpotMultiplexer(std::size_t connections = 1, std::size_t streamsPerConnection = 1024, WSReactor &reactor = WSReactor::shared());
+        virtual ~WSSpotMultiplexer();
+
+        WSSpotMultiplexer(const WSSpotMultiplexer &)                     = delete;
+        auto operator=(const WSSpotMultiplexer &) -> WSSpotMultiplexer & = delete;
+
+    public:
+        /// \brief Subscribe to streams. Use the stream names of WSSpotBinanceAPI, e.g. WSSpotBinanceAPI::diffBookDepthStreamName.
+        /// Streams already subscribed are ignored. Thread-safe
+        auto subscribe(const std::vector<std::string> &streams) -> void;
+        auto subscribe(const std::string &stream) -> void;
+
+        /// \brief Stop receiving streams. Thread-safe
+        auto unsubscribe(const std::vector<std::string> &streams) -> void;
+        auto unsubscribe(const std::string &stream) -> void;
+
+        /// \brief Close every connection and forget the streams. Blocks until the connections are closed, so it is
+        /// never called from a callback
+        auto terminate() -> void;
+
+        /// \brief Record the latency of the events. Applies to the connections opened from now on
+        /// \param metrics Must outlive the connections
+        auto setStreamMetrics(StreamMetrics *metrics) -> void;
+
+        /// \brief Connect to another server, such as the testnet. Applies to the connections opened from now on
+        auto setHost(const std::string &url, int32_t port) -> void;
+
+    public:
+        /// \brief Connections carrying streams. Connections left over may still be open until their streams are moved
+        T_NODISCARD auto connections() const -> std::size_t;
+        /// \brief Subscribed streams
+        T_NODISCARD auto streams() const -> std::size_t;
+        /// \brief Streams carried by a connection
+        T_NODISCARD auto streams(std::size_t connection) const -> std::size_t;
+        /// \brief Connection carrying a stream
+        T_NODISCARD auto connectionOf(const std::string &stream) const -> std::optional<std::size_t>;
+
+    public:
+        /// \brief The part of a stream name that decides its connection: the symbol, or the whole name for the
+        /// streams of all the market, e.g. !miniTicker@arr
+        T_NODISCARD static auto symbolOf(std::string_view stream) noexcept -> std::string_view;
+
+        /// \brief Assign symbols to connections
+        ///
+        /// \param symbols Streams of each symbol
+        /// \param connections Number of connections
+        /// \param capacity Streams a connection can carry. A symbol goes to the highest ranked connection with room for its streams
+        /// \return The connection of each symbol
+        T_NODISCARD static auto assign(const std::map<std::string, std::size_t> &symbols, std::size_t connections, std::size_t capacity)
+            -> std::unordered_map<std::string, std::size_t>;
+
+    protected:
+        /// Connection events. connection is the index of the connection
+        virtual void connected(std::size_t connection);
+        virtual void close(std::size_t connection);
+        virtual void connectionError(std::size_t connection);
+        /// The server rejected the streams subscriptionAttempts times. They are not subscribed anymore
+        virtual void subscriptionFailed(const std::vector<std::string> &streams);
+
+        /// Receiving methods. See WSSpotBinanceAPI
+        virtual void kline(const std::string &symbol, uint64_t eventTime, BinanceTimeIntervals interval, const Candlestick &cs);
+        virtual void individualSymbolMiniTicker(const std::string &symbol, uint64_t eventTime, const StreamIndividualSymbolMiniTicker &ticker);
+        virtual void allMarketMiniTickers(const std::multimap<std::string, std::pair<uint64_t, StreamMarketMiniTickers>> &mm);
+        virtual void individualSymbolTicker(const std::string &symbol, uint64_t eventTime, const StreamIndividualSymbolTicker &ticker);
+        virtual void allMarketTickers(const std::multimap<std::string, std::pair<uint64_t, StreamMarketTickers>> &mm);
+        virtual void bookTicker(const std::string &symbol, uint64_t eventTime, const StreamBookTicker &ticker);
+        virtual void depthUpdate(const std::string &symbol, uint64_t eventTime, const StreamDepthUpdate &sdp);
+        virtual void sharedDepthUpdate(const std::string &symbol, uint64_t eventTime, Snapshot<StreamDepthUpdate> sdp);
+        virtual void aggregateTradeStream(const std::string &symbol, uint64_t eventTime, const StreamAggregateTrade &as);
+        virtual void sequenceGap(const std::string &symbol, SequencedStream stream, const SequenceGap &gap);
+
+    private:
+        class Shard;
+
+        /// \brief A stream moved out of a connection, to be unsubscribed when the new connection confirms it
+        struct Handover
+        {
+            Shard *from;
+            std::string stream;
+        };
+
+        /// \brief Open or close connections for the current streams, move the symbols and send the (un)subscriptions.
+        /// Called with m_mutex held
+        auto rebalance() -> void;
+        /// \brief Streams to be carried by each connection
+        auto plannedStreams(std::size_t connections) const -> std::vector<std::set<std::string>>;
+        /// \brief A subscription request of a connection was answered: unsubscribe the streams it moved from their old
+        /// connection, and subscribe again the streams of a failed request. Called from the reactor
+        auto subscribed(Shard &shard, int request, bool success) -> void;
+        /// \brief Remove a stream from its symbol. Called with m_mutex held
+        auto forget(const std::string &stream) -> void;
+        /// \brief Unsubscribe the streams moved from the connections they left, unless they came back. Called with m_mutex held
+        auto completeHandovers(const std::vector<Handover> &handovers) -> void;
+        /// \brief Close the connections left over whose streams are all confirmed elsewhere. Called with m_mutex held
+        auto closeLeaving() -> void;
+        /// \brief Destroy the connections closed. A shard waits for its connection when destroyed, which a thread of
+        /// the reactor can not do: then they are destroyed by the next call from another thread, or by terminate().
+        /// Called without m_mutex held
+        auto reap() -> void;
+
+    private:
+        WSReactor &m_reactor;
+        const std::size_t m_minConnections;
+        const std::size_t m_streamsPerConnection;
+
+        mutable std::mutex m_mutex;
+        std::vector<std::unique_ptr<Shard>> m_shards;
+        // Connections left over, open until their streams are confirmed on the others
+        std::vector<std::unique_ptr<Shard>> m_leaving;
+        // Connections closed, waiting to be destroyed outside the lock
+        std::vector<std::unique_ptr<Shard>> m_retired;
+        // Streams to unsubscribe from their old connection, by the connection and the request subscribing them on the new one
+        std::map<std::pair<const Shard *, int>, std::vector<Handover>> m_handovers;
+        // Subscriptions of each stream rejected in a row
+        std::unordered_map<std::string, std::size_t> m_failures;
+        // Subscribed streams of each symbol (see symbolOf)
+        std::map<std::string, std::set<std::string>> m_symbols;
+        // Connection of each symbol
+        std::unordered_map<std::string, std::size_t> m_assignment;
+        StreamMetrics *m_streamMetrics { nullptr };
+        // Server of the connections. Empty for the default
+        std::string m_url;
+        int32_t m_port { 0 };
+    };
+} // namespace BINAPI_NAMESPACE::ws
+
+#endif /*WSSPOTMULTIPLEXER_HPP_*/
@@ -0,0 +1,163 @@
+////////////////////////////////////////////////////////////////////////////////
+// Created by Ricardo Romero on 17/10/2026 for BinanceAPI.
+// Copyright (c) 2026. Ricardo Romero
+// All rights reserved.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __cplusplus
+#error "C++ compiler needed"
+#endif /*__cplusplus*/
+
+#pragma once
+
+#ifndef WSSUBSCRIPTIONS_HPP_
+#define WSSUBSCRIPTIONS_HPP_
+
+#include "BinanceAPIGlobal.hpp"
+
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace BINAPI_NAMESPACE::ws
+{
+    /// \brief SUBSCRIBE and UNSUBSCRIBE requests of a stream connection, and the state of its streams.
+    /// Requests are queued and turned into messages only when the connection can send one (see nextMessage), so the
+    /// streams asked for while a message waits for the rate limit of the connection go together in the next one: a
+    /// single message carries up to streamsPerMessage streams of any number of requests.
+    ///
+    /// Every function is thread-safe
+    class BINAPI_EXPORT WSSubscriptions final
+    {
+    public:
+        enum class Method
+        {
+            subscribe,
+            unsubscribe
+        };
+
+        enum class State
+        {
+            /// The subscription is queued or waiting for the answer
+            pending,
+            /// The server confirmed the subscription
+            active,
+            /// The unsubscription is queued or waiting for the answer
+            unsubscribing,
+            /// The server rejected the subscription. The stream is forgotten when its request is completed
+            failed
+        };
+
+        /// \brief A request. The future is true if the server accepted every stream of it
+        struct Ticket
+        {
+            int id;
+            std::future<bool> confirmed;
+        };
+
+        /// \brief A request answered by the server
+        struct Completion
+        {
+            Method method;
+            int id;
+            bool success;
+        };
+
+    public:
+        /// \param wake Called when there are messages to send. The connection answers calling nextMessage
+        /// \param streamsPerMessage Streams carried by one message, at most
+        explicit WSSubscriptions(std::function<void()> wake, std::size_t streamsPerMessage = 200);
+
+        WSSubscriptions(const WSSubscriptions &)                     = delete;
+        auto operator=(const WSSubscriptions &) -> WSSubscriptions & = delete;
+
+    public:
+        /// \brief Queue a subscription to the streams
+        auto subscribe(const std::vector<std::string> &streams) -> Ticket;
+        /// \brief Queue an unsubscription from the streams
+        auto unsubscribe(const std::vector<std::string> &streams) -> Ticket;
+
+        /// \brief The next message to send: as many queued streams with the same method as fit, in the order requested
+        /// \return Nothing if the queue is empty
+        auto nextMessage() -> std::optional<std::string>;
+
+        /// \brief Apply the answer of the server to a message
+        ///
+        /// \param id Id of the message
+        /// \param success The answer was a null result and not an error
+        /// \return The requests completed by the answer, or nothing if the id is not of a message sent by this object
+        auto confirm(int id, bool success) -> std::optional<std::vector<Completion>>;
+
+        /// \brief The connection was lost and a new one is being opened. The active streams and the ones being subscribed
+        /// are queued to be subscribed again, keeping the requests not answered; the unsubscriptions not answered are done,
+        /// the server forgot the streams with the connection. The messages not answered are discarded
+        /// \return The unsubscription requests completed
+        auto resubscribe() -> std::vector<Completion>;
+
+        /// \brief The connection was lost. The requests not answered fail, the states are cleared
+        /// \return The streams that were active or being subscribed, to subscribe them again on a new connection
+        auto reset() -> std::vector<std::string>;
+
+    public:
+        T_NODISCARD auto state(const std::string &stream) const -> std::optional<State>;
+        /// \brief Streams in a state
+        T_NODISCARD auto streams(State state) const -> std::vector<std::string>;
+        /// \brief Streams queued and not sent yet
+        T_NODISCARD auto queued() const -> std::size_t;
+
+    private:
+        struct Request
+        {
+            Method method;
+            // Streams of the request not answered yet
+            std::size_t remaining;
+            bool success { true };
+            // Streams of the request rejected by the server
+            std::vector<std::string> failed;
+            std::promise<bool> promise;
+        };
+
+        struct Operation
+        {
+            Method method;
+            std::string stream;
+            int request;
+        };
+
+        struct Message
+        {
+            Method method;
+            std::vector<Operation> operations;
+        };
+
+        struct StreamState
+        {
+            State state;
+            // The last request of the stream. Answers to older requests do not change the state.
+            // Zero for the streams subscribed again by resubscribe
+            int request;
+        };
+
+        auto enqueue(Method method, const std::vector<std::string> &streams) -> Ticket;
+
+    private:
+        const std::function<void()> m_wake;
+        const std::size_t m_streamsPerMessage;
+
+        mutable std::mutex m_mutex;
+        std::deque<Operation> m_queue;
+        std::unordered_map<int, Request> m_requests;
+        // Messages sent and not answered, by id
+        std::unordered_map<int, Message> m_inFlight;
+        std::unordered_map<std::string, StreamState> m_states;
+        int m_nextRequest { 1 };
+        int m_nextMessage { 1 };
+    };
+} // namespace BINAPI_NAMESPACE::ws
+
+#endif /*WSSUBSCRIPTIONS_HPP_*/
@@ -14,18 +14,46 @@
 #define FUTURES_WSTHREAD_HPP
 
 #include "BinanceAPIGlobal.hpp"
+#include "BinanceAPIMetrics.hpp"
+#include "WSReactor.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
 
 namespace BINAPI_NAMESPACE::ws
 {
-    class WSThread
+    /// \brief A stream connection. The connection is serviced by a WSReactor, shared by default with all the other streams,
+    /// so the callbacks come from one of its threads.
+    /// With reconnection enabled (see setReconnection) a connection lost or failed to open is opened again after a jittered,
+    /// exponentially growing delay, until terminate() is called.
+    /// \remarks The destructor detaches a connection still open, but the virtual functions may be running until then:
+    /// derived classes call terminate() and wait() before they are destroyed. So a WSThread is never destroyed from a callback
+    /// of the reactor (see WSReactor)
+    class WSThread : private WSReactor::Handler
     {
     public:
-        WSThread(std::string url, std::string endPoint, int32_t port);
-        virtual ~WSThread();
-
+        /// \param url Host
+        /// \param endPoint Path
+        /// \param port Port
+        /// \param reactor Services the connection
+        WSThread(std::string url, std::string endPoint, int32_t port, WSReactor &reactor = WSReactor::shared());
+        ~WSThread() override;
+
+        /// \brief Connect and wait until the connection is closed
         auto run() -> void;
 
-        /// \brief Stop receiving. The function is thread safe
+        /// \brief Connect and return. connected() or connectionError() are called from the reactor
+        auto start() -> void;
+
+        /// \brief Wait until the connection started by start() is closed, and not reconnecting
+        /// \throws std::logic_error From a service thread of a WSReactor, such as in a callback, where it would never return
+        auto wait() -> void;
+
+        /// \brief Stop receiving, and reconnecting. The function is thread safe
         void terminate();
 
     public:
@@ -37,42 +65,118 @@ namespace BINAPI_NAMESPACE::ws
         virtual auto connectionError() -> void = 0;
         /// \brief Called when the ping frame was sent successfully or unsuccessfully
         virtual void pingSent(bool success) noexcept = 0;
+        /// \brief Called when the connection was lost, or failed to connect, and will be opened again
+        ///
+        /// \param attempt Reconnections since the last time the connection was established, this one included
+        /// \param delay Time until the connection is opened
+        virtual void reconnecting(uint32_t attempt, std::chrono::milliseconds delay) noexcept;
 
     protected:
-        auto getJsonData() const -> const std::string &;
+        /// \brief The message being delivered to receivedData, with all its fragments.
+        /// The text is null-terminated and mutable, so it can be parsed in situ (see local::ResponseDocument).
+        /// It is valid until receivedData returns; the buffer is reused by the next message
+        auto getMessage() noexcept -> std::span<char>;
+        /// \brief Timestamps of the message being delivered to receivedData. Valid until receivedData returns
+        auto getTimings() const noexcept -> const StreamTimings &;
+        /// \brief Called by the parsers once the event of the message is known: stamps the end of the parsing and records
+        /// it in the StreamMetrics, as the stream symbol@event
+        auto eventParsed(std::string_view symbol, std::string_view event, uint64_t eventTime) -> void;
 
     public:
         auto isRunning() -> bool;
         auto isTerminated() -> bool;
+        /// \brief The connection was lost and is waiting to be opened again
+        auto isReconnecting() -> bool;
         auto setPingTimer(uint64_t timer) -> void;
+        /// \brief Messages sent in any second, at most. Zero is no limit. Takes effect on the next connection
+        auto setMessageRate(uint32_t messagesPerSecond) -> void;
+        /// \brief Open the connection again when it is lost. Call it before start().
+        /// The n-th consecutive attempt waits a random time between half and all of min(initialDelay * 2^n, maximumDelay),
+        /// so many connections lost at once do not reconnect at once
+        auto setReconnection(bool enabled,
+            std::chrono::milliseconds initialDelay = std::chrono::milliseconds(50),
+            std::chrono::milliseconds maximumDelay = std::chrono::seconds(30)) -> void;
+        /// \brief Record the latency of the events received. Nullptr disables it. Call it before start()
+        /// \param metrics Must outlive the connection
+        auto setStreamMetrics(StreamMetrics *metrics) -> void;
 
     public:
         /// \brief This function can be called to change the endpoint. Just make sure to call it before a calling run()
         /// \param endpoint New base endpoint
         auto setEndPoint(const std::string &endpoint) -> void;
+        /// \brief Connect to another server, such as the testnet. Call it before run() or start()
+        /// \param url New host
+        /// \param port New port
+        auto setHost(const std::string &url, int32_t port) -> void;
+
+    public:
+        /// Messages larger than this are dropped
+        static constexpr std::size_t maxMessageSize = 64 * 1024 * 1024;
 
     protected:
+        /// \brief Called for every complete text message. Use getMessage to read it
         virtual auto receivedData() -> void = 0;
         auto sendData(const std::string &msg) -> void;
         static auto randNumber() -> int;
 
+        /// \brief Called from the reactor when the connection can send a message and sendData queued none.
+        /// The message is built when it can be sent, so it can carry everything asked meanwhile
+        /// \return The message to send, or nothing
+        virtual auto nextMessage() -> std::optional<std::string>;
+        /// \brief Call nextMessage as soon as the message rate allows it. Thread-safe
+        auto requestMessage() -> void;
+        /// \brief The connection is gone
+        /// \param reconnecting A new connection will be opened. If false, called before wait() returns
+        virtual auto disconnected(bool reconnecting) noexcept -> void;
+
     private:
-        lws_context *m_context { nullptr };
-        lws_protocols m_protocols[2] {};
-        lws *m_lws { nullptr };
+        auto event(lws *wsi, lws_callback_reasons reason, void *in, std::size_t len) -> int override;
+        auto finished() noexcept -> void override;
+        auto pull() -> std::optional<std::string> override;
+
+        auto endpoint() const -> WSReactor::Endpoint;
+        /// \brief Delay of the next reconnection attempt
+        auto reconnectionDelay() -> std::chrono::milliseconds;
+
+    private:
+        WSReactor &m_reactor;
+        std::atomic<WSReactor::ConnectionId> m_connection { 0 };
+
+        std::mutex m_finishedMutex;
+        std::condition_variable m_finishedCondition;
+        // No connection, or the connection is closed
+        bool m_finished { true };
 
         std::string m_url;
         std::string m_endPoint;
-        std::string m_jsonData;
+        // Reassembly buffer. Its capacity is kept between messages
+        std::string m_message;
+        // A fragment of the message was received and the final one was not
+        bool m_receiving { false };
+        // The message outgrew maxMessageSize. The rest of its fragments are skipped
+        bool m_overflow { false };
+        // Of the message being received
+        StreamTimings m_timings;
+        StreamMetrics *m_streamMetrics { nullptr };
+        // Name of the stream recorded last. Its capacity is kept between messages
+        std::string m_streamName;
 
         uint64_t m_pingTimer { 0 };
+        uint32_t m_messageRate { 0 };
+
+        bool m_reconnect { false };
+        std::chrono::milliseconds m_initialDelay { 50 };
+        std::chrono::milliseconds m_maximumDelay { 30'000 };
+        // Reconnections since the connection was last established. Only used by the reactor
+        uint32_t m_attempt { 0 };
 
         int32_t m_port;
 
         std::atomic_bool m_running;
         std::atomic_bool m_terminate;
-
-        static auto eventManager(struct lws *wsi, lws_callback_reasons reason, void *user, void *in, size_t len) -> int;
+        std::atomic_bool m_reconnecting { false };
+        // terminate() was called. Guarded by m_finishedMutex
+        bool m_stop { false };
     };
 } // namespace BINAPI_NAMESPACE::ws
 
@@ -0,0 +1,138 @@
+////////////////////////////////////////////////////////////////////////////////
+// Created by Ricardo Romero on 17/10/2026 for BinanceAPI.
+// Copyright (c) 2026. Ricardo Romero
+// All rights reserved.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "BinanceAPIArena.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+    // Enough for the calls a thread may have alive at the same time. Arenas beyond this are freed
+    constexpr std::size_t g_maxFreeArenas   = 4;
+    // First size of the buffer. Most of the responses fit
+    constexpr std::size_t g_initialCapacity = 64 * 1024;
+
+    struct ThreadArenas
+    {
+        std::vector<std::unique_ptr<BINAPI_NAMESPACE::local::ResponseArena>> free;
+        BINAPI_NAMESPACE::local::ResponseArena::Statistics statistics;
+    };
+
+    auto threadArenas() noexcept -> ThreadArenas &
+    {
+        thread_local ThreadArenas arenas;
+        return arenas;
+    }
+} // namespace
+
+auto BINAPI_NAMESPACE::local::ResponseArena::Recycler::operator()(ResponseArena *arena) const noexcept -> void
+{
+    std::unique_ptr<ResponseArena> owned { arena };
+
+    auto &arenas = threadArenas();
+    if (arenas.free.size() < g_maxFreeArenas)
+    {
+        try
+        {
+            arenas.free.push_back(std::move(owned));
+        } catch (...)
+        {
+            // The arena is freed
+        }
+    }
+}
+
+auto BINAPI_NAMESPACE::local::ResponseArena::acquire() -> Pointer
+{
+    auto &arenas = threadArenas();
+
+    if (arenas.free.empty())
+        return Pointer { new ResponseArena };
+
+    ++arenas.statistics.reused;
+    Pointer arena { arenas.free.back().release() };
+    arenas.free.pop_back();
+    return arena;
+}
+
+auto BINAPI_NAMESPACE::local::ResponseArena::getStatistics() noexcept -> Statistics
+{
+    return threadArenas().statistics;
+}
+
+BINAPI_NAMESPACE::local::ResponseArena::ResponseArena() :
+    m_buffer { std::make_unique<char[]>(g_initialCapacity) },
+    m_bufferSize { g_initialCapacity }
+{
+    auto &statistics    = threadArenas().statistics;
+    statistics.capacity = std::max(statistics.capacity, m_bufferSize);
+}
+
+BINAPI_NAMESPACE::local::ResponseArena::~ResponseArena() = default;
+
+auto BINAPI_NAMESPACE::local::ResponseArena::prepare(std::string &&body) -> rapidjson::MemoryPoolAllocator<> *
+{
+    auto &statistics = threadArenas().statistics;
+
+    // The previous response did not fit. Capacity() includes the buffer and every chunk taken from the heap,
+    // so the new buffer holds that response in one piece
+    if (m_allocator.has_value() && m_allocator->Capacity() > m_bufferSize)
+    {
+        m_bufferSize = m_allocator->Capacity();
+        m_allocator.reset();
+        m_buffer = std::make_unique<char[]>(m_bufferSize);
+
+        ++statistics.grown;
+        statistics.capacity = std::max(statistics.capacity, m_bufferSize);
+    }
+
+    // Releases the chunks of the previous response. The buffer itself is never freed by the allocator
+    m_allocator.emplace(m_buffer.get(), m_bufferSize);
+    m_body     = std::move(body);
+    m_textSize = m_body.size();
+
+    ++statistics.responses;
+    return &*m_allocator;
+}
+
+auto BINAPI_NAMESPACE::local::ResponseArena::prepare(std::size_t textSize) -> rapidjson::MemoryPoolAllocator<> *
+{
+    auto *allocator = prepare(std::string {});
+    m_textSize      = textSize;
+    return allocator;
+}
+
+auto BINAPI_NAMESPACE::local::ResponseArena::body() noexcept -> char *
+{
+    return m_body.data();
+}
+
+auto BINAPI_NAMESPACE::local::ResponseArena::stackCapacity() const noexcept -> std::size_t
+{
+    return std::max<std::size_t>(1024, m_textSize / 8);
+}
+
+BINAPI_NAMESPACE::local::ResponseDocument::ResponseDocument(std::string &&body) :
+    ResponseArenaHolder { ResponseArena::acquire() },
+    rapidjson::Document { m_arena->prepare(std::move(body)), m_arena->stackCapacity() }
+{
+    ParseInsitu(m_arena->body());
+}
+
+BINAPI_NAMESPACE::local::ResponseDocument::ResponseDocument(char *text, std::size_t size) :
+    ResponseArenaHolder { ResponseArena::acquire() },
+    rapidjson::Document { m_arena->prepare(size), m_arena->stackCapacity() }
+{
+    ParseInsitu(text);
+}
+
+BINAPI_NAMESPACE::local::ResponseDocument::~ResponseDocument() = default;
+
+auto BINAPI_NAMESPACE::local::ResponseDocument::root() const noexcept -> const rapidjson::Value &
+{
+    return *this;
+}
@@ -0,0 +1,158 @@
+////////////////////////////////////////////////////////////////////////////////
+// Created by Ricardo Romero on 17/10/2026 for BinanceAPI.
+// Copyright (c) 2026. Ricardo Romero
+// All rights reserved.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "BinanceAPIAsync.hpp"
+
+BINAPI_NAMESPACE::RequestExecutor::RequestExecutor(std::size_t workers)
+{
+    if (workers == 0)
+        workers = 1;
+
+    m_workers.reserve(workers);
+    for (std::size_t i = 0; i < workers; ++i)
+        m_workers.emplace_back([this] { run(); });
+}
+
+BINAPI_NAMESPACE::RequestExecutor::~RequestExecutor()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_terminate = true;
+    }
+    m_wakeUp.notify_all();
+
+    for (auto &worker : m_workers)
+        worker.join();
+}
+
+auto BINAPI_NAMESPACE::RequestExecutor::getWorkers() const noexcept -> std::size_t
+{
+    return m_workers.size();
+}
+
+auto BINAPI_NAMESPACE::RequestExecutor::getPending() const noexcept -> std::size_t
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_tasks.size();
+}
+
+auto BINAPI_NAMESPACE::RequestExecutor::discardPending() -> std::size_t
+{
+    std::deque<std::function<void()>> discarded;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        discarded.swap(m_tasks);
+    }
+    // Destroying a packaged_task that never ran breaks its promise. Done out of the lock, with the captures of the tasks
+    return discarded.size();
+}
+
+auto BINAPI_NAMESPACE::RequestExecutor::enqueue(std::function<void()> task) -> void
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.emplace_back(std::move(task));
+    }
+    m_wakeUp.notify_one();
+}
+
+auto BINAPI_NAMESPACE::RequestExecutor::run() noexcept -> void
+{
+    for (;;)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wakeUp.wait(lock, [this] { return m_terminate || !m_tasks.empty(); });
+
+            // Pending tasks are still executed, so no future is left without a value
+            if (m_tasks.empty())
+                return;
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+        // packaged_task stores the exceptions in the future
+        task();
+    }
+}
+
+BINAPI_NAMESPACE::BinanceAPISpotAsync::BinanceAPISpotAsync(BinanceAPISpot *api, std::size_t workers) :
+    m_api { api },
+    m_executor { workers == 0 ? api->getConnectionPool()->getMaxSessions() : workers }
+{
+    // More workers than sessions will only make the workers wait for a session
+    if (m_api->getConnectionPool()->getMaxSessions() < m_executor.getWorkers())
+        m_api->getConnectionPool()->setMaxSessions(m_executor.getWorkers());
+}
+
+BINAPI_NAMESPACE::BinanceAPISpotAsync::~BinanceAPISpotAsync() = default;
+
+auto BINAPI_NAMESPACE::BinanceAPISpotAsync::ping() -> std::future<void>
+{
+    return submit([](BinanceAPISpot &api) { api.ping(); });
+}
+
+auto BINAPI_NAMESPACE::BinanceAPISpotAsync::checkServerTime() -> std::future<uint64_t>
+{
+    return submit([](BinanceAPISpot &api) { return api.checkServerTime(); });
+}
+
+auto BINAPI_NAMESPACE::BinanceAPISpotAsync::getExchangeInformation() -> std::future<SPOT::ExchangeInformation>
+{
+    return submit([](BinanceAPISpot &api) { return api.getExchangeInformation(); });
+}
+
+auto BINAPI_NAMESPACE::BinanceAPISpotAsync::getOrderBook(v_sym_t symbol, uint32_t limit) -> std::future<SPOT::OrderBook>
+{
+    return submit([symbol = sym_t { symbol }, limit](BinanceAPISpot &api) { return api.getOrderBook(symbol, limit); });
+}
+
+auto BINAPI_NAMESPACE::BinanceAPISpotAsync::candlestickData(v_sym_t symbol, BinanceTimeIntervals bti, uint64_t startTime, uint64_t endTime, uint64_t limit) -> std::future<std::vector<Candlestick>>
+{
+    return submit([symbol = sym_t { symbol }, bti, startTime, endTime, limit](BinanceAPISpot &api) {
+        return api.candlestickData(symbol, bti, startTime, endTime, limit);
+    });
+}
+
+auto BINAPI_NAMESPACE::BinanceAPISpotAsync::tickerPriceChangeStatistics24hr(v_sym_t symbol) -> std::future<SPOT::TickerPriceChangeStatistics>
+{
+    return submit([symbol = sym_t { symbol }](BinanceAPISpot &api) { return api.tickerPriceChangeStatistics24hr(symbol); });
+}
+
+auto BINAPI_NAMESPACE::BinanceAPISpotAsync::tickerPriceChangeStatistics24hr(const std::vector<sym_t> &symbols) -> std::future<std::unordered_map<sym_t, SPOT::TickerPriceChangeStatistics>>
+{
+    return submit([symbols](BinanceAPISpot &api) { return api.tickerPriceChangeStatistics24hr(symbols); });
+}
+
+auto BINAPI_NAMESPACE::BinanceAPISpotAsync::candlesByPeriod(v_sym_t symbol, BinanceTimeIntervals bti, uint64_t startTime, uint64_t endTime) -> std::vector<std::future<std::vector<Candlestick>>>
+{
+    uint64_t totalExpected = 0;
+    const auto chunks      = BinanceAPI::getCandlesTimesAndLimits(bti, startTime, endTime, totalExpected);
+
+    std::vector<std::future<std::vector<Candlestick>>> futures;
+    futures.reserve(chunks.size());
+
+    for (const auto &[start, end, limit] : chunks)
+    {
+        // The trailing chunk is empty when the range is a multiple of 1000 candles. candlestickData would clamp its
+        // limit to 1 and fetch a candle past the range, so it is not requested
+        if (limit == 0)
+            continue;
+        // A backfill runs in the background so the calls made meanwhile are not delayed behind its chunks
+        futures.emplace_back(submit([symbol = sym_t { symbol }, bti, start = start, end = end, limit = limit](BinanceAPISpot &api) {
+            const RequestPriorityScope priority { RequestPriority::background };
+            return api.candlestickData(symbol, bti, start, end, limit);
+        }));
+    }
+
+    return futures;
+}
+
+auto BINAPI_NAMESPACE::BinanceAPISpotAsync::getExecutor() noexcept -> RequestExecutor &
+{
+    return m_executor;
+}
@@ -0,0 +1,330 @@
+////////////////////////////////////////////////////////////////////////////////
+// Created by Ricardo Romero on 17/10/2026 for BinanceAPI.
+// Copyright (c) 2026. Ricardo Romero
+// All rights reserved.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "BinanceAPICache.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fmt/format.h>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+
+namespace
+{
+    // Snapshot layout, native byte order:
+    //   magic, version, count
+    //   count x { key size, key, etag size, etag, last modified size, last modified, stored (ms since epoch), body size, body }
+    // Sizes are uint32_t except the body size, which is uint64_t
+    constexpr std::array<char, 4> g_snapshotMagic { 'B', 'R', 'C', 'S' };
+    constexpr uint32_t g_snapshotVersion = 1;
+
+    constexpr std::array<std::string_view, 3> g_volatileParameters { "timestamp", "recvWindow", "signature" };
+
+    /// \brief FNV-1a. Stable between runs, unlike std::hash, so the keys can be persisted
+    auto fnv1a(std::string_view text) noexcept -> uint64_t
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (const char c : text)
+        {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    auto endPointOf(std::string_view key) noexcept -> std::string_view
+    {
+        return key.substr(0, key.find('?'));
+    }
+
+    /// \brief Keys of signed calls end with the hash of the API key
+    auto isSigned(std::string_view key) noexcept -> bool
+    {
+        return key.find('#') != std::string_view::npos;
+    }
+
+    template <typename T>
+    auto write(std::ostream &stream, const T &value) -> void
+    {
+        stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    auto writeString(std::ostream &stream, std::string_view text) -> void
+    {
+        write(stream, static_cast<uint32_t>(text.size()));
+        stream.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+
+    /// \brief Reads a snapshot from memory, checking every size against what is left
+    class SnapshotReader
+    {
+    public:
+        explicit SnapshotReader(std::string_view data) noexcept :
+            m_data { data } { }
+
+        template <typename T>
+        auto read(T &value) noexcept -> bool
+        {
+            if (m_data.size() < sizeof(T))
+                return false;
+            std::memcpy(&value, m_data.data(), sizeof(T));
+            m_data.remove_prefix(sizeof(T));
+            return true;
+        }
+
+        template <typename Size>
+        auto readString(std::string &text) -> bool
+        {
+            Size size {};
+            if (!read(size) || m_data.size() < size)
+                return false;
+            text.assign(m_data.data(), static_cast<std::size_t>(size));
+            m_data.remove_prefix(static_cast<std::size_t>(size));
+            return true;
+        }
+
+        T_NODISCARD auto empty() const noexcept -> bool
+        {
+            return m_data.empty();
+        }
+
+    private:
+        std::string_view m_data;
+    };
+} // namespace
+
+BINAPI_NAMESPACE::ResponseCache::ResponseCache() noexcept = default;
+
+BINAPI_NAMESPACE::ResponseCache::~ResponseCache() = default;
+
+auto BINAPI_NAMESPACE::ResponseCache::setTimeToLive(std::string_view endPoint, std::chrono::seconds timeToLive) -> void
+{
+    std::scoped_lock lock(m_mutex);
+    if (timeToLive.count() <= 0)
+        m_timeToLive.erase(std::string { endPoint });
+    else
+        m_timeToLive[std::string { endPoint }] = timeToLive;
+}
+
+auto BINAPI_NAMESPACE::ResponseCache::getTimeToLive(std::string_view endPoint) const -> std::chrono::seconds
+{
+    std::scoped_lock lock(m_mutex);
+    const auto timeToLive = m_timeToLive.find(std::string { endPoint });
+    return timeToLive == m_timeToLive.end() ? std::chrono::seconds { 0 } : timeToLive->second;
+}
+
+auto BINAPI_NAMESPACE::ResponseCache::makeKey(std::string_view endPoint, const std::vector<std::pair<std::string, std::string>> &parameters, std::string_view identity) -> std::string
+{
+    std::vector<const std::pair<std::string, std::string> *> sorted;
+    sorted.reserve(parameters.size());
+    for (const auto &parameter : parameters)
+    {
+        if (std::find(g_volatileParameters.begin(), g_volatileParameters.end(), parameter.first) == g_volatileParameters.end())
+            sorted.push_back(&parameter);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const auto *a, const auto *b) { return *a < *b; });
+
+    std::string key { endPoint };
+    key.push_back('?');
+    for (const auto *parameter : sorted)
+        key.append(parameter->first).append("=").append(parameter->second).append("&");
+
+    if (!identity.empty())
+        key.append(fmt::format("#{:016x}", fnv1a(identity)));
+
+    return key;
+}
+
+auto BINAPI_NAMESPACE::ResponseCache::find(std::string_view endPoint, const std::string &key, long long callWeight, clock::time_point now) -> Lookup
+{
+    std::scoped_lock lock(m_mutex);
+
+    auto &metrics         = m_metrics[std::string { endPoint }];
+    const auto timeToLive = m_timeToLive.find(std::string { endPoint });
+    const auto entry      = m_entries.find(key);
+
+    if (timeToLive == m_timeToLive.end() || entry == m_entries.end())
+    {
+        ++metrics.misses;
+        return {};
+    }
+
+    if (now - entry->second.stored < timeToLive->second)
+    {
+        ++metrics.hits;
+        metrics.weightSaved += static_cast<uint64_t>(std::max(callWeight, 0LL));
+        return { .body = entry->second.body, .conditional = {} };
+    }
+
+    ++metrics.misses;
+
+    Lookup lookup;
+    if (!entry->second.etag.empty())
+        lookup.conditional.emplace_back("If-None-Match", entry->second.etag);
+    if (!entry->second.lastModified.empty())
+        lookup.conditional.emplace_back("If-Modified-Since", entry->second.lastModified);
+    return lookup;
+}
+
+auto BINAPI_NAMESPACE::ResponseCache::store(std::string_view endPoint, const std::string &key, std::string body, std::string etag, std::string lastModified, clock::time_point now) -> void
+{
+    // The body is moved into a shared string before taking the lock
+    auto shared = std::make_shared<const std::string>(std::move(body));
+
+    std::scoped_lock lock(m_mutex);
+    m_entries[key] = Entry { .body = std::move(shared), .etag = std::move(etag), .lastModified = std::move(lastModified), .stored = now };
+    ++m_metrics[std::string { endPoint }].stores;
+}
+
+auto BINAPI_NAMESPACE::ResponseCache::revalidated(std::string_view endPoint, const std::string &key, clock::time_point now) -> std::shared_ptr<const std::string>
+{
+    std::scoped_lock lock(m_mutex);
+
+    const auto entry = m_entries.find(key);
+    if (entry == m_entries.end())
+        return nullptr;
+
+    entry->second.stored = now;
+    ++m_metrics[std::string { endPoint }].revalidated;
+    return entry->second.body;
+}
+
+auto BINAPI_NAMESPACE::ResponseCache::invalidate(std::string_view endPoint) -> void
+{
+    std::scoped_lock lock(m_mutex);
+
+    if (endPoint.empty())
+    {
+        m_entries.clear();
+        return;
+    }
+
+    std::erase_if(m_entries, [&](const auto &entry) { return endPointOf(entry.first) == endPoint; });
+}
+
+auto BINAPI_NAMESPACE::ResponseCache::saveSnapshot(const std::filesystem::path &path, bool includeSigned) const -> bool
+{
+    auto temporary = path;
+    temporary += ".tmp";
+
+    {
+        std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+        if (!stream)
+            return false;
+
+        std::scoped_lock lock(m_mutex);
+
+        const auto isWritten = [includeSigned](const std::string &key) { return includeSigned || !isSigned(key); };
+
+        stream.write(g_snapshotMagic.data(), g_snapshotMagic.size());
+        write(stream, g_snapshotVersion);
+        write(stream, static_cast<uint32_t>(std::count_if(m_entries.begin(), m_entries.end(), [&](const auto &entry) { return isWritten(entry.first); })));
+
+        for (const auto &[key, entry] : m_entries)
+        {
+            if (!isWritten(key))
+                continue;
+
+            writeString(stream, key);
+            writeString(stream, entry.etag);
+            writeString(stream, entry.lastModified);
+            write(stream, static_cast<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(entry.stored.time_since_epoch()).count()));
+            write(stream, static_cast<uint64_t>(entry.body->size()));
+            stream.write(entry.body->data(), static_cast<std::streamsize>(entry.body->size()));
+        }
+
+        if (!stream.flush())
+            return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error)
+    {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
+
+auto BINAPI_NAMESPACE::ResponseCache::loadSnapshot(const std::filesystem::path &path) -> bool
+{
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream)
+        return false;
+
+    const std::string data { std::istreambuf_iterator<char> { stream }, std::istreambuf_iterator<char> {} };
+    SnapshotReader reader { data };
+
+    std::array<char, 4> magic {};
+    uint32_t version = 0;
+    uint32_t count   = 0;
+    if (!reader.read(magic) || magic != g_snapshotMagic || !reader.read(version) || version != g_snapshotVersion || !reader.read(count))
+        return false;
+
+    std::unordered_map<std::string, Entry> loaded;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        std::string key;
+        std::string body;
+        Entry entry;
+        int64_t stored = 0;
+
+        if (!reader.readString<uint32_t>(key)
+            || !reader.readString<uint32_t>(entry.etag)
+            || !reader.readString<uint32_t>(entry.lastModified)
+            || !reader.read(stored)
+            || !reader.readString<uint64_t>(body))
+            return false;
+
+        entry.stored = clock::time_point { std::chrono::duration_cast<clock::duration>(std::chrono::milliseconds { stored }) };
+        entry.body   = std::make_shared<const std::string>(std::move(body));
+        loaded.insert_or_assign(std::move(key), std::move(entry));
+    }
+
+    if (!reader.empty())
+        return false;
+
+    std::scoped_lock lock(m_mutex);
+    for (auto &[key, entry] : loaded)
+    {
+        const auto current = m_entries.find(key);
+        if (current == m_entries.end() || current->second.stored < entry.stored)
+            m_entries.insert_or_assign(key, std::move(entry));
+    }
+    return true;
+}
+
+auto BINAPI_NAMESPACE::ResponseCache::getMetrics() const -> Metrics
+{
+    std::scoped_lock lock(m_mutex);
+
+    Metrics total;
+    for (const auto &[endPoint, metrics] : m_metrics)
+    {
+        total.hits += metrics.hits;
+        total.misses += metrics.misses;
+        total.revalidated += metrics.revalidated;
+        total.stores += metrics.stores;
+        total.weightSaved += metrics.weightSaved;
+    }
+    return total;
+}
+
+auto BINAPI_NAMESPACE::ResponseCache::getMetrics(std::string_view endPoint) const -> Metrics
+{
+    std::scoped_lock lock(m_mutex);
+    const auto metrics = m_metrics.find(std::string { endPoint });
+    return metrics == m_metrics.end() ? Metrics {} : metrics->second;
+}
+
+auto BINAPI_NAMESPACE::ResponseCache::size() const -> std::size_t
+{
+    std::scoped_lock lock(m_mutex);
+    return m_entries.size();
+}
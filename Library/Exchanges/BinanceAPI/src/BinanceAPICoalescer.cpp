@@ -0,0 +1,127 @@
+////////////////////////////////////////////////////////////////////////////////
+// Created by Ricardo Romero on 17/10/2026 for BinanceAPI.
+// Copyright (c) 2026. Ricardo Romero
+// All rights reserved.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "BinanceAPICoalescer.hpp"
+
+#include <algorithm>
+
+BINAPI_NAMESPACE::RequestCoalescer::RequestCoalescer() noexcept = default;
+
+BINAPI_NAMESPACE::RequestCoalescer::~RequestCoalescer() = default;
+
+auto BINAPI_NAMESPACE::RequestCoalescer::run(std::string_view endPoint, const std::string &key, long long callWeight, RequestPriority priority, const std::function<cpr::Response()> &call) -> cpr::Response
+{
+    if (!isEnabled())
+        return call();
+
+    const auto index = static_cast<std::size_t>(priority);
+
+    std::shared_ptr<Flight> flight;
+    bool leader = false;
+    {
+        std::scoped_lock lock(m_mutex);
+
+        auto &metrics = m_metrics[std::string { endPoint }];
+        auto &flights = m_flights[key];
+
+        // The first flight of the same class or a higher one. A lower class may still be waiting for its weight
+        for (std::size_t i = 0; i <= index && flight == nullptr; ++i)
+            flight = flights[i];
+
+        if (flight == nullptr)
+        {
+            flight = flights[index] = std::make_shared<Flight>();
+            leader = true;
+            ++metrics.transferred;
+        }
+        else
+        {
+            ++flight->followers;
+            ++metrics.coalesced;
+            metrics.weightSaved += static_cast<uint64_t>(std::max(callWeight, 0LL));
+        }
+    }
+
+    if (!leader)
+    {
+        // Each follower parses its own copy
+        return *flight->response.get();
+    }
+
+    cpr::Response response;
+    try
+    {
+        response = call();
+    } catch (...)
+    {
+        {
+            std::scoped_lock lock(m_mutex);
+            land(key, index);
+        }
+        flight->promise.set_exception(std::current_exception());
+        throw;
+    }
+
+    // Once the flight is removed no one else can join it, so the response is only copied when someone is waiting
+    bool shared = false;
+    {
+        std::scoped_lock lock(m_mutex);
+        land(key, index);
+        shared = flight->followers > 0;
+    }
+    flight->promise.set_value(shared ? std::make_shared<const cpr::Response>(response) : nullptr);
+
+    return response;
+}
+
+auto BINAPI_NAMESPACE::RequestCoalescer::land(const std::string &key, std::size_t index) -> void
+{
+    const auto flights = m_flights.find(key);
+    flights->second[index].reset();
+    if (std::ranges::all_of(flights->second, [](const auto &flight) { return flight == nullptr; }))
+        m_flights.erase(flights);
+}
+
+auto BINAPI_NAMESPACE::RequestCoalescer::setEnabled(bool enabled) noexcept -> void
+{
+    m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+auto BINAPI_NAMESPACE::RequestCoalescer::isEnabled() const noexcept -> bool
+{
+    return m_enabled.load(std::memory_order_relaxed);
+}
+
+auto BINAPI_NAMESPACE::RequestCoalescer::getMetrics() const -> Metrics
+{
+    std::scoped_lock lock(m_mutex);
+
+    Metrics total;
+    for (const auto &[endPoint, metrics] : m_metrics)
+    {
+        total.transferred += metrics.transferred;
+        total.coalesced += metrics.coalesced;
+        total.weightSaved += metrics.weightSaved;
+    }
+    return total;
+}
+
+auto BINAPI_NAMESPACE::RequestCoalescer::getMetrics(std::string_view endPoint) const -> Metrics
+{
+    std::scoped_lock lock(m_mutex);
+    const auto metrics = m_metrics.find(std::string { endPoint });
+    return metrics == m_metrics.end() ? Metrics {} : metrics->second;
+}
+
+auto BINAPI_NAMESPACE::RequestCoalescer::inFlight() const -> std::size_t
+{
+    std::scoped_lock lock(m_mutex);
+
+    std::size_t count = 0;
+    for (const auto &[key, flights] : m_flights)
+        count += static_cast<std::size_t>(std::ranges::count_if(flights, [](const auto &flight) { return flight != nullptr; }));
+    return count;
+}
@@ -0,0 +1,170 @@
+////////////////////////////////////////////////////////////////////////////////
+// Created by Ricardo Romero on 17/10/2026 for BinanceAPI.
+// Copyright (c) 2026. Ricardo Romero
+// All rights reserved.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "BinanceAPIConnectionPool.hpp"
+
+BINAPI_NAMESPACE::BinanceAPIConnectionPool::Lease::Lease(BinanceAPIConnectionPool *pool, HostSessions *host, std::unique_ptr<cpr::Session> session) noexcept :
+    m_pool { pool },
+    m_host { host },
+    m_session { std::move(session) }
+{
+}
+
+BINAPI_NAMESPACE::BinanceAPIConnectionPool::Lease::Lease(Lease &&lease) noexcept :
+    m_pool { lease.m_pool },
+    m_host { lease.m_host },
+    m_session { std::move(lease.m_session) }
+{
+    lease.m_pool = nullptr;
+    lease.m_host = nullptr;
+}
+
+BINAPI_NAMESPACE::BinanceAPIConnectionPool::Lease::~Lease()
+{
+    if (m_pool != nullptr && m_session != nullptr)
+        m_pool->release(m_host, std::move(m_session));
+}
+
+auto BINAPI_NAMESPACE::BinanceAPIConnectionPool::Lease::transferred() noexcept -> void
+{
+    // CURLINFO_NUM_CONNECTS is the number of new connections CURL had to create for the last transfer.
+    // Zero means the transfer went through an already established (keep-alive) connection
+    long connects = 0;
+    curl_easy_getinfo(m_session->GetCurlHolder()->handle, CURLINFO_NUM_CONNECTS, &connects);
+
+    m_pool->m_transfers.fetch_add(1, std::memory_order_relaxed);
+    if (connects > 0)
+        m_pool->m_handshakes.fetch_add(static_cast<uint64_t>(connects), std::memory_order_relaxed);
+}
+
+BINAPI_NAMESPACE::BinanceAPIConnectionPool::BinanceAPIConnectionPool(std::size_t maxSessions) noexcept :
+    m_maxSessions { maxSessions == 0 ? 1 : maxSessions }
+{
+}
+
+BINAPI_NAMESPACE::BinanceAPIConnectionPool::~BinanceAPIConnectionPool() = default;
+
+auto BINAPI_NAMESPACE::BinanceAPIConnectionPool::acquire(std::string_view baseURL) -> Lease
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    auto host = m_hosts.find(std::string { baseURL });
+    if (host == m_hosts.end())
+        host = m_hosts.emplace(std::string { baseURL }, HostSessions {}).first;
+
+    HostSessions *hostSessions = &host->second;
+
+    if (hostSessions->idle.empty() && hostSessions->total >= m_maxSessions)
+    {
+        m_waits.fetch_add(1, std::memory_order_relaxed);
+        m_released.wait(lock, [&] { return !hostSessions->idle.empty() || hostSessions->total < m_maxSessions; });
+    }
+
+    m_checkouts.fetch_add(1, std::memory_order_relaxed);
+
+    if (!hostSessions->idle.empty())
+    {
+        auto session = std::move(hostSessions->idle.back());
+        hostSessions->idle.pop_back();
+        m_reused.fetch_add(1, std::memory_order_relaxed);
+        return { this, hostSessions, std::move(session) };
+    }
+
+    ++hostSessions->total;
+    const bool verifySsl = m_verifySsl;
+    lock.unlock();
+
+    std::unique_ptr<cpr::Session> session;
+    try
+    {
+        session = std::make_unique<cpr::Session>();
+    } catch (...)
+    {
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            --hostSessions->total;
+        }
+        m_released.notify_one();
+        throw;
+    }
+
+    session->SetVerifySsl(cpr::VerifySsl { verifySsl });
+    // Keep the connection alive between requests; Binance closes idle connections on its own side
+    curl_easy_setopt(session->GetCurlHolder()->handle, CURLOPT_TCP_KEEPALIVE, 1L);
+    m_created.fetch_add(1, std::memory_order_relaxed);
+
+    return { this, hostSessions, std::move(session) };
+}
+
+auto BINAPI_NAMESPACE::BinanceAPIConnectionPool::release(HostSessions *host, std::unique_ptr<cpr::Session> session) noexcept -> void
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (host->total > m_maxSessions)
+        {
+            // The pool was shrunk while the session was checked out
+            --host->total;
+            session.reset();
+        }
+        else
+            host->idle.emplace_back(std::move(session));
+    }
+    m_released.notify_one();
+}
+
+auto BINAPI_NAMESPACE::BinanceAPIConnectionPool::setMaxSessions(std::size_t maxSessions) noexcept -> void
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_maxSessions = maxSessions == 0 ? 1 : maxSessions;
+        for (auto &[url, host] : m_hosts)
+        {
+            while (host.total > m_maxSessions && !host.idle.empty())
+            {
+                host.idle.pop_back();
+                --host.total;
+            }
+        }
+    }
+    m_released.notify_all();
+}
+
+auto BINAPI_NAMESPACE::BinanceAPIConnectionPool::getMaxSessions() const noexcept -> std::size_t
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_maxSessions;
+}
+
+auto BINAPI_NAMESPACE::BinanceAPIConnectionPool::setVerifySsl(bool verify) noexcept -> void
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_verifySsl = verify;
+}
+
+auto BINAPI_NAMESPACE::BinanceAPIConnectionPool::clear() noexcept -> void
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto &[url, host] : m_hosts)
+        {
+            host.total -= host.idle.size();
+            host.idle.clear();
+        }
+    }
+    m_released.notify_all();
+}
+
+auto BINAPI_NAMESPACE::BinanceAPIConnectionPool::getStatistics() const noexcept -> Statistics
+{
+    return Statistics {
+        .checkouts  = m_checkouts.load(std::memory_order_relaxed),
+        .reused     = m_reused.load(std::memory_order_relaxed),
+        .created    = m_created.load(std::memory_order_relaxed),
+        .transfers  = m_transfers.load(std::memory_order_relaxed),
+        .handshakes = m_handshakes.load(std::memory_order_relaxed),
+        .waits      = m_waits.load(std::memory_order_relaxed)
+    };
+}
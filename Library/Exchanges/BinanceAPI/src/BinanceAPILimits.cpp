@@ -8,118 +8,394 @@
 
 #include "BinanceAPILimits.hpp"
 
-bool BINAPI_NAMESPACE::BinanceLimits::secureCall(const long long &callWeight)
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <cstdint>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+namespace
 {
-    // Protect all reads and writes from other threads
-    std::lock_guard<std::mutex> lock(m_secureRequest);
-
-    // No requests. so m_secondsNow = 0, and we must initialize it to a valid time
-    if (m_secondsNow.count() == 0)
-        m_secondsNow = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch());
-    // This variable sets the time right now
-    std::chrono::seconds seconds_right_now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch());
-    // These Operations calculate the time elapsed since right now from the m_secondsNow initialization
-    auto span         = seconds_right_now - m_secondsNow;
-    m_requestsSeconds = span.count();
-    // If time limit is reached this is
-    if (span.count() < m_maxApiRequestsTsInterval && m_apiRequests + callWeight > m_maxApiRequestsWeight)
+    auto toNanoseconds(BINAPI_NAMESPACE::SlidingWindowLimit::clock::time_point time) noexcept -> int64_t
     {
-        return false;
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    }
+
+    /// HTTP headers are case-insensitive. HTTP/2 sends them in lower case
+    auto startsWith(std::string_view str, std::string_view prefix) noexcept -> bool
+    {
+        constexpr auto lower = [](char c) noexcept {
+            return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+        };
+        return str.size() >= prefix.size()
+               && std::equal(prefix.begin(), prefix.end(), str.begin(), [&lower](char a, char b) {
+                      return lower(a) == lower(b);
+                  });
     }
 
-    // If the operation is done after the limit and limit request is not reached reset api requests and reset the timer
-    if (span.count() > m_maxApiRequestsTsInterval && m_apiRequests < m_maxApiRequestsWeight)
+    auto toNumber(std::string_view str, long long &value) noexcept -> bool
     {
-        m_apiRequests = 0;
-        m_secondsNow  = std::chrono::seconds(0ll);
+        const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+        return ec == std::errc {} && ptr == str.data() + str.size();
     }
 
-    // Update the request for the time span (m_apiRequests) and the total api requests
-    m_apiRequests += callWeight;
-    m_totalRequests += callWeight;
+    /// Length of the window of the header suffix. "1m" in X-MBX-USED-WEIGHT-1M, "10s" in X-MBX-ORDER-COUNT-10S
+    auto headerInterval(std::string_view suffix) noexcept -> std::chrono::seconds
+    {
+        long long count = 0;
+        if (suffix.size() < 2 || !toNumber(suffix.substr(0, suffix.size() - 1), count))
+            return std::chrono::seconds { 0 };
 
-    // Allow the operation
-    return true;
+        switch (suffix.back())
+        {
+            case 's':
+            case 'S':
+                return std::chrono::seconds { count };
+            case 'm':
+            case 'M':
+                return std::chrono::minutes { count };
+            case 'h':
+            case 'H':
+                return std::chrono::hours { count };
+            case 'd':
+            case 'D':
+                return std::chrono::hours { 24 * count };
+            default:
+                return std::chrono::seconds { 0 };
+        }
+    }
+} // namespace
+
+BINAPI_NAMESPACE::SlidingWindowLimit::SlidingWindowLimit(long long limit, std::chrono::nanoseconds interval) noexcept
+{
+    setLimit(limit, interval);
 }
 
-bool BINAPI_NAMESPACE::BinanceLimits::secureOrderCall(const long long &callWeight)
+void BINAPI_NAMESPACE::SlidingWindowLimit::setLimit(long long limit, std::chrono::nanoseconds interval) noexcept
+{
+    // The weight of a slot is 32 bits wide. Higher limits are not counted at all
+    m_limit.store(limit, std::memory_order_relaxed);
+    m_slotLength.store(std::max<int64_t>(1, interval.count() / slots), std::memory_order_relaxed);
+
+    for (auto &slot : m_slots)
+        slot.store(0, std::memory_order_relaxed);
+}
+
+void BINAPI_NAMESPACE::SlidingWindowLimit::add(int64_t slot, long long weight) noexcept
 {
-    // Protect all reads and writes from other threads
-    std::lock_guard<std::mutex> lock(m_orderRequest);
-
-    // No requests. so m_seconds_now = 0 and we must initialized it to a valid time
-    if (m_secondsNowOrderLow.count() == 0)
-        m_secondsNowOrderLow = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch());
-    if (m_secondsNowOrderHigh.count() == 0)
-        m_secondsNowOrderHigh = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch());
-    // This variable sets the time right now
-    std::chrono::seconds secondsRightNow = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch());
-    // This Operations calculates the time elpased since right now from the m_seconds_now initialization
-    auto span_low         = secondsRightNow - m_secondsNowOrderLow;
-    auto span_high        = secondsRightNow - m_secondsNowOrderHigh;
-
-    m_lowRequestsSeconds  = span_low.count();
-    m_highRequestsSeconds = span_high.count();
-
-    // If time limit is reached this is
-    if (span_low.count() < m_maxApiOrdersTsIntervalLow && m_apiOrdersLow + callWeight > m_maxApiOrdersLow)
+    auto &entry          = m_slots[static_cast<std::size_t>(slot % slots)];
+    const auto number    = static_cast<uint32_t>(slot);
+    uint64_t stored      = entry.load(std::memory_order_relaxed);
+    uint64_t replacement = 0;
+    do
     {
-        return false;
+        // A slot holding an older number has left the window. Its weight no longer counts
+        const long long current = static_cast<uint32_t>(stored) == number ? static_cast<long long>(stored >> 32) : 0;
+        replacement             = (static_cast<uint64_t>(std::clamp<long long>(current + weight, 0, UINT32_MAX)) << 32) | number;
+    } while (!entry.compare_exchange_weak(stored, replacement, std::memory_order_acq_rel, std::memory_order_relaxed));
+}
+
+long long BINAPI_NAMESPACE::SlidingWindowLimit::sum(int64_t current, int64_t first) const noexcept
+{
+    long long total = 0;
+    for (const auto &entry : m_slots)
+    {
+        const uint64_t stored = entry.load(std::memory_order_acquire);
+        // Slot numbers are compared in 32 bits, which is enough for the slots of the window
+        const auto age = static_cast<uint32_t>(static_cast<uint32_t>(current) - static_cast<uint32_t>(stored));
+        if (age <= static_cast<uint32_t>(current - first))
+            total += static_cast<long long>(stored >> 32);
     }
-    // If the operation is done after the limit and limit request is not reached reset api requests and reset the timer
-    if (span_low.count() > m_maxApiOrdersTsIntervalLow && m_apiOrdersLow < m_maxApiOrdersLow)
+    return total;
+}
+
+std::chrono::nanoseconds BINAPI_NAMESPACE::SlidingWindowLimit::tryAcquire(long long weight, clock::time_point now, long long reserved) noexcept
+{
+    const long long maximum = m_limit.load(std::memory_order_relaxed);
+    if (weight <= 0 || maximum > INT32_MAX)
+        return std::chrono::nanoseconds { 0 };
+
+    // The reserved weight is left for others, so this call sees a lower limit
+    const long long limit = maximum - std::max(reserved, 0LL);
+
+    if (weight > limit)
+        return std::chrono::nanoseconds::max();
+
+    const int64_t nowNs   = toNanoseconds(now);
+    const int64_t blocked = m_blockedUntil.load(std::memory_order_relaxed);
+    if (nowNs < blocked)
+        return std::chrono::nanoseconds { blocked - nowNs };
+
+    const int64_t length  = m_slotLength.load(std::memory_order_relaxed);
+    const int64_t current = nowNs / length;
+
+    // Reserve first and check after, so two threads can not both take the last of the weight
+    add(current, weight);
+    const long long total = sum(current, current - slots + 1);
+    if (total <= limit)
+        return std::chrono::nanoseconds { 0 };
+
+    add(current, -weight);
+    return untilFree(total - limit, current, nowNs);
+}
+
+std::chrono::nanoseconds BINAPI_NAMESPACE::SlidingWindowLimit::waitFor(long long weight, clock::time_point now) const noexcept
+{
+    const long long limit = m_limit.load(std::memory_order_relaxed);
+    if (weight <= 0 || limit > INT32_MAX)
+        return std::chrono::nanoseconds { 0 };
+
+    if (weight > limit)
+        return std::chrono::nanoseconds::max();
+
+    const int64_t nowNs   = toNanoseconds(now);
+    const int64_t blocked = m_blockedUntil.load(std::memory_order_relaxed);
+    if (nowNs < blocked)
+        return std::chrono::nanoseconds { blocked - nowNs };
+
+    const int64_t current = nowNs / m_slotLength.load(std::memory_order_relaxed);
+    const long long total = sum(current, current - slots + 1) + weight;
+    return total <= limit ? std::chrono::nanoseconds { 0 } : untilFree(total - limit, current, nowNs);
+}
+
+std::chrono::nanoseconds BINAPI_NAMESPACE::SlidingWindowLimit::untilFree(long long excess, int64_t current, int64_t nowNs) const noexcept
+{
+    // Wait for the oldest slots holding the excess to leave the window
+    const int64_t length = m_slotLength.load(std::memory_order_relaxed);
+    for (int64_t slot = current - slots + 1; slot <= current; ++slot)
     {
-        m_apiOrdersLow       = 0;
-        m_secondsNowOrderLow = std::chrono::seconds(0ll);
+        excess -= sum(slot, slot);
+        if (excess <= 0)
+            return std::chrono::nanoseconds { (slot + slots) * length - nowNs };
     }
+    return std::chrono::nanoseconds { length };
+}
+
+void BINAPI_NAMESPACE::SlidingWindowLimit::release(long long weight, clock::time_point now) noexcept
+{
+    if (weight > 0 && m_limit.load(std::memory_order_relaxed) <= INT32_MAX)
+        add(toNanoseconds(now) / m_slotLength.load(std::memory_order_relaxed), -weight);
+}
+
+void BINAPI_NAMESPACE::SlidingWindowLimit::synchronize(long long used, bool authoritative, clock::time_point now) noexcept
+{
+    if (m_limit.load(std::memory_order_relaxed) > INT32_MAX)
+        return;
 
-    bool bLimitHighExceeded = false;
-    // If time limit is reached this is
-    if (span_high.count() < m_maxApiOrdersTsIntervalHigh && m_apiOrdersHigh > m_maxApiOrdersHigh)
+    const int64_t length  = m_slotLength.load(std::memory_order_relaxed);
+    const int64_t current = toNanoseconds(now) / length;
+    // First slot of the fixed window of the server
+    const int64_t first = current - current % slots;
+
+    if (authoritative)
     {
-        bLimitHighExceeded = true;
+        for (int64_t slot = current - slots + 1; slot < first; ++slot)
+            add(slot, -sum(slot, slot));
     }
-    // If the operation is done after the limit and limit request is not reached reset api requests and reset the timer
-    if (span_high.count() > m_maxApiOrdersTsIntervalHigh)
+
+    const long long difference = used - sum(current, first);
+    if (difference > 0 || authoritative)
+        add(current, difference);
+}
+
+void BINAPI_NAMESPACE::SlidingWindowLimit::block(clock::time_point until) noexcept
+{
+    const int64_t untilNs = toNanoseconds(until);
+
+    int64_t blocked = m_blockedUntil.load(std::memory_order_relaxed);
+    while (blocked < untilNs && !m_blockedUntil.compare_exchange_weak(blocked, untilNs, std::memory_order_relaxed))
     {
-        ;
-        // Only when the count is higher than m_maxApiOrdersTsIntervalHigh reset the counters
-        m_apiOrdersHigh       = 0;
-        m_secondsNowOrderHigh = std::chrono::seconds(0ll);
-        bLimitHighExceeded    = false;
     }
+}
 
-    // Do the operation taking care of Server Requests
-    if (bLimitHighExceeded)
-        return false;
+long long BINAPI_NAMESPACE::SlidingWindowLimit::used(clock::time_point now) const noexcept
+{
+    const int64_t current = toNanoseconds(now) / m_slotLength.load(std::memory_order_relaxed);
+    return sum(current, current - slots + 1);
+}
 
-    // Update the request for the time span (m_api_requests) and the total api requests
-    m_apiOrdersLow += callWeight;
-    m_totalOrdersLow += callWeight;
+std::chrono::nanoseconds BINAPI_NAMESPACE::SlidingWindowLimit::untilClear(clock::time_point now) const noexcept
+{
+    const int64_t nowNs   = toNanoseconds(now);
+    const int64_t length  = m_slotLength.load(std::memory_order_relaxed);
+    const int64_t current = nowNs / length;
 
-    m_apiOrdersHigh += callWeight;
-    m_totalOrdersHigh += callWeight;
+    for (int64_t slot = current; slot > current - slots; --slot)
+    {
+        if (sum(slot, slot) > 0)
+            return std::chrono::nanoseconds { (slot + slots) * length - nowNs };
+    }
+    return std::chrono::nanoseconds { 0 };
+}
 
-    // Return
+std::chrono::nanoseconds BINAPI_NAMESPACE::SlidingWindowLimit::blockedFor(clock::time_point now) const noexcept
+{
+    const int64_t left = m_blockedUntil.load(std::memory_order_relaxed) - toNanoseconds(now);
+    return std::chrono::nanoseconds { std::max<int64_t>(left, 0) };
+}
+
+bool BINAPI_NAMESPACE::BinanceLimits::secureCall(const long long &callWeight)
+{
+    return tryAcquire(callWeight, false).count() == 0;
+}
+
+bool BINAPI_NAMESPACE::BinanceLimits::secureOrderCall(const long long &callWeight)
+{
+    // The request weight is taken by secureCall
+    const auto now = SlidingWindowLimit::clock::now();
+
+    if (m_ordersLow.tryAcquire(callWeight, now).count() != 0)
+        return false;
+
+    if (m_ordersHigh.tryAcquire(callWeight, now).count() != 0)
+    {
+        m_ordersLow.release(callWeight, now);
+        return false;
+    }
+
+    m_totalOrders.fetch_add(callWeight, std::memory_order_relaxed);
     return true;
 }
 
+std::chrono::nanoseconds BINAPI_NAMESPACE::BinanceLimits::tryAcquire(const long long &callWeight, bool isOrderCall, long long reserved) noexcept
+{
+    const auto now = SlidingWindowLimit::clock::now();
+
+    const auto requestWait = m_requests.tryAcquire(callWeight, now, reserved);
+    if (requestWait.count() != 0)
+        return requestWait;
+
+    if (isOrderCall)
+    {
+        const auto lowWait = m_ordersLow.tryAcquire(callWeight, now);
+        if (lowWait.count() != 0)
+        {
+            m_requests.release(callWeight, now);
+            return lowWait;
+        }
+
+        const auto highWait = m_ordersHigh.tryAcquire(callWeight, now);
+        if (highWait.count() != 0)
+        {
+            m_ordersLow.release(callWeight, now);
+            m_requests.release(callWeight, now);
+            return highWait;
+        }
+
+        m_totalOrders.fetch_add(callWeight, std::memory_order_relaxed);
+    }
+
+    m_totalRequests.fetch_add(callWeight, std::memory_order_relaxed);
+    return std::chrono::nanoseconds { 0 };
+}
+
+std::chrono::nanoseconds BINAPI_NAMESPACE::BinanceLimits::getOrdersWait(const long long &callWeight) const noexcept
+{
+    const auto now = SlidingWindowLimit::clock::now();
+    return std::max(m_ordersLow.waitFor(callWeight, now), m_ordersHigh.waitFor(callWeight, now));
+}
+
+bool BINAPI_NAMESPACE::BinanceLimits::acquire(const long long &callWeight, bool isOrderCall, std::chrono::steady_clock::time_point deadline)
+{
+    for (;;)
+    {
+        const auto wait = tryAcquire(callWeight, isOrderCall);
+        if (wait.count() == 0)
+            return true;
+
+        // Other threads may take the capacity first, so the loop tries again after the wait
+        if (wait == std::chrono::nanoseconds::max() || std::chrono::steady_clock::now() + wait > deadline)
+            return false;
+
+        std::this_thread::sleep_for(wait);
+    }
+}
+
+BINAPI_NAMESPACE::BinanceLimits::Admission::Admission(BinanceLimits &limits, long long callWeight, bool isOrderCall) noexcept :
+    m_limits { &limits },
+    m_callWeight { callWeight },
+    m_isOrderCall { isOrderCall }
+{
+    m_limits->m_inFlightWeight.fetch_add(m_callWeight, std::memory_order_relaxed);
+    if (m_isOrderCall)
+        m_limits->m_inFlightOrders.fetch_add(m_callWeight, std::memory_order_relaxed);
+}
+
+BINAPI_NAMESPACE::BinanceLimits::Admission::~Admission()
+{
+    if (!m_inFlight)
+        return;
+
+    m_limits->m_inFlightWeight.fetch_sub(m_callWeight, std::memory_order_relaxed);
+    if (m_isOrderCall)
+        m_limits->m_inFlightOrders.fetch_sub(m_callWeight, std::memory_order_relaxed);
+}
+
+void BINAPI_NAMESPACE::BinanceLimits::Admission::completed(const cpr::Header &headers, long statusCode) noexcept
+{
+    if (!std::exchange(m_inFlight, false))
+        return;
+
+    // With other calls in flight the response may be older than what the server has already counted
+    const bool weightAuthoritative = m_limits->m_inFlightWeight.fetch_sub(m_callWeight, std::memory_order_relaxed) == m_callWeight;
+    const bool ordersAuthoritative = !m_isOrderCall || m_limits->m_inFlightOrders.fetch_sub(m_callWeight, std::memory_order_relaxed) == m_callWeight;
+
+    m_limits->synchronize(weightAuthoritative, ordersAuthoritative, headers, statusCode);
+}
+
+void BINAPI_NAMESPACE::BinanceLimits::synchronize(bool weightAuthoritative, bool ordersAuthoritative, const cpr::Header &headers, long statusCode) noexcept
+{
+    constexpr std::string_view usedWeight = "x-mbx-used-weight-";
+    constexpr std::string_view orderCount = "x-mbx-order-count-";
+
+    const auto now = SlidingWindowLimit::clock::now();
+
+    for (const auto &[header, value] : headers)
+    {
+        long long count = 0;
+
+        if (startsWith(header, usedWeight) && toNumber(value, count))
+        {
+            if (headerInterval(std::string_view { header }.substr(usedWeight.size())) == m_requests.getInterval())
+                m_requests.synchronize(count, weightAuthoritative, now);
+        }
+        else if (startsWith(header, orderCount) && toNumber(value, count))
+        {
+            const auto interval = headerInterval(std::string_view { header }.substr(orderCount.size()));
+            if (interval == m_ordersLow.getInterval())
+                m_ordersLow.synchronize(count, ordersAuthoritative, now);
+            else if (interval == m_ordersHigh.getInterval())
+                m_ordersHigh.synchronize(count, ordersAuthoritative, now);
+        }
+        else if ((statusCode == 418 || statusCode == 429) && startsWith(header, "retry-after") && toNumber(value, count))
+        {
+            // 429: the limit was broken. 418: the IP is banned after ignoring a 429
+            m_requests.block(now + std::chrono::seconds { count });
+        }
+    }
+}
+
+void BINAPI_NAMESPACE::BinanceLimits::setWaitForCapacity(std::chrono::milliseconds maxWait) noexcept
+{
+    m_waitForCapacity.store(maxWait.count(), std::memory_order_relaxed);
+}
+
 void BINAPI_NAMESPACE::BinanceLimits::setAPIRequestsLimits(const long long &max, const long long &interval) noexcept
 {
     // Timer counter is in seconds
-    m_maxApiRequestsWeight     = max;
-    m_maxApiRequestsTsInterval = interval;
+    m_requests.setLimit(max, std::chrono::seconds { interval });
 }
 
 void BINAPI_NAMESPACE::BinanceLimits::setAPIOrderLimitLow(const long long &max, const long long &interval) noexcept
 {
     // Timer counter is in seconds
-    m_maxApiOrdersLow           = max;
-    m_maxApiOrdersTsIntervalLow = interval;
+    m_ordersLow.setLimit(max, std::chrono::seconds { interval });
 }
+
 void BINAPI_NAMESPACE::BinanceLimits::setAPIOrderLimitHigh(const long long &max, const long long &interval) noexcept
 {
     // Timer counter is in seconds
-    m_maxApiOrdersHigh           = max;
-    m_maxApiOrdersTsIntervalHigh = interval;
+    m_ordersHigh.setLimit(max, std::chrono::seconds { interval });
 }
@@ -0,0 +1,362 @@
+////////////////////////////////////////////////////////////////////////////////
+// Created by Ricardo Romero on 17/10/2026 for BinanceAPI.
+// Copyright (c) 2026. Ricardo Romero
+// All rights reserved.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "BinanceAPIMetrics.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <functional>
+
+auto BINAPI_NAMESPACE::LatencyHistogram::bucketOf(uint64_t value) noexcept -> std::size_t
+{
+    constexpr uint64_t largest = (1ull << maxBits) - 1;
+    value                      = std::min(value, largest);
+
+    // The first two ranges are exact: one bucket per microsecond
+    if (value < 2 * subBuckets)
+        return static_cast<std::size_t>(value);
+
+    // Above, the subBucketBits + 1 most significant bits select the bucket
+    const auto shift = static_cast<uint32_t>(std::bit_width(value)) - 1 - subBucketBits;
+    return static_cast<std::size_t>(shift) * subBuckets + static_cast<std::size_t>(value >> shift);
+}
+
+auto BINAPI_NAMESPACE::LatencyHistogram::lowerBound(std::size_t bucket) noexcept -> uint64_t
+{
+    if (bucket < 2 * subBuckets)
+        return bucket;
+
+    const auto shift = bucket / subBuckets - 1;
+    return static_cast<uint64_t>(bucket % subBuckets + subBuckets) << shift;
+}
+
+auto BINAPI_NAMESPACE::LatencyHistogram::upperBound(std::size_t bucket) noexcept -> uint64_t
+{
+    if (bucket < 2 * subBuckets)
+        return bucket;
+
+    const auto shift = bucket / subBuckets - 1;
+    return lowerBound(bucket) + (1ull << shift) - 1;
+}
+
+auto BINAPI_NAMESPACE::LatencyHistogram::record(std::chrono::microseconds value) noexcept -> void
+{
+    const auto micro = static_cast<uint64_t>(std::max<std::chrono::microseconds::rep>(value.count(), 0));
+
+    m_counts[bucketOf(micro)].fetch_add(1, std::memory_order_relaxed);
+    m_total.fetch_add(micro, std::memory_order_relaxed);
+
+    uint64_t max = m_max.load(std::memory_order_relaxed);
+    while (micro > max && !m_max.compare_exchange_weak(max, micro, std::memory_order_relaxed))
+        ;
+}
+
+auto BINAPI_NAMESPACE::LatencyHistogram::snapshot() const noexcept -> Snapshot
+{
+    // The count is taken from the buckets, so the percentiles add up even if values are recorded meanwhile
+    Snapshot snapshot;
+    for (std::size_t i = 0; i < bucketCount; ++i)
+    {
+        snapshot.counts[i] = m_counts[i].load(std::memory_order_relaxed);
+        snapshot.count += snapshot.counts[i];
+    }
+    snapshot.total = m_total.load(std::memory_order_relaxed);
+    snapshot.max   = m_max.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+auto BINAPI_NAMESPACE::LatencyHistogram::Snapshot::percentile(double quantile) const noexcept -> std::chrono::microseconds
+{
+    if (count == 0)
+        return std::chrono::microseconds { 0 };
+
+    const auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(std::clamp(quantile, 0.0, 1.0) * static_cast<double>(count))));
+
+    uint64_t seen = 0;
+    for (std::size_t i = 0; i < bucketCount; ++i)
+    {
+        seen += counts[i];
+        // Never above the largest value recorded
+        if (seen >= rank)
+            return std::chrono::microseconds { static_cast<std::chrono::microseconds::rep>(std::min(upperBound(i), std::max(max, lowerBound(i)))) };
+    }
+    return std::chrono::microseconds { static_cast<std::chrono::microseconds::rep>(max) };
+}
+
+auto BINAPI_NAMESPACE::LatencyHistogram::Snapshot::mean() const noexcept -> std::chrono::microseconds
+{
+    return std::chrono::microseconds { count == 0 ? 0 : static_cast<std::chrono::microseconds::rep>(total / count) };
+}
+
+namespace
+{
+    // Open addressing. A slot is written once, from null to its entry
+    template <typename Entry, std::size_t Slots>
+    auto findOrAdd(std::array<std::atomic<Entry *>, Slots> &slots, std::string_view name) noexcept -> Entry *
+    {
+        const auto start = std::hash<std::string_view> {}(name) % Slots;
+
+        for (std::size_t probe = 0; probe < Slots; ++probe)
+        {
+            auto &slot   = slots[(start + probe) % Slots];
+            Entry *entry = slot.load(std::memory_order_acquire);
+
+            if (entry == nullptr)
+            {
+                Entry *created = nullptr;
+                try
+                {
+                    created = new Entry(name);
+                } catch (...)
+                {
+                    return nullptr;
+                }
+
+                if (slot.compare_exchange_strong(entry, created, std::memory_order_acq_rel, std::memory_order_acquire))
+                    return created;
+
+                // Another thread took the slot first. entry now holds its value
+                delete created;
+            }
+
+            if (entry->name == name)
+                return entry;
+        }
+        return nullptr;
+    }
+
+    template <typename Entry, std::size_t Slots>
+    auto findEntry(const std::array<std::atomic<Entry *>, Slots> &slots, std::string_view name) noexcept -> const Entry *
+    {
+        const auto start = std::hash<std::string_view> {}(name) % Slots;
+
+        for (std::size_t probe = 0; probe < Slots; ++probe)
+        {
+            const Entry *entry = slots[(start + probe) % Slots].load(std::memory_order_acquire);
+            if (entry == nullptr)
+                return nullptr;
+            if (entry->name == name)
+                return entry;
+        }
+        return nullptr;
+    }
+
+    auto microseconds(std::chrono::steady_clock::duration duration) noexcept -> std::chrono::microseconds
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(duration);
+    }
+} // namespace
+
+BINAPI_NAMESPACE::RequestMetrics::RequestMetrics() noexcept = default;
+
+BINAPI_NAMESPACE::RequestMetrics::~RequestMetrics()
+{
+    for (auto &slot : m_endPoints)
+        delete slot.load(std::memory_order_acquire);
+}
+
+auto BINAPI_NAMESPACE::RequestMetrics::endPoint(std::string_view name) noexcept -> Endpoint *
+{
+    return findOrAdd(m_endPoints, name);
+}
+
+auto BINAPI_NAMESPACE::RequestMetrics::find(std::string_view name) const noexcept -> const Endpoint *
+{
+    return findEntry(m_endPoints, name);
+}
+
+auto BINAPI_NAMESPACE::RequestMetrics::recordTransfer(std::string_view name, const TransferTimings &timings, long long callWeight) noexcept -> void
+{
+    Endpoint *endPoint = this->endPoint(name);
+    if (endPoint == nullptr)
+        return;
+
+    endPoint->latency[static_cast<std::size_t>(RequestPhase::dns)].record(timings.dns);
+    endPoint->latency[static_cast<std::size_t>(RequestPhase::connect)].record(timings.connect);
+    endPoint->latency[static_cast<std::size_t>(RequestPhase::tls)].record(timings.tls);
+    endPoint->latency[static_cast<std::size_t>(RequestPhase::wait)].record(timings.wait);
+    endPoint->latency[static_cast<std::size_t>(RequestPhase::transfer)].record(timings.transfer);
+
+    endPoint->transfers.fetch_add(1, std::memory_order_relaxed);
+    endPoint->weight.fetch_add(static_cast<uint64_t>(std::max(callWeight, 0LL)), std::memory_order_relaxed);
+}
+
+auto BINAPI_NAMESPACE::RequestMetrics::recordPhase(std::string_view name, RequestPhase phase, std::chrono::microseconds value) noexcept -> void
+{
+    if (Endpoint *endPoint = this->endPoint(name); endPoint != nullptr)
+        endPoint->latency[static_cast<std::size_t>(phase)].record(value);
+}
+
+auto BINAPI_NAMESPACE::RequestMetrics::recordError(std::string_view name, APIException::Type type) noexcept -> void
+{
+    if (Endpoint *endPoint = this->endPoint(name); endPoint != nullptr)
+        endPoint->errors[static_cast<std::size_t>(type)].fetch_add(1, std::memory_order_relaxed);
+}
+
+auto BINAPI_NAMESPACE::RequestMetrics::copy(const Endpoint &endPoint) -> EndpointMetricsSnapshot
+{
+    EndpointMetricsSnapshot snapshot;
+    snapshot.endPoint = endPoint.name;
+    for (std::size_t i = 0; i < requestPhases; ++i)
+        snapshot.latency[i] = endPoint.latency[i].snapshot();
+    snapshot.transfers = endPoint.transfers.load(std::memory_order_relaxed);
+    snapshot.weight    = endPoint.weight.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < exceptionTypes; ++i)
+        snapshot.errors[i] = endPoint.errors[i].load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+auto BINAPI_NAMESPACE::RequestMetrics::snapshot() const -> std::vector<EndpointMetricsSnapshot>
+{
+    std::vector<EndpointMetricsSnapshot> snapshots;
+    for (const auto &slot : m_endPoints)
+    {
+        if (const Endpoint *endPoint = slot.load(std::memory_order_acquire); endPoint != nullptr)
+            snapshots.push_back(copy(*endPoint));
+    }
+
+    std::sort(snapshots.begin(), snapshots.end(), [](const auto &a, const auto &b) { return a.endPoint < b.endPoint; });
+    return snapshots;
+}
+
+auto BINAPI_NAMESPACE::RequestMetrics::snapshot(std::string_view name) const -> std::optional<EndpointMetricsSnapshot>
+{
+    if (const Endpoint *endPoint = find(name); endPoint != nullptr)
+        return copy(*endPoint);
+    return std::nullopt;
+}
+
+auto BINAPI_NAMESPACE::ClockOffset::sample(uint64_t serverTime, std::chrono::system_clock::time_point sent, std::chrono::system_clock::time_point received) noexcept -> void
+{
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    const auto roundTrip = std::max(duration_cast<microseconds>(received - sent), microseconds { 0 });
+    const auto midpoint  = duration_cast<microseconds>(sent.time_since_epoch()) + roundTrip / 2;
+    const Sample taken { .offset = microseconds { static_cast<int64_t>(serverTime) * 1000 } - midpoint, .roundTrip = roundTrip };
+
+    std::scoped_lock lock(m_mutex);
+    m_samples[m_samplesTaken % samplesKept] = taken;
+    ++m_samplesTaken;
+
+    const auto last = m_samples.begin() + static_cast<std::ptrdiff_t>(std::min(m_samplesTaken, samplesKept));
+    const auto best = std::min_element(m_samples.begin(), last, [](const Sample &a, const Sample &b) { return a.roundTrip < b.roundTrip; });
+
+    m_offset.store(best->offset.count(), std::memory_order_relaxed);
+    m_roundTrip.store(best->roundTrip.count(), std::memory_order_release);
+}
+
+auto BINAPI_NAMESPACE::ClockOffset::offset() const noexcept -> std::optional<std::chrono::microseconds>
+{
+    if (m_roundTrip.load(std::memory_order_acquire) < 0)
+        return std::nullopt;
+    return std::chrono::microseconds { m_offset.load(std::memory_order_relaxed) };
+}
+
+auto BINAPI_NAMESPACE::ClockOffset::roundTrip() const noexcept -> std::optional<std::chrono::microseconds>
+{
+    const int64_t roundTrip = m_roundTrip.load(std::memory_order_acquire);
+    if (roundTrip < 0)
+        return std::nullopt;
+    return std::chrono::microseconds { roundTrip };
+}
+
+auto BINAPI_NAMESPACE::ClockOffset::toLocal(uint64_t exchangeTime) const noexcept -> std::chrono::system_clock::time_point
+{
+    const std::chrono::microseconds exchange { static_cast<int64_t>(exchangeTime) * 1000 };
+    return std::chrono::system_clock::time_point { std::chrono::duration_cast<std::chrono::system_clock::duration>(exchange - offset().value_or(std::chrono::microseconds { 0 })) };
+}
+
+BINAPI_NAMESPACE::StreamMetrics::StreamMetrics() noexcept = default;
+
+BINAPI_NAMESPACE::StreamMetrics::~StreamMetrics()
+{
+    for (auto &slot : m_streams)
+        delete slot.load(std::memory_order_acquire);
+}
+
+auto BINAPI_NAMESPACE::StreamMetrics::setClockOffset(const ClockOffset *clock) noexcept -> void
+{
+    m_clock.store(clock, std::memory_order_release);
+}
+
+auto BINAPI_NAMESPACE::StreamMetrics::network(const StreamTimings &timings) const noexcept -> std::optional<std::chrono::microseconds>
+{
+    const ClockOffset *clock = m_clock.load(std::memory_order_acquire);
+    if (clock == nullptr || !clock->offset().has_value())
+        return std::nullopt;
+
+    return std::chrono::duration_cast<std::chrono::microseconds>(timings.received - clock->toLocal(timings.eventTime));
+}
+
+auto BINAPI_NAMESPACE::StreamMetrics::recordParsed(std::string_view name, const StreamTimings &timings) noexcept -> void
+{
+    Stream *stream = findOrAdd(m_streams, name);
+    if (stream == nullptr)
+        return;
+
+    if (const auto network = this->network(timings); network.has_value())
+        stream->latency[static_cast<std::size_t>(StreamStage::network)].record(*network);
+    stream->latency[static_cast<std::size_t>(StreamStage::parse)].record(microseconds(timings.parsed - timings.receivedSteady));
+    stream->events.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto BINAPI_NAMESPACE::StreamMetrics::recordDispatched(std::string_view name, const StreamTimings &timings) noexcept -> void
+{
+    if (Stream *stream = findOrAdd(m_streams, name); stream != nullptr)
+        stream->latency[static_cast<std::size_t>(StreamStage::dispatch)].record(microseconds(timings.dispatched - timings.parsed));
+}
+
+auto BINAPI_NAMESPACE::StreamMetrics::recordRendered(std::string_view name, const StreamTimings &timings, std::chrono::steady_clock::time_point rendered) noexcept -> void
+{
+    Stream *stream = findOrAdd(m_streams, name);
+    if (stream == nullptr)
+        return;
+
+    // Events drawn in the thread that parsed them were never dispatched
+    const auto start = timings.dispatched == std::chrono::steady_clock::time_point {} ? timings.parsed : timings.dispatched;
+    stream->latency[static_cast<std::size_t>(StreamStage::render)].record(microseconds(rendered - start));
+
+    if (const auto network = this->network(timings); network.has_value())
+        stream->latency[static_cast<std::size_t>(StreamStage::total)].record(*network + microseconds(rendered - timings.receivedSteady));
+}
+
+auto BINAPI_NAMESPACE::StreamMetrics::record(std::string_view name, StreamStage stage, std::chrono::microseconds value) noexcept -> void
+{
+    if (Stream *stream = findOrAdd(m_streams, name); stream != nullptr)
+        stream->latency[static_cast<std::size_t>(stage)].record(value);
+}
+
+auto BINAPI_NAMESPACE::StreamMetrics::copy(const Stream &stream) -> StreamMetricsSnapshot
+{
+    StreamMetricsSnapshot snapshot;
+    snapshot.stream = stream.name;
+    for (std::size_t i = 0; i < streamStages; ++i)
+        snapshot.latency[i] = stream.latency[i].snapshot();
+    snapshot.events = stream.events.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+auto BINAPI_NAMESPACE::StreamMetrics::snapshot() const -> std::vector<StreamMetricsSnapshot>
+{
+    std::vector<StreamMetricsSnapshot> snapshots;
+    for (const auto &slot : m_streams)
+    {
+        if (const Stream *stream = slot.load(std::memory_order_acquire); stream != nullptr)
+            snapshots.push_back(copy(*stream));
+    }
+
+    std::sort(snapshots.begin(), snapshots.end(), [](const auto &a, const auto &b) { return a.stream < b.stream; });
+    return snapshots;
+}
+
+auto BINAPI_NAMESPACE::StreamMetrics::snapshot(std::string_view name) const -> std::optional<StreamMetricsSnapshot>
+{
+    if (const Stream *stream = findEntry(m_streams, name); stream != nullptr)
+        return copy(*stream);
+    return std::nullopt;
+}
@@ -0,0 +1,390 @@
+////////////////////////////////////////////////////////////////////////////////
+// Created by Ricardo Romero on 17/10/2026 for BinanceAPI.
+// Copyright (c) 2026. Ricardo Romero
+// All rights reserved.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "BinanceAPIOrderBook.hpp"
+
+#include <algorithm>
+
+BINAPI_NAMESPACE::OrderBookSide::OrderBookSide(BookSide side) noexcept :
+    m_side { side }
+{
+}
+
+auto BINAPI_NAMESPACE::OrderBookSide::position(currency_t price) const noexcept -> std::size_t
+{
+    // Bids go up to the highest price and asks go down to the lowest one
+    const auto level = m_side == BookSide::bids
+                           ? std::lower_bound(m_levels.begin(), m_levels.end(), price, [](const PriceLevel &level, currency_t price) { return level.price < price; })
+                           : std::lower_bound(m_levels.begin(), m_levels.end(), price, [](const PriceLevel &level, currency_t price) { return level.price > price; });
+    return static_cast<std::size_t>(level - m_levels.begin());
+}
+
+auto BINAPI_NAMESPACE::OrderBookSide::set(currency_t price, quantity_t quantity) -> void
+{
+    const std::size_t index = position(price);
+    const bool exists       = index < m_levels.size() && m_levels[index].price == price;
+    const auto level        = m_levels.begin() + static_cast<std::ptrdiff_t>(index);
+
+    if (quantity <= 0.0)
+    {
+        // Removing a level that is not in the book is normal
+        if (exists)
+            m_levels.erase(level);
+    }
+    else if (exists)
+        level->quantity = quantity;
+    else
+        m_levels.insert(level, PriceLevel { price, quantity });
+}
+
+auto BINAPI_NAMESPACE::OrderBookSide::clear() noexcept -> void
+{
+    m_levels.clear();
+}
+
+auto BINAPI_NAMESPACE::OrderBookSide::reserve(std::size_t levels) -> void
+{
+    m_levels.reserve(levels);
+}
+
+auto BINAPI_NAMESPACE::OrderBookSide::best() const noexcept -> std::optional<PriceLevel>
+{
+    if (m_levels.empty())
+        return std::nullopt;
+    return m_levels.back();
+}
+
+auto BINAPI_NAMESPACE::OrderBookSide::top(std::size_t levels) const noexcept -> std::ranges::subrange<const_iterator>
+{
+    return { m_levels.rbegin(), m_levels.rbegin() + static_cast<std::ptrdiff_t>(std::min(levels, m_levels.size())) };
+}
+
+auto BINAPI_NAMESPACE::OrderBookSide::quantity(currency_t price) const noexcept -> quantity_t
+{
+    const std::size_t index = position(price);
+    return index < m_levels.size() && m_levels[index].price == price ? m_levels[index].quantity : 0.0;
+}
+
+auto BINAPI_NAMESPACE::OrderBookSide::side() const noexcept -> BookSide
+{
+    return m_side;
+}
+
+auto BINAPI_NAMESPACE::OrderBookSide::size() const noexcept -> std::size_t
+{
+    return m_levels.size();
+}
+
+auto BINAPI_NAMESPACE::OrderBookSide::empty() const noexcept -> bool
+{
+    return m_levels.empty();
+}
+
+auto BINAPI_NAMESPACE::OrderBookSide::begin() const noexcept -> const_iterator
+{
+    return m_levels.rbegin();
+}
+
+auto BINAPI_NAMESPACE::OrderBookSide::end() const noexcept -> const_iterator
+{
+    return m_levels.rend();
+}
+
+BINAPI_NAMESPACE::OrderBook::OrderBook(OrderBookSequencing sequencing, std::size_t maxBuffered) :
+    m_sequencing { sequencing },
+    m_maxBuffered { std::max<std::size_t>(maxBuffered, 1) }
+{
+}
+
+auto BINAPI_NAMESPACE::OrderBook::isStale(const StreamDepthUpdate &diff) const noexcept -> bool
+{
+    if (m_sequencing == OrderBookSequencing::spot)
+        return diff.finalUpdateId <= m_lastUpdateId;
+    return diff.finalUpdateId < m_lastUpdateId;
+}
+
+auto BINAPI_NAMESPACE::OrderBook::follows(const StreamDepthUpdate &diff) const noexcept -> bool
+{
+    if (m_sequencing == OrderBookSequencing::spot)
+    {
+        // The first diff contains lastUpdateId + 1; the next ones start right after the previous one
+        if (m_first)
+            return diff.firstUpdateId <= m_lastUpdateId + 1 && diff.finalUpdateId >= m_lastUpdateId + 1;
+        return diff.firstUpdateId == m_lastUpdateId + 1;
+    }
+
+    // The first diff contains lastUpdateId; the next ones point to the previous one
+    if (m_first)
+        return diff.firstUpdateId <= m_lastUpdateId && diff.finalUpdateId >= m_lastUpdateId;
+    return diff.finalUpdateIdLastStream == m_lastUpdateId;
+}
+
+auto BINAPI_NAMESPACE::OrderBook::apply(const StreamDepthUpdate &diff) -> void
+{
+    for (const auto &[price, quantity] : diff.bids)
+        m_bids.set(price, quantity);
+    for (const auto &[price, quantity] : diff.asks)
+        m_asks.set(price, quantity);
+
+    m_lastUpdateId = diff.finalUpdateId;
+    m_first        = false;
+}
+
+auto BINAPI_NAMESPACE::OrderBook::clearLevels() noexcept -> void
+{
+    m_bids.clear();
+    m_asks.clear();
+    m_synchronized = false;
+    m_first        = true;
+    m_lastUpdateId = 0;
+}
+
+auto BINAPI_NAMESPACE::OrderBook::update(Snapshot<StreamDepthUpdate> diff) -> OrderBookStatus
+{
+    if (!m_synchronized)
+    {
+        m_buffer.push_back(std::move(diff));
+        if (m_buffer.size() > m_maxBuffered)
+            m_buffer.pop_front();
+        return OrderBookStatus::buffered;
+    }
+
+    if (isStale(*diff))
+        return OrderBookStatus::stale;
+
+    if (!follows(*diff))
+    {
+        clearLevels();
+        m_buffer.clear();
+        m_buffer.push_back(std::move(diff));
+        return OrderBookStatus::outOfSync;
+    }
+
+    apply(*diff);
+    return OrderBookStatus::applied;
+}
+
+auto BINAPI_NAMESPACE::OrderBook::snapshot(const SPOT::OrderBook &book) -> bool
+{
+    clearLevels();
+
+    // The answer has the best price first. Added from the worst one, every level goes at the end of its side
+    m_bids.reserve(book.bids.size());
+    m_asks.reserve(book.asks.size());
+    for (auto level = book.bids.rbegin(); level != book.bids.rend(); ++level)
+        m_bids.set(level->price, level->quantity);
+    for (auto level = book.asks.rbegin(); level != book.asks.rend(); ++level)
+        m_asks.set(level->price, level->quantity);
+
+    m_lastUpdateId = book.lastUpdateId;
+    m_synchronized = true;
+
+    while (!m_buffer.empty() && isStale(*m_buffer.front()))
+        m_buffer.pop_front();
+
+    while (!m_buffer.empty())
+    {
+        if (!follows(*m_buffer.front()))
+        {
+            // The snapshot is older than the diffs, or a diff between them was lost. The rest waits for a newer snapshot
+            clearLevels();
+            return false;
+        }
+
+        apply(*m_buffer.front());
+        m_buffer.pop_front();
+    }
+    return true;
+}
+
+auto BINAPI_NAMESPACE::OrderBook::reset() -> void
+{
+    clearLevels();
+    m_buffer.clear();
+}
+
+auto BINAPI_NAMESPACE::OrderBook::synchronized() const noexcept -> bool
+{
+    return m_synchronized;
+}
+
+auto BINAPI_NAMESPACE::OrderBook::lastUpdateId() const noexcept -> uint64_t
+{
+    return m_lastUpdateId;
+}
+
+auto BINAPI_NAMESPACE::OrderBook::buffered() const noexcept -> std::size_t
+{
+    return m_buffer.size();
+}
+
+auto BINAPI_NAMESPACE::OrderBook::bids() const noexcept -> const OrderBookSide &
+{
+    return m_bids;
+}
+
+auto BINAPI_NAMESPACE::OrderBook::asks() const noexcept -> const OrderBookSide &
+{
+    return m_asks;
+}
+
+auto BINAPI_NAMESPACE::OrderBook::bestBid() const noexcept -> std::optional<PriceLevel>
+{
+    return m_bids.best();
+}
+
+auto BINAPI_NAMESPACE::OrderBook::bestAsk() const noexcept -> std::optional<PriceLevel>
+{
+    return m_asks.best();
+}
+
+BINAPI_NAMESPACE::OrderBookSnapshots::OrderBookSnapshots(std::chrono::milliseconds initialDelay, std::chrono::milliseconds maxDelay) noexcept :
+    m_initialDelay { initialDelay },
+    m_maxDelay { maxDelay }
+{
+}
+
+auto BINAPI_NAMESPACE::OrderBookSnapshots::request(const std::string &symbol, clock::time_point now) -> std::optional<uint64_t>
+{
+    auto &state = m_symbols[symbol];
+    // The diffs received meanwhile are buffered by the book and applied over the snapshot of the request in flight
+    if (state.request != 0 || (state.failures > 0 && now < state.retryAt))
+        return std::nullopt;
+
+    state.request = ++m_lastRequest;
+    return state.request;
+}
+
+auto BINAPI_NAMESPACE::OrderBookSnapshots::completed(const std::string &symbol, uint64_t request) -> bool
+{
+    const auto state = m_symbols.find(symbol);
+    if (state == m_symbols.end() || state->second.request != request)
+        return false;
+
+    state->second = {};
+    return true;
+}
+
+auto BINAPI_NAMESPACE::OrderBookSnapshots::failed(const std::string &symbol, uint64_t request, clock::time_point now, std::chrono::nanoseconds retryAfter) -> bool
+{
+    const auto state = m_symbols.find(symbol);
+    if (state == m_symbols.end() || state->second.request != request)
+        return false;
+
+    auto &failedSymbol   = state->second;
+    failedSymbol.request = 0;
+    ++failedSymbol.failures;
+
+    // initialDelay, twice as much, four times... up to maxDelay. Beyond 2^20 the delay is the maximum anyway
+    const auto backoff   = std::min<std::chrono::nanoseconds>(m_initialDelay * (int64_t { 1 } << std::min<uint32_t>(failedSymbol.failures - 1, 20)), m_maxDelay);
+    failedSymbol.retryAt = now + std::max(backoff, retryAfter);
+    return true;
+}
+
+auto BINAPI_NAMESPACE::OrderBookSnapshots::erase(const std::string &symbol) -> void
+{
+    m_symbols.erase(symbol);
+}
+
+auto BINAPI_NAMESPACE::OrderBookSnapshots::pending(const std::string &symbol) const -> std::optional<uint64_t>
+{
+    const auto state = m_symbols.find(symbol);
+    if (state == m_symbols.end() || state->second.request == 0)
+        return std::nullopt;
+    return state->second.request;
+}
+
+auto BINAPI_NAMESPACE::OrderBookSnapshots::retryAt(const std::string &symbol) const -> std::optional<clock::time_point>
+{
+    const auto state = m_symbols.find(symbol);
+    if (state == m_symbols.end() || state->second.failures == 0)
+        return std::nullopt;
+    return state->second.retryAt;
+}
+
+BINAPI_NAMESPACE::BookConflator::BookConflator(const OrderBook &book) noexcept :
+    m_book { book }
+{
+}
+
+auto BINAPI_NAMESPACE::BookConflator::subscribe(std::size_t levels, std::chrono::milliseconds interval, Subscriber subscriber) -> uint32_t
+{
+    m_subscriptions.push_back({ .id = ++m_lastId, .levels = levels, .interval = interval, .subscriber = std::move(subscriber) });
+    return m_lastId;
+}
+
+auto BINAPI_NAMESPACE::BookConflator::unsubscribe(uint32_t id) -> void
+{
+    std::erase_if(m_subscriptions, [id](const Subscription &subscription) { return subscription.id == id; });
+}
+
+auto BINAPI_NAMESPACE::BookConflator::changed(uint64_t eventTime, clock::time_point now) -> void
+{
+    m_eventTime = eventTime;
+    m_top.reset();
+
+    for (auto &subscription : m_subscriptions)
+    {
+        if (subscription.interval.count() > 0)
+        {
+            subscription.pending = true;
+            continue;
+        }
+
+        if (m_book.synchronized())
+        {
+            subscription.subscriber(top(subscription.levels));
+            subscription.published = now;
+        }
+    }
+}
+
+auto BINAPI_NAMESPACE::BookConflator::poll(clock::time_point now) -> std::optional<clock::time_point>
+{
+    // A book waiting for a snapshot is not published; the subscribers are updated with the first change after it
+    if (!m_book.synchronized())
+        return std::nullopt;
+
+    std::optional<clock::time_point> next;
+    for (auto &subscription : m_subscriptions)
+    {
+        if (!subscription.pending)
+            continue;
+
+        const auto due = subscription.published + subscription.interval;
+        if (now < due)
+        {
+            next = next.has_value() ? std::min(*next, due) : due;
+            continue;
+        }
+
+        subscription.subscriber(top(subscription.levels));
+        subscription.published = now;
+        subscription.pending   = false;
+    }
+    return next;
+}
+
+auto BINAPI_NAMESPACE::BookConflator::subscribers() const noexcept -> std::size_t
+{
+    return m_subscriptions.size();
+}
+
+auto BINAPI_NAMESPACE::BookConflator::top(std::size_t levels) -> Snapshot<BookTop>
+{
+    if (m_top != nullptr && m_topLevels == levels)
+        return m_top;
+
+    BookTop top { .lastUpdateId = m_book.lastUpdateId(), .eventTime = m_eventTime, .bids = {}, .asks = {} };
+    const auto bids = m_book.bids().top(levels);
+    const auto asks = m_book.asks().top(levels);
+    top.bids.assign(bids.begin(), bids.end());
+    top.asks.assign(asks.begin(), asks.end());
+
+    m_top       = makeSnapshot<BookTop>(std::move(top));
+    m_topLevels = levels;
+    return m_top;
+}
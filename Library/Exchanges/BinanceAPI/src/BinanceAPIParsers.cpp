@@ -0,0 +1,838 @@
+////////////////////////////////////////////////////////////////////////////////
+// Created by Ricardo Romero on 17/10/2026 for BinanceAPI.
+// Copyright (c) 2026. Ricardo Romero
+// All rights reserved.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "BinanceAPIParsers.hpp"
+#include "BinanceAPIArena.hpp"
+#include "BinanceAPINumeric.hpp"
+
+#include <fmt/format.h>
+#include <limits>
+#include <rapidjson/memorystream.h>
+
+BINAPI_NAMESPACE::local::TypedHandler::~TypedHandler() = default;
+
+auto BINAPI_NAMESPACE::local::TypedHandler::Null() -> bool
+{
+    return scalar({});
+}
+
+auto BINAPI_NAMESPACE::local::TypedHandler::Bool(bool b) -> bool
+{
+    return scalar({ .type = Scalar::Type::boolean, .boolean = b });
+}
+
+auto BINAPI_NAMESPACE::local::TypedHandler::Int(int i) -> bool
+{
+    return scalar({ .type = Scalar::Type::integer, .integer = i });
+}
+
+auto BINAPI_NAMESPACE::local::TypedHandler::Uint(unsigned u) -> bool
+{
+    return scalar({ .type = Scalar::Type::integer, .integer = u });
+}
+
+auto BINAPI_NAMESPACE::local::TypedHandler::Int64(int64_t i) -> bool
+{
+    return scalar({ .type = Scalar::Type::integer, .integer = i });
+}
+
+auto BINAPI_NAMESPACE::local::TypedHandler::Uint64(uint64_t u) -> bool
+{
+    if (u > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))
+        return fail("integer out of range");
+    return scalar({ .type = Scalar::Type::integer, .integer = static_cast<int64_t>(u) });
+}
+
+auto BINAPI_NAMESPACE::local::TypedHandler::Double(double d) -> bool
+{
+    return scalar({ .type = Scalar::Type::real, .real = d });
+}
+
+auto BINAPI_NAMESPACE::local::TypedHandler::RawNumber(const char *, rapidjson::SizeType, bool) -> bool
+{
+    return fail("raw numbers are not supported");
+}
+
+auto BINAPI_NAMESPACE::local::TypedHandler::String(const char *str, rapidjson::SizeType length, bool) -> bool
+{
+    return scalar({ .type = Scalar::Type::string, .string = { str, length } });
+}
+
+auto BINAPI_NAMESPACE::local::TypedHandler::StartObject() -> bool
+{
+    if (!onStart(false))
+        return false;
+
+    // Frames are reused, so the keys do not allocate once the deepest level has been reached
+    if (m_frames.size() == m_depth)
+        m_frames.emplace_back();
+    auto &frame = m_frames[m_depth++];
+    frame.key.clear();
+    frame.index   = 0;
+    frame.isArray = false;
+    return true;
+}
+
+auto BINAPI_NAMESPACE::local::TypedHandler::Key(const char *str, rapidjson::SizeType length, bool) -> bool
+{
+    m_frames[m_depth - 1].key.assign(str, length);
+    return true;
+}
+
+auto BINAPI_NAMESPACE::local::TypedHandler::EndObject(rapidjson::SizeType memberCount) -> bool
+{
+    --m_depth;
+    if (!onEnd(false, memberCount))
+        return false;
+
+    if (m_depth > 0 && m_frames[m_depth - 1].isArray)
+        ++m_frames[m_depth - 1].index;
+    return true;
+}
+
+auto BINAPI_NAMESPACE::local::TypedHandler::StartArray() -> bool
+{
+    if (!onStart(true))
+        return false;
+
+    if (m_frames.size() == m_depth)
+        m_frames.emplace_back();
+    auto &frame = m_frames[m_depth++];
+    frame.key.clear();
+    frame.index   = 0;
+    frame.isArray = true;
+    return true;
+}
+
+auto BINAPI_NAMESPACE::local::TypedHandler::EndArray(rapidjson::SizeType elementCount) -> bool
+{
+    --m_depth;
+    if (!onEnd(true, elementCount))
+        return false;
+
+    if (m_depth > 0 && m_frames[m_depth - 1].isArray)
+        ++m_frames[m_depth - 1].index;
+    return true;
+}
+
+auto BINAPI_NAMESPACE::local::TypedHandler::getError() const noexcept -> const std::string &
+{
+    return m_error;
+}
+
+auto BINAPI_NAMESPACE::local::TypedHandler::depth() const noexcept -> std::size_t
+{
+    return m_depth;
+}
+
+auto BINAPI_NAMESPACE::local::TypedHandler::key(std::size_t level) const noexcept -> std::string_view
+{
+    return m_frames[level].key;
+}
+
+auto BINAPI_NAMESPACE::local::TypedHandler::index(std::size_t level) const noexcept -> uint32_t
+{
+    return m_frames[level].index;
+}
+
+auto BINAPI_NAMESPACE::local::TypedHandler::currentKey() const noexcept -> std::string_view
+{
+    if (m_depth == 0)
+        return {};
+    return m_frames[m_depth - 1].key;
+}
+
+auto BINAPI_NAMESPACE::local::TypedHandler::fail(std::string_view reason) -> bool
+{
+    m_error.assign(reason);
+    if (m_depth > 0)
+        m_error.append(fmt::format(". At: {}", m_frames[m_depth - 1].isArray ? fmt::to_string(m_frames[m_depth - 1].index) : m_frames[m_depth - 1].key));
+    return false;
+}
+
+auto BINAPI_NAMESPACE::local::TypedHandler::get(const Scalar &value, std::string &out) -> bool
+{
+    if (value.type != Scalar::Type::string)
+        return fail("string expected");
+    out.assign(value.string);
+    return true;
+}
+
+auto BINAPI_NAMESPACE::local::TypedHandler::get(const Scalar &value, double &out) -> bool
+{
+    switch (value.type)
+    {
+        case Scalar::Type::string:
+            try
+            {
+                out = parseDecimal(value.string);
+            } catch (const std::invalid_argument &)
+            {
+                return fail("decimal expected");
+            }
+            return true;
+        case Scalar::Type::integer:
+            out = static_cast<double>(value.integer);
+            return true;
+        case Scalar::Type::real:
+            out = value.real;
+            return true;
+        default:
+            return fail("decimal expected");
+    }
+}
+
+auto BINAPI_NAMESPACE::local::TypedHandler::get(const Scalar &value, bool &out) -> bool
+{
+    if (value.type != Scalar::Type::boolean)
+        return fail("boolean expected");
+    out = value.boolean;
+    return true;
+}
+
+auto BINAPI_NAMESPACE::local::TypedHandler::scalar(const Scalar &value) -> bool
+{
+    if (!onValue(value))
+        return false;
+
+    if (m_depth > 0 && m_frames[m_depth - 1].isArray)
+        ++m_frames[m_depth - 1].index;
+    return true;
+}
+
+auto BINAPI_NAMESPACE::local::parseTyped(std::string_view json, TypedHandler &handler, const rapidjson::SchemaDocument *schema, std::string &error) -> bool
+{
+    // The reader unescapes the strings in its stack. Keeping the stack in the arena of the thread avoids growing it from the heap on every call
+    const auto arena = ResponseArena::acquire();
+    rapidjson::GenericReader<rapidjson::UTF8<>, rapidjson::UTF8<>, rapidjson::MemoryPoolAllocator<>> reader(arena->prepare(json.size()));
+    rapidjson::MemoryStream stream(json.data(), json.size());
+
+    if (schema == nullptr)
+    {
+        const auto result = reader.Parse(stream, handler);
+        if (!result.IsError())
+            return true;
+
+        error = handler.getError().empty() ? fmt::format("{}. At Offset: {}", rapidjson::GetParseError_En(result.Code()), result.Offset()) : handler.getError();
+        return false;
+    }
+
+    // The validator forwards every event to the handler, so the document is read once
+    rapidjson::GenericSchemaValidator<rapidjson::SchemaDocument, TypedHandler> validator(*schema, handler);
+    const auto result = reader.Parse(stream, validator);
+    if (!result.IsError())
+        return true;
+
+    // The validator also reports itself invalid when the handler stops the parsing
+    if (!handler.getError().empty())
+        error = handler.getError();
+    else if (!validator.IsValid())
+    {
+        rapidjson::StringBuffer sbSchema, sbDocument;
+        validator.GetInvalidSchemaPointer().StringifyUriFragment(sbSchema);
+        validator.GetInvalidDocumentPointer().StringifyUriFragment(sbDocument);
+
+        error = fmt::format("Invalid schema: {}\nInvalid keyword: {}\nInvalid document: {}",
+            sbSchema.GetString(),
+            validator.GetInvalidSchemaKeyword() != nullptr ? validator.GetInvalidSchemaKeyword() : "",
+            sbDocument.GetString());
+    }
+    else
+        error = fmt::format("{}. At Offset: {}", rapidjson::GetParseError_En(result.Code()), result.Offset());
+
+    return false;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Candlesticks: [[openTime, "open", "high", "low", "close", "volume", closeTime, "quoteAssetVolume", trades, "takerBase", "takerQuote", "ignore"], ...]
+
+BINAPI_NAMESPACE::local::CandlestickHandler::CandlestickHandler(std::size_t expected)
+{
+    m_candles.reserve(expected);
+}
+
+auto BINAPI_NAMESPACE::local::CandlestickHandler::take() noexcept -> std::vector<Candlestick>
+{
+    return std::move(m_candles);
+}
+
+auto BINAPI_NAMESPACE::local::CandlestickHandler::onStart(bool isArray) -> bool
+{
+    switch (depth())
+    {
+        case 0:
+            return isArray ? true : fail("array of candles expected");
+        case 1:
+            if (!isArray)
+                return fail("candle array expected");
+            m_current = {};
+            return true;
+        default:
+            return fail("unexpected nesting");
+    }
+}
+
+auto BINAPI_NAMESPACE::local::CandlestickHandler::onValue(const Scalar &value) -> bool
+{
+    if (depth() != 2)
+        return fail("unexpected value");
+
+    switch (index(1))
+    {
+        case 0:
+            return get(value, m_current.openTime);
+        case 1:
+            return get(value, m_current.open);
+        case 2:
+            return get(value, m_current.high);
+        case 3:
+            return get(value, m_current.low);
+        case 4:
+            return get(value, m_current.close);
+        case 5:
+            return get(value, m_current.volume);
+        case 6:
+            return get(value, m_current.closeTime);
+        case 7:
+            return get(value, m_current.quoteAssetVolume);
+        case 8:
+            return get(value, m_current.numberOfTrades);
+        case 9:
+            return get(value, m_current.takerBaseAssetVolume);
+        case 10:
+            return get(value, m_current.takerQuoteAssetVolume);
+        default:
+            return true;
+    }
+}
+
+auto BINAPI_NAMESPACE::local::CandlestickHandler::onEnd(bool, rapidjson::SizeType count) -> bool
+{
+    if (depth() == 1)
+    {
+        if (count < 11)
+            return fail("incomplete candle");
+        m_candles.push_back(m_current);
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// Exchange information
+
+auto BINAPI_NAMESPACE::local::ExchangeInformationHandler::take() noexcept -> SPOT::ExchangeInformation
+{
+    return std::move(m_info);
+}
+
+auto BINAPI_NAMESPACE::local::ExchangeInformationHandler::onStart(bool isArray) -> bool
+{
+    switch (depth())
+    {
+        case 0:
+            return isArray ? fail("object expected") : true;
+        case 1:
+            if (key(0) == "rateLimits")
+                return isArray ? true : fail("array expected");
+            if (key(0) == "symbols")
+            {
+                m_hasSymbols = true;
+                return isArray ? true : fail("array expected");
+            }
+            return true;
+        case 2:
+            if (key(0) == "rateLimits")
+            {
+                m_rateLimitType.clear();
+                m_rateLimitInterval.clear();
+                m_rateLimitNumber = 0;
+                m_rateLimit       = 0;
+            }
+            else if (key(0) == "symbols")
+                m_symbol = {};
+            else
+                return true;
+            return isArray ? fail("object expected") : true;
+        case 3:
+            if (key(0) == "symbols" && (key(2) == "orderTypes" || key(2) == "permissions" || key(2) == "filters"))
+                return isArray ? true : fail("array expected");
+            return true;
+        case 4:
+            if (key(0) == "symbols" && key(2) == "filters")
+            {
+                m_filterSize = 0;
+                return isArray ? fail("object expected") : true;
+            }
+            return true;
+        default:
+            return true;
+    }
+}
+
+auto BINAPI_NAMESPACE::local::ExchangeInformationHandler::onValue(const Scalar &value) -> bool
+{
+    switch (depth())
+    {
+        case 1:
+            if (key(0) == "timezone")
+            {
+                m_hasTimezone = true;
+                return get(value, m_info.timezone);
+            }
+            return true;
+        case 3:
+            if (key(0) == "rateLimits")
+                return rateLimitValue(value);
+            if (key(0) == "symbols")
+                return symbolValue(value);
+            return true;
+        case 4:
+            if (key(0) != "symbols")
+                return true;
+            if (key(2) == "orderTypes")
+            {
+                if (value.type != Scalar::Type::string)
+                    return fail("string expected");
+                if (value.string == "LIMIT")
+                    m_symbol.orderType.set(static_cast<uint64_t>(OrderType::limit));
+                else if (value.string == "LIMIT_MAKER")
+                    m_symbol.orderType.set(static_cast<uint64_t>(OrderType::limitMaker));
+                else if (value.string == "MARKET")
+                    m_symbol.orderType.set(static_cast<uint64_t>(OrderType::market));
+                else if (value.string == "STOP_LOSS_LIMIT")
+                    m_symbol.orderType.set(static_cast<uint64_t>(OrderType::stopLossLimit));
+                else if (value.string == "TAKE_PROFIT_LIMIT")
+                    m_symbol.orderType.set(static_cast<uint64_t>(OrderType::takeProfitLimit));
+            }
+            else if (key(2) == "permissions")
+            {
+                if (value.type != Scalar::Type::string)
+                    return fail("string expected");
+                if (value.string == "SPOT")
+                    m_symbol.permissions.set(SPOT::AccountPermissions::spot);
+                else if (value.string == "MARGIN")
+                    m_symbol.permissions.set(SPOT::AccountPermissions::margin);
+                else if (value.string == "LEVERAGED")
+                    m_symbol.permissions.set(SPOT::AccountPermissions::leveraged);
+            }
+            return true;
+        case 5:
+            if (key(0) == "symbols" && key(2) == "filters")
+            {
+                if (m_filterSize == m_filter.size())
+                    m_filter.emplace_back();
+                auto &member = m_filter[m_filterSize++];
+                member.key.assign(currentKey());
+                member.type    = value.type;
+                member.integer = value.integer;
+                member.boolean = value.boolean;
+                member.text.assign(value.string);
+            }
+            return true;
+        default:
+            return true;
+    }
+}
+
+auto BINAPI_NAMESPACE::local::ExchangeInformationHandler::onEnd(bool, rapidjson::SizeType) -> bool
+{
+    switch (depth())
+    {
+        case 0:
+            if (!m_hasTimezone || !m_hasSymbols)
+                return fail("timezone and symbols are required");
+            return true;
+        case 2:
+            if (key(0) == "rateLimits")
+                applyRateLimit();
+            else if (key(0) == "symbols")
+            {
+                if (m_symbol.symbol.empty())
+                    return fail("symbol name is required");
+                auto name            = m_symbol.symbol;
+                m_info.symbols[name] = std::move(m_symbol);
+            }
+            return true;
+        case 4:
+            if (key(0) == "symbols" && key(2) == "filters")
+                return applyFilter();
+            return true;
+        default:
+            return true;
+    }
+}
+
+auto BINAPI_NAMESPACE::local::ExchangeInformationHandler::rateLimitValue(const Scalar &value) -> bool
+{
+    const auto name = currentKey();
+    if (name == "rateLimitType")
+        return get(value, m_rateLimitType);
+    if (name == "interval")
+        return get(value, m_rateLimitInterval);
+    if (name == "intervalNum")
+        return get(value, m_rateLimitNumber);
+    if (name == "limit")
+        return get(value, m_rateLimit);
+    return true;
+}
+
+auto BINAPI_NAMESPACE::local::ExchangeInformationHandler::symbolValue(const Scalar &value) -> bool
+{
+    const auto name = currentKey();
+    if (name == "symbol")
+        return get(value, m_symbol.symbol);
+    if (name == "status")
+    {
+        if (value.type != Scalar::Type::string)
+            return fail("string expected");
+        m_symbol.status = value.string == "TRADING" ? SPOT::TradingStatus::Trading : SPOT::TradingStatus::Break;
+        return true;
+    }
+    if (name == "baseAsset")
+        return get(value, m_symbol.baseAsset);
+    if (name == "quoteAsset")
+        return get(value, m_symbol.quoteAsset);
+    if (name == "baseAssetPrecision")
+        return get(value, m_symbol.baseAssetPrecision);
+    if (name == "quotePrecision")
+        return get(value, m_symbol.quotePrecision);
+    if (name == "quoteAssetPrecision")
+        return get(value, m_symbol.quoteAssetPrecision);
+    if (name == "baseCommissionPrecision")
+        return get(value, m_symbol.baseCommissionPrecision);
+    if (name == "quoteCommissionPrecision")
+        return get(value, m_symbol.quoteCommissionPrecision);
+    if (name == "icebergAllowed")
+        return get(value, m_symbol.icebergAllowed);
+    if (name == "ocoAllowed")
+        return get(value, m_symbol.ocoAllowed);
+    if (name == "quoteOrderQtyMarketAllowed")
+        return get(value, m_symbol.quoteOrderQtyMarketAllowed);
+    return true;
+}
+
+auto BINAPI_NAMESPACE::local::ExchangeInformationHandler::applyRateLimit() -> void
+{
+    uint32_t intervalNumber = 0;
+
+    if (m_rateLimitInterval == "MINUTE")
+        intervalNumber = 60;
+    else if (m_rateLimitInterval == "SECOND")
+        intervalNumber = 1;
+    else if (m_rateLimitInterval == "DAY")
+        intervalNumber = 24 * 60 * 60;
+
+    if (m_rateLimitType == "REQUEST_WEIGHT")
+    {
+        m_info.limitWeight.seconds = intervalNumber * m_rateLimitNumber;
+        m_info.limitWeight.limit   = m_rateLimit;
+    }
+    else if (m_rateLimitType == "ORDERS")
+    {
+        if (intervalNumber == 1)
+        {
+            // SECOND
+            m_info.limitOrderSecond.seconds = intervalNumber * m_rateLimitNumber;
+            m_info.limitOrderSecond.limit   = m_rateLimit;
+        }
+        else
+        {
+            m_info.limitOrderDay.seconds = intervalNumber * m_rateLimitNumber;
+            m_info.limitOrderDay.limit   = m_rateLimit;
+        }
+    }
+}
+
+auto BINAPI_NAMESPACE::local::ExchangeInformationHandler::applyFilter() -> bool
+{
+    const auto member = [this](std::string_view name) -> const FilterMember * {
+        for (std::size_t i = 0; i < m_filterSize; ++i)
+        {
+            if (m_filter[i].key == name)
+                return &m_filter[i];
+        }
+        return nullptr;
+    };
+
+    const auto decimal = [&](std::string_view name, double &out) -> bool {
+        const auto *field = member(name);
+        if (field == nullptr || field->type != Scalar::Type::string)
+            return fail(fmt::format("filter member {} expected", name));
+        try
+        {
+            out = parseDecimal(field->text);
+        } catch (const std::invalid_argument &)
+        {
+            return fail(fmt::format("filter member {} is not a decimal", name));
+        }
+        return true;
+    };
+
+    const auto scale = [&](std::string_view name, DecimalScale &out) -> bool {
+        const auto *field = member(name);
+        if (field == nullptr || field->type != Scalar::Type::string)
+            return fail(fmt::format("filter member {} expected", name));
+        try
+        {
+            out = DecimalScale::fromString(field->text);
+        } catch (const std::exception &)
+        {
+            return fail(fmt::format("filter member {} is not a decimal", name));
+        }
+        return true;
+    };
+
+    const auto integer = [&](std::string_view name, int32_t &out) -> bool {
+        const auto *field = member(name);
+        if (field == nullptr || field->type != Scalar::Type::integer)
+            return fail(fmt::format("filter member {} expected", name));
+        out = static_cast<int32_t>(field->integer);
+        return true;
+    };
+
+    const auto boolean = [&](std::string_view name, bool &out) -> bool {
+        const auto *field = member(name);
+        if (field == nullptr || field->type != Scalar::Type::boolean)
+            return fail(fmt::format("filter member {} expected", name));
+        out = field->boolean;
+        return true;
+    };
+
+    const auto *type = member("filterType");
+    if (type == nullptr || type->type != Scalar::Type::string)
+        return fail("filterType expected");
+
+    const std::string &filterType = type->text;
+    auto &sym                     = m_symbol;
+
+    if (filterType == "PRICE_FILTER")
+    {
+        sym.eifPrice.present = true;
+        return decimal("minPrice", sym.eifPrice.minPrice)
+            && decimal("maxPrice", sym.eifPrice.maxPrice)
+            && decimal("tickSize", sym.eifPrice.tickSize)
+            && scale("tickSize", sym.eifPrice.tickScale);
+    }
+    if (filterType == "PERCENT_PRICE")
+    {
+        sym.eifPercentPrice.present = true;
+        return decimal("multiplierUp", sym.eifPercentPrice.multiplierUp)
+            && decimal("multiplierDown", sym.eifPercentPrice.multiplierDown)
+            && integer("avgPriceMins", sym.eifPercentPrice.averagePriceMins);
+    }
+    if (filterType == "LOT_SIZE")
+    {
+        sym.eifLotSize.present = true;
+        return decimal("minQty", sym.eifLotSize.minQty)
+            && decimal("maxQty", sym.eifLotSize.maxQty)
+            && decimal("stepSize", sym.eifLotSize.stepSize)
+            && scale("stepSize", sym.eifLotSize.stepScale);
+    }
+    if (filterType == "MIN_NOTIONAL")
+    {
+        sym.eifMinNotional.present = true;
+        return decimal("minNotional", sym.eifMinNotional.minNotional)
+            && boolean("applyToMarket", sym.eifMinNotional.applyToMarket)
+            && integer("avgPriceMins", sym.eifMinNotional.averagePriceMins);
+    }
+    if (filterType == "ICEBERG_PARTS")
+    {
+        sym.eifIcebergParts.present = true;
+        return integer("limit", sym.eifIcebergParts.limit);
+    }
+    if (filterType == "MARKET_LOT_SIZE")
+    {
+        sym.eifMarketLotSize.present = true;
+        return decimal("minQty", sym.eifMarketLotSize.minQty)
+            && decimal("maxQty", sym.eifMarketLotSize.maxQty)
+            && decimal("stepSize", sym.eifMarketLotSize.stepSize)
+            && scale("stepSize", sym.eifMarketLotSize.stepScale);
+    }
+    if (filterType == "MAX_NUM_ALGO_ORDERS")
+    {
+        sym.eifMaxNumAlgoOrders.present = true;
+        return integer("maxNumAlgoOrders", sym.eifMaxNumAlgoOrders.maxNumAlgoOrders);
+    }
+    if (filterType == "MAX_NUM_ORDERS")
+    {
+        sym.eifMaxNumOrders.present = true;
+        return integer("maxNumOrders", sym.eifMaxNumOrders.maxNumOrders);
+    }
+    if (filterType == "MAX_NUM_ICEBERG_ORDERS")
+    {
+        sym.eifMaxNumIcerbergOrders.present = true;
+        return integer("maxNumIcebergOrders", sym.eifMaxNumIcerbergOrders.maxNumIcebergOrders);
+    }
+    if (filterType == "MAX_POSITION")
+    {
+        sym.eifMaxPosition.present = true;
+        return decimal("maxPosition", sym.eifMaxPosition.maxPosition);
+    }
+
+    // Filters added by Binance after this code was written are ignored
+    return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------
+// All coins information
+
+auto BINAPI_NAMESPACE::local::AllCoinsInformationHandler::take() noexcept -> std::unordered_map<sym_t, SPOT::CoinInformation>
+{
+    return std::move(m_coins);
+}
+
+auto BINAPI_NAMESPACE::local::AllCoinsInformationHandler::onStart(bool isArray) -> bool
+{
+    switch (depth())
+    {
+        case 0:
+            return isArray ? true : fail("array of coins expected");
+        case 1:
+            m_coin = {};
+            return isArray ? fail("coin object expected") : true;
+        case 2:
+            if (key(1) == "networkList")
+                return isArray ? true : fail("array expected");
+            return true;
+        case 3:
+            if (key(1) == "networkList")
+            {
+                m_network = {};
+                return isArray ? fail("network object expected") : true;
+            }
+            return true;
+        default:
+            return true;
+    }
+}
+
+auto BINAPI_NAMESPACE::local::AllCoinsInformationHandler::onValue(const Scalar &value) -> bool
+{
+    switch (depth())
+    {
+        case 0:
+        case 1:
+            return fail("object expected");
+        case 2:
+            return coinValue(value);
+        case 4:
+            if (key(1) == "networkList")
+                return networkValue(value);
+            return true;
+        default:
+            return true;
+    }
+}
+
+auto BINAPI_NAMESPACE::local::AllCoinsInformationHandler::onEnd(bool, rapidjson::SizeType) -> bool
+{
+    switch (depth())
+    {
+        case 1:
+            {
+                if (m_coin.coin.empty())
+                    return fail("coin is required");
+                auto name     = m_coin.coin;
+                m_coins[name] = std::move(m_coin);
+                return true;
+            }
+        case 3:
+            if (key(1) == "networkList")
+            {
+                // Descriptions only make sense when the operation is disabled
+                if (m_network.depositEnable)
+                    m_network.depositDescription.clear();
+                if (m_network.withdrawEnable)
+                    m_network.withdrawDescription.clear();
+                m_coin.networkList.emplace_back(std::move(m_network));
+            }
+            return true;
+        default:
+            return true;
+    }
+}
+
+auto BINAPI_NAMESPACE::local::AllCoinsInformationHandler::coinValue(const Scalar &value) -> bool
+{
+    const auto name = currentKey();
+    if (name == "coin")
+        return get(value, m_coin.coin);
+    if (name == "name")
+        return get(value, m_coin.name);
+    if (name == "free")
+        return get(value, m_coin.free);
+    if (name == "freeze")
+        return get(value, m_coin.freeze);
+    if (name == "ipoable")
+        return get(value, m_coin.ipoable);
+    if (name == "ipoing")
+        return get(value, m_coin.ipoing);
+    if (name == "locked")
+        return get(value, m_coin.locked);
+    if (name == "storage")
+        return get(value, m_coin.storage);
+    if (name == "withdrawing")
+        return get(value, m_coin.withdrawing);
+    if (name == "depositAllEnable")
+        return get(value, m_coin.depositAlLEnable);
+    if (name == "isLegalMoney")
+        return get(value, m_coin.isLegalMoney);
+    if (name == "trading")
+        return get(value, m_coin.trading);
+    if (name == "withdrawAllEnable")
+        return get(value, m_coin.withdrawAllEnable);
+    return true;
+}
+
+auto BINAPI_NAMESPACE::local::AllCoinsInformationHandler::networkValue(const Scalar &value) -> bool
+{
+    const auto name = currentKey();
+    if (name == "coin")
+        return get(value, m_network.coin);
+    if (name == "addressRegex")
+        return get(value, m_network.addressRegEx);
+    if (name == "depositDesc")
+        return get(value, m_network.depositDescription);
+    if (name == "memoRegex")
+        return get(value, m_network.memoRegEx);
+    if (name == "name")
+        return get(value, m_network.name);
+    if (name == "network")
+        return get(value, m_network.network);
+    if (name == "specialTips")
+        return get(value, m_network.specialTips);
+    if (name == "withdrawDesc")
+        return get(value, m_network.withdrawDescription);
+    if (name == "specialWithdrawTips")
+        return get(value, m_network.specialWithdrawTips);
+    if (name == "addressRule")
+        return get(value, m_network.addressRule);
+    if (name == "withdrawFee")
+        return get(value, m_network.withdrawFee);
+    if (name == "withdrawIntegerMultiple")
+        return get(value, m_network.withdrawIntegerMultiple);
+    if (name == "withdrawMin")
+        return get(value, m_network.withdrawMin);
+    if (name == "withdrawMax")
+        return get(value, m_network.withdrawMax);
+    if (name == "estimatedArrivalTime")
+        return get(value, m_network.estimatedArrivalTime);
+    if (name == "minConfirm")
+        return get(value, m_network.minConfirmation);
+    if (name == "unLockConfirm")
+        return get(value, m_network.unLockConfirm);
+    if (name == "depositEnable")
+        return get(value, m_network.depositEnable);
+    if (name == "isDefault")
+        return get(value, m_network.isDefault);
+    if (name == "resetAddressStatus")
+        return get(value, m_network.resetAddressStatus);
+    if (name == "withdrawEnable")
+        return get(value, m_network.withdrawEnable);
+    if (name == "sameAddress")
+        return get(value, m_network.sameAddress);
+    return true;
+}
@@ -0,0 +1,218 @@
+////////////////////////////////////////////////////////////////////////////////
+// Created by Ricardo Romero on 17/10/2026 for BinanceAPI.
+// Copyright (c) 2026. Ricardo Romero
+// All rights reserved.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "BinanceAPIScheduler.hpp"
+#include "BinanceAPILimits.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    thread_local std::optional<BINAPI_NAMESPACE::RequestPriority> g_threadPriority;
+
+    constexpr auto toIndex(BINAPI_NAMESPACE::RequestPriority priority) noexcept -> std::size_t
+    {
+        return static_cast<std::size_t>(priority);
+    }
+} // namespace
+
+BINAPI_NAMESPACE::RequestPriorityScope::RequestPriorityScope(RequestPriority priority) noexcept :
+    m_previous { g_threadPriority }
+{
+    g_threadPriority = priority;
+}
+
+BINAPI_NAMESPACE::RequestPriorityScope::~RequestPriorityScope()
+{
+    g_threadPriority = m_previous;
+}
+
+auto BINAPI_NAMESPACE::RequestPriorityScope::current() noexcept -> std::optional<RequestPriority>
+{
+    return g_threadPriority;
+}
+
+BINAPI_NAMESPACE::RequestScheduler::RequestScheduler(BinanceLimits *limits) noexcept :
+    m_limits { limits }
+{
+    m_reservedShare[toIndex(RequestPriority::trading)].store(0.1, std::memory_order_relaxed);
+    m_reservedShare[toIndex(RequestPriority::interactive)].store(0.1, std::memory_order_relaxed);
+}
+
+BINAPI_NAMESPACE::RequestScheduler::~RequestScheduler() = default;
+
+auto BINAPI_NAMESPACE::RequestScheduler::setReservedShare(RequestPriority priority, double share) noexcept -> void
+{
+    m_reservedShare[toIndex(priority)].store(std::clamp(share, 0.0, 1.0), std::memory_order_relaxed);
+}
+
+auto BINAPI_NAMESPACE::RequestScheduler::getReservedShare(RequestPriority priority) const noexcept -> double
+{
+    return m_reservedShare[toIndex(priority)].load(std::memory_order_relaxed);
+}
+
+auto BINAPI_NAMESPACE::RequestScheduler::reservedWeight(RequestPriority priority) const noexcept -> long long
+{
+    double share = 0.0;
+    for (std::size_t i = 0; i < toIndex(priority); ++i)
+        share += m_reservedShare[i].load(std::memory_order_relaxed);
+
+    return static_cast<long long>(std::ceil(std::min(share, 1.0) * static_cast<double>(m_limits->getMaxAPIRequestWeight())));
+}
+
+auto BINAPI_NAMESPACE::RequestScheduler::waitingAtOrAbove(RequestPriority priority) const noexcept -> bool
+{
+    for (std::size_t i = 0; i <= toIndex(priority); ++i)
+    {
+        if (m_counters[i].depth.load(std::memory_order_acquire) != 0)
+            return true;
+    }
+    return false;
+}
+
+auto BINAPI_NAMESPACE::RequestScheduler::head(std::chrono::steady_clock::time_point now) const noexcept -> const Ticket *
+{
+    const Ticket *best = nullptr;
+    for (const auto *ticket : m_queue)
+    {
+        // Waiting for the order count. The weight goes to the calls behind it meanwhile
+        if (ticket->ordersFreeAt > now)
+            continue;
+
+        if (best == nullptr || ticket->priority < best->priority)
+        {
+            best = ticket;
+            continue;
+        }
+        if (ticket->priority != best->priority)
+            continue;
+
+        // Same class: the client that has received less weight, then the oldest call
+        const auto served     = m_served.find(ticket->client);
+        const auto bestServed = m_served.find(best->client);
+        const long long a     = served == m_served.end() ? 0 : served->second;
+        const long long b     = bestServed == m_served.end() ? 0 : bestServed->second;
+        if (a < b || (a == b && ticket->sequence < best->sequence))
+            best = ticket;
+    }
+    return best;
+}
+
+auto BINAPI_NAMESPACE::RequestScheduler::dequeue(const Ticket *ticket) -> void
+{
+    m_queue.erase(std::find(m_queue.begin(), m_queue.end(), ticket));
+    m_counters[toIndex(ticket->priority)].depth.fetch_sub(1, std::memory_order_release);
+
+    if (m_queue.empty())
+        m_served.clear();
+
+    // Another ticket may be the head now
+    m_changed.notify_all();
+}
+
+auto BINAPI_NAMESPACE::RequestScheduler::admit(long long callWeight, bool isOrderCall, RequestPriority priority, uint64_t client, std::chrono::steady_clock::time_point deadline) -> bool
+{
+    auto &counters      = m_counters[toIndex(priority)];
+    const auto reserved = reservedWeight(priority);
+
+    // Fast path. Nobody with the same or a higher priority is waiting, or the call can not wait at all
+    if (!waitingAtOrAbove(priority) || std::chrono::steady_clock::now() >= deadline)
+    {
+        if (m_limits->tryAcquire(callWeight, isOrderCall, reserved).count() == 0)
+        {
+            counters.admitted.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        if (std::chrono::steady_clock::now() >= deadline)
+        {
+            counters.rejected.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    Ticket ticket { priority, client, m_sequence++ };
+    m_queue.push_back(&ticket);
+
+    const auto depth = counters.depth.fetch_add(1, std::memory_order_release) + 1;
+    auto maxDepth    = counters.maxDepth.load(std::memory_order_relaxed);
+    while (maxDepth < depth && !counters.maxDepth.compare_exchange_weak(maxDepth, depth, std::memory_order_relaxed))
+    {
+    }
+
+    for (;;)
+    {
+        const auto now = std::chrono::steady_clock::now();
+
+        if (head(now) != &ticket)
+        {
+            if (now >= deadline)
+            {
+                dequeue(&ticket);
+                counters.rejected.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            // Woken up whenever the head leaves the queue, or when the order count lets this call try again.
+            // Past the deadline the call gets one last try if it is the head
+            m_changed.wait_until(lock, ticket.ordersFreeAt > now ? std::min(deadline, ticket.ordersFreeAt) : deadline);
+            continue;
+        }
+
+        const auto wait = m_limits->tryAcquire(callWeight, isOrderCall, reserved);
+        if (wait.count() == 0)
+        {
+            m_served[client] += callWeight;
+            dequeue(&ticket);
+            counters.admitted.fetch_add(1, std::memory_order_relaxed);
+            counters.delayed.fetch_add(1, std::memory_order_relaxed);
+            counters.waited.fetch_add((std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+            return true;
+        }
+
+        if (wait == std::chrono::nanoseconds::max() || now + wait > deadline)
+        {
+            dequeue(&ticket);
+            counters.rejected.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        if (isOrderCall)
+        {
+            // Held by the order count: the calls that only need weight go ahead meanwhile
+            if (const auto ordersWait = m_limits->getOrdersWait(callWeight); ordersWait.count() != 0)
+            {
+                ticket.ordersFreeAt = now + ordersWait;
+                m_changed.notify_all();
+            }
+        }
+
+        // A call of a higher class arriving meanwhile takes the head
+        m_changed.wait_until(lock, now + wait);
+    }
+}
+
+auto BINAPI_NAMESPACE::RequestScheduler::getMetrics(RequestPriority priority) const noexcept -> Metrics
+{
+    const auto &counters = m_counters[toIndex(priority)];
+    return {
+        .depth    = counters.depth.load(std::memory_order_relaxed),
+        .maxDepth = counters.maxDepth.load(std::memory_order_relaxed),
+        .admitted = counters.admitted.load(std::memory_order_relaxed),
+        .delayed  = counters.delayed.load(std::memory_order_relaxed),
+        .rejected = counters.rejected.load(std::memory_order_relaxed),
+        .waited   = std::chrono::nanoseconds { counters.waited.load(std::memory_order_relaxed) }
+    };
+}
+
+auto BINAPI_NAMESPACE::RequestScheduler::getQueueDepth(RequestPriority priority) const noexcept -> std::size_t
+{
+    return static_cast<std::size_t>(m_counters[toIndex(priority)].depth.load(std::memory_order_relaxed));
+}
@@ -0,0 +1,140 @@
+////////////////////////////////////////////////////////////////////////////////
+// Created by Ricardo Romero on 17/10/2026 for BinanceAPI.
+// Copyright (c) 2026. Ricardo Romero
+// All rights reserved.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "BinanceAPISigner.hpp"
+#include "HexEncoder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <new>
+#include <vector>
+
+#if defined(__clang__) || defined(__GNUC__)
+BINAPI_WARN_PUSH
+// clang-format off
+BINAPI_WARN_OFF(old-style-cast)
+BINAPI_WARN_OFF(padded)
+BINAPI_WARN_OFF(deprecated-volatile)
+BINAPI_WARN_OFF(weak-vtables)
+BINAPI_WARN_OFF(documentation-unknown-command)
+BINAPI_WARN_OFF(reserved-id-macro)
+BINAPI_WARN_OFF(documentation-deprecated-sync)
+BINAPI_WARN_OFF(undefined-func-template)
+BINAPI_WARN_OFF(nonportable-system-include-path)
+BINAPI_WARN_OFF(language-extension-token)
+// clang-format on
+#endif /*defined(__clang__) || defined(__GNUC__)*/
+
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+
+#if defined(__clang__) || defined(__GNUC__)
+BINAPI_WARN_POP
+#endif /*defined(__clang__) || defined(__GNUC__)*/
+
+namespace
+{
+    // SHA-256 block size
+    constexpr std::size_t g_blockSize = 64;
+    // Keys a thread keeps signers for. One per BinanceKeys is the common case
+    constexpr std::size_t g_maxThreadSigners = 4;
+
+    auto initialize(EVP_MD_CTX *context, const std::array<unsigned char, g_blockSize> &key, unsigned char pad) noexcept -> bool
+    {
+        std::array<unsigned char, g_blockSize> padded {};
+        for (std::size_t i = 0; i < g_blockSize; ++i)
+            padded[i] = key[i] ^ pad;
+
+        const bool result = EVP_DigestInit_ex(context, EVP_sha256(), nullptr) == 1 && EVP_DigestUpdate(context, padded.data(), padded.size()) == 1;
+        OPENSSL_cleanse(padded.data(), padded.size());
+        return result;
+    }
+} // namespace
+
+BINAPI_NAMESPACE::local::HMACSigner::HMACSigner(std::string_view key) :
+    m_inner { EVP_MD_CTX_new() },
+    m_outer { EVP_MD_CTX_new() },
+    m_work { EVP_MD_CTX_new() },
+    m_key { key }
+{
+    if (m_inner == nullptr || m_outer == nullptr || m_work == nullptr)
+    {
+        EVP_MD_CTX_free(m_inner);
+        EVP_MD_CTX_free(m_outer);
+        EVP_MD_CTX_free(m_work);
+        throw std::bad_alloc();
+    }
+
+    // Keys longer than a block are hashed first (RFC 2104)
+    std::array<unsigned char, g_blockSize> block {};
+    if (key.size() > g_blockSize)
+    {
+        unsigned int size = 0;
+        EVP_Digest(key.data(), key.size(), block.data(), &size, EVP_sha256(), nullptr);
+    }
+    else
+        std::copy(key.begin(), key.end(), block.begin());
+
+    const bool initialized = initialize(m_inner, block, 0x36) && initialize(m_outer, block, 0x5c);
+    OPENSSL_cleanse(block.data(), block.size());
+
+    if (!initialized)
+    {
+        EVP_MD_CTX_free(m_inner);
+        EVP_MD_CTX_free(m_outer);
+        EVP_MD_CTX_free(m_work);
+        throw std::bad_alloc();
+    }
+}
+
+BINAPI_NAMESPACE::local::HMACSigner::~HMACSigner()
+{
+    EVP_MD_CTX_free(m_inner);
+    EVP_MD_CTX_free(m_outer);
+    EVP_MD_CTX_free(m_work);
+    OPENSSL_cleanse(m_key.data(), m_key.size());
+}
+
+auto BINAPI_NAMESPACE::local::HMACSigner::forThread(std::string_view key) -> HMACSigner &
+{
+    // The most recently used signer is at the back
+    thread_local std::vector<std::unique_ptr<HMACSigner>> signers;
+
+    for (auto it = signers.rbegin(); it != signers.rend(); ++it)
+    {
+        if ((*it)->isKey(key))
+            return **it;
+    }
+
+    if (signers.size() == g_maxThreadSigners)
+        signers.erase(signers.begin());
+
+    return *signers.emplace_back(std::make_unique<HMACSigner>(key));
+}
+
+auto BINAPI_NAMESPACE::local::HMACSigner::sign(std::string_view message, char *out) noexcept -> void
+{
+    std::array<unsigned char, EVP_MAX_MD_SIZE> digest {};
+    unsigned int size = 0;
+
+    // H((K ^ opad) || H((K ^ ipad) || message)) starting from the precomputed pad states
+    EVP_MD_CTX_copy_ex(m_work, m_inner);
+    EVP_DigestUpdate(m_work, message.data(), message.size());
+    EVP_DigestFinal_ex(m_work, digest.data(), &size);
+
+    EVP_MD_CTX_copy_ex(m_work, m_outer);
+    EVP_DigestUpdate(m_work, digest.data(), size);
+    EVP_DigestFinal_ex(m_work, digest.data(), &size);
+
+    CENTAUR_NAMESPACE::hexEncode(digest.data(), size, out);
+    out[2 * size] = 0;
+}
+
+auto BINAPI_NAMESPACE::local::HMACSigner::isKey(std::string_view key) const noexcept -> bool
+{
+    return m_key == key;
+}
@@ -4,6 +4,7 @@
 // All rights reserved.
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <array>
 #include <iostream>
 #include <random>
@@ -14,6 +15,7 @@
 #include "schemas.hpp"
 
 #include "Binapi.hpp"
+#include "BinanceAPINumeric.hpp"
 #include "schemas.hpp"
 
 #define VIEW_INIT(x)       \
@@ -145,15 +147,32 @@ namespace
         ROLLING_WINDOW_PRICE_CHANGE_STATISTICS_100
     };
 
+    /// \brief Time to live of the reference data. Symbols, networks and fees change seldom; the coin information also
+    /// carries the balances, so it is kept for less time
+    auto setCacheDefaults(BINAPI_NAMESPACE::ResponseCache &cache) -> void
+    {
+        using namespace std::chrono_literals;
+        cache.setTimeToLive(g_spotRequests[EXCHANGE_INFORMATION].endPoint, 1h);
+        cache.setTimeToLive(g_spotRequests[ALL_COINS_INFORMATION].endPoint, 5min);
+        cache.setTimeToLive(g_spotRequests[ASSET_DETAIL].endPoint, 1h);
+        cache.setTimeToLive(g_spotRequests[TRADE_FEE].endPoint, 1h);
+    }
 } // namespace
 
 BINAPI_NAMESPACE::BinanceAPISpot::BinanceAPISpot(std::string_view userAgent, BinanceKeys *keys, BinanceLimits *exl) :
     BinanceAPI("https://api.binance.com", userAgent, keys, exl)
 {
+    setCacheDefaults(*getResponseCache());
 }
 BINAPI_NAMESPACE::BinanceAPISpot::BinanceAPISpot(BinanceKeys *keys, BinanceLimits *exl) :
     BinanceAPI("https://api.binance.com", "CPP_interface_api/curl-openssl/7.70.0/Ricardo", keys, exl)
 {
+    setCacheDefaults(*getResponseCache());
+}
+BINAPI_NAMESPACE::BinanceAPISpot::BinanceAPISpot(std::string_view baseURL, std::string_view userAgent, BinanceKeys *keys, BinanceLimits *exl) :
+    BinanceAPI(baseURL, userAgent, keys, exl)
+{
+    setCacheDefaults(*getResponseCache());
 }
 
 BINAPI_NAMESPACE::BinanceAPISpot::~BinanceAPISpot() = default;
@@ -164,95 +183,23 @@ auto binapi::BinanceAPISpot::getExchangeStatus() -> bool
     return doc["status"].GetInt() == 0;
 }
 
-#define JTO_STRING(x, y)                         \
-    std::string                                  \
-    {                                            \
-        x[y].GetString(), x[y].GetStringLength() \
-    }
+#define JTO_STRING(x, y) \
+    std::string { jsonToView(x[y]) }
 
 #define JTO_DOB(x, y) \
-    std::stod(JTO_STRING(x, y))
+    jsonToDouble(x[y])
 
 auto binapi::BinanceAPISpot::getAllCoinsInformation() -> binapi::AllCoinsInformation
 {
-    auto doc = apiRequest(g_spotRequests[ALL_COINS_INFORMATION],
+    local::AllCoinsInformationHandler handler;
+    apiRequest(g_spotRequests[ALL_COINS_INFORMATION],
         {
             {"recvWindow", fmt::to_string(getRecvWindow())},
             { "timestamp",       fmt::to_string(getTime())}
     },
+        handler,
         true);
-    std::unordered_map<sym_t, SPOT::CoinInformation> info;
-
-    for (const auto &data : doc.GetArray())
-    {
-        SPOT::CoinInformation cif {
-            .coin              = JTO_STRING(data, "coin"),
-            .name              = JTO_STRING(data, "name"),
-            .free              = JTO_DOB(data, "free"),
-            .freeze            = JTO_DOB(data, "freeze"),
-            .ipoable           = JTO_DOB(data, "ipoable"),
-            .ipoing            = JTO_DOB(data, "ipoing"),
-            .locked            = JTO_DOB(data, "locked"),
-            .storage           = JTO_DOB(data, "storage"),
-            .withdrawing       = JTO_DOB(data, "withdrawing"),
-            .depositAlLEnable  = data["depositAllEnable"].GetBool(),
-            .isLegalMoney      = data["isLegalMoney"].GetBool(),
-            .trading           = data["trading"].GetBool(),
-            .withdrawAllEnable = data["withdrawAllEnable"].GetBool()
-        };
-
-        for (const auto &list : data["networkList"].GetArray())
-        {
-            SPOT::CoinInformation::NetworkList ls {
-                .coin               = JTO_STRING(list, "coin"),
-                .addressRegEx       = JTO_STRING(list, "addressRegex"),
-                .depositDescription = [&list]() -> std::string {
-                    if (!list["depositEnable"].GetBool())
-                        return JTO_STRING(list, "depositDesc");
-                    else
-                        return "";
-                }(),
-                .memoRegEx   = JTO_STRING(list, "memoRegex"),
-                .name        = JTO_STRING(list, "name"),
-                .network     = JTO_STRING(list, "network"),
-                .specialTips = [&]() -> std::string {
-                    auto iter = list.FindMember("specialTips");
-                    if (iter != list.MemberEnd())
-                        return JTO_STRING(list, "specialTips");
-                    return "";
-                }(),
-                .withdrawDescription = [&list]() -> std::string {
-                    if (!list["withdrawEnable"].GetBool())
-                        return JTO_STRING(list, "withdrawDesc");
-                    else
-                        return "";
-                }(),
-                .specialWithdrawTips = [&]() -> std::string {
-                    auto iter = list.FindMember("specialWithdrawTips");
-                    if (iter != list.MemberEnd())
-                        return JTO_STRING(list, "specialWithdrawTips");
-                    return "";
-                }(),
-                .addressRule             = JTO_STRING(list, "addressRule"),
-                .withdrawFee             = JTO_DOB(list, "withdrawFee"),
-                .withdrawIntegerMultiple = JTO_DOB(list, "withdrawIntegerMultiple"),
-                .withdrawMin             = JTO_DOB(list, "withdrawMin"),
-                .withdrawMax             = JTO_DOB(list, "withdrawMax"),
-                .estimatedArrivalTime    = list["estimatedArrivalTime"].GetUint64(),
-                .minConfirmation         = list["minConfirm"].GetInt64(),
-                .unLockConfirm           = list["unLockConfirm"].GetInt64(),
-                .depositEnable           = list["depositEnable"].GetBool(),
-                .isDefault               = list["isDefault"].GetBool(),
-                .resetAddressStatus      = list["resetAddressStatus"].GetBool(),
-                .withdrawEnable          = list["withdrawEnable"].GetBool(),
-                .sameAddress             = list["sameAddress"].GetBool()
-            };
-            cif.networkList.emplace_back(ls);
-        }
-
-        info[cif.coin] = cif;
-    }
-    return info;
+    return handler.take();
 }
 auto binapi::BinanceAPISpot::getDailyAccountSnapshotSpot(uint64_t limit, uint64_t startTime, uint64_t endTime) -> std::vector<SPOT::AccountSnapshotSpot>
 {
@@ -272,6 +219,8 @@ auto binapi::BinanceAPISpot::getDailyAccountSnapshotSpot(uint64_t limit, uint64_
     if (endTime > 0)
         params.emplace_back("endTime", fmt::to_string(endTime));
 
+    // The snapshots are the heaviest calls of the API. They must not take the weight of orders or of the UI
+    const RequestPriorityScope priority { RequestPriority::background };
     auto doc = apiRequest(g_spotRequests[DAILY_ACCOUNT_SNAPSHOT_SPOT], params, true);
 
     std::vector<SPOT::AccountSnapshotSpot> dass;
@@ -280,7 +229,7 @@ auto binapi::BinanceAPISpot::getDailyAccountSnapshotSpot(uint64_t limit, uint64_
     {
         SPOT::AccountSnapshotSpot acs {
             .updateTime      = vos["updateTime"].GetUint64(),
-            .totalAssetOfBtc = std::stod(vos["data"]["balances"]["totalAssetOfBtc"].GetString())
+            .totalAssetOfBtc = jsonToDouble(vos["data"]["balances"]["totalAssetOfBtc"])
         };
 
         for (const auto &balances : vos["data"]["balances"].GetArray())
@@ -312,6 +261,7 @@ auto binapi::BinanceAPISpot::getDailyAccountSnapshotMargin(uint64_t limit, uint6
     if (endTime > 0)
         params.emplace_back("endTime", fmt::to_string(endTime));
 
+    const RequestPriorityScope priority { RequestPriority::background };
     auto doc = apiRequest(g_spotRequests[DAILY_ACCOUNT_SNAPSHOT_MARGIN], params, true);
 
     std::vector<SPOT::AccountSnapshotMargin> acsm;
@@ -362,6 +312,7 @@ auto binapi::BinanceAPISpot::getDailyAccountSnapshotFutures(uint64_t limit, uint
     if (endTime > 0)
         params.emplace_back("endTime", fmt::to_string(endTime));
 
+    const RequestPriorityScope priority { RequestPriority::background };
     auto doc = apiRequest(g_spotRequests[DAILY_ACCOUNT_SNAPSHOT_FUTURES], params, true);
 
     std::vector<SPOT::AccountSnapshotFutures> vasf;
@@ -1048,7 +999,7 @@ auto binapi::BinanceAPISpot::queryUserUniversalTransferHistory(binapi::SPOT::Uni
             .timestamp = row["timestamp"].GetUint64(),
             .tranId    = row["tranId"].GetUint64(),
             .amount    = JTO_DOB(row, "amount"),
-            .type      = [type = JTO_STRING(row, "type")]() -> SPOT::UniversalTransferType {
+            .type      = [type = jsonToView(row["type"])]() -> SPOT::UniversalTransferType {
                 if (type == "MAIN_UMFUTURE")
                     return SPOT::UniversalTransferType::MAIN_UMFUTURE;
                 else if (type == "MAIN_CMFUTURE")
@@ -1192,192 +1143,21 @@ auto binapi::BinanceAPISpot::ping() -> void
 
 auto binapi::BinanceAPISpot::checkServerTime() -> uint64_t
 {
-    auto doc = apiRequest(g_spotRequests[CHECK_SERVER_TIME]);
-    return doc["serverTime"].GetUint64();
+    const auto sent       = std::chrono::system_clock::now();
+    auto doc              = apiRequest(g_spotRequests[CHECK_SERVER_TIME]);
+    const auto received   = std::chrono::system_clock::now();
+    const auto serverTime = doc["serverTime"].GetUint64();
+
+    getClockOffset()->sample(serverTime, sent, received);
+    return serverTime;
 }
 
 auto binapi::BinanceAPISpot::getExchangeInformation() -> binapi::SPOT::ExchangeInformation
 {
-    auto doc = apiRequest(g_spotRequests[EXCHANGE_INFORMATION]);
-
-    SPOT::ExchangeInformation exchangeInfo;
-    // Parse all data
-    exchangeInfo.timezone = std::string { doc["timezone"].GetString(), doc["timezone"].GetStringLength() };
-
-    // Extract Limits
-    for (const auto &limit : doc["rateLimits"].GetArray())
-    {
-        std::string type { limit["rateLimitType"].GetString(), limit["rateLimitType"].GetStringLength() };
-        std::string interval { limit["interval"].GetString(), limit["interval"].GetStringLength() };
-        uint32_t number    = limit["intervalNum"].GetUint();
-        uint32_t rateLimit = limit["limit"].GetUint();
-
-        uint32_t intervalNumber = 0;
-
-        if (interval == "MINUTE")
-            intervalNumber = 60;
-        else if (interval == "SECOND")
-            intervalNumber = 1;
-        else if (interval == "DAY")
-            intervalNumber = 24 * 60 * 60;
-
-        if (type == "REQUEST_WEIGHT")
-        {
-            exchangeInfo.limitWeight.seconds = intervalNumber * number;
-            exchangeInfo.limitWeight.limit   = rateLimit;
-        }
-        else if (type == "ORDERS")
-        {
-            if (intervalNumber == 1)
-            {
-                // SECOND
-                exchangeInfo.limitOrderSecond.seconds = intervalNumber * number;
-                exchangeInfo.limitOrderSecond.limit   = rateLimit;
-            }
-            else
-            {
-                exchangeInfo.limitOrderDay.seconds = intervalNumber * number;
-                exchangeInfo.limitOrderDay.limit   = rateLimit;
-            }
-        }
-        else
-        {
-            // POSSIBLE BUG IF BINANCE CHANGE THE FORMAT OF THE OUTPUT DATA
-        }
-    }
-
-    // Symbols
-    for (const auto &symbol : doc["symbols"].GetArray())
-    {
-        SPOT::ExchangeInformationSymbol sym;
-
-        sym.symbol = { symbol["symbol"].GetString(), symbol["symbol"].GetStringLength() };
-
-        // Strings are limited by the Schema
-        if (std::string status = symbol["status"].GetString(); status == "TRADING")
-            sym.status = SPOT::TradingStatus::Trading;
-        else
-            sym.status = SPOT::TradingStatus::Break;
-
-        sym.baseAsset = { symbol["baseAsset"].GetString(), symbol["baseAsset"].GetStringLength() };
-
-        sym.baseAssetPrecision = symbol["baseAssetPrecision"].GetInt();
-
-        sym.quoteAsset = { symbol["quoteAsset"].GetString(), symbol["quoteAsset"].GetStringLength() };
-
-        sym.quotePrecision           = symbol["quotePrecision"].GetInt();
-        sym.quoteAssetPrecision      = symbol["quoteAssetPrecision"].GetInt();
-        sym.baseCommissionPrecision  = symbol["baseCommissionPrecision"].GetInt();
-        sym.quoteCommissionPrecision = symbol["quoteCommissionPrecision"].GetInt();
-        // Order Types
-        for (const auto &orderTypes : symbol["orderTypes"].GetArray())
-        {
-            std::string type = orderTypes.GetString();
-            if (type == "LIMIT")
-                sym.orderType.set(static_cast<uint64_t>(OrderType::limit));
-            else if (type == "LIMIT_MAKER")
-                sym.orderType.set(static_cast<uint64_t>(OrderType::limitMaker));
-            else if (type == "MARKET")
-                sym.orderType.set(static_cast<uint64_t>(OrderType::market));
-            else if (type == "STOP_LOSS_LIMIT")
-                sym.orderType.set(static_cast<uint64_t>(OrderType::stopLossLimit));
-            else if (type == "TAKE_PROFIT_LIMIT")
-                sym.orderType.set(static_cast<uint64_t>(OrderType::takeProfitLimit));
-            else
-            {
-                // The schema forbids this scenario
-            }
-        }
-        sym.icebergAllowed             = symbol["icebergAllowed"].GetBool();
-        sym.ocoAllowed                 = symbol["ocoAllowed"].GetBool();
-        sym.quoteOrderQtyMarketAllowed = symbol["quoteOrderQtyMarketAllowed"].GetBool();
-        // Filters
-        for (const auto &filters : symbol["filters"].GetArray())
-        {
-            std::string filterType = filters["filterType"].GetString();
-
-            if (filterType == "PRICE_FILTER")
-            {
-                sym.eifPrice.present  = true;
-                sym.eifPrice.minPrice = std::stod(filters["minPrice"].GetString());
-                sym.eifPrice.maxPrice = std::stod(filters["maxPrice"].GetString());
-                sym.eifPrice.tickSize = std::stod(filters["tickSize"].GetString());
-            }
-            else if (filterType == "PERCENT_PRICE")
-            {
-                sym.eifPercentPrice.present          = true;
-                sym.eifPercentPrice.multiplierUp     = std::stod(filters["multiplierUp"].GetString());
-                sym.eifPercentPrice.multiplierDown   = std::stod(filters["multiplierDown"].GetString());
-                sym.eifPercentPrice.averagePriceMins = filters["avgPriceMins"].GetInt();
-            }
-            else if (filterType == "LOT_SIZE")
-            {
-                sym.eifLotSize.present  = true;
-                sym.eifLotSize.minQty   = std::stod(filters["minQty"].GetString());
-                sym.eifLotSize.maxQty   = std::stod(filters["maxQty"].GetString());
-                sym.eifLotSize.stepSize = std::stod(filters["stepSize"].GetString());
-            }
-            else if (filterType == "MIN_NOTIONAL")
-            {
-                sym.eifMinNotional.present          = true;
-                sym.eifMinNotional.minNotional      = std::stod(filters["minNotional"].GetString());
-                sym.eifMinNotional.applyToMarket    = filters["applyToMarket"].GetBool();
-                sym.eifMinNotional.averagePriceMins = filters["avgPriceMins"].GetInt();
-            }
-            else if (filterType == "ICEBERG_PARTS")
-            {
-                sym.eifIcebergParts.present = true;
-                sym.eifIcebergParts.limit   = filters["limit"].GetInt();
-            }
-            else if (filterType == "MARKET_LOT_SIZE")
-            {
-                sym.eifMarketLotSize.present  = true;
-                sym.eifMarketLotSize.minQty   = std::stod(filters["minQty"].GetString());
-                sym.eifMarketLotSize.maxQty   = std::stod(filters["maxQty"].GetString());
-                sym.eifMarketLotSize.stepSize = std::stod(filters["stepSize"].GetString());
-            }
-            else if (filterType == "MAX_NUM_ALGO_ORDERS")
-            {
-                sym.eifMaxNumAlgoOrders.present          = true;
-                sym.eifMaxNumAlgoOrders.maxNumAlgoOrders = filters["maxNumAlgoOrders"].GetInt();
-            }
-            else if (filterType == "MAX_NUM_ORDERS")
-            {
-                sym.eifMaxNumOrders.present      = true;
-                sym.eifMaxNumOrders.maxNumOrders = filters["maxNumOrders"].GetInt();
-            }
-            else if (filterType == "MAX_NUM_ICEBERG_ORDERS")
-            {
-                sym.eifMaxNumIcerbergOrders.present             = true;
-                sym.eifMaxNumIcerbergOrders.maxNumIcebergOrders = filters["maxNumIcebergOrders"].GetInt();
-            }
-            else if (filterType == "MAX_POSITION")
-            {
-                sym.eifMaxPosition.present     = true;
-                sym.eifMaxPosition.maxPosition = std::stod(filters["maxPosition"].GetString());
-            }
-        }
-        // Permissions
-        for (const auto &permissions : symbol["permissions"].GetArray())
-        {
-            std::string type { permissions.GetString(), permissions.GetStringLength() };
-            if (type == "SPOT")
-                sym.permissions.set(SPOT::AccountPermissions::spot);
-            else if (type == "MARGIN")
-                sym.permissions.set(SPOT::AccountPermissions::margin);
-            else if (type == "LEVERAGED")
-                sym.permissions.set(SPOT::AccountPermissions::leveraged);
-            else
-            {
-                // The schema forbids this scenario
-            }
-        }
-
-        // Add to list
-        exchangeInfo.symbols[sym.symbol] = sym;
-    }
-
-    return exchangeInfo;
+    // The response is several megabytes; it is read in a single pass with no intermediate document
+    local::ExchangeInformationHandler handler;
+    apiRequest(g_spotRequests[EXCHANGE_INFORMATION], {}, handler);
+    return handler.take();
 }
 auto binapi::BinanceAPISpot::getOrderBook(binapi::v_sym_t symbol, uint32_t limit) -> binapi::SPOT::OrderBook
 {
@@ -1386,33 +1166,36 @@ auto binapi::BinanceAPISpot::getOrderBook(binapi::v_sym_t symbol, uint32_t limit
         { "limit", limit == 0 ? "1" : (limit > 5000 ? "5000" : fmt::to_string(limit))}
     };
 
-    rapidjson::Document doc;
+    // ResponseDocument is not assignable, so the request is chosen before making it
+    SPOTRequests request;
 
     if (limit >= 1 && limit <= 100)
-        doc = apiRequest(g_spotRequests[ORDER_BOOK_1], parameters);
+        request = ORDER_BOOK_1;
     else if (limit >= 101 && limit <= 500)
-        doc = apiRequest(g_spotRequests[ORDER_BOOK_5], parameters);
+        request = ORDER_BOOK_5;
     else if (limit >= 501 && limit <= 1000)
-        doc = apiRequest(g_spotRequests[ORDER_BOOK_10], parameters);
+        request = ORDER_BOOK_10;
     else if (limit >= 1001 && limit <= 5000)
-        doc = apiRequest(g_spotRequests[ORDER_BOOK_50], parameters);
+        request = ORDER_BOOK_50;
     else
         return {};
 
+    auto doc = apiRequest(g_spotRequests[request], parameters);
+
     SPOT::OrderBook ob;
     ob.lastUpdateId = doc["lastUpdateId"].GetUint64();
 
     for (const auto &bids : doc["bids"].GetArray())
     {
         ob.bids.push_back(
-            { std::stod({ bids[0].GetString(), bids[0].GetStringLength() }),
-                std::stod({ bids[1].GetString(), bids[1].GetStringLength() }) });
+            { jsonToDouble(bids[0]),
+                jsonToDouble(bids[1]) });
     }
     for (const auto &asks : doc["asks"].GetArray())
     {
         ob.asks.push_back(
-            { std::stod({ asks[0].GetString(), asks[0].GetStringLength() }),
-                std::stod({ asks[1].GetString(), asks[1].GetStringLength() }) });
+            { jsonToDouble(asks[0]),
+                jsonToDouble(asks[1]) });
     }
 
     return ob;
@@ -1531,6 +1314,9 @@ auto binapi::BinanceAPISpot::compressedAggregateTradeList(v_sym_t symbol, uint64
 
 auto binapi::BinanceAPISpot::candlestickData(v_sym_t symbol, BinanceTimeIntervals bti, uint64_t startTime, uint64_t endTime, uint64_t limit) -> std::vector<Candlestick>
 {
+    // Binance rejects a limit of 0 and never returns more than 1000 candles per call
+    limit = std::clamp<uint64_t>(limit, 1, 1000);
+
     eparams parameters {
         { "symbol", VIEW_INIT(symbol) },
         { "interval", VIEW_INIT(fromIntervalToString(bti)) },
@@ -1546,59 +1332,9 @@ auto binapi::BinanceAPISpot::candlestickData(v_sym_t symbol, BinanceTimeInterval
         parameters.emplace_back("startTime", fmt::to_string(startTime));
     }
 
-    auto doc = apiRequest(g_spotRequests[CANDLESTICK], parameters, false);
-
-    std::vector<Candlestick> cdl;
-    for (const auto &candleData : doc.GetArray())
-    {
-        std::size_t i = 0;
-        Candlestick csd {};
-        for (const auto &candle : candleData.GetArray())
-        {
-            switch (i)
-            {
-                case 0:
-                    csd.openTime = candle.GetUint64();
-                    break;
-                case 1:
-                    csd.open = std::stod(candle.GetString());
-                    break;
-                case 2:
-                    csd.high = std::stod(candle.GetString());
-                    break;
-                case 3:
-                    csd.low = std::stod(candle.GetString());
-                    break;
-                case 4:
-                    csd.close = std::stod(candle.GetString());
-                    break;
-                case 5:
-                    csd.volume = std::stod(candle.GetString());
-                    break;
-                case 6:
-                    csd.closeTime = candle.GetUint64();
-                    break;
-                case 7:
-                    csd.quoteAssetVolume = std::stod(candle.GetString());
-                    break;
-                case 8:
-                    csd.numberOfTrades = candle.GetUint64();
-                    break;
-                case 9:
-                    csd.takerBaseAssetVolume = std::stod(candle.GetString());
-                    break;
-                case 10:
-                    csd.takerQuoteAssetVolume = std::stod(candle.GetString());
-                    break;
-                default:
-                    break;
-            }
-            ++i;
-        }
-        cdl.push_back(csd);
-    }
-
-    return cdl;
+    local::CandlestickHandler handler(limit);
+    apiRequest(g_spotRequests[CANDLESTICK], parameters, handler, false);
+    return handler.take();
 }
 
 auto binapi::BinanceAPISpot::currentAveragePrice(v_sym_t symbol) -> SPOT::AveragePrice
@@ -1677,6 +1413,7 @@ auto binapi::BinanceAPISpot::tickerPriceChangeStatistics24hr(const std::vector<s
 
     auto doc = apiRequest(g_spotRequests[request], parameters, false);
 
+    smsstpcs.reserve(doc.Size());
     for (const auto &data : doc.GetArray())
     {
         smsstpcs[JTO_STRING(data, "symbol")] = SPOT::TickerPriceChangeStatistics {
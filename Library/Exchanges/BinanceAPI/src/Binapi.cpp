@@ -6,34 +6,15 @@
 
 #include "Binapi.hpp"
 #include "APIException.hpp"
+#include "BinanceAPISigner.hpp"
 #include "schemas.hpp"
+#include <algorithm>
 #include <array>
+#include <chrono>
 #include <fmt/format.h>
 #include <iostream>
 #include <random>
 
-#if defined(__clang__) || defined(__GNUC__)
-BINAPI_WARN_PUSH
-// clang-format off
-BINAPI_WARN_OFF(old-style-cast)
-BINAPI_WARN_OFF(padded)
-BINAPI_WARN_OFF(deprecated-volatile)
-BINAPI_WARN_OFF(weak-vtables)
-BINAPI_WARN_OFF(documentation-unknown-command)
-BINAPI_WARN_OFF(reserved-id-macro)
-BINAPI_WARN_OFF(documentation-deprecated-sync)
-BINAPI_WARN_OFF(undefined-func-template)
-BINAPI_WARN_OFF(nonportable-system-include-path)
-BINAPI_WARN_OFF(language-extension-token)
-// clang-format on
-#endif /*defined(__clang__) || defined(__GNUC__)*/
-
-#include <openssl/hmac.h>
-
-#if defined(__clang__) || defined(__GNUC__)
-BINAPI_WARN_POP
-#endif /*defined(__clang__) || defined(__GNUC__)*/
-
 namespace BINAPI_NAMESPACE::local
 {
     auto BINAPI_HIDDEN loadJsonSchema(const char *schemaData) noexcept -> rapidjson::SchemaDocument
@@ -56,35 +37,93 @@ namespace BINAPI_NAMESPACE::local
 
 namespace
 {
-    /// \brief Used in HMAC to fastly convert unsigned char to char*
-    // clang-format off
-    constexpr std::array<std::string_view, 256> g_toString = {
-        "00", "01", "02", "03", "04", "05", "06", "07", "08", "09", "0a", "0b", "0c", "0d", "0e", "0f",
-        "10", "11", "12", "13", "14", "15", "16", "17", "18", "19", "1a", "1b", "1c", "1d", "1e", "1f",
-        "20", "21", "22", "23", "24", "25", "26", "27", "28", "29", "2a", "2b", "2c", "2d", "2e", "2f",
-        "30", "31", "32", "33", "34", "35", "36", "37", "38", "39", "3a", "3b", "3c", "3d", "3e", "3f",
-        "40", "41", "42", "43", "44", "45", "46", "47", "48", "49", "4a", "4b", "4c", "4d", "4e", "4f",
-        "50", "51", "52", "53", "54", "55", "56", "57", "58", "59", "5a", "5b", "5c", "5d", "5e", "5f",
-        "60", "61", "62", "63", "64", "65", "66", "67", "68", "69", "6a", "6b", "6c", "6d", "6e", "6f",
-        "70", "71", "72", "73", "74", "75", "76", "77", "78", "79", "7a", "7b", "7c", "7d", "7e", "7f",
-        "80", "81", "82", "83", "84", "85", "86", "87", "88", "89", "8a", "8b", "8c", "8d", "8e", "8f",
-        "90", "91", "92", "93", "94", "95", "96", "97", "98", "99", "9a", "9b", "9c", "9d", "9e", "9f",
-        "a0", "a1", "a2", "a3", "a4", "a5", "a6", "a7", "a8", "a9", "aa", "ab", "ac", "ad", "ae", "af",
-        "b0", "b1", "b2", "b3", "b4", "b5", "b6", "b7", "b8", "b9", "ba", "bb", "bc", "bd", "be", "bf",
-        "c0", "c1", "c2", "c3", "c4", "c5", "c6", "c7", "c8", "c9", "ca", "cb", "cc", "cd", "ce", "cf",
-        "d0", "d1", "d2", "d3", "d4", "d5", "d6", "d7", "d8", "d9", "da", "db", "dc", "dd", "de", "df",
-        "e0", "e1", "e2", "e3", "e4", "e5", "e6", "e7", "e8", "e9", "ea", "eb", "ec", "ed", "ee", "ef",
-        "f0", "f1", "f2", "f3", "f4", "f5", "f6", "f7", "f8", "f9", "fa", "fb", "fc", "fd", "fe", "ff"
+    // Client identifiers of the BinanceAPI objects for RequestScheduler
+    std::atomic<uint64_t> g_schedulerClients { 1 };
+
+    /// \brief Same check as the schemas::api_error and schemas::sapi_error schemas
+    auto isErrorResponse(bool isSAPI, const rapidjson::Value &value) -> bool
+    {
+        if (!value.IsObject())
+            return false;
+
+        const auto msg = value.FindMember("msg");
+        if (msg == value.MemberEnd() || !msg->value.IsString())
+            return false;
+
+        if (isSAPI)
+        {
+            const auto success = value.FindMember("success");
+            if (success == value.MemberEnd())
+                return value.MemberCount() == 1;
+            return success->value.IsBool() && value.MemberCount() == 2;
+        }
+
+        const auto code = value.FindMember("code");
+        return code != value.MemberEnd() && code->value.IsNumber() && value.MemberCount() == 2;
+    }
+
+    /// \brief Phases of the last transfer of a handle. CURL gives every time from the start of the transfer
+    auto transferTimings(CURL *handle) noexcept -> BINAPI_NAMESPACE::TransferTimings
+    {
+        curl_off_t nameLookup = 0, connect = 0, appConnect = 0, preTransfer = 0, startTransfer = 0, total = 0;
+        curl_easy_getinfo(handle, CURLINFO_NAMELOOKUP_TIME_T, &nameLookup);
+        curl_easy_getinfo(handle, CURLINFO_CONNECT_TIME_T, &connect);
+        curl_easy_getinfo(handle, CURLINFO_APPCONNECT_TIME_T, &appConnect);
+        curl_easy_getinfo(handle, CURLINFO_PRETRANSFER_TIME_T, &preTransfer);
+        curl_easy_getinfo(handle, CURLINFO_STARTTRANSFER_TIME_T, &startTransfer);
+        curl_easy_getinfo(handle, CURLINFO_TOTAL_TIME_T, &total);
+
+        const auto span = [](curl_off_t from, curl_off_t to) noexcept {
+            return std::chrono::microseconds { std::max<curl_off_t>(to - from, 0) };
+        };
+
+        return {
+            .dns      = span(0, nameLookup),
+            .connect  = span(nameLookup, connect),
+            // Zero when the connection was reused: no TLS handshake was made
+            .tls      = appConnect == 0 ? std::chrono::microseconds { 0 } : span(connect, appConnect),
+            .wait     = span(preTransfer, startTransfer),
+            .transfer = span(startTransfer, total)
+        };
+    }
+
+    /// \brief Records the time of a phase when the scope ends
+    class PhaseTimer final
+    {
+    public:
+        PhaseTimer(BINAPI_NAMESPACE::RequestMetrics &metrics, std::string_view endPoint, BINAPI_NAMESPACE::RequestPhase phase) noexcept :
+            m_metrics { metrics },
+            m_endPoint { endPoint },
+            m_phase { phase },
+            m_start { std::chrono::steady_clock::now() } { }
+
+        ~PhaseTimer()
+        {
+            m_metrics.recordPhase(m_endPoint, m_phase, std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start));
+        }
+
+        PhaseTimer(const PhaseTimer &)                     = delete;
+        auto operator=(const PhaseTimer &) -> PhaseTimer & = delete;
+
+    private:
+        BINAPI_NAMESPACE::RequestMetrics &m_metrics;
+        std::string_view m_endPoint;
+        BINAPI_NAMESPACE::RequestPhase m_phase;
+        std::chrono::steady_clock::time_point m_start;
     };
-    // clang-format on
-    constexpr unsigned int hashSize = EVP_MAX_MD_SIZE;
 } // namespace
 
 BINAPI_NAMESPACE::BinanceAPI::BinanceAPI(std::string_view baseURL, std::string_view userAgent, BinanceKeys *keys, BinanceLimits *exl) noexcept :
     m_baseURL { std::move(baseURL) },
     m_userAgent { std::move(userAgent) },
     m_binanceKeys { keys },
-    m_binanceLimits { exl }
+    m_binanceLimits { exl },
+    m_connectionPool { std::make_unique<BinanceAPIConnectionPool>() },
+    m_responseCache { std::make_unique<ResponseCache>() },
+    m_requestCoalescer { std::make_unique<RequestCoalescer>() },
+    m_requestMetrics { std::make_unique<RequestMetrics>() },
+    m_clockOffset { std::make_unique<ClockOffset>() },
+    m_schedulerClient { g_schedulerClients.fetch_add(1, std::memory_order_relaxed) }
 {
 }
 
@@ -92,23 +131,14 @@ BINAPI_NAMESPACE::BinanceAPI::~BinanceAPI() noexcept = default;
 
 auto BINAPI_NAMESPACE::BinanceAPI::HMAC256(const std::string &key, const std::string &plainText, char *out) noexcept -> void
 {
-    unsigned int locHashSize = hashSize;
-    unsigned char *str       = ::HMAC(EVP_sha256(),
-              key.c_str(),
-              static_cast<int>(key.size()),
-              reinterpret_cast<const unsigned char *>(plainText.c_str()),
-              plainText.size(),
-              nullptr,
-              &locHashSize);
-
-    // Copy the string using some C-style code
-    auto k = 0ul;
-    for (auto i = 0ul; i < locHashSize; i++)
-    {
-        for (auto j = 0ul; j < 2; ++j, ++k)
-            out[k] = g_toString[str[i]][j]; // fmt::format("{:02x}", str[i]);
+    // The key schedule is done once per key and thread
+    try
+    {
+        local::HMACSigner::forThread(key).sign(plainText, out);
+    } catch (...)
+    {
+        out[0] = 0;
     }
-    out[k] = 0;
 }
 
 auto BINAPI_NAMESPACE::BinanceAPI::getKeys() const noexcept -> BinanceKeys *
@@ -123,7 +153,7 @@ auto BINAPI_NAMESPACE::BinanceAPI::getLimits() const noexcept -> BinanceLimits *
 
 auto BINAPI_NAMESPACE::BinanceAPI::getLastCallTime() const noexcept -> double
 {
-    return m_lastCallSeconds;
+    return m_lastCallSeconds.load(std::memory_order_relaxed);
 }
 
 auto BINAPI_NAMESPACE::BinanceAPI::getTime() noexcept -> uint64_t
@@ -146,6 +176,52 @@ auto BINAPI_NAMESPACE::BinanceAPI::getRecvWindow() const noexcept -> uint32_t
     return m_recvWindow;
 }
 
+auto BINAPI_NAMESPACE::BinanceAPI::getConnectionPool() const noexcept -> BinanceAPIConnectionPool *
+{
+    return m_connectionPool.get();
+}
+
+auto BINAPI_NAMESPACE::BinanceAPI::getResponseCache() const noexcept -> ResponseCache *
+{
+    return m_responseCache.get();
+}
+
+auto BINAPI_NAMESPACE::BinanceAPI::getRequestCoalescer() const noexcept -> RequestCoalescer *
+{
+    return m_requestCoalescer.get();
+}
+
+auto BINAPI_NAMESPACE::BinanceAPI::getRequestMetrics() const noexcept -> RequestMetrics *
+{
+    return m_requestMetrics.get();
+}
+
+auto BINAPI_NAMESPACE::BinanceAPI::getClockOffset() const noexcept -> ClockOffset *
+{
+    return m_clockOffset.get();
+}
+
+auto BINAPI_NAMESPACE::BinanceAPI::setSchemaValidation(SchemaValidation validation, uint32_t sampling) noexcept -> void
+{
+    m_validationSampling.store(sampling == 0 ? 1 : sampling, std::memory_order_relaxed);
+    m_schemaValidation.store(validation, std::memory_order_relaxed);
+}
+
+auto BINAPI_NAMESPACE::BinanceAPI::setDefaultPriority(RequestPriority priority) noexcept -> void
+{
+    m_defaultPriority.store(priority, std::memory_order_relaxed);
+}
+
+auto BINAPI_NAMESPACE::BinanceAPI::getDefaultPriority() const noexcept -> RequestPriority
+{
+    return m_defaultPriority.load(std::memory_order_relaxed);
+}
+
+auto BINAPI_NAMESPACE::BinanceAPI::getSchemaValidation() const noexcept -> SchemaValidation
+{
+    return m_schemaValidation.load(std::memory_order_relaxed);
+}
+
 auto BINAPI_NAMESPACE::BinanceAPI::getCandlesTimesAndLimits(BinanceTimeIntervals interval, uint64_t startTime, uint64_t endTime, uint64_t &totalExpected) noexcept -> std::vector<std::tuple<uint64_t, uint64_t, uint64_t>>
 {
     std::vector<std::tuple<uint64_t, uint64_t, uint64_t>> data;
@@ -189,55 +265,265 @@ auto BINAPI_NAMESPACE::BinanceAPI::getCandlesTimesAndLimits(BinanceTimeIntervals
     return data;
 }
 
-auto BINAPI_NAMESPACE::BinanceAPI::request(const local::BinanceAPIRequest &request, const std::vector<std::pair<std::string, std::string>> &params, bool secure, double *const timeLog) -> rapidjson::Document
+auto BINAPI_NAMESPACE::BinanceAPI::request(const local::BinanceAPIRequest &request, const std::vector<std::pair<std::string, std::string>> &params, bool secure, double *const timeLog) -> local::ResponseDocument
 {
-    using namespace BINAPI_NAMESPACE::local;
+    const PhaseTimer total { *m_requestMetrics, request.endPoint, RequestPhase::total };
+    try
+    {
+        return requestDocument(request, params, secure, timeLog);
+    } catch (const APIException &ex)
+    {
+        m_requestMetrics->recordError(request.endPoint, ex.type());
+        throw;
+    }
+}
 
-    cpr::Url url { fmt::format("{}{}", m_baseURL, request.endPoint) };
+auto BINAPI_NAMESPACE::BinanceAPI::request(const local::BinanceAPIRequest &request, const std::vector<std::pair<std::string, std::string>> &params, local::TypedHandler &handler, bool secure, double *const timeLog) -> void
+{
+    const PhaseTimer total { *m_requestMetrics, request.endPoint, RequestPhase::total };
+    try
+    {
+        requestTyped(request, params, handler, secure, timeLog);
+    } catch (const APIException &ex)
+    {
+        m_requestMetrics->recordError(request.endPoint, ex.type());
+        throw;
+    }
+}
+
+auto BINAPI_NAMESPACE::BinanceAPI::requestDocument(const local::BinanceAPIRequest &request, const eparams &params, bool secure, double *const timeLog) -> local::ResponseDocument
+{
+    if (!isCached(request))
+    {
+        cpr::Response apiCall = transfer(request, params, secure, timeLog);
+        const PhaseTimer parse { *m_requestMetrics, request.endPoint, RequestPhase::parse };
+        return parseResponse(request, apiCall, validateNextResponse());
+    }
+
+    const auto key = cacheKey(request, params, secure);
+    std::shared_ptr<const std::string> cached;
+    cpr::Response apiCall = cachedRequest(request, params, secure, timeLog, key, cached);
+
+    // Cached bodies were checked when they were stored. The document takes a copy, since it is parsed in situ
+    if (cached != nullptr)
+    {
+        const PhaseTimer parse { *m_requestMetrics, request.endPoint, RequestPhase::parse };
+        return local::ResponseDocument { std::string { *cached } };
+    }
 
-    cpr::Parameters parameters;
-    cpr::Session session;
+    std::string body = apiCall.text;
+    auto document    = [&]() {
+        const PhaseTimer parse { *m_requestMetrics, request.endPoint, RequestPhase::parse };
+        return parseResponse(request, apiCall, validateNextResponse());
+    }();
+    storeResponse(request, key, std::move(body), apiCall.header);
+    return document;
+}
 
-    for (const auto &[key, value] : params)
-        parameters.Add({ key, value });
+auto BINAPI_NAMESPACE::BinanceAPI::requestTyped(const local::BinanceAPIRequest &request, const eparams &params, local::TypedHandler &handler, bool secure, double *const timeLog) -> void
+{
+    std::string key;
+    std::shared_ptr<const std::string> cached;
+    cpr::Response apiCall;
 
-    if (secure)
+    if (isCached(request))
     {
-        // Do proper changes to the data
-        secureRequest(session, parameters, *session.GetCurlHolder(), request.preventSignatureWhenSigned);
+        key     = cacheKey(request, params, secure);
+        apiCall = cachedRequest(request, params, secure, timeLog, key, cached);
     }
+    else
+        apiCall = transfer(request, params, secure, timeLog);
 
-    session.SetUrl(url);
-    session.SetParameters(parameters);
-    session.SetUserAgent({ m_userAgent.data(), m_userAgent.size() });
+    std::string error;
+    bool parsed = false;
+    {
+        // One sample per response, the DOM fallback of the errors included
+        const PhaseTimer parse { *m_requestMetrics, request.endPoint, RequestPhase::parse };
+        parsed = cached != nullptr ? local::parseTyped(*cached, handler, nullptr, error)
+                                   : local::parseTyped(apiCall.text, handler, validateNextResponse() ? request.docSchema.get() : nullptr, error);
+
+        // Error bodies and malformed data are rare. The DOM path reports them exactly as before
+        if (!parsed && cached == nullptr)
+            (void)parseResponse(request, apiCall, true);
+    }
 
-    bool secureRequest;
-    secureRequest = m_binanceLimits->secureCall(request.callWeight);
-    if (request.isOrderCall && secureRequest)
-        secureRequest = m_binanceLimits->secureOrderCall(request.callWeight);
+    if (cached != nullptr)
+    {
+        if (parsed)
+            return;
+        throw APIException(APIException::Type::schema, cpr::Url { fmt::format("{}{}", m_baseURL, request.endPoint) }, error);
+    }
 
-    if (!secureRequest)
+    if (parsed)
+    {
+        if (!key.empty())
+            storeResponse(request, key, std::move(apiCall.text), apiCall.header);
+        return;
+    }
+
+    throw APIException(APIException::Type::schema, apiCall.url, error);
+}
+
+auto BINAPI_NAMESPACE::BinanceAPI::isCached(const local::BinanceAPIRequest &request) const -> bool
+{
+    return request.http == local::HTTPRequest::GET && m_responseCache->getTimeToLive(request.endPoint).count() > 0;
+}
+
+auto BINAPI_NAMESPACE::BinanceAPI::cacheKey(const local::BinanceAPIRequest &request, const eparams &params, bool secure) const -> std::string
+{
+    // Signed responses belong to an account
+    const std::string_view identity = secure && m_binanceKeys != nullptr ? std::string_view { m_binanceKeys->apiKey } : std::string_view {};
+    return ResponseCache::makeKey(request.endPoint, params, identity);
+}
+
+auto BINAPI_NAMESPACE::BinanceAPI::cachedRequest(const local::BinanceAPIRequest &request, const eparams &params, bool secure, double *const timeLog, const std::string &key, std::shared_ptr<const std::string> &cached) -> cpr::Response
+{
+    auto lookup = m_responseCache->find(request.endPoint, key, request.callWeight);
+    if (lookup.body != nullptr)
+    {
+        if (timeLog != nullptr)
+            *timeLog = 0.0;
+        cached = std::move(lookup.body);
+        return {};
+    }
+
+    cpr::Header conditional;
+    for (auto &[header, value] : lookup.conditional)
+        conditional.emplace(std::move(header), std::move(value));
+
+    cpr::Response apiCall = transfer(request, params, secure, timeLog, conditional);
+    if (apiCall.status_code == 304)
+    {
+        cached = m_responseCache->revalidated(request.endPoint, key);
+        // The entry was invalidated while the call was made
+        if (cached == nullptr)
+            apiCall = transfer(request, params, secure, timeLog);
+    }
+    return apiCall;
+}
+
+auto BINAPI_NAMESPACE::BinanceAPI::priorityOf(const local::BinanceAPIRequest &request) const noexcept -> RequestPriority
+{
+    return request.isOrderCall ? RequestPriority::trading : RequestPriorityScope::current().value_or(getDefaultPriority());
+}
+
+auto BINAPI_NAMESPACE::BinanceAPI::transfer(const local::BinanceAPIRequest &request, const eparams &params, bool secure, double *const timeLog, const cpr::Header &conditional) -> cpr::Response
+{
+    if (request.http != local::HTTPRequest::GET || request.isOrderCall || !m_requestCoalescer->isEnabled())
+        return performRequest(request, params, secure, timeLog, conditional);
+
+    // A conditional call may be answered with a 304, so it is only identical to calls with the same validators
+    auto key = cacheKey(request, params, secure);
+    for (const auto &[header, value] : conditional)
+        key.append(fmt::format("|{}:{}", header, value));
+
+    // A call only joins an identical one of its RequestPriority or a higher one
+    cpr::Response apiCall = m_requestCoalescer->run(request.endPoint, key, request.callWeight, priorityOf(request), [&] {
+        return performRequest(request, params, secure, nullptr, conditional);
+    });
+
+    if (timeLog != nullptr)
+        *timeLog = apiCall.elapsed;
+
+    return apiCall;
+}
+
+auto BINAPI_NAMESPACE::BinanceAPI::storeResponse(const local::BinanceAPIRequest &request, const std::string &key, std::string body, const cpr::Header &headers) -> void
+{
+    const auto header = [&headers](const char *name) -> std::string {
+        const auto value = headers.find(name);
+        return value == headers.end() ? std::string {} : value->second;
+    };
+
+    m_responseCache->store(request.endPoint, key, std::move(body), header("ETag"), header("Last-Modified"));
+}
+
+auto BINAPI_NAMESPACE::BinanceAPI::validateNextResponse() noexcept -> bool
+{
+    switch (m_schemaValidation.load(std::memory_order_relaxed))
+    {
+        case SchemaValidation::full:
+            return true;
+        case SchemaValidation::sampled:
+            return m_validationCounter.fetch_add(1, std::memory_order_relaxed) % m_validationSampling.load(std::memory_order_relaxed) == 0;
+        case SchemaValidation::off:
+            return false;
+    }
+    return true;
+}
+
+auto BINAPI_NAMESPACE::BinanceAPI::performRequest(const local::BinanceAPIRequest &request, const std::vector<std::pair<std::string, std::string>> &params, bool secure, double *const timeLog, const cpr::Header &conditional) -> cpr::Response
+{
+    using namespace BINAPI_NAMESPACE::local;
+
+    cpr::Url url { fmt::format("{}{}", m_baseURL, request.endPoint) };
+
+    // With BinanceLimits::setWaitForCapacity the call waits for the weight instead of failing at once.
+    // While waiting, the scheduler serves orders first, then interactive calls, then the background ones
+    const auto priority = priorityOf(request);
+    const auto deadline = std::chrono::steady_clock::now() + m_binanceLimits->getWaitForCapacity();
+    if (!m_binanceLimits->getScheduler().admit(request.callWeight, request.isOrderCall, priority, m_schedulerClient, deadline))
     {
         throw APIException(APIException::Type::limits, "limits reached");
     }
+    // Ends the call in the limits even if the transfer throws
+    BinanceLimits::Admission admission { *m_binanceLimits, request.callWeight, request.isOrderCall };
 
     cpr::Response apiCall;
-    switch (request.http)
-    {
-        case HTTPRequest::GET:
-            apiCall = session.Get();
-            break;
-        case HTTPRequest::DELETE:
-            apiCall = session.Delete();
-            break;
-        case HTTPRequest::POST:
-            apiCall = session.Post();
-            break;
-        case HTTPRequest::PUT:
-            apiCall = session.Put();
-            break;
+    {
+        // Sessions are kept alive between calls, so the TCP and TLS handshakes are only made once per pooled session.
+        // The session goes back to the pool as soon as the transfer is done
+        auto lease            = m_connectionPool->acquire(m_baseURL);
+        cpr::Session &session = *lease;
+
+        cpr::Parameters parameters;
+        for (const auto &[key, value] : params)
+            parameters.Add({ key, value });
+
+        if (secure)
+        {
+            // Do proper changes to the data
+            secureRequest(session, parameters, *session.GetCurlHolder(), request.preventSignatureWhenSigned);
+        }
+        else
+        {
+            // A pooled session may still hold the API-Key header from a previous signed call
+            session.SetHeader(cpr::Header {});
+        }
+
+        // If-None-Match and If-Modified-Since of an expired cache entry
+        if (!conditional.empty())
+            session.UpdateHeader(conditional);
+
+        session.SetUrl(url);
+        session.SetParameters(parameters);
+        session.SetUserAgent({ m_userAgent.data(), m_userAgent.size() });
+
+        switch (request.http)
+        {
+            case HTTPRequest::GET:
+                apiCall = session.Get();
+                break;
+            case HTTPRequest::DELETE:
+                apiCall = session.Delete();
+                break;
+            case HTTPRequest::POST:
+                apiCall = session.Post();
+                break;
+            case HTTPRequest::PUT:
+                apiCall = session.Put();
+                break;
+        }
+        lease.transferred();
+
+        // Read before the session goes back to the pool
+        if (apiCall.error.code == cpr::ErrorCode::OK)
+            m_requestMetrics->recordTransfer(request.endPoint, transferTimings(session.GetCurlHolder()->handle), request.callWeight);
     }
 
+    // The server counts are used to re-synchronize the limits
+    admission.completed(apiCall.header, apiCall.status_code);
+
     // Log Time
     if (timeLog != nullptr)
         *timeLog = apiCall.elapsed;
@@ -249,8 +535,8 @@ auto BINAPI_NAMESPACE::BinanceAPI::request(const local::BinanceAPIRequest &reque
         throw APIException(APIException::Type::request, static_cast<int>(apiCall.error.code), apiCall.url, apiCall.error.message);
     }
 
-    // HTTP Error checking
-    if (apiCall.status_code != 200)
+    // HTTP Error checking. With validators, 304 Not Modified means the cached response is still valid
+    if (apiCall.status_code != 200 && !(apiCall.status_code == 304 && !conditional.empty()))
     {
         if (apiCall.header["content-type"] == "application/json;charset=UTF-8" || apiCall.header["content-type"] == "application/json")
         {
@@ -265,22 +551,38 @@ auto BINAPI_NAMESPACE::BinanceAPI::request(const local::BinanceAPIRequest &reque
         }
     }
 
-    rapidjson::Document jsonDoc;
-    jsonDoc.Parse(apiCall.text.c_str());
+    return apiCall;
+}
+
+auto BINAPI_NAMESPACE::BinanceAPI::parseResponse(const local::BinanceAPIRequest &request, cpr::Response &apiCall, bool validate) -> local::ResponseDocument
+{
+    local::ResponseDocument jsonDoc(std::move(apiCall.text));
     if (jsonDoc.HasParseError())
     {
         throw APIException(APIException::Type::json, apiCall.url, fmt::format("{}. At Offset: {}", rapidjson::GetParseError_En(jsonDoc.GetParseError()), jsonDoc.GetErrorOffset()));
     }
 
-    rapidjson::SchemaValidator errorValidator(*request.errorSchema);
-    if (jsonDoc.Accept(errorValidator))
+    // Without validation the error schema is replaced by the equivalent structural check, which does not walk the document
+    bool isError = false;
+    if (validate)
+    {
+        rapidjson::SchemaValidator errorValidator(*request.errorSchema);
+        isError = jsonDoc.Accept(errorValidator);
+    }
+    else
+        isError = isErrorResponse(request.isSAPI, jsonDoc.root());
+
+    if (isError)
     {
         int code;
         std::string msg;
-        if (handleAPIRequestError(request.isSAPI, jsonDoc, code, msg))
+        if (handleAPIRequestError(request.isSAPI, jsonDoc.root(), code, msg))
             throw APIException(APIException::Type::api, code, apiCall.url, msg);
     }
 
+    if (!validate)
+        return jsonDoc;
+
     // Validate against the returned endpoint data
     rapidjson::SchemaValidator schemaValidator(*request.docSchema);
 
@@ -321,7 +623,7 @@ auto BINAPI_NAMESPACE::BinanceAPI::secureRequest(cpr::Session &session, cpr::Par
     // For USER_STREAM data.  This does not content any parameters
     if (!parametersContent.empty() && !preventSignature)
     {
-        char signature[hashSize + 1] {};
+        char signature[local::HMACSigner::signatureSize + 1] {};
         HMAC256(m_binanceKeys->secretKey, parametersContent, signature);
         parameters.Add({ "signature", signature });
     }
@@ -359,12 +661,23 @@ auto BINAPI_NAMESPACE::BinanceAPI::handleHTTPErrorResponse(const std::string &js
     message = jsonDoc["msg"].GetString();
 }
 
-auto BINAPI_NAMESPACE::BinanceAPI::apiRequest(const local::BinanceAPIRequest &requests, bool secure) -> rapidjson::Document
+auto BINAPI_NAMESPACE::BinanceAPI::apiRequest(const local::BinanceAPIRequest &requests, bool secure) -> local::ResponseDocument
+{
+    return apiRequest(requests, {}, secure);
+}
+
+auto BINAPI_NAMESPACE::BinanceAPI::apiRequest(const local::BinanceAPIRequest &requests, const std::vector<std::pair<std::string, std::string>> &parameters, bool secure) -> local::ResponseDocument
 {
-    return request(requests, {}, secure, &m_lastCallSeconds);
+    // The API can be called from several threads at the same time (see BinanceAPISpotAsync), so the time is not written directly
+    double elapsed = 0.0;
+    auto document  = request(requests, parameters, secure, &elapsed);
+    m_lastCallSeconds.store(elapsed, std::memory_order_relaxed);
+    return document;
 }
 
-auto BINAPI_NAMESPACE::BinanceAPI::apiRequest(const local::BinanceAPIRequest &requests, const std::vector<std::pair<std::string, std::string>> &parameters, bool secure) -> rapidjson::Document
+auto BINAPI_NAMESPACE::BinanceAPI::apiRequest(const local::BinanceAPIRequest &requests, const std::vector<std::pair<std::string, std::string>> &parameters, local::TypedHandler &handler, bool secure) -> void
 {
-    return request(requests, parameters, secure, &m_lastCallSeconds);
+    double elapsed = 0.0;
+    request(requests, parameters, handler, secure, &elapsed);
+    m_lastCallSeconds.store(elapsed, std::memory_order_relaxed);
 }
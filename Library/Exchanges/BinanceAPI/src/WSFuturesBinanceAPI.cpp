@@ -9,51 +9,25 @@
 #include "WSFuturesBinanceAPI.hpp"
 
 #include "Binapi.hpp"
+#include "BinanceAPINumeric.hpp"
+#include "BinanceAPIStreamEvents.hpp"
 #include <random>
 
 #include <fmt/color.h>
 #include <fmt/core.h>
 
-#define SUBSCRIBE_METHOD(stream)              \
-    if (!isRunning())                         \
-        return { stream };                    \
-    else                                      \
-    {                                         \
-        int id = randNumber();                \
-        while (true)                          \
-        {                                     \
-            if (!m_subscribeIds.contains(id)) \
-            {                                 \
-                m_subscribeIds.insert(id);    \
-                break;                        \
-            }                                 \
-        }                                     \
-        subscribe(std::string(stream), id);   \
-        return { id };                        \
-    }
+#define SUBSCRIBE_METHOD(stream)             \
+    if (!isRunning() && !isReconnecting()) \
+        return { stream };                   \
+    return { m_subscriptions.subscribe({ std::string(stream) }).id };
 
-#define UNSUBSCRIBE_METHOD(stream)              \
-    if (isRunning())                            \
-    {                                           \
-        int id = randNumber();                  \
-        while (true)                            \
-        {                                       \
-            if (!m_unsubscribeIds.contains(id)) \
-            {                                   \
-                m_unsubscribeIds.insert(id);    \
-                break;                          \
-            }                                   \
-        }                                       \
-        unsubscribe(std::string(stream), id);   \
-        return id;                              \
-    }                                           \
+#define UNSUBSCRIBE_METHOD(stream)                                       \
+    if (isRunning() || isReconnecting())                                 \
+        return m_subscriptions.unsubscribe({ std::string(stream) }).id; \
     return -1;
 
-#define JTO_STRING(x, y)                         \
-    std::string                                  \
-    {                                            \
-        x[y].GetString(), x[y].GetStringLength() \
-    }
+#define JTO_STRING(x, y) \
+    std::string { jsonToView(x[y]) }
 
 #ifdef __clang__
 #pragma clang diagnostic push
@@ -62,34 +36,6 @@
 
 namespace glstr
 {
-    constexpr std::string_view g_1m { "1m" };
-    constexpr std::string_view g_3m { "3m" };
-    constexpr std::string_view g_5m { "5m" };
-    constexpr std::string_view g_15m { "15m" };
-    constexpr std::string_view g_30m { "30m" };
-    constexpr std::string_view g_1h { "1h" };
-    constexpr std::string_view g_2h { "2h" };
-    constexpr std::string_view g_4h { "4h" };
-    constexpr std::string_view g_6h { "6h" };
-    constexpr std::string_view g_8h { "8h" };
-    constexpr std::string_view g_12h { "12h" };
-    constexpr std::string_view g_1d { "1d" };
-    constexpr std::string_view g_3d { "3d" };
-    constexpr std::string_view g_1w { "1w" };
-    constexpr std::string_view g_1M { "1M" };
-
-    constexpr std::string_view g_aggTrade { "aggTrade" };
-    constexpr std::string_view g_markPriceUpdate { "markPriceUpdate" };
-    constexpr std::string_view g_kline { "kline" };
-    constexpr std::string_view g_continuous_kline { "continuous_kline" };
-    constexpr std::string_view g_24hrMiniTicker { "24hrMiniTicker" };
-    constexpr std::string_view g_24hrTicker { "24hrTicker" };
-    constexpr std::string_view g_bookTicker { "bookTicke" };
-    constexpr std::string_view g_forceOrder { "forceOrder" };
-    constexpr std::string_view g_depthUpdate { "depthUpdate" };
-    constexpr std::string_view g_nav { "nav" };
-    constexpr std::string_view g_compositeIndex { "compositeIndex" };
-
     constexpr std::string_view g_PERPETUAL { "PERPETUAL" };
     constexpr std::string_view g_CURRENT_QUARTER { "CURRENT_QUARTER" };
     constexpr std::string_view g_NEXT_QUARTER { "NEXT_QUARTER" };
@@ -119,20 +65,36 @@ namespace
 } // namespace
 
 BINAPI_NAMESPACE::ws::WSFuturesBinanceAPI::WSFuturesBinanceAPI(std::string endPoint) :
-    BINAPI_NAMESPACE::ws::WSThread("fstream.binance.com", std::move(endPoint), 443)
+    BINAPI_NAMESPACE::ws::WSThread("fstream.binance.com", std::move(endPoint), 443),
+    m_subscriptions { [this] { requestMessage(); } }
 {
+    // One message of every second is left for the pings
+    setMessageRate(messageRateLimit - 1);
 }
 
-void BINAPI_NAMESPACE::ws::WSFuturesBinanceAPI::subscribe(const std::string &stream, int id)
+auto BINAPI_NAMESPACE::ws::WSFuturesBinanceAPI::subscriptions() noexcept -> WSSubscriptions &
 {
-    std::string subscribe = fmt::format(R"({{"method": "SUBSCRIBE","params":["{}"],"id":{}}})", stream, id);
-    sendData(subscribe);
+    return m_subscriptions;
 }
 
-void BINAPI_NAMESPACE::ws::WSFuturesBinanceAPI::unsubscribe(const std::string &stream, int id)
+auto BINAPI_NAMESPACE::ws::WSFuturesBinanceAPI::nextMessage() -> std::optional<std::string>
 {
-    std::string unsubscribe = fmt::format(R"({{"method": "UNSUBSCRIBE","params":["{}"],"id":{}}})", stream, id);
-    sendData(unsubscribe);
+    return m_subscriptions.nextMessage();
+}
+
+auto BINAPI_NAMESPACE::ws::WSFuturesBinanceAPI::disconnected(bool reconnecting) noexcept -> void
+{
+    // The subscriptions belong to the connection
+    if (!reconnecting)
+    {
+        m_subscriptions.reset();
+        m_sequences.clear();
+        return;
+    }
+
+    // Subscribed again as soon as the new connection is established. The sequences are kept to tell whether it missed any event
+    for (const auto &completion : m_subscriptions.resubscribe())
+        unsubscribe(completion.success, completion.id);
 }
 
 void BINAPI_NAMESPACE::ws::WSFuturesBinanceAPI::subscribe([[maybe_unused]] bool result, [[maybe_unused]] int id)
@@ -291,8 +253,9 @@ std::variant<std::string, int> BINAPI_NAMESPACE::ws::WSFuturesBinanceAPI::subscr
 
 void BINAPI_NAMESPACE::ws::WSFuturesBinanceAPI::receivedData()
 {
-    rapidjson::Document jsonDoc;
-    jsonDoc.Parse(getJsonData().c_str());
+    // Parsed in situ over the message, with the memory of the arena of the thread
+    const auto message = getMessage();
+    local::ResponseDocument jsonDoc(message.data(), message.size());
     if (jsonDoc.HasParseError())
     {
         fmt::print(fmt::fg(fmt::color::red), "STREAM ERROR: ");
@@ -302,347 +265,310 @@ void BINAPI_NAMESPACE::ws::WSFuturesBinanceAPI::receivedData()
 
     try
     {
-        // Test for (un)subscription messages
-        if (jsonDoc.FindMember("result") != jsonDoc.MemberEnd())
+        // Test for (un)subscription answers: {"result":null,"id":1} or {"error":{...},"id":1}
+        const auto result = jsonDoc.FindMember("result");
+        const auto error  = jsonDoc.FindMember("error");
+        if (result != jsonDoc.MemberEnd() || error != jsonDoc.MemberEnd())
         {
+            const auto id = jsonDoc.FindMember("id");
+            if (id == jsonDoc.MemberEnd() || !id->value.IsInt())
+                return;
 
-            bool result = jsonDoc["result"].IsNull();
+            const bool success     = result != jsonDoc.MemberEnd() && result->value.IsNull();
+            const auto completions = m_subscriptions.confirm(id->value.GetInt(), success);
+            if (!completions.has_value())
+                return;
 
-            int id      = jsonDoc["id"].GetInt();
-            // Find the Id
-            auto siid = m_subscribeIds.find(id);
-            if (siid != m_subscribeIds.end())
-            {
-                m_subscribeIds.erase(siid);
-                subscribe(result, id);
-            }
-            else
+            for (const auto &completion : *completions)
             {
-                auto uiid = m_unsubscribeIds.find(id);
-                if (uiid != m_unsubscribeIds.end())
-                {
-                    unsubscribe(result, id);
-                    m_unsubscribeIds.erase(uiid);
-                }
+                if (completion.method == WSSubscriptions::Method::subscribe)
+                    subscribe(completion.success, completion.id);
+                else
+                    unsubscribe(completion.success, completion.id);
             }
 
             return;
         }
 
-        const rapidjson::Value &value = jsonDoc.FindMember("data") != jsonDoc.MemberEnd() ? jsonDoc["data"].GetObject() : jsonDoc.GetObject();
-
-        const std::string_view type { value["e"].GetString(), value["e"].GetStringLength() };
+        // Combined streams wrap the payload in "data". The all market streams send an array
+        const auto data               = jsonDoc.FindMember("data");
+        const rapidjson::Value &value = data != jsonDoc.MemberEnd() ? data->value : jsonDoc.root();
 
         if (!value.IsArray())
         {
-            if (type == glstr::g_aggTrade)
-            {
-                StreamAggregateTrade sat {
-                    .aggregateTradeId = value["a"].GetInt64(),
-                    .price            = std::stod(JTO_STRING(value, "p")),
-                    .qty              = std::stod(JTO_STRING(value, "q")),
-                    .firstTradeId     = value["f"].GetInt64(),
-                    .lastTradeId      = value["l"].GetInt64(),
-                    .tradeTime        = value["T"].GetUint64(),
-                    .isMaker          = value["m"].GetBool()
-                };
-                aggregateTradeStream(JTO_STRING(value, "s"), value["E"].GetUint64(), sat);
-            }
-            else if (type == glstr::g_markPriceUpdate)
-            {
-
-                StreamMarkPrice smp {
-                    .markPrice        = std::stod(JTO_STRING(value, "p")),
-                    .indexPrice       = std::stod(JTO_STRING(value, "i")),
-                    .estimSettlePrice = std::stod(JTO_STRING(value, "P")),
-                    .fundingRate      = std::stod(JTO_STRING(value, "r")),
-                    .nextFundingTime  = value["T"].GetUint64(),
-                };
-                markPriceStream(JTO_STRING(value, "s"), value["E"].GetUint64(), smp);
-            }
-            else if (type == glstr::g_kline)
-            {
-                const auto &cd           = value["k"].GetObject();
-                BinanceTimeIntervals bti = BinanceTimeIntervals::i1M;
-
-                const std::string_view interval { cd["i"].GetString(), cd["i"].GetStringLength() };
-
-                if (interval == glstr::g_1m)
-                    bti = BinanceTimeIntervals::i1m;
-                else if (interval == glstr::g_3m)
-                    bti = BinanceTimeIntervals::i3m;
-                else if (interval == glstr::g_5m)
-                    bti = BinanceTimeIntervals::i5m;
-                else if (interval == glstr::g_15m)
-                    bti = BinanceTimeIntervals::i15m;
-                else if (interval == glstr::g_30m)
-                    bti = BinanceTimeIntervals::i30m;
-                else if (interval == glstr::g_1h)
-                    bti = BinanceTimeIntervals::i1h;
-                else if (interval == glstr::g_2h)
-                    bti = BinanceTimeIntervals::i2h;
-                else if (interval == glstr::g_4h)
-                    bti = BinanceTimeIntervals::i4h;
-                else if (interval == glstr::g_6h)
-                    bti = BinanceTimeIntervals::i6h;
-                else if (interval == glstr::g_8h)
-                    bti = BinanceTimeIntervals::i8h;
-                else if (interval == glstr::g_12h)
-                    bti = BinanceTimeIntervals::i12h;
-                else if (interval == glstr::g_1d)
-                    bti = BinanceTimeIntervals::i1d;
-                else if (interval == glstr::g_3d)
-                    bti = BinanceTimeIntervals::i3d;
-                else if (interval == glstr::g_1w)
-                    bti = BinanceTimeIntervals::i1w;
-                else if (interval == glstr::g_1M)
-                    bti = BinanceTimeIntervals::i1M;
-
-                Candlestick cs {
-                    .openTime              = cd["t"].GetUint64(),
-                    .open                  = std::stod(JTO_STRING(cd, "o")),
-                    .high                  = std::stod(JTO_STRING(cd, "h")),
-                    .low                   = std::stod(JTO_STRING(cd, "l")),
-                    .close                 = std::stod(JTO_STRING(cd, "c")),
-                    .volume                = std::stod(JTO_STRING(cd, "v")),
-                    .closeTime             = cd["T"].GetUint64(),
-                    .quoteAssetVolume      = std::stod(JTO_STRING(cd, "q")),
-                    .baseAssetVolume       = std::stod(JTO_STRING(cd, "v")),
-                    .numberOfTrades        = cd["n"].GetUint64(),
-                    .takerBaseAssetVolume  = std::stod(JTO_STRING(cd, "V")),
-                    .takerQuoteAssetVolume = std::stod(JTO_STRING(cd, "Q")),
-                    .isClosed              = cd["x"].GetBool(), /// Stream field otherwise always true
-                    .firstTradeId          = cd["f"].GetInt64(),
-                    .lastTradeId           = cd["L"].GetInt64()
-                };
-                kline({ value["s"].GetString(), value["s"].GetStringLength() }, value["E"].GetUint64(), bti, cs);
-            }
-            else if (type == glstr::g_continuous_kline)
+            // The parse stage of the event ends here: the message is parsed and its event known
+            const std::string_view event = jsonToView(value["e"]);
+            const auto symbol            = value.FindMember("s");
+            const auto eventTime         = value.FindMember("E");
+            eventParsed(symbol != value.MemberEnd() && symbol->value.IsString() ? jsonToView(symbol->value) : std::string_view {},
+                event,
+                eventTime != value.MemberEnd() && eventTime->value.IsUint64() ? eventTime->value.GetUint64() : 0);
+
+            switch (streamEventOf(event))
             {
-                const auto &cd           = value["k"].GetObject();
-                BinanceTimeIntervals bti = BinanceTimeIntervals::i1M;
-                const std::string_view interval { cd["i"].GetString(), cd["i"].GetStringLength() };
-
-                if (interval == glstr::g_1m)
-                    bti = BinanceTimeIntervals::i1m;
-                else if (interval == glstr::g_3m)
-                    bti = BinanceTimeIntervals::i3m;
-                else if (interval == glstr::g_5m)
-                    bti = BinanceTimeIntervals::i5m;
-                else if (interval == glstr::g_15m)
-                    bti = BinanceTimeIntervals::i15m;
-                else if (interval == glstr::g_30m)
-                    bti = BinanceTimeIntervals::i30m;
-                else if (interval == glstr::g_1h)
-                    bti = BinanceTimeIntervals::i1h;
-                else if (interval == glstr::g_2h)
-                    bti = BinanceTimeIntervals::i2h;
-                else if (interval == glstr::g_4h)
-                    bti = BinanceTimeIntervals::i4h;
-                else if (interval == glstr::g_6h)
-                    bti = BinanceTimeIntervals::i6h;
-                else if (interval == glstr::g_8h)
-                    bti = BinanceTimeIntervals::i8h;
-                else if (interval == glstr::g_12h)
-                    bti = BinanceTimeIntervals::i12h;
-                else if (interval == glstr::g_1d)
-                    bti = BinanceTimeIntervals::i1d;
-                else if (interval == glstr::g_3d)
-                    bti = BinanceTimeIntervals::i3d;
-                else if (interval == glstr::g_1w)
-                    bti = BinanceTimeIntervals::i1w;
-                else if (interval == glstr::g_1M)
-                    bti = BinanceTimeIntervals::i1M;
-
-                ContractType ct = ContractType::none;
-                const std::string_view cts { value["ct"].GetString(), value["ct"].GetStringLength() };
-
-                if (cts == glstr::g_PERPETUAL)
-                    ct = ContractType::PERPETUAL;
-                else if (cts == glstr::g_CURRENT_QUARTER)
-                    ct = ContractType::CURRENT_QUARTER;
-                else if (cts == glstr::g_NEXT_QUARTER)
-                    ct = ContractType::NEXT_QUARTER;
-
-                Candlestick cs {
-                    .openTime              = cd["t"].GetUint64(),
-                    .open                  = std::stod(JTO_STRING(cd, "o")),
-                    .high                  = std::stod(JTO_STRING(cd, "h")),
-                    .low                   = std::stod(JTO_STRING(cd, "l")),
-                    .close                 = std::stod(JTO_STRING(cd, "c")),
-                    .volume                = std::stod(JTO_STRING(cd, "v")),
-                    .closeTime             = cd["T"].GetUint64(),
-                    .quoteAssetVolume      = std::stod(JTO_STRING(cd, "q")),
-                    .baseAssetVolume       = std::stod(JTO_STRING(cd, "v")),
-                    .numberOfTrades        = cd["n"].GetUint64(),
-                    .takerBaseAssetVolume  = std::stod(JTO_STRING(cd, "V")),
-                    .takerQuoteAssetVolume = std::stod(JTO_STRING(cd, "Q")),
-                    .isClosed              = cd["x"].GetBool(), /// Stream field otherwise always true
-                    .firstTradeId          = cd["f"].GetInt64(),
-                    .lastTradeId           = cd["L"].GetInt64()
-                };
-                continuousKline({ value["ps"].GetString(), value["ps"].GetStringLength() }, value["E"].GetUint64(), ct, bti, cs);
-            }
-
-            else if (type == glstr::g_24hrMiniTicker)
-            {
-                StreamIndividualSymbolMiniTicker smmt {
-                    .closePrice                  = std::stod(JTO_STRING(value, "c")),
-                    .openPrice                   = std::stod(JTO_STRING(value, "o")),
-                    .highPrice                   = std::stod(JTO_STRING(value, "h")),
-                    .lowPrice                    = std::stod(JTO_STRING(value, "l")),
-                    .totalTradedBaseAssetVolume  = std::stod(JTO_STRING(value, "v")),
-                    .totalTradedQuoteAssetVolume = std::stod(JTO_STRING(value, "q"))
-                };
-                individualSymbolMiniTicker(JTO_STRING(value, "s"), value["E"].GetUint64(), smmt);
-            }
-            else if (type == glstr::g_24hrTicker)
-            {
-                StreamIndividualSymbolTicker sst {
-                    .priceChange                 = std::stod(JTO_STRING(value, "p")),
-                    .priceChangePercent          = std::stod(JTO_STRING(value, "P")),
-                    .weightedAveratePrice        = std::stod(JTO_STRING(value, "w")),
-                    .lastPrice                   = std::stod(JTO_STRING(value, "c")),
-                    .lastPriceQuantity           = std::stod(JTO_STRING(value, "Q")),
-                    .openPrice                   = std::stod(JTO_STRING(value, "o")),
-                    .highPrice                   = std::stod(JTO_STRING(value, "h")),
-                    .lowPrice                    = std::stod(JTO_STRING(value, "l")),
-                    .totalTradedBaseAssetVolume  = std::stod(JTO_STRING(value, "v")),
-                    .totalTradedQuoteAssetVolume = std::stod(JTO_STRING(value, "q")),
-                    .statisticsOpenTime          = value["O"].GetInt64(),
-                    .statisticsCloseTime         = value["C"].GetInt64(),
-                    .firstTreadeId               = value["F"].GetInt64(),
-                    .lastTradeId                 = value["L"].GetInt64(),
-                    .totalNumberOfTrades         = value["n"].GetUint64()
-                };
-                individualSymbolTicker(JTO_STRING(value, "s"), value["E"].GetUint64(), sst);
-            }
-            else if (type == glstr::g_bookTicker)
-            {
-                StreamBookTicker sbt {
-                    .transactionTime = value["T"].GetUint64(),
-                    .bestBidPice     = std::stod(JTO_STRING(value, "b")),
-                    .bestBidQty      = std::stod(JTO_STRING(value, "B")),
-                    .bestAskPice     = std::stod(JTO_STRING(value, "a")),
-                    .bestAskQty      = std::stod(JTO_STRING(value, "A")),
-                };
-                bookTicker(JTO_STRING(value, "s"), value["E"].GetUint64(), sbt);
-            }
-            else if (type == glstr::g_forceOrder)
-            {
-                const auto &fod           = value["o"].GetObject();
-
-                const std::string sSide   = JTO_STRING(fod, "S");
-                const std::string sType   = JTO_STRING(fod, "T");
-                const std::string sTIF    = JTO_STRING(fod, "f");
-                const std::string sStatus = JTO_STRING(fod, "X");
-
-                StreamLiquidationOrder slo {
-                    .side = [&sSide]() {
-                        if (sSide == "SELL")
-                            return OrderSide::sell;
-                        return OrderSide::buy;
-                    }(),
-                    .type = [&sType]() {
-                        if (sType == "LIMIT")
-                            return OrderType::limit;
-                        else if (sType == "MARKET")
-                            return OrderType::market;
-                        else if (sType == "STOP_LOSS")
-                            return OrderType::stopLoss;
-                        else if (sType == "STOP_LOSS_LIMIT")
-                            return OrderType::stopLossLimit;
-                        else if (sType == "TAKE_PROFIT")
-                            return OrderType::takeProfit;
-                        else if (sType == "TAKE_PROFIT_LIMIT")
-                            return OrderType::takeProfitLimit;
-                        else if (sType == "LIMIT_MAKER")
-                            return OrderType::limitMaker;
-                        else if (sType == "STOP")
-                            return OrderType::stop;
-                        else if (sType == "STOP_MARKET")
-                            return OrderType::stopMarket;
-                        else if (sType == "STOP_PROFIT_MARKET")
-                            return OrderType::takeProfitMarket;
-                        else if (sType == "TRAILING_STOP_MARKET")
-                            return OrderType::trailingStopMarket;
-                        return OrderType::limit; // SHOULD NOT BE REACHED, unless API changes
-                    }(),
-                    .tif = [&sTIF]() {
-                        if (sTIF == "GTC")
-                            return OrderTimeInForce::GTC;
-                        else if (sTIF == "IOC")
-                            return OrderTimeInForce::IOC;
-                        else if (sTIF == "FOK")
-                            return OrderTimeInForce::FOK;
-                        return OrderTimeInForce::GTC;
-                    }(),
-                    .originalQty  = std::stod(JTO_STRING(fod, "q")),
-                    .price        = std::stod(JTO_STRING(fod, "p")),
-                    .averagePrice = std::stod(JTO_STRING(fod, "ap")),
-                    .status       = [&sStatus]() {
-                        if (sStatus == "NEW")
-                            return OrderStatus::newOrder;
-                        else if (sStatus == "PARTIALLY_FILLED")
-                            return OrderStatus::partiallyFilled;
-                        else if (sStatus == "FILLED")
-                            return OrderStatus::filled;
-                        else if (sStatus == "CANCELED")
-                            return OrderStatus::canceled;
-                        else if (sStatus == "PENDING_CANCEL")
-                            return OrderStatus::pendingCancel;
-                        else if (sStatus == "REJECTED")
-                            return OrderStatus::rejected;
-                        return OrderStatus::expired;
-                    }(),
-                    .orderLastFilledQty        = std::stod(JTO_STRING(fod, "l")),
-                    .orderFilledAccumulatedQty = std::stod(JTO_STRING(fod, "z")),
-                    .tradeTime                 = fod["T"].GetUint64()
-                };
-                liquidationOrder(JTO_STRING(fod, "s"), value["E"].GetUint64(), slo);
-            }
-            else if (type == glstr::g_depthUpdate)
-            {
-                StreamDepthUpdate sdp {
-                    .transactionTime         = value["T"].GetUint64(),
-                    .firstUpdateId           = value["U"].GetUint64(),
-                    .finalUpdateId           = value["u"].GetUint64(),
-                    .finalUpdateIdLastStream = value["pu"].GetUint64()
-                };
-                for (const auto &bids : value["b"].GetArray())
-                    sdp.bids[std::stod(JTO_STRING(bids, 0))] = std::stod(JTO_STRING(bids, 1));
-                for (const auto &asks : value["a"].GetArray())
-                    sdp.asks[std::stod(JTO_STRING(asks, 0))] = std::stod(JTO_STRING(asks, 1));
-
-                depthUpdate(JTO_STRING(value, "s"), value["E"].GetUint64(), sdp);
-            }
-            else if (type == glstr::g_nav)
-            {
-                StreamBLVTInfo sbi;
-                sbi.tokenIssued    = value["m"].GetDouble();
-                sbi.BLVTNav        = value["n"].GetDouble();
-                sbi.realLeverage   = value["l"].GetDouble();
-                sbi.targetLeverage = value["t"].GetDouble();
-                sbi.fundingRatio   = value["f"].GetDouble();
-                for (const auto &baskets : value["b"].GetArray())
-                    sbi.baskets[JTO_STRING(baskets, "s")] = baskets["n"].GetDouble();
-                blvtInfo(JTO_STRING(value, "s"), value["E"].GetUint64(), sbi);
-            }
-            else if (type == glstr::g_compositeIndex)
-            {
-                std::vector<StreamCompositionIndex> vsci;
-                for (const auto &composition : value["c"].GetArray())
-                {
-                    StreamCompositionIndex sci {
-                        .baseAsset          = JTO_STRING(composition, "b"),
-                        .quoteAsset         = JTO_STRING(composition, "q"),
-                        .weightInQuantity   = std::stod(JTO_STRING(composition, "")),
-                        .weightInPercentage = std::stod(JTO_STRING(composition, "")),
-                        .indexPrice         = std::stod(JTO_STRING(composition, ""))
-                    };
-                    vsci.push_back(sci);
-                }
-                compositeIndex(JTO_STRING(value, "s"), value["E"].GetUint64(), std::stod(JTO_STRING(value, "p")), vsci);
+                case StreamEvent::aggTrade:
+                    {
+                        StreamAggregateTrade sat {
+                            .aggregateTradeId = value["a"].GetInt64(),
+                            .price            = jsonToDouble(value["p"]),
+                            .qty              = jsonToDouble(value["q"]),
+                            .firstTradeId     = value["f"].GetInt64(),
+                            .lastTradeId      = value["l"].GetInt64(),
+                            .tradeTime        = value["T"].GetUint64(),
+                            .isMaker          = value["m"].GetBool()
+                        };
+                        const std::string symbol = JTO_STRING(value, "s");
+                        const auto id            = static_cast<uint64_t>(sat.aggregateTradeId);
+                        if (const auto gap = m_sequences.received(SequencedStream::aggregateTrade, symbol, id - 1, id); gap.has_value())
+                            sequenceGap(symbol, SequencedStream::aggregateTrade, *gap);
+
+                        aggregateTradeStream(symbol, value["E"].GetUint64(), sat);
+                    }
+                    break;
+                case StreamEvent::markPriceUpdate:
+                    {
+
+                        StreamMarkPrice smp {
+                            .markPrice        = jsonToDouble(value["p"]),
+                            .indexPrice       = jsonToDouble(value["i"]),
+                            .estimSettlePrice = jsonToDouble(value["P"]),
+                            .fundingRate      = jsonToDouble(value["r"]),
+                            .nextFundingTime  = value["T"].GetUint64(),
+                        };
+                        markPriceStream(JTO_STRING(value, "s"), value["E"].GetUint64(), smp);
+                    }
+                    break;
+                case StreamEvent::kline:
+                    {
+                        const auto &cd                 = value["k"].GetObject();
+                        const BinanceTimeIntervals bti = timeIntervalOf(jsonToView(cd["i"])).value_or(BinanceTimeIntervals::i1M);
+
+                        Candlestick cs {
+                            .openTime              = cd["t"].GetUint64(),
+                            .open                  = jsonToDouble(cd["o"]),
+                            .high                  = jsonToDouble(cd["h"]),
+                            .low                   = jsonToDouble(cd["l"]),
+                            .close                 = jsonToDouble(cd["c"]),
+                            .volume                = jsonToDouble(cd["v"]),
+                            .closeTime             = cd["T"].GetUint64(),
+                            .quoteAssetVolume      = jsonToDouble(cd["q"]),
+                            .baseAssetVolume       = jsonToDouble(cd["v"]),
+                            .numberOfTrades        = cd["n"].GetUint64(),
+                            .takerBaseAssetVolume  = jsonToDouble(cd["V"]),
+                            .takerQuoteAssetVolume = jsonToDouble(cd["Q"]),
+                            .isClosed              = cd["x"].GetBool(), /// Stream field otherwise always true
+                            .firstTradeId          = cd["f"].GetInt64(),
+                            .lastTradeId           = cd["L"].GetInt64()
+                        };
+                        kline({ value["s"].GetString(), value["s"].GetStringLength() }, value["E"].GetUint64(), bti, cs);
+                    }
+                    break;
+                case StreamEvent::continuousKline:
+                    {
+                        const auto &cd                 = value["k"].GetObject();
+                        const BinanceTimeIntervals bti = timeIntervalOf(jsonToView(cd["i"])).value_or(BinanceTimeIntervals::i1M);
+
+                        ContractType ct = ContractType::none;
+                        const std::string_view cts { value["ct"].GetString(), value["ct"].GetStringLength() };
+
+                        if (cts == glstr::g_PERPETUAL)
+                            ct = ContractType::PERPETUAL;
+                        else if (cts == glstr::g_CURRENT_QUARTER)
+                            ct = ContractType::CURRENT_QUARTER;
+                        else if (cts == glstr::g_NEXT_QUARTER)
+                            ct = ContractType::NEXT_QUARTER;
+
+                        Candlestick cs {
+                            .openTime              = cd["t"].GetUint64(),
+                            .open                  = jsonToDouble(cd["o"]),
+                            .high                  = jsonToDouble(cd["h"]),
+                            .low                   = jsonToDouble(cd["l"]),
+                            .close                 = jsonToDouble(cd["c"]),
+                            .volume                = jsonToDouble(cd["v"]),
+                            .closeTime             = cd["T"].GetUint64(),
+                            .quoteAssetVolume      = jsonToDouble(cd["q"]),
+                            .baseAssetVolume       = jsonToDouble(cd["v"]),
+                            .numberOfTrades        = cd["n"].GetUint64(),
+                            .takerBaseAssetVolume  = jsonToDouble(cd["V"]),
+                            .takerQuoteAssetVolume = jsonToDouble(cd["Q"]),
+                            .isClosed              = cd["x"].GetBool(), /// Stream field otherwise always true
+                            .firstTradeId          = cd["f"].GetInt64(),
+                            .lastTradeId           = cd["L"].GetInt64()
+                        };
+                        continuousKline({ value["ps"].GetString(), value["ps"].GetStringLength() }, value["E"].GetUint64(), ct, bti, cs);
+                    }
+                    break;
+                case StreamEvent::miniTicker:
+                    {
+                        StreamIndividualSymbolMiniTicker smmt {
+                            .closePrice                  = jsonToDouble(value["c"]),
+                            .openPrice                   = jsonToDouble(value["o"]),
+                            .highPrice                   = jsonToDouble(value["h"]),
+                            .lowPrice                    = jsonToDouble(value["l"]),
+                            .totalTradedBaseAssetVolume  = jsonToDouble(value["v"]),
+                            .totalTradedQuoteAssetVolume = jsonToDouble(value["q"])
+                        };
+                        individualSymbolMiniTicker(JTO_STRING(value, "s"), value["E"].GetUint64(), smmt);
+                    }
+                    break;
+                case StreamEvent::ticker:
+                    {
+                        StreamIndividualSymbolTicker sst {
+                            .priceChange                 = jsonToDouble(value["p"]),
+                            .priceChangePercent          = jsonToDouble(value["P"]),
+                            .weightedAveratePrice        = jsonToDouble(value["w"]),
+                            .lastPrice                   = jsonToDouble(value["c"]),
+                            .lastPriceQuantity           = jsonToDouble(value["Q"]),
+                            .openPrice                   = jsonToDouble(value["o"]),
+                            .highPrice                   = jsonToDouble(value["h"]),
+                            .lowPrice                    = jsonToDouble(value["l"]),
+                            .totalTradedBaseAssetVolume  = jsonToDouble(value["v"]),
+                            .totalTradedQuoteAssetVolume = jsonToDouble(value["q"]),
+                            .statisticsOpenTime          = value["O"].GetInt64(),
+                            .statisticsCloseTime         = value["C"].GetInt64(),
+                            .firstTreadeId               = value["F"].GetInt64(),
+                            .lastTradeId                 = value["L"].GetInt64(),
+                            .totalNumberOfTrades         = value["n"].GetUint64()
+                        };
+                        individualSymbolTicker(JTO_STRING(value, "s"), value["E"].GetUint64(), sst);
+                    }
+                    break;
+                case StreamEvent::bookTicker:
+                    {
+                        StreamBookTicker sbt {
+                            .transactionTime = value["T"].GetUint64(),
+                            .bestBidPice     = jsonToDouble(value["b"]),
+                            .bestBidQty      = jsonToDouble(value["B"]),
+                            .bestAskPice     = jsonToDouble(value["a"]),
+                            .bestAskQty      = jsonToDouble(value["A"]),
+                        };
+                        bookTicker(JTO_STRING(value, "s"), value["E"].GetUint64(), sbt);
+                    }
+                    break;
+                case StreamEvent::forceOrder:
+                    {
+                        const auto &fod           = value["o"].GetObject();
+
+                        const std::string sSide   = JTO_STRING(fod, "S");
+                        const std::string sType   = JTO_STRING(fod, "T");
+                        const std::string sTIF    = JTO_STRING(fod, "f");
+                        const std::string sStatus = JTO_STRING(fod, "X");
+
+                        StreamLiquidationOrder slo {
+                            .side = [&sSide]() {
+                                if (sSide == "SELL")
+                                    return OrderSide::sell;
+                                return OrderSide::buy;
+                            }(),
+                            .type = [&sType]() {
+                                if (sType == "LIMIT")
+                                    return OrderType::limit;
+                                else if (sType == "MARKET")
+                                    return OrderType::market;
+                                else if (sType == "STOP_LOSS")
+                                    return OrderType::stopLoss;
+                                else if (sType == "STOP_LOSS_LIMIT")
+                                    return OrderType::stopLossLimit;
+                                else if (sType == "TAKE_PROFIT")
+                                    return OrderType::takeProfit;
+                                else if (sType == "TAKE_PROFIT_LIMIT")
+                                    return OrderType::takeProfitLimit;
+                                else if (sType == "LIMIT_MAKER")
+                                    return OrderType::limitMaker;
+                                else if (sType == "STOP")
+                                    return OrderType::stop;
+                                else if (sType == "STOP_MARKET")
+                                    return OrderType::stopMarket;
+                                else if (sType == "STOP_PROFIT_MARKET")
+                                    return OrderType::takeProfitMarket;
+                                else if (sType == "TRAILING_STOP_MARKET")
+                                    return OrderType::trailingStopMarket;
+                                return OrderType::limit; // SHOULD NOT BE REACHED, unless API changes
+                            }(),
+                            .tif = [&sTIF]() {
+                                if (sTIF == "GTC")
+                                    return OrderTimeInForce::GTC;
+                                else if (sTIF == "IOC")
+                                    return OrderTimeInForce::IOC;
+                                else if (sTIF == "FOK")
+                                    return OrderTimeInForce::FOK;
+                                return OrderTimeInForce::GTC;
+                            }(),
+                            .originalQty  = jsonToDouble(fod["q"]),
+                            .price        = jsonToDouble(fod["p"]),
+                            .averagePrice = jsonToDouble(fod["ap"]),
+                            .status       = [&sStatus]() {
+                                if (sStatus == "NEW")
+                                    return OrderStatus::newOrder;
+                                else if (sStatus == "PARTIALLY_FILLED")
+                                    return OrderStatus::partiallyFilled;
+                                else if (sStatus == "FILLED")
+                                    return OrderStatus::filled;
+                                else if (sStatus == "CANCELED")
+                                    return OrderStatus::canceled;
+                                else if (sStatus == "PENDING_CANCEL")
+                                    return OrderStatus::pendingCancel;
+                                else if (sStatus == "REJECTED")
+                                    return OrderStatus::rejected;
+                                return OrderStatus::expired;
+                            }(),
+                            .orderLastFilledQty        = jsonToDouble(fod["l"]),
+                            .orderFilledAccumulatedQty = jsonToDouble(fod["z"]),
+                            .tradeTime                 = fod["T"].GetUint64()
+                        };
+                        liquidationOrder(JTO_STRING(fod, "s"), value["E"].GetUint64(), slo);
+                    }
+                    break;
+                case StreamEvent::depthUpdate:
+                    {
+                        // Built in place of the payload shared with the consumers, see sharedDepthUpdate
+                        auto sdp = std::make_shared<StreamDepthUpdate>(StreamDepthUpdate {
+                            .transactionTime         = value["T"].GetUint64(),
+                            .firstUpdateId           = value["U"].GetUint64(),
+                            .finalUpdateId           = value["u"].GetUint64(),
+                            .finalUpdateIdLastStream = value["pu"].GetUint64(),
+                            .bids                    = jsonToPriceLevels(value["b"]),
+                            .asks                    = jsonToPriceLevels(value["a"]) });
+
+                        const std::string symbol = JTO_STRING(value, "s");
+                        if (const auto gap = m_sequences.received(SequencedStream::depthUpdate, symbol, sdp->finalUpdateIdLastStream, sdp->finalUpdateId); gap.has_value())
+                            sequenceGap(symbol, SequencedStream::depthUpdate, *gap);
+
+                        sharedDepthUpdate(symbol, value["E"].GetUint64(), std::move(sdp));
+                    }
+                    break;
+                case StreamEvent::nav:
+                    {
+                        StreamBLVTInfo sbi;
+                        sbi.tokenIssued    = value["m"].GetDouble();
+                        sbi.BLVTNav        = value["n"].GetDouble();
+                        sbi.realLeverage   = value["l"].GetDouble();
+                        sbi.targetLeverage = value["t"].GetDouble();
+                        sbi.fundingRatio   = value["f"].GetDouble();
+                        for (const auto &baskets : value["b"].GetArray())
+                            sbi.baskets[JTO_STRING(baskets, "s")] = baskets["n"].GetDouble();
+                        blvtInfo(JTO_STRING(value, "s"), value["E"].GetUint64(), sbi);
+                    }
+                    break;
+                case StreamEvent::compositeIndex:
+                    {
+                        std::vector<StreamCompositionIndex> vsci;
+                        for (const auto &composition : value["c"].GetArray())
+                        {
+                            StreamCompositionIndex sci {
+                                .baseAsset          = JTO_STRING(composition, "b"),
+                                .quoteAsset         = JTO_STRING(composition, "q"),
+                                .weightInQuantity   = jsonToDouble(composition[""]),
+                                .weightInPercentage = jsonToDouble(composition[""]),
+                                .indexPrice         = jsonToDouble(composition[""])
+                            };
+                            vsci.push_back(sci);
+                        }
+                        compositeIndex(JTO_STRING(value, "s"), value["E"].GetUint64(), jsonToDouble(value["p"]), vsci);
+                    }
+                    break;
+                default:
+                    break;
             }
         }
         else // STREAM IS AN ARRAY
@@ -652,52 +578,59 @@ void BINAPI_NAMESPACE::ws::WSFuturesBinanceAPI::receivedData()
             std::multimap<std::string, std::pair<uint64_t, StreamMarketTickers>> mmsmt;
             for (const auto &streamArray : value.GetArray())
             {
-                const std::string stype = JTO_STRING(streamArray, "e");
-                if (stype == "markPriceUpdate")
-                {
-                    StreamMarkPriceAllMarket smpam {
-                        .symbol           = JTO_STRING(streamArray, "s"),
-                        .markPrice        = std::stod(JTO_STRING(streamArray, "p")),
-                        .indexPrice       = std::stod(JTO_STRING(streamArray, "i")),
-                        .estimSettlePrice = std::stod(JTO_STRING(streamArray, "P")),
-                        .fundingRate      = std::stod(JTO_STRING(streamArray, "r")),
-                        .nextFundingTime  = streamArray["T"].GetUint64(),
-                        .eventTime        = streamArray["E"].GetUint64()
-                    };
-                    vsmpam.push_back(smpam);
-                }
-                else if (stype == "24hrMiniTicker")
-                {
-                    StreamMarketMiniTickers smmt {
-                        .closePrice                  = std::stod(JTO_STRING(streamArray, "c")),
-                        .openPrice                   = std::stod(JTO_STRING(streamArray, "o")),
-                        .highPrice                   = std::stod(JTO_STRING(streamArray, "h")),
-                        .lowPrice                    = std::stod(JTO_STRING(streamArray, "l")),
-                        .totalTradedBaseAssetVolume  = std::stod(JTO_STRING(streamArray, "v")),
-                        .totalTradedQuoteAssetVolume = std::stod(JTO_STRING(streamArray, "q"))
-                    };
-                    mmsmmt.insert({ JTO_STRING(value, "s"), { value["E"].GetUint64(), smmt } });
-                }
-                else if (stype == "24hrTicker")
+                switch (streamEventOf(jsonToView(streamArray["e"])))
                 {
-                    StreamMarketTickers smt {
-                        .priceChange                 = std::stod(JTO_STRING(value, "p")),
-                        .priceChangePercent          = std::stod(JTO_STRING(value, "P")),
-                        .weightedAveratePrice        = std::stod(JTO_STRING(value, "w")),
-                        .lastPrice                   = std::stod(JTO_STRING(value, "c")),
-                        .lastPriceQuantity           = std::stod(JTO_STRING(value, "Q")),
-                        .openPrice                   = std::stod(JTO_STRING(value, "o")),
-                        .highPrice                   = std::stod(JTO_STRING(value, "h")),
-                        .lowPrice                    = std::stod(JTO_STRING(value, "l")),
-                        .totalTradedBaseAssetVolume  = std::stod(JTO_STRING(value, "v")),
-                        .totalTradedQuoteAssetVolume = std::stod(JTO_STRING(value, "q")),
-                        .statisticsOpenTime          = value["O"].GetInt64(),
-                        .statisticsCloseTime         = value["C"].GetInt64(),
-                        .firstTreadeId               = value["F"].GetInt64(),
-                        .lastTradeId                 = value["L"].GetInt64(),
-                        .totalNumberOfTrades         = value["n"].GetUint64()
-                    };
-                    mmsmt.insert({ JTO_STRING(value, "s"), { value["E"].GetUint64(), smt } });
+                    case StreamEvent::markPriceUpdate:
+                        {
+                            StreamMarkPriceAllMarket smpam {
+                                .symbol           = JTO_STRING(streamArray, "s"),
+                                .markPrice        = jsonToDouble(streamArray["p"]),
+                                .indexPrice       = jsonToDouble(streamArray["i"]),
+                                .estimSettlePrice = jsonToDouble(streamArray["P"]),
+                                .fundingRate      = jsonToDouble(streamArray["r"]),
+                                .nextFundingTime  = streamArray["T"].GetUint64(),
+                                .eventTime        = streamArray["E"].GetUint64()
+                            };
+                            vsmpam.push_back(smpam);
+                        }
+                        break;
+                    case StreamEvent::miniTicker:
+                        {
+                            StreamMarketMiniTickers smmt {
+                                .closePrice                  = jsonToDouble(streamArray["c"]),
+                                .openPrice                   = jsonToDouble(streamArray["o"]),
+                                .highPrice                   = jsonToDouble(streamArray["h"]),
+                                .lowPrice                    = jsonToDouble(streamArray["l"]),
+                                .totalTradedBaseAssetVolume  = jsonToDouble(streamArray["v"]),
+                                .totalTradedQuoteAssetVolume = jsonToDouble(streamArray["q"])
+                            };
+                            mmsmmt.insert({ JTO_STRING(streamArray, "s"), { streamArray["E"].GetUint64(), smmt } });
+                        }
+                        break;
+                    case StreamEvent::ticker:
+                        {
+                            StreamMarketTickers smt {
+                                .priceChange                 = jsonToDouble(streamArray["p"]),
+                                .priceChangePercent          = jsonToDouble(streamArray["P"]),
+                                .weightedAveratePrice        = jsonToDouble(streamArray["w"]),
+                                .lastPrice                   = jsonToDouble(streamArray["c"]),
+                                .lastPriceQuantity           = jsonToDouble(streamArray["Q"]),
+                                .openPrice                   = jsonToDouble(streamArray["o"]),
+                                .highPrice                   = jsonToDouble(streamArray["h"]),
+                                .lowPrice                    = jsonToDouble(streamArray["l"]),
+                                .totalTradedBaseAssetVolume  = jsonToDouble(streamArray["v"]),
+                                .totalTradedQuoteAssetVolume = jsonToDouble(streamArray["q"]),
+                                .statisticsOpenTime          = streamArray["O"].GetInt64(),
+                                .statisticsCloseTime         = streamArray["C"].GetInt64(),
+                                .firstTreadeId               = streamArray["F"].GetInt64(),
+                                .lastTradeId                 = streamArray["L"].GetInt64(),
+                                .totalNumberOfTrades         = streamArray["n"].GetUint64()
+                            };
+                            mmsmt.insert({ JTO_STRING(streamArray, "s"), { streamArray["E"].GetUint64(), smt } });
+                        }
+                        break;
+                    default:
+                        break;
                 }
             }
             if (!vsmpam.empty())
@@ -725,7 +658,9 @@ void BINAPI_NAMESPACE::ws::WSFuturesBinanceAPI::individualSymbolTicker([[maybe_u
 void BINAPI_NAMESPACE::ws::WSFuturesBinanceAPI::allMarketTickers([[maybe_unused]] const std::multimap<std::string, std::pair<uint64_t, StreamMarketTickers>> &mm) { }
 void BINAPI_NAMESPACE::ws::WSFuturesBinanceAPI::bookTicker([[maybe_unused]] const std::string &symbol, [[maybe_unused]] uint64_t eventTime, [[maybe_unused]] const StreamBookTicker &ticker) { }
 void BINAPI_NAMESPACE::ws::WSFuturesBinanceAPI::liquidationOrder([[maybe_unused]] const std::string &symbol, [[maybe_unused]] uint64_t eventTime, [[maybe_unused]] const StreamLiquidationOrder &slo) { }
+void BINAPI_NAMESPACE::ws::WSFuturesBinanceAPI::sequenceGap([[maybe_unused]] const std::string &symbol, [[maybe_unused]] SequencedStream stream, [[maybe_unused]] const SequenceGap &gap) { }
 void BINAPI_NAMESPACE::ws::WSFuturesBinanceAPI::depthUpdate([[maybe_unused]] const std::string &symbol, [[maybe_unused]] uint64_t eventTime, [[maybe_unused]] const StreamDepthUpdate &sdp) { }
+void BINAPI_NAMESPACE::ws::WSFuturesBinanceAPI::sharedDepthUpdate(const std::string &symbol, uint64_t eventTime, Snapshot<StreamDepthUpdate> sdp) { depthUpdate(symbol, eventTime, *sdp); }
 void BINAPI_NAMESPACE::ws::WSFuturesBinanceAPI::blvtInfo([[maybe_unused]] const std::string &blvtName, [[maybe_unused]] uint64_t eventTime, [[maybe_unused]] const StreamBLVTInfo &blvt) { }
 void BINAPI_NAMESPACE::ws::WSFuturesBinanceAPI::compositeIndex([[maybe_unused]] const std::string &symbol, [[maybe_unused]] uint64_t eventTime, [[maybe_unused]] currency_t price, [[maybe_unused]] const std::vector<StreamCompositionIndex> &sci) { }
 
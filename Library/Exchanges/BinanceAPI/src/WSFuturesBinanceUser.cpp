@@ -8,14 +8,12 @@
 
 #include "WSFuturesBinanceUser.hpp"
 #include "Binapi.hpp"
+#include "BinanceAPINumeric.hpp"
 #include <fmt/color.h>
 #include <fmt/core.h>
 
-#define JTO_STRING(x, y)                         \
-    std::string                                  \
-    {                                            \
-        x[y].GetString(), x[y].GetStringLength() \
-    }
+#define JTO_STRING(x, y) \
+    std::string { jsonToView(x[y]) }
 
 BINAPI_NAMESPACE::ws::WSFuturesBinanceUser::WSFuturesBinanceUser(const std::string &listenKey, uint64_t pingTimer) :
     WSThread("fstream.binance.com", fmt::format("/ws/{}", listenKey), 443)
@@ -27,8 +25,9 @@ BINAPI_NAMESPACE::ws::WSFuturesBinanceUser::~WSFuturesBinanceUser() = default;
 
 void BINAPI_NAMESPACE::ws::WSFuturesBinanceUser::receivedData()
 {
-    rapidjson::Document jsonDoc;
-    jsonDoc.Parse(getJsonData().c_str());
+    // Parsed in situ over the message, with the memory of the arena of the thread
+    const auto message = getMessage();
+    local::ResponseDocument jsonDoc(message.data(), message.size());
     if (jsonDoc.HasParseError())
     {
         fmt::print(fmt::fg(fmt::color::red), "STREAM ERROR: ");
@@ -48,7 +47,7 @@ void BINAPI_NAMESPACE::ws::WSFuturesBinanceUser::receivedData()
         {
             BINAPI_NAMESPACE::UserStreamMarginCallFutures usmcf;
             if (jsonDoc.FindMember("cw") != jsonDoc.MemberEnd())
-                usmcf.crossMarginWallet = std::stod(JTO_STRING(jsonDoc, "cw"));
+                usmcf.crossMarginWallet = jsonToDouble(jsonDoc["cw"]);
             for (const auto &pos : jsonDoc["p"].GetArray())
             {
                 const std::string symbol { JTO_STRING(pos, "s") };
@@ -62,11 +61,11 @@ void BINAPI_NAMESPACE::ws::WSFuturesBinanceUser::receivedData()
                         else
                             return Futures::PositionSide::BOTH;
                     }(),
-                    .positionAmount            = std::stod(JTO_STRING(pos, "pa")),
-                    .markPrice                 = std::stod(JTO_STRING(pos, "mp")),
-                    .isolatedWallet            = std::stod(JTO_STRING(pos, "iw")),
-                    .unrealizedPnL             = std::stod(JTO_STRING(pos, "up")),
-                    .maintenanceMarginRequired = std::stod(JTO_STRING(pos, "mm")),
+                    .positionAmount            = jsonToDouble(pos["pa"]),
+                    .markPrice                 = jsonToDouble(pos["mp"]),
+                    .isolatedWallet            = jsonToDouble(pos["iw"]),
+                    .unrealizedPnL             = jsonToDouble(pos["up"]),
+                    .maintenanceMarginRequired = jsonToDouble(pos["mm"]),
                     .marginType                = [&]() {
                         const std::string type { JTO_STRING(pos, "mt") };
                         if (type == "CROSSED")
@@ -138,10 +137,10 @@ void BINAPI_NAMESPACE::ws::WSFuturesBinanceUser::receivedData()
                     else
                         return OrderTimeInForce::GTX;
                 }(),
-                .originalQty   = std::stod(JTO_STRING(objectData, "q")),
-                .originalPrice = std::stod(JTO_STRING(objectData, "p")),
-                .averagePrice  = std::stod(JTO_STRING(objectData, "ap")),
-                .stopPrice     = std::stod(JTO_STRING(objectData, "sp")),
+                .originalQty   = jsonToDouble(objectData["q"]),
+                .originalPrice = jsonToDouble(objectData["p"]),
+                .averagePrice  = jsonToDouble(objectData["ap"]),
+                .stopPrice     = jsonToDouble(objectData["sp"]),
                 .execType      = [&objectData]() {
                     const std::string exec { JTO_STRING(objectData, "x") };
                     if (exec == "NEW")
@@ -177,12 +176,12 @@ void BINAPI_NAMESPACE::ws::WSFuturesBinanceUser::receivedData()
                         return StreamOrderStatusFutures::unknown;
                 }(),
                 .orderId              = objectData["i"].GetUint64(),
-                .lastFilledQty        = std::stod(JTO_STRING(objectData, "l")),
-                .filledAccumulatedQty = std::stod(JTO_STRING(objectData, "z")),
-                .lastFilledPrice      = std::stod(JTO_STRING(objectData, "L")),
+                .lastFilledQty        = jsonToDouble(objectData["l"]),
+                .filledAccumulatedQty = jsonToDouble(objectData["z"]),
+                .lastFilledPrice      = jsonToDouble(objectData["L"]),
                 .commissionAmmount    = [&objectData]() {
                     if (objectData.FindMember("n") != objectData.MemberEnd())
-                        return std::stod(JTO_STRING(objectData, "n"));
+                        return jsonToDouble(objectData["n"]);
                     return -1.0;
                 }(),
                 .commissionAsset = [&objectData]() {
@@ -192,8 +191,8 @@ void BINAPI_NAMESPACE::ws::WSFuturesBinanceUser::receivedData()
                 }(),
                 .tradeTime    = objectData["T"].GetUint64(),
                 .tradeId      = objectData["t"].GetInt64(),
-                .bidsNotional = std::stod(JTO_STRING(objectData, "b")),
-                .asksNotional = std::stod(JTO_STRING(objectData, "a")),
+                .bidsNotional = jsonToDouble(objectData["b"]),
+                .asksNotional = jsonToDouble(objectData["a"]),
                 .isMaker      = objectData["m"].GetBool(),
                 .isReduceOnly = objectData["R"].GetBool(),
                 .workType     = [&objectData]() {
@@ -241,15 +240,15 @@ void BINAPI_NAMESPACE::ws::WSFuturesBinanceUser::receivedData()
                 .closeAll        = objectData["cp"].GetBool(), // if not conditional order the value is false
                 .activationPrice = [&objectData]() {
                     if (objectData.FindMember("AP") != objectData.MemberEnd())
-                        return std::stod(JTO_STRING(objectData, "AP"));
+                        return jsonToDouble(objectData["AP"]);
                     return -1.0;
                 }(),
                 .callbackRate = [&objectData]() {
                     if (objectData.FindMember("cr") != objectData.MemberEnd())
-                        return std::stod(JTO_STRING(objectData, "cr"));
+                        return jsonToDouble(objectData["cr"]);
                     return -1.0;
                 }(),
-                .realizedProfit = std::stod(JTO_STRING(objectData, "rp"))
+                .realizedProfit = jsonToDouble(objectData["rp"])
             };
             eventOrderUpdate(jsonDoc["E"].GetUint64(), jsonDoc["T"].GetUint64(), { objectData["s"].GetString(), objectData["s"].GetStringLength() }, usou);
         }
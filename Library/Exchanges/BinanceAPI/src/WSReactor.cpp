@@ -0,0 +1,534 @@
+////////////////////////////////////////////////////////////////////////////////
+// Created by Ricardo Romero on 17/10/2026 for BinanceAPI.
+// Copyright (c) 2026. Ricardo Romero
+// All rights reserved.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "WSReactor.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <stdexcept>
+
+namespace
+{
+    // Index of the service thread running on this thread, -1 on any other
+    thread_local int t_serviceThread = -1;
+} // namespace
+
+struct BINAPI_NAMESPACE::ws::WSReactor::Connection
+{
+    ConnectionId id { 0 };
+    Endpoint endpoint;
+
+    // Held while the handler is called, so detach can wait for a call in progress
+    std::mutex handlerMutex;
+    Handler *handler { nullptr };
+
+    // Only used by the service thread that owns the connection
+    lws *wsi { nullptr };
+    // The handshake is done. Only used by the owner
+    bool established { false };
+    // The connection error was delivered to the handler
+    bool failed { false };
+
+    // Service thread that opens the connection and receives its events. -1 until it is opened
+    std::atomic_int owner { -1 };
+    std::atomic_bool closing { false };
+
+    // Text frames with LWS_PRE bytes in front. Guarded by the mutex of the reactor
+    std::deque<std::string> outbox;
+    // The connection is in the timers of the reactor to be written. Guarded by the mutex of the reactor
+    bool delayed { false };
+    // The connection is in the timers of the reactor to be opened. Guarded by the mutex of the reactor
+    bool scheduled { false };
+
+    // When the messages of the last second were written, if the connection has a rate limit. Only used by the owner
+    std::deque<std::chrono::steady_clock::time_point> written;
+};
+
+BINAPI_NAMESPACE::ws::WSReactor::Handler::~Handler() = default;
+
+auto BINAPI_NAMESPACE::ws::WSReactor::Handler::pull() -> std::optional<std::string>
+{
+    return std::nullopt;
+}
+
+BINAPI_NAMESPACE::ws::WSReactor::WSReactor(std::size_t threads)
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    m_protocols[0] = { "wsProtocol", WSReactor::callback, 0, 65535, 0, nullptr, 0 };
+    m_protocols[1] = { nullptr, nullptr, 0, 0, 0, nullptr, 0 };
+    lws_set_log_level(0, nullptr);
+
+    lws_context_creation_info info {};
+    memset(&info, 0, sizeof(lws_context_creation_info));
+
+    info.options       = LWS_SERVER_OPTION_DO_SSL_GLOBAL_INIT;
+    info.port          = CONTEXT_PORT_NO_LISTEN; /* we do not run any server */
+    info.protocols     = m_protocols;
+    info.count_threads = static_cast<unsigned int>(threads);
+    info.user          = this;
+
+    m_context = lws_create_context(&info);
+    if (m_context == nullptr)
+        throw std::runtime_error("failed to create the WebSocket context");
+
+    // libwebsockets may service the context with fewer threads than requested
+    const int count = std::max(1, lws_get_count_threads(m_context));
+    m_threads.reserve(static_cast<std::size_t>(count));
+    for (int thread = 0; thread < count; ++thread)
+    {
+        m_threads.emplace_back([this, thread] {
+            t_serviceThread = thread;
+            // lws_service_tsi sleeps until there is network activity, a timer or lws_cancel_service
+            while (!m_stop.load(std::memory_order_acquire))
+            {
+                if (lws_service_tsi(m_context, 0, thread) < 0)
+                    break;
+            }
+        });
+    }
+
+    m_timersThread = std::thread([this] { runTimers(); });
+}
+
+BINAPI_NAMESPACE::ws::WSReactor::~WSReactor()
+{
+    m_stop.store(true, std::memory_order_release);
+    lws_cancel_service(m_context);
+
+    {
+        // The timers thread checks m_stop with the mutex held
+        std::scoped_lock lock(m_mutex);
+    }
+    m_timersCondition.notify_all();
+    if (m_timersThread.joinable())
+        m_timersThread.join();
+
+    for (auto &thread : m_threads)
+    {
+        if (thread.joinable())
+            thread.join();
+    }
+
+    {
+        // The handlers still registered may be gone. The context closes their connections without calling them
+        std::scoped_lock lock(m_mutex);
+        for (auto &[id, connection] : m_connections)
+        {
+            std::scoped_lock handlerLock(connection->handlerMutex);
+            connection->handler = nullptr;
+        }
+        m_timers.clear();
+    }
+
+    lws_context_destroy(m_context);
+}
+
+auto BINAPI_NAMESPACE::ws::WSReactor::shared() -> WSReactor &
+{
+    static WSReactor reactor;
+    return reactor;
+}
+
+auto BINAPI_NAMESPACE::ws::WSReactor::connect(Endpoint endpoint, Handler *handler, std::chrono::milliseconds delay) -> ConnectionId
+{
+    auto connection      = std::make_shared<Connection>();
+    connection->endpoint = std::move(endpoint);
+    connection->handler  = handler;
+
+    ConnectionId id = 0;
+    {
+        std::scoped_lock lock(m_mutex);
+        id             = m_nextId++;
+        connection->id = id;
+        m_connections.emplace(id, connection);
+
+        if (delay > std::chrono::milliseconds::zero())
+        {
+            // Moved to the pending connections by the timers thread
+            connection->scheduled = true;
+            m_timers.emplace(std::chrono::steady_clock::now() + delay, std::move(connection));
+            m_timersCondition.notify_one();
+            return id;
+        }
+
+        m_pending.push_back(std::move(connection));
+    }
+
+    lws_cancel_service(m_context);
+    return id;
+}
+
+auto BINAPI_NAMESPACE::ws::WSReactor::send(ConnectionId id, const std::string &message) -> bool
+{
+    std::string frame(LWS_PRE, '\0');
+    frame.append(message);
+
+    {
+        std::scoped_lock lock(m_mutex);
+        const auto connection = m_connections.find(id);
+        if (connection == m_connections.end() || connection->second->closing.load(std::memory_order_relaxed))
+            return false;
+
+        connection->second->outbox.push_back(std::move(frame));
+        m_requests.push_back(connection->second);
+    }
+
+    lws_cancel_service(m_context);
+    return true;
+}
+
+auto BINAPI_NAMESPACE::ws::WSReactor::wake(ConnectionId id) -> void
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        const auto connection = m_connections.find(id);
+        if (connection == m_connections.end())
+            return;
+
+        m_requests.push_back(connection->second);
+    }
+
+    lws_cancel_service(m_context);
+}
+
+auto BINAPI_NAMESPACE::ws::WSReactor::close(ConnectionId id) -> void
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        const auto connection = m_connections.find(id);
+        if (connection == m_connections.end())
+            return;
+
+        connection->second->closing.store(true, std::memory_order_relaxed);
+        if (connection->second->scheduled)
+        {
+            // Not opened yet: finished as a pending connection, without waiting for the delay
+            std::erase_if(m_timers, [&connection](const auto &timer) { return timer.second == connection->second; });
+            connection->second->scheduled = false;
+            m_pending.push_back(connection->second);
+        }
+        else
+        {
+            m_requests.push_back(connection->second);
+        }
+    }
+
+    lws_cancel_service(m_context);
+}
+
+auto BINAPI_NAMESPACE::ws::WSReactor::detach(ConnectionId id) -> void
+{
+    const auto connection = find(id);
+    if (connection == nullptr)
+        return;
+
+    {
+        std::scoped_lock handlerLock(connection->handlerMutex);
+        connection->handler = nullptr;
+    }
+    close(id);
+}
+
+auto BINAPI_NAMESPACE::ws::WSReactor::connections() const -> std::size_t
+{
+    std::scoped_lock lock(m_mutex);
+    return m_connections.size();
+}
+
+auto BINAPI_NAMESPACE::ws::WSReactor::threads() const noexcept -> std::size_t
+{
+    return m_threads.size();
+}
+
+auto BINAPI_NAMESPACE::ws::WSReactor::isServiceThread() noexcept -> bool
+{
+    return t_serviceThread >= 0;
+}
+
+auto BINAPI_NAMESPACE::ws::WSReactor::find(ConnectionId id) const -> std::shared_ptr<Connection>
+{
+    std::scoped_lock lock(m_mutex);
+    const auto connection = m_connections.find(id);
+    return connection == m_connections.end() ? nullptr : connection->second;
+}
+
+auto BINAPI_NAMESPACE::ws::WSReactor::finish(ConnectionId id) noexcept -> void
+{
+    std::shared_ptr<Connection> connection;
+    {
+        std::scoped_lock lock(m_mutex);
+        const auto iterator = m_connections.find(id);
+        if (iterator == m_connections.end())
+            return;
+
+        connection = std::move(iterator->second);
+        m_connections.erase(iterator);
+    }
+
+    std::scoped_lock handlerLock(connection->handlerMutex);
+    if (connection->handler != nullptr)
+    {
+        connection->handler->finished();
+        connection->handler = nullptr;
+    }
+}
+
+auto BINAPI_NAMESPACE::ws::WSReactor::serviceRequests(int thread) -> void
+{
+    std::vector<std::shared_ptr<Connection>> pending;
+    std::vector<std::shared_ptr<Connection>> requests;
+    {
+        std::scoped_lock lock(m_mutex);
+        pending.swap(m_pending);
+        // This thread opens them, so from now on their requests wait for it
+        for (const auto &connection : pending)
+            connection->owner.store(thread, std::memory_order_relaxed);
+
+        // Requests of connections owned by other threads are left for them. Connections not opened yet are dropped:
+        // a closing one is finished when it is opened
+        const auto mine = std::stable_partition(m_requests.begin(), m_requests.end(), [thread](const auto &connection) {
+            return connection->owner.load(std::memory_order_relaxed) != thread;
+        });
+        requests.assign(mine, m_requests.end());
+        m_requests.erase(mine, m_requests.end());
+        std::erase_if(m_requests, [](const auto &connection) { return connection->owner.load(std::memory_order_relaxed) < 0; });
+    }
+
+    for (const auto &connection : pending)
+    {
+        if (connection->closing.load(std::memory_order_relaxed))
+        {
+            finish(connection->id);
+            continue;
+        }
+
+        lws_client_connect_info ccinfo {};
+        memset(&ccinfo, 0, sizeof(lws_client_connect_info));
+        ccinfo.context        = m_context;
+        ccinfo.address        = connection->endpoint.address.c_str();
+        ccinfo.port           = connection->endpoint.port;
+        ccinfo.path           = connection->endpoint.path.c_str();
+        ccinfo.host           = lws_canonical_hostname(m_context);
+        ccinfo.origin         = "origin";
+        ccinfo.protocol       = m_protocols[0].name;
+        ccinfo.userdata       = reinterpret_cast<void *>(connection.get());
+        ccinfo.pwsi           = &connection->wsi;
+        ccinfo.ssl_connection = connection->endpoint.ssl ? LCCSCF_USE_SSL | LCCSCF_ALLOW_SELFSIGNED | LCCSCF_SKIP_SERVER_CERT_HOSTNAME_CHECK : 0;
+
+        if (lws_client_connect_via_info(&ccinfo) == nullptr)
+        {
+            {
+                // Unless libwebsockets did it before returning
+                std::scoped_lock handlerLock(connection->handlerMutex);
+                if (!connection->failed && connection->handler != nullptr)
+                    connection->handler->event(nullptr, LWS_CALLBACK_CLIENT_CONNECTION_ERROR, nullptr, 0);
+                connection->failed = true;
+            }
+            finish(connection->id);
+        }
+    }
+
+    for (const auto &connection : requests)
+    {
+        if (connection->wsi == nullptr)
+            continue;
+
+        // Messages are written and closings are done on the writable callback. Before the handshake is done there is no
+        // writable callback: the messages wait for it, but a closing connection is dropped now, so a hung handshake
+        // can be cancelled
+        if (connection->established)
+            lws_callback_on_writable(connection->wsi);
+        else if (connection->closing.load(std::memory_order_relaxed))
+            lws_set_timeout(connection->wsi, PENDING_TIMEOUT_USER_OK, LWS_TO_KILL_ASYNC);
+    }
+}
+
+auto BINAPI_NAMESPACE::ws::WSReactor::write(Connection &connection, lws *wsi) -> int
+{
+    using namespace std::chrono_literals;
+
+    const auto now   = std::chrono::steady_clock::now();
+    const auto limit = connection.endpoint.messagesPerSecond;
+    if (limit > 0)
+    {
+        while (!connection.written.empty() && now - connection.written.front() >= 1s)
+            connection.written.pop_front();
+
+        if (connection.written.size() >= limit)
+        {
+            // Written again when the oldest message of the window is one second old
+            std::scoped_lock lock(m_mutex);
+            const auto shared = m_connections.find(connection.id);
+            if (!connection.delayed && shared != m_connections.end())
+            {
+                connection.delayed = true;
+                m_timers.emplace(connection.written.front() + 1s, shared->second);
+                m_timersCondition.notify_one();
+            }
+            return 0;
+        }
+    }
+
+    std::string frame;
+    bool more = false;
+    {
+        std::scoped_lock lock(m_mutex);
+        if (!connection.outbox.empty())
+        {
+            frame = std::move(connection.outbox.front());
+            connection.outbox.pop_front();
+            more = !connection.outbox.empty();
+        }
+    }
+
+    if (frame.empty())
+    {
+        std::optional<std::string> message;
+        {
+            std::scoped_lock handlerLock(connection.handlerMutex);
+            if (connection.handler != nullptr)
+                message = connection.handler->pull();
+        }
+        if (!message.has_value())
+            return 0;
+
+        frame.assign(LWS_PRE, '\0');
+        frame.append(*message);
+        // Until the handler has nothing else
+        more = true;
+    }
+
+    const std::size_t size = frame.size() - LWS_PRE;
+    if (lws_write(wsi, reinterpret_cast<unsigned char *>(frame.data()) + LWS_PRE, size, LWS_WRITE_TEXT) < static_cast<int>(size))
+        return -1;
+
+    if (limit > 0)
+        connection.written.push_back(now);
+    if (more)
+        lws_callback_on_writable(wsi);
+    return 0;
+}
+
+auto BINAPI_NAMESPACE::ws::WSReactor::runTimers() -> void
+{
+    std::unique_lock lock(m_mutex);
+    while (!m_stop.load(std::memory_order_acquire))
+    {
+        if (m_timers.empty())
+        {
+            m_timersCondition.wait(lock);
+            continue;
+        }
+
+        // A copy: the timer can be removed while waiting (see close)
+        const auto now  = std::chrono::steady_clock::now();
+        const auto next = m_timers.begin()->first;
+        if (now < next)
+        {
+            m_timersCondition.wait_until(lock, next);
+            continue;
+        }
+
+        while (!m_timers.empty() && m_timers.begin()->first <= now)
+        {
+            auto connection = std::move(m_timers.begin()->second);
+            m_timers.erase(m_timers.begin());
+
+            if (connection->scheduled)
+            {
+                connection->scheduled = false;
+                m_pending.push_back(std::move(connection));
+            }
+            else
+            {
+                connection->delayed = false;
+                m_requests.push_back(std::move(connection));
+            }
+        }
+
+        lock.unlock();
+        lws_cancel_service(m_context);
+        lock.lock();
+    }
+}
+
+auto BINAPI_NAMESPACE::ws::WSReactor::callback(lws *wsi, lws_callback_reasons reason, void *user, void *in, std::size_t len) -> int
+{
+    auto reactor = reinterpret_cast<WSReactor *>(lws_context_user(lws_get_context(wsi)));
+    if (reactor == nullptr)
+        return 0;
+
+    // With LWS_MAX_SMP > 1 a new connection goes to the service thread that answers the same id, so it stays with the
+    // thread that opens it (see serviceRequests)
+    if (reason == LWS_CALLBACK_GET_THREAD_ID)
+        return t_serviceThread;
+
+    // lws_cancel_service wakes every service thread with this event
+    if (reason == LWS_CALLBACK_EVENT_WAIT_CANCELLED)
+    {
+        if (t_serviceThread >= 0)
+            reactor->serviceRequests(t_serviceThread);
+        return 0;
+    }
+
+    auto connection = reinterpret_cast<Connection *>(user);
+    if (connection == nullptr)
+        return 0;
+
+    return reactor->dispatch(*connection, wsi, reason, in, len);
+}
+
+auto BINAPI_NAMESPACE::ws::WSReactor::dispatch(Connection &connection, lws *wsi, lws_callback_reasons reason, void *in, std::size_t len) -> int
+{
+    if (t_serviceThread >= 0)
+        connection.owner.store(t_serviceThread, std::memory_order_relaxed);
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wswitch-enum"
+#endif /*__clang__*/
+    switch (reason)
+    {
+        case LWS_CALLBACK_CLIENT_ESTABLISHED:
+            // Messages queued or asked for while connecting, and closings, are done on the writable callback
+            connection.wsi         = wsi;
+            connection.established = true;
+            lws_callback_on_writable(wsi);
+            break;
+
+        case LWS_CALLBACK_CLIENT_WRITEABLE:
+            if (connection.closing.load(std::memory_order_relaxed))
+                return -1;
+            return write(connection, wsi);
+
+        case LWS_CALLBACK_CLIENT_CONNECTION_ERROR:
+            {
+                std::scoped_lock handlerLock(connection.handlerMutex);
+                connection.failed = true;
+                if (connection.handler != nullptr)
+                    connection.handler->event(wsi, reason, in, len);
+            }
+            return 0;
+
+        case LWS_CALLBACK_WSI_DESTROY:
+            // The last event of the connection
+            connection.wsi = nullptr;
+            finish(connection.id);
+            return 0;
+
+        default:
+            break;
+    }
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif /*__clang__*/
+
+    std::scoped_lock handlerLock(connection.handlerMutex);
+    return connection.handler == nullptr ? 0 : connection.handler->event(wsi, reason, in, len);
+}
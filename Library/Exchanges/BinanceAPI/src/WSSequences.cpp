@@ -0,0 +1,40 @@
+////////////////////////////////////////////////////////////////////////////////
+// Created by Ricardo Romero on 17/10/2026 for BinanceAPI.
+// Copyright (c) 2026. Ricardo Romero
+// All rights reserved.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "WSSequences.hpp"
+
+auto BINAPI_NAMESPACE::ws::WSSequences::received(SequencedStream stream, const std::string &symbol, uint64_t follows, uint64_t last) -> std::optional<SequenceGap>
+{
+    auto &ids                 = m_last[static_cast<std::size_t>(stream)];
+    const auto [id, inserted] = ids.try_emplace(symbol, last);
+    if (inserted)
+        return std::nullopt;
+
+    const uint64_t previous = id->second;
+    id->second              = last;
+
+    if (previous == follows)
+        return std::nullopt;
+    return SequenceGap { .lastReceived = previous, .follows = follows };
+}
+
+auto BINAPI_NAMESPACE::ws::WSSequences::forget(SequencedStream stream, const std::string &symbol) -> void
+{
+    m_last[static_cast<std::size_t>(stream)].erase(symbol);
+}
+
+auto BINAPI_NAMESPACE::ws::WSSequences::clear() -> void
+{
+    for (auto &ids : m_last)
+        ids.clear();
+}
+
+auto BINAPI_NAMESPACE::ws::WSSequences::last(SequencedStream stream, const std::string &symbol) const -> std::optional<uint64_t>
+{
+    const auto &ids = m_last[static_cast<std::size_t>(stream)];
+    const auto id   = ids.find(symbol);
+    return id == ids.end() ? std::nullopt : std::optional<uint64_t> { id->second };
+}
@@ -6,51 +6,25 @@
 
 #include "WSSpotBinanceAPI.hpp"
 #include "Binapi.hpp"
+#include "BinanceAPINumeric.hpp"
+#include "BinanceAPIStreamEvents.hpp"
 #include <random>
 
 #include <fmt/color.h>
 #include <fmt/core.h>
 
-#define SUBSCRIBE_METHOD(stream)              \
-    if (!isRunning())                         \
-        return { stream };                    \
-    else                                      \
-    {                                         \
-        int id = randNumber();                \
-        while (true)                          \
-        {                                     \
-            if (!m_subscribeIds.contains(id)) \
-            {                                 \
-                m_subscribeIds.insert(id);    \
-                break;                        \
-            }                                 \
-        }                                     \
-        subscribe(std::string(stream), id);   \
-        return { id };                        \
-    }
+#define SUBSCRIBE_METHOD(stream)             \
+    if (!isRunning() && !isReconnecting()) \
+        return { stream };                   \
+    return { m_subscriptions.subscribe({ std::string(stream) }).id };
 
-#define UNSUBSCRIBE_METHOD(stream)              \
-    if (isRunning())                            \
-    {                                           \
-        int id = randNumber();                  \
-        while (true)                            \
-        {                                       \
-            if (!m_unsubscribeIds.contains(id)) \
-            {                                   \
-                m_unsubscribeIds.insert(id);    \
-                break;                          \
-            }                                   \
-        }                                       \
-        unsubscribe(std::string(stream), id);   \
-        return id;                              \
-    }                                           \
+#define UNSUBSCRIBE_METHOD(stream)                                       \
+    if (isRunning() || isReconnecting())                                 \
+        return m_subscriptions.unsubscribe({ std::string(stream) }).id; \
     return -1;
 
-#define JTO_STRING(x, y)                         \
-    std::string                                  \
-    {                                            \
-        x[y].GetString(), x[y].GetStringLength() \
-    }
+#define JTO_STRING(x, y) \
+    std::string { jsonToView(x[y]) }
 
 static std::string symbolToLower(const std::string &symbol)
 {
@@ -59,21 +33,76 @@ static std::string symbolToLower(const std::string &symbol)
     return str;
 }
 
-BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::WSSpotBinanceAPI(std::string endpoint) :
-    WSThread("stream.binance.com", std::move(endpoint), 9443)
+
+BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::WSSpotBinanceAPI(std::string endpoint, WSReactor &reactor) :
+    WSThread("stream.binance.com", std::move(endpoint), 9443, reactor),
+    m_subscriptions { [this] { requestMessage(); } }
+{
+    // One message of every second is left for the pings
+    setMessageRate(messageRateLimit - 1);
+}
+
+auto BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::subscriptions() noexcept -> WSSubscriptions &
+{
+    return m_subscriptions;
+}
+
+auto BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::nextMessage() -> std::optional<std::string>
+{
+    return m_subscriptions.nextMessage();
+}
+
+auto BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::disconnected(bool reconnecting) noexcept -> void
+{
+    // The subscriptions belong to the connection
+    if (!reconnecting)
+    {
+        m_subscriptions.reset();
+        m_sequences.clear();
+        return;
+    }
+
+    // Subscribed again as soon as the new connection is established. The sequences are kept to tell whether it missed any event
+    for (const auto &completion : m_subscriptions.resubscribe())
+        unsubscribe(completion.success, completion.id);
+}
+
+auto BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::klineStreamName(const std::string &symbol, BinanceTimeIntervals interval) -> std::string
 {
+    return fmt::format("{}@kline_{}", symbolToLower(symbol), BINAPI_NAMESPACE::BinanceAPI::fromIntervalToString(interval));
 }
 
-void BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::subscribe(const std::string &stream, int id)
+auto BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::individualMiniTickerStreamName(const std::string &symbol) -> std::string
 {
-    std::string subscribe = fmt::format(R"({{"method": "SUBSCRIBE","params":["{}"],"id":{}}})", stream, id);
-    sendData(subscribe);
+    return fmt::format("{}@miniTicker", symbolToLower(symbol));
 }
 
-void BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::unsubscribe(const std::string &stream, int id)
+auto BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::individualSymbolTickerStreamName(const std::string &symbol) -> std::string
 {
-    std::string unsubscribe = fmt::format(R"({{"method": "UNSUBSCRIBE","params":["{}"],"id":{}}})", stream, id);
-    sendData(unsubscribe);
+    return fmt::format("{}@ticker", symbolToLower(symbol));
+}
+
+auto BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::individualSymbolBookTickerStreamName(const std::string &symbol) -> std::string
+{
+    return fmt::format("{}@bookTicker", symbolToLower(symbol));
+}
+
+auto BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::partialBookDepthStreamName(const std::string &symbol, int levels, int update) -> std::string
+{
+    assert(levels == 5 || levels == 10 || levels == 20);
+    assert(update == 1000 || update == 100);
+    return fmt::format("{}@depth{}@{}ms", symbolToLower(symbol), levels, update);
+}
+
+auto BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::diffBookDepthStreamName(const std::string &symbol, int update) -> std::string
+{
+    assert(update == 1000 || update == 100);
+    return fmt::format("{}@depth@{}ms", symbolToLower(symbol), update);
+}
+
+auto BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::aggregateTradeStreamName(const std::string &symbol) -> std::string
+{
+    return fmt::format("{}@aggTrade", symbolToLower(symbol));
 }
 
 /**
@@ -154,25 +183,25 @@ if (m_lws != nullptr)
 
 std::variant<std::string, int> BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::subscribeKline(const std::string &symbol, BinanceTimeIntervals interval)
 {
-    std::string stream = fmt::format("{}@kline_{}", symbolToLower(symbol), BINAPI_NAMESPACE::BinanceAPI::fromIntervalToString(interval));
+    std::string stream = klineStreamName(symbol, interval);
     SUBSCRIBE_METHOD(stream)
 }
 
 int BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::unsubscribeKline(const std::string &symbol, BinanceTimeIntervals interval)
 {
-    std::string stream = fmt::format("{}@kline_{}", symbolToLower(symbol), BINAPI_NAMESPACE::BinanceAPI::fromIntervalToString(interval));
+    std::string stream = klineStreamName(symbol, interval);
     UNSUBSCRIBE_METHOD(stream)
 }
 
 std::variant<std::string, int> BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::subscribeIndividualMiniTicker(const std::string &symbol)
 {
-    std::string stream = fmt::format("{}@miniTicker", symbolToLower(symbol));
+    std::string stream = individualMiniTickerStreamName(symbol);
     SUBSCRIBE_METHOD(stream);
 }
 
 int BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::unsubscribeIndividualMiniTicker(const std::string &symbol)
 {
-    std::string stream = fmt::format("{}@miniTicker", symbolToLower(symbol));
+    std::string stream = individualMiniTickerStreamName(symbol);
     UNSUBSCRIBE_METHOD(stream);
 }
 
@@ -184,7 +213,7 @@ std::variant<std::string, int> BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::subscribe
 
 std::variant<std::string, int> BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::subscribeIndividualSymbolTicker(const std::string &symbol)
 {
-    std::string stream = fmt::format("{}@ticker", symbolToLower(symbol));
+    std::string stream = individualSymbolTickerStreamName(symbol);
     SUBSCRIBE_METHOD(stream);
 }
 
@@ -196,7 +225,7 @@ std::variant<std::string, int> BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::subscribe
 
 std::variant<std::string, int> BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::subscribeIndividualSymbolBookTickerStreams(const std::string &symbol)
 {
-    std::string stream = fmt::format("{}@bookTicker", symbolToLower(symbol));
+    std::string stream = individualSymbolBookTickerStreamName(symbol);
     SUBSCRIBE_METHOD(stream);
 }
 
@@ -208,23 +237,31 @@ std::variant<std::string, int> BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::subscribe
 
 std::variant<std::string, int> BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::subscribePartialBookDepth(const std::string &symbol, int levels, int update)
 {
-    assert(levels == 5 || levels == 10 || levels == 20);
-    assert(update == 1000 || update == 100);
-    std::string stream = fmt::format("{}@depth{}@{}ms", symbolToLower(symbol), levels, update);
+    std::string stream = partialBookDepthStreamName(symbol, levels, update);
     SUBSCRIBE_METHOD(stream)
 }
 
 std::variant<std::string, int> BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::subscribeDiffBookDepth(const std::string &symbol, int update)
 {
-    assert(update == 1000 || update == 100);
-    std::string stream = fmt::format("{}@depth@{}ms", symbolToLower(symbol), update);
+    std::string stream = diffBookDepthStreamName(symbol, update);
     SUBSCRIBE_METHOD(stream)
 }
 
 int BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::unsubscribeDiffBookDepth(const std::string &symbol, int update)
 {
-    assert(update == 1000 || update == 100);
-    std::string stream = fmt::format("{}@depth@{}ms", symbolToLower(symbol), update);
+    std::string stream = diffBookDepthStreamName(symbol, update);
+    UNSUBSCRIBE_METHOD(stream)
+}
+
+std::variant<std::string, int> BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::subscribeAggregateTrade(const std::string &symbol)
+{
+    std::string stream = aggregateTradeStreamName(symbol);
+    SUBSCRIBE_METHOD(stream)
+}
+
+int BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::unsubscribeAggregateTrade(const std::string &symbol)
+{
+    std::string stream = aggregateTradeStreamName(symbol);
     UNSUBSCRIBE_METHOD(stream)
 }
 
@@ -260,9 +297,22 @@ void BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::bookTicker([[maybe_unused]] const s
 {
 }
 
+void BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::sequenceGap([[maybe_unused]] const std::string &symbol, [[maybe_unused]] SequencedStream stream, [[maybe_unused]] const SequenceGap &gap)
+{
+}
+
 void BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::depthUpdate([[maybe_unused]] const std::string &symbol, [[maybe_unused]] uint64_t eventTime, [[maybe_unused]] const StreamDepthUpdate &sdp)
 {
 }
+
+void BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::sharedDepthUpdate(const std::string &symbol, uint64_t eventTime, Snapshot<StreamDepthUpdate> sdp)
+{
+    depthUpdate(symbol, eventTime, *sdp);
+}
+
+void BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::aggregateTradeStream([[maybe_unused]] const std::string &symbol, [[maybe_unused]] uint64_t eventTime, [[maybe_unused]] const StreamAggregateTrade &as)
+{
+}
 /*
 void BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::sendData(const std::string &msg)
 {
@@ -276,8 +326,9 @@ void BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::sendData(const std::string &msg)
 */
 auto BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::receivedData() -> void
 {
-    rapidjson::Document jsonDoc;
-    jsonDoc.Parse(getJsonData().c_str());
+    // Parsed in situ over the message, with the memory of the arena of the thread
+    const auto message = getMessage();
+    local::ResponseDocument jsonDoc(message.data(), message.size());
     if (jsonDoc.HasParseError())
     {
         fmt::print(fmt::fg(fmt::color::red), "STREAM ERROR: ");
@@ -287,155 +338,158 @@ auto BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::receivedData() -> void
 
     try
     {
-        // Test for (un)subscription messages
-        if (jsonDoc.FindMember("result") != jsonDoc.MemberEnd())
+        // Test for (un)subscription answers: {"result":null,"id":1} or {"error":{...},"id":1}
+        const auto result = jsonDoc.FindMember("result");
+        const auto error  = jsonDoc.FindMember("error");
+        if (result != jsonDoc.MemberEnd() || error != jsonDoc.MemberEnd())
         {
+            const auto id = jsonDoc.FindMember("id");
+            if (id == jsonDoc.MemberEnd() || !id->value.IsInt())
+                return;
 
-            bool result = jsonDoc["result"].IsNull();
+            const bool success     = result != jsonDoc.MemberEnd() && result->value.IsNull();
+            const auto completions = m_subscriptions.confirm(id->value.GetInt(), success);
+            if (!completions.has_value())
+                return;
 
-            int id      = jsonDoc["id"].GetInt();
-            // Find the Id
-            auto siid = m_subscribeIds.find(id);
-            if (siid != m_subscribeIds.end())
+            for (const auto &completion : *completions)
             {
-                m_subscribeIds.erase(siid);
-
-                subscribe(result, id);
-            }
-            else
-            {
-                auto uiid = m_unsubscribeIds.find(id);
-                if (uiid != m_unsubscribeIds.end())
-                {
-                    unsubscribe(result, id);
-                    m_unsubscribeIds.erase(uiid);
-                }
+                if (completion.method == WSSubscriptions::Method::subscribe)
+                    subscribe(completion.success, completion.id);
+                else
+                    unsubscribe(completion.success, completion.id);
             }
 
             return;
         }
 
-        const rapidjson::Value &value = m_combined ? (jsonDoc.FindMember("data") != jsonDoc.MemberEnd() ? jsonDoc["data"].GetObject() : jsonDoc.GetObject()) : jsonDoc.GetObject();
-        std::string type              = JTO_STRING(value, "e");
+        // Combined streams wrap the payload in "data". The all market streams send an array
+        const auto data               = jsonDoc.FindMember("data");
+        const rapidjson::Value &value = m_combined && data != jsonDoc.MemberEnd() ? data->value : jsonDoc.root();
 
         if (!value.IsArray())
         {
-            if (type == "kline")
-            {
-                const auto &cd           = value["k"].GetObject();
-                BinanceTimeIntervals bti = BinanceTimeIntervals::i1M;
-                std::string interval     = JTO_STRING(cd, "i");
-                if (interval == "1m")
-                    bti = BinanceTimeIntervals::i1m;
-                else if (interval == "3m")
-                    bti = BinanceTimeIntervals::i3m;
-                else if (interval == "5m")
-                    bti = BinanceTimeIntervals::i5m;
-                else if (interval == "15m")
-                    bti = BinanceTimeIntervals::i15m;
-                else if (interval == "30m")
-                    bti = BinanceTimeIntervals::i30m;
-                else if (interval == "1h")
-                    bti = BinanceTimeIntervals::i1h;
-                else if (interval == "2h")
-                    bti = BinanceTimeIntervals::i2h;
-                else if (interval == "4h")
-                    bti = BinanceTimeIntervals::i4h;
-                else if (interval == "6h")
-                    bti = BinanceTimeIntervals::i6h;
-                else if (interval == "8h")
-                    bti = BinanceTimeIntervals::i8h;
-                else if (interval == "12h")
-                    bti = BinanceTimeIntervals::i12h;
-                else if (interval == "1d")
-                    bti = BinanceTimeIntervals::i1d;
-                else if (interval == "3d")
-                    bti = BinanceTimeIntervals::i3d;
-                else if (interval == "1w")
-                    bti = BinanceTimeIntervals::i1w;
-                else if (interval == "1M")
-                    bti = BinanceTimeIntervals::i1M;
-
-                Candlestick cs {
-                    .openTime              = cd["t"].GetUint64(),
-                    .open                  = std::stod(JTO_STRING(cd, "o")),
-                    .high                  = std::stod(JTO_STRING(cd, "h")),
-                    .low                   = std::stod(JTO_STRING(cd, "l")),
-                    .close                 = std::stod(JTO_STRING(cd, "c")),
-                    .volume                = std::stod(JTO_STRING(cd, "v")),
-                    .closeTime             = cd["T"].GetUint64(),
-                    .quoteAssetVolume      = std::stod(JTO_STRING(cd, "q")),
-                    .baseAssetVolume       = std::stod(JTO_STRING(cd, "v")),
-                    .numberOfTrades        = cd["n"].GetUint64(),
-                    .takerBaseAssetVolume  = std::stod(JTO_STRING(cd, "V")),
-                    .takerQuoteAssetVolume = std::stod(JTO_STRING(cd, "Q")),
-                    .isClosed              = cd["x"].GetBool(), /// Stream field otherwise always true
-                    .firstTradeId          = cd["f"].GetInt64(),
-                    .lastTradeId           = cd["L"].GetInt64()
-                };
-                kline(JTO_STRING(value, "s"), value["E"].GetUint64(), bti, cs);
-            }
-
-            else if (type == "24hrMiniTicker")
-            {
-                StreamIndividualSymbolMiniTicker smmt {
-                    .closePrice                  = std::stod(JTO_STRING(value, "c")),
-                    .openPrice                   = std::stod(JTO_STRING(value, "o")),
-                    .highPrice                   = std::stod(JTO_STRING(value, "h")),
-                    .lowPrice                    = std::stod(JTO_STRING(value, "l")),
-                    .totalTradedBaseAssetVolume  = std::stod(JTO_STRING(value, "v")),
-                    .totalTradedQuoteAssetVolume = std::stod(JTO_STRING(value, "q"))
-                };
-                individualSymbolMiniTicker(JTO_STRING(value, "s"), value["E"].GetUint64(), smmt);
-            }
-            else if (type == "24hrTicker")
-            {
-                StreamIndividualSymbolTicker sst {
-                    .priceChange                 = std::stod(JTO_STRING(value, "p")),
-                    .priceChangePercent          = std::stod(JTO_STRING(value, "P")),
-                    .weightedAveratePrice        = std::stod(JTO_STRING(value, "w")),
-                    .lastPrice                   = std::stod(JTO_STRING(value, "c")),
-                    .lastPriceQuantity           = std::stod(JTO_STRING(value, "Q")),
-                    .openPrice                   = std::stod(JTO_STRING(value, "o")),
-                    .highPrice                   = std::stod(JTO_STRING(value, "h")),
-                    .lowPrice                    = std::stod(JTO_STRING(value, "l")),
-                    .totalTradedBaseAssetVolume  = std::stod(JTO_STRING(value, "v")),
-                    .totalTradedQuoteAssetVolume = std::stod(JTO_STRING(value, "q")),
-                    .statisticsOpenTime          = value["O"].GetInt64(),
-                    .statisticsCloseTime         = value["C"].GetInt64(),
-                    .firstTreadeId               = value["F"].GetInt64(),
-                    .lastTradeId                 = value["L"].GetInt64(),
-                    .totalNumberOfTrades         = value["n"].GetUint64()
-                };
-                individualSymbolTicker(JTO_STRING(value, "s"), value["E"].GetUint64(), sst);
-            }
-            else if (type == "bookTicker")
+            // The parse stage of the event ends here: the message is parsed and its event known
+            const std::string_view event = jsonToView(value["e"]);
+            const auto symbol            = value.FindMember("s");
+            const auto eventTime         = value.FindMember("E");
+            eventParsed(symbol != value.MemberEnd() && symbol->value.IsString() ? jsonToView(symbol->value) : std::string_view {},
+                event,
+                eventTime != value.MemberEnd() && eventTime->value.IsUint64() ? eventTime->value.GetUint64() : 0);
+
+            switch (streamEventOf(event))
             {
-                StreamBookTicker sbt {
-                    .transactionTime = value["T"].GetUint64(),
-                    .bestBidPice     = std::stod(JTO_STRING(value, "b")),
-                    .bestBidQty      = std::stod(JTO_STRING(value, "B")),
-                    .bestAskPice     = std::stod(JTO_STRING(value, "a")),
-                    .bestAskQty      = std::stod(JTO_STRING(value, "A")),
-                };
-                bookTicker(JTO_STRING(value, "s"), value["E"].GetUint64(), sbt);
-            }
-
-            else if (type == "depthUpdate")
-            {
-
-                StreamDepthUpdate sdp {
-                    .transactionTime         = 0,
-                    .firstUpdateId           = value["U"].GetUint64(),
-                    .finalUpdateId           = value["u"].GetUint64(),
-                    .finalUpdateIdLastStream = 0
-                };
-                for (const auto &bids : value["b"].GetArray())
-                    sdp.bids[std::stod(JTO_STRING(bids, 0))] = std::stod(JTO_STRING(bids, 1));
-                for (const auto &asks : value["a"].GetArray())
-                    sdp.asks[std::stod(JTO_STRING(asks, 0))] = std::stod(JTO_STRING(asks, 1));
-
-                depthUpdate(JTO_STRING(value, "s"), value["E"].GetUint64(), sdp);
+                case StreamEvent::aggTrade:
+                    {
+                        StreamAggregateTrade sat {
+                            .aggregateTradeId = value["a"].GetInt64(),
+                            .price            = jsonToDouble(value["p"]),
+                            .qty              = jsonToDouble(value["q"]),
+                            .firstTradeId     = value["f"].GetInt64(),
+                            .lastTradeId      = value["l"].GetInt64(),
+                            .tradeTime        = value["T"].GetUint64(),
+                            .isMaker          = value["m"].GetBool()
+                        };
+                        const std::string symbol = JTO_STRING(value, "s");
+                        const auto id            = static_cast<uint64_t>(sat.aggregateTradeId);
+                        if (const auto gap = m_sequences.received(SequencedStream::aggregateTrade, symbol, id - 1, id); gap.has_value())
+                            sequenceGap(symbol, SequencedStream::aggregateTrade, *gap);
+
+                        aggregateTradeStream(symbol, value["E"].GetUint64(), sat);
+                    }
+                    break;
+                case StreamEvent::kline:
+                    {
+                        const auto &cd                 = value["k"].GetObject();
+                        const BinanceTimeIntervals bti = timeIntervalOf(jsonToView(cd["i"])).value_or(BinanceTimeIntervals::i1M);
+
+                        Candlestick cs {
+                            .openTime              = cd["t"].GetUint64(),
+                            .open                  = jsonToDouble(cd["o"]),
+                            .high                  = jsonToDouble(cd["h"]),
+                            .low                   = jsonToDouble(cd["l"]),
+                            .close                 = jsonToDouble(cd["c"]),
+                            .volume                = jsonToDouble(cd["v"]),
+                            .closeTime             = cd["T"].GetUint64(),
+                            .quoteAssetVolume      = jsonToDouble(cd["q"]),
+                            .baseAssetVolume       = jsonToDouble(cd["v"]),
+                            .numberOfTrades        = cd["n"].GetUint64(),
+                            .takerBaseAssetVolume  = jsonToDouble(cd["V"]),
+                            .takerQuoteAssetVolume = jsonToDouble(cd["Q"]),
+                            .isClosed              = cd["x"].GetBool(), /// Stream field otherwise always true
+                            .firstTradeId          = cd["f"].GetInt64(),
+                            .lastTradeId           = cd["L"].GetInt64()
+                        };
+                        kline(JTO_STRING(value, "s"), value["E"].GetUint64(), bti, cs);
+                    }
+                    break;
+                case StreamEvent::miniTicker:
+                    {
+                        StreamIndividualSymbolMiniTicker smmt {
+                            .closePrice                  = jsonToDouble(value["c"]),
+                            .openPrice                   = jsonToDouble(value["o"]),
+                            .highPrice                   = jsonToDouble(value["h"]),
+                            .lowPrice                    = jsonToDouble(value["l"]),
+                            .totalTradedBaseAssetVolume  = jsonToDouble(value["v"]),
+                            .totalTradedQuoteAssetVolume = jsonToDouble(value["q"])
+                        };
+                        individualSymbolMiniTicker(JTO_STRING(value, "s"), value["E"].GetUint64(), smmt);
+                    }
+                    break;
+                case StreamEvent::ticker:
+                    {
+                        StreamIndividualSymbolTicker sst {
+                            .priceChange                 = jsonToDouble(value["p"]),
+                            .priceChangePercent          = jsonToDouble(value["P"]),
+                            .weightedAveratePrice        = jsonToDouble(value["w"]),
+                            .lastPrice                   = jsonToDouble(value["c"]),
+                            .lastPriceQuantity           = jsonToDouble(value["Q"]),
+                            .openPrice                   = jsonToDouble(value["o"]),
+                            .highPrice                   = jsonToDouble(value["h"]),
+                            .lowPrice                    = jsonToDouble(value["l"]),
+                            .totalTradedBaseAssetVolume  = jsonToDouble(value["v"]),
+                            .totalTradedQuoteAssetVolume = jsonToDouble(value["q"]),
+                            .statisticsOpenTime          = value["O"].GetInt64(),
+                            .statisticsCloseTime         = value["C"].GetInt64(),
+                            .firstTreadeId               = value["F"].GetInt64(),
+                            .lastTradeId                 = value["L"].GetInt64(),
+                            .totalNumberOfTrades         = value["n"].GetUint64()
+                        };
+                        individualSymbolTicker(JTO_STRING(value, "s"), value["E"].GetUint64(), sst);
+                    }
+                    break;
+                case StreamEvent::bookTicker:
+                    {
+                        StreamBookTicker sbt {
+                            .transactionTime = value["T"].GetUint64(),
+                            .bestBidPice     = jsonToDouble(value["b"]),
+                            .bestBidQty      = jsonToDouble(value["B"]),
+                            .bestAskPice     = jsonToDouble(value["a"]),
+                            .bestAskQty      = jsonToDouble(value["A"]),
+                        };
+                        bookTicker(JTO_STRING(value, "s"), value["E"].GetUint64(), sbt);
+                    }
+                    break;
+                case StreamEvent::depthUpdate:
+                    {
+                        // Built in place of the payload shared with the consumers, see sharedDepthUpdate
+                        auto sdp = std::make_shared<StreamDepthUpdate>(StreamDepthUpdate {
+                            .transactionTime         = 0,
+                            .firstUpdateId           = value["U"].GetUint64(),
+                            .finalUpdateId           = value["u"].GetUint64(),
+                            .finalUpdateIdLastStream = 0,
+                            .bids                    = jsonToPriceLevels(value["b"]),
+                            .asks                    = jsonToPriceLevels(value["a"]) });
+
+                        const std::string symbol = JTO_STRING(value, "s");
+                        if (const auto gap = m_sequences.received(SequencedStream::depthUpdate, symbol, sdp->firstUpdateId - 1, sdp->finalUpdateId); gap.has_value())
+                            sequenceGap(symbol, SequencedStream::depthUpdate, *gap);
+
+                        sharedDepthUpdate(symbol, value["E"].GetUint64(), std::move(sdp));
+                    }
+                    break;
+                default:
+                    break;
             }
         }
         else // STREAM IS AN ARRAY
@@ -444,39 +498,45 @@ auto BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::receivedData() -> void
             std::multimap<std::string, std::pair<uint64_t, StreamMarketTickers>> mmsmt;
             for (const auto &streamArray : value.GetArray())
             {
-                const std::string stype = JTO_STRING(streamArray, "e");
-                if (stype == "24hrMiniTicker")
-                {
-                    StreamMarketMiniTickers smmt {
-                        .closePrice                  = std::stod(JTO_STRING(streamArray, "c")),
-                        .openPrice                   = std::stod(JTO_STRING(streamArray, "o")),
-                        .highPrice                   = std::stod(JTO_STRING(streamArray, "h")),
-                        .lowPrice                    = std::stod(JTO_STRING(streamArray, "l")),
-                        .totalTradedBaseAssetVolume  = std::stod(JTO_STRING(streamArray, "v")),
-                        .totalTradedQuoteAssetVolume = std::stod(JTO_STRING(streamArray, "q"))
-                    };
-                    mmsmmt.insert({ JTO_STRING(value, "s"), { value["E"].GetUint64(), smmt } });
-                }
-                else if (stype == "24hrTicker")
+                switch (streamEventOf(jsonToView(streamArray["e"])))
                 {
-                    StreamMarketTickers smt {
-                        .priceChange                 = std::stod(JTO_STRING(value, "p")),
-                        .priceChangePercent          = std::stod(JTO_STRING(value, "P")),
-                        .weightedAveratePrice        = std::stod(JTO_STRING(value, "w")),
-                        .lastPrice                   = std::stod(JTO_STRING(value, "c")),
-                        .lastPriceQuantity           = std::stod(JTO_STRING(value, "Q")),
-                        .openPrice                   = std::stod(JTO_STRING(value, "o")),
-                        .highPrice                   = std::stod(JTO_STRING(value, "h")),
-                        .lowPrice                    = std::stod(JTO_STRING(value, "l")),
-                        .totalTradedBaseAssetVolume  = std::stod(JTO_STRING(value, "v")),
-                        .totalTradedQuoteAssetVolume = std::stod(JTO_STRING(value, "q")),
-                        .statisticsOpenTime          = value["O"].GetInt64(),
-                        .statisticsCloseTime         = value["C"].GetInt64(),
-                        .firstTreadeId               = value["F"].GetInt64(),
-                        .lastTradeId                 = value["L"].GetInt64(),
-                        .totalNumberOfTrades         = value["n"].GetUint64()
-                    };
-                    mmsmt.insert({ JTO_STRING(value, "s"), { value["E"].GetUint64(), smt } });
+                    case StreamEvent::miniTicker:
+                        {
+                            StreamMarketMiniTickers smmt {
+                                .closePrice                  = jsonToDouble(streamArray["c"]),
+                                .openPrice                   = jsonToDouble(streamArray["o"]),
+                                .highPrice                   = jsonToDouble(streamArray["h"]),
+                                .lowPrice                    = jsonToDouble(streamArray["l"]),
+                                .totalTradedBaseAssetVolume  = jsonToDouble(streamArray["v"]),
+                                .totalTradedQuoteAssetVolume = jsonToDouble(streamArray["q"])
+                            };
+                            mmsmmt.insert({ JTO_STRING(streamArray, "s"), { streamArray["E"].GetUint64(), smmt } });
+                        }
+                        break;
+                    case StreamEvent::ticker:
+                        {
+                            StreamMarketTickers smt {
+                                .priceChange                 = jsonToDouble(streamArray["p"]),
+                                .priceChangePercent          = jsonToDouble(streamArray["P"]),
+                                .weightedAveratePrice        = jsonToDouble(streamArray["w"]),
+                                .lastPrice                   = jsonToDouble(streamArray["c"]),
+                                .lastPriceQuantity           = jsonToDouble(streamArray["Q"]),
+                                .openPrice                   = jsonToDouble(streamArray["o"]),
+                                .highPrice                   = jsonToDouble(streamArray["h"]),
+                                .lowPrice                    = jsonToDouble(streamArray["l"]),
+                                .totalTradedBaseAssetVolume  = jsonToDouble(streamArray["v"]),
+                                .totalTradedQuoteAssetVolume = jsonToDouble(streamArray["q"]),
+                                .statisticsOpenTime          = streamArray["O"].GetInt64(),
+                                .statisticsCloseTime         = streamArray["C"].GetInt64(),
+                                .firstTreadeId               = streamArray["F"].GetInt64(),
+                                .lastTradeId                 = streamArray["L"].GetInt64(),
+                                .totalNumberOfTrades         = streamArray["n"].GetUint64()
+                            };
+                            mmsmt.insert({ JTO_STRING(streamArray, "s"), { streamArray["E"].GetUint64(), smt } });
+                        }
+                        break;
+                    default:
+                        break;
                 }
             }
 
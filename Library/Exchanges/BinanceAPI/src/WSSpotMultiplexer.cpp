@@ -0,0 +1,586 @@
+////////////////////////////////////////////////////////////////////////////////
+// Created by Ricardo Romero on 17/10/2026 for BinanceAPI.
+// Copyright (c) 2026. Ricardo Romero
+// All rights reserved.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "WSSpotMultiplexer.hpp"
+#include "WSSpotBinanceAPI.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+    // Rendezvous weight of a symbol on a connection: FNV-1a of the symbol, mixed with the connection by splitmix64
+    auto rank(std::string_view symbol, std::size_t connection) noexcept -> uint64_t
+    {
+        uint64_t hash = 0xCBF2'9CE4'8422'2325ull;
+        for (const char c : symbol)
+        {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 0x0000'0100'0000'01B3ull;
+        }
+
+        uint64_t z = hash + (static_cast<uint64_t>(connection) + 1) * 0x9E37'79B9'7F4A'7C15ull;
+        z          = (z ^ (z >> 30)) * 0xBF58'476D'1CE4'E5B9ull;
+        z          = (z ^ (z >> 27)) * 0x94D0'49BB'1331'11EBull;
+        return z ^ (z >> 31);
+    }
+
+    // The highest ranked connection with room for the streams, or the highest ranked one if none has room
+    auto pick(std::string_view symbol, std::size_t streams, std::vector<std::size_t> &loads, std::size_t capacity) -> std::size_t
+    {
+        std::vector<std::pair<uint64_t, std::size_t>> ranks;
+        ranks.reserve(loads.size());
+        for (std::size_t connection = 0; connection < loads.size(); ++connection)
+            ranks.emplace_back(rank(symbol, connection), connection);
+        std::ranges::sort(ranks, std::greater {});
+
+        std::size_t chosen = ranks.front().second;
+        for (const auto &[weight, connection] : ranks)
+        {
+            if (loads[connection] + streams <= capacity)
+            {
+                chosen = connection;
+                break;
+            }
+        }
+
+        loads[chosen] += streams;
+        return chosen;
+    }
+} // namespace
+
+/// \brief One connection of the multiplexer. Forwards the data to the callbacks of the multiplexer
+class BINAPI_NAMESPACE::ws::WSSpotMultiplexer::Shard final : public WSSpotBinanceAPI
+{
+public:
+    Shard(WSSpotMultiplexer &owner, std::size_t index, WSReactor &reactor) :
+        WSSpotBinanceAPI("/ws", reactor),
+        m_owner { owner },
+        m_index { index }
+    {
+        // Opened again as soon as it is lost, the streams are subscribed again by WSSpotBinanceAPI
+        setReconnection(true);
+    }
+
+    ~Shard() override
+    {
+        terminate();
+        wait();
+    }
+
+public:
+    /// \brief Subscribe to the planned streams not carried yet
+    /// \return The id of the request and the streams added
+    auto subscribeTo(const std::set<std::string> &planned) -> std::pair<int, std::vector<std::string>>
+    {
+        std::vector<std::string> added;
+        std::ranges::set_difference(planned, streams, std::back_inserter(added));
+        if (added.empty())
+            return {};
+
+        const int request = subscriptions().subscribe(added).id;
+        streams.insert(added.begin(), added.end());
+        for (const auto &stream : added)
+            unconfirmed.insert_or_assign(stream, request);
+        return { request, std::move(added) };
+    }
+
+    /// \brief Stop carrying the streams that are not planned. They are received until drop() unsubscribes them
+    /// \return The streams
+    auto release(const std::set<std::string> &planned) -> std::vector<std::string>
+    {
+        std::vector<std::string> removed;
+        std::ranges::set_difference(streams, planned, std::back_inserter(removed));
+        for (const auto &stream : removed)
+        {
+            streams.erase(stream);
+            unconfirmed.erase(stream);
+        }
+        return removed;
+    }
+
+    /// \brief A subscription request was answered. The streams of a failed request are not carried anymore
+    /// \return The streams of the request still planned on the connection
+    auto answered(int request, bool success) -> std::vector<std::string>
+    {
+        std::vector<std::string> answered;
+        std::erase_if(unconfirmed, [request, &answered](const auto &entry) {
+            if (entry.second != request)
+                return false;
+            answered.push_back(entry.first);
+            return true;
+        });
+
+        if (!success)
+        {
+            for (const auto &stream : answered)
+                streams.erase(stream);
+        }
+        return answered;
+    }
+
+    /// \brief Unsubscribe from the streams released that were not planned again meanwhile
+    auto drop(std::vector<std::string> released) -> void
+    {
+        std::erase_if(released, [this](const auto &stream) { return streams.contains(stream); });
+        if (!released.empty())
+            subscriptions().unsubscribe(released);
+    }
+
+public:
+    // Streams planned on the connection. Guarded by the mutex of the multiplexer
+    std::set<std::string> streams;
+    // Streams planned and not confirmed yet, with the request subscribing them. Guarded by the mutex of the multiplexer
+    std::unordered_map<std::string, int> unconfirmed;
+
+public:
+    auto connected() -> void override { m_owner.connected(m_index); }
+    auto close() -> void override { m_owner.close(m_index); }
+    auto connectionError() -> void override { m_owner.connectionError(m_index); }
+    void pingSent([[maybe_unused]] bool success) noexcept override { }
+
+protected:
+    void subscribe(bool result, int id) override
+    {
+        m_owner.subscribed(*this, id, result);
+    }
+
+    void kline(const std::string &symbol, uint64_t eventTime, BinanceTimeIntervals interval, const Candlestick &cs) override
+    {
+        m_owner.kline(symbol, eventTime, interval, cs);
+    }
+
+    void individualSymbolMiniTicker(const std::string &symbol, uint64_t eventTime, const StreamIndividualSymbolMiniTicker &ticker) override
+    {
+        m_owner.individualSymbolMiniTicker(symbol, eventTime, ticker);
+    }
+
+    void allMarketMiniTickers(const std::multimap<std::string, std::pair<uint64_t, StreamMarketMiniTickers>> &mm) override
+    {
+        m_owner.allMarketMiniTickers(mm);
+    }
+
+    void individualSymbolTicker(const std::string &symbol, uint64_t eventTime, const StreamIndividualSymbolTicker &ticker) override
+    {
+        m_owner.individualSymbolTicker(symbol, eventTime, ticker);
+    }
+
+    void allMarketTickers(const std::multimap<std::string, std::pair<uint64_t, StreamMarketTickers>> &mm) override
+    {
+        m_owner.allMarketTickers(mm);
+    }
+
+    void bookTicker(const std::string &symbol, uint64_t eventTime, const StreamBookTicker &ticker) override
+    {
+        m_owner.bookTicker(symbol, eventTime, ticker);
+    }
+
+    void sharedDepthUpdate(const std::string &symbol, uint64_t eventTime, Snapshot<StreamDepthUpdate> sdp) override
+    {
+        m_owner.sharedDepthUpdate(symbol, eventTime, std::move(sdp));
+    }
+
+    void aggregateTradeStream(const std::string &symbol, uint64_t eventTime, const StreamAggregateTrade &as) override
+    {
+        m_owner.aggregateTradeStream(symbol, eventTime, as);
+    }
+
+    void sequenceGap(const std::string &symbol, SequencedStream stream, const SequenceGap &gap) override
+    {
+        m_owner.sequenceGap(symbol, stream, gap);
+    }
+
+private:
+    WSSpotMultiplexer &m_owner;
+    const std::size_t m_index;
+};
+
+BINAPI_NAMESPACE::ws::WSSpotMultiplexer::WSSpotMultiplexer(std::size_t connections, std::size_t streamsPerConnection, WSReactor &reactor) :
+    m_reactor { reactor },
+    m_minConnections { std::max<std::size_t>(1, connections) },
+    m_streamsPerConnection { std::max<std::size_t>(1, streamsPerConnection) }
+{
+}
+
+BINAPI_NAMESPACE::ws::WSSpotMultiplexer::~WSSpotMultiplexer()
+{
+    terminate();
+}
+
+auto BINAPI_NAMESPACE::ws::WSSpotMultiplexer::subscribe(const std::vector<std::string> &streams) -> void
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        for (const auto &stream : streams)
+            m_symbols[std::string(symbolOf(stream))].insert(stream);
+        rebalance();
+    }
+    reap();
+}
+
+auto BINAPI_NAMESPACE::ws::WSSpotMultiplexer::subscribe(const std::string &stream) -> void
+{
+    subscribe(std::vector<std::string> { stream });
+}
+
+auto BINAPI_NAMESPACE::ws::WSSpotMultiplexer::unsubscribe(const std::vector<std::string> &streams) -> void
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        for (const auto &stream : streams)
+            forget(stream);
+        rebalance();
+    }
+    reap();
+}
+
+auto BINAPI_NAMESPACE::ws::WSSpotMultiplexer::unsubscribe(const std::string &stream) -> void
+{
+    unsubscribe(std::vector<std::string> { stream });
+}
+
+auto BINAPI_NAMESPACE::ws::WSSpotMultiplexer::forget(const std::string &stream) -> void
+{
+    m_failures.erase(stream);
+
+    const auto symbol = m_symbols.find(std::string(symbolOf(stream)));
+    if (symbol == m_symbols.end())
+        return;
+
+    symbol->second.erase(stream);
+    if (symbol->second.empty())
+    {
+        m_assignment.erase(symbol->first);
+        m_symbols.erase(symbol);
+    }
+}
+
+auto BINAPI_NAMESPACE::ws::WSSpotMultiplexer::setStreamMetrics(StreamMetrics *metrics) -> void
+{
+    std::scoped_lock lock(m_mutex);
+    m_streamMetrics = metrics;
+}
+
+auto BINAPI_NAMESPACE::ws::WSSpotMultiplexer::setHost(const std::string &url, int32_t port) -> void
+{
+    std::scoped_lock lock(m_mutex);
+    m_url  = url;
+    m_port = port;
+}
+
+auto BINAPI_NAMESPACE::ws::WSSpotMultiplexer::terminate() -> void
+{
+    std::vector<std::unique_ptr<Shard>> shards;
+    {
+        std::scoped_lock lock(m_mutex);
+        shards.swap(m_shards);
+        std::ranges::move(m_leaving, std::back_inserter(shards));
+        std::ranges::move(m_retired, std::back_inserter(shards));
+        m_leaving.clear();
+        m_retired.clear();
+        m_handovers.clear();
+        m_failures.clear();
+        m_symbols.clear();
+        m_assignment.clear();
+    }
+    // The shards close their connection and wait for it when destroyed
+    shards.clear();
+}
+
+auto BINAPI_NAMESPACE::ws::WSSpotMultiplexer::reap() -> void
+{
+    if (WSReactor::isServiceThread())
+        return;
+
+    std::vector<std::unique_ptr<Shard>> retired;
+    {
+        std::scoped_lock lock(m_mutex);
+        retired.swap(m_retired);
+    }
+    retired.clear();
+}
+
+auto BINAPI_NAMESPACE::ws::WSSpotMultiplexer::connections() const -> std::size_t
+{
+    std::scoped_lock lock(m_mutex);
+    return m_shards.size();
+}
+
+auto BINAPI_NAMESPACE::ws::WSSpotMultiplexer::streams() const -> std::size_t
+{
+    std::scoped_lock lock(m_mutex);
+    std::size_t count = 0;
+    for (const auto &[symbol, streams] : m_symbols)
+        count += streams.size();
+    return count;
+}
+
+auto BINAPI_NAMESPACE::ws::WSSpotMultiplexer::streams(std::size_t connection) const -> std::size_t
+{
+    std::scoped_lock lock(m_mutex);
+    return connection < m_shards.size() ? m_shards[connection]->streams.size() : 0;
+}
+
+auto BINAPI_NAMESPACE::ws::WSSpotMultiplexer::connectionOf(const std::string &stream) const -> std::optional<std::size_t>
+{
+    std::scoped_lock lock(m_mutex);
+    const std::string symbol { symbolOf(stream) };
+
+    const auto streams = m_symbols.find(symbol);
+    if (streams == m_symbols.end() || !streams->second.contains(stream))
+        return std::nullopt;
+
+    const auto assignment = m_assignment.find(symbol);
+    return assignment == m_assignment.end() ? std::nullopt : std::optional<std::size_t> { assignment->second };
+}
+
+auto BINAPI_NAMESPACE::ws::WSSpotMultiplexer::symbolOf(std::string_view stream) noexcept -> std::string_view
+{
+    if (stream.starts_with('!'))
+        return stream;
+    return stream.substr(0, stream.find('@'));
+}
+
+auto BINAPI_NAMESPACE::ws::WSSpotMultiplexer::assign(const std::map<std::string, std::size_t> &symbols, std::size_t connections, std::size_t capacity)
+    -> std::unordered_map<std::string, std::size_t>
+{
+    std::unordered_map<std::string, std::size_t> assignment;
+    if (connections == 0)
+        return assignment;
+
+    std::vector<std::size_t> loads(connections, 0);
+    assignment.reserve(symbols.size());
+    for (const auto &[symbol, streams] : symbols)
+        assignment.emplace(symbol, pick(symbol, streams, loads, capacity));
+
+    return assignment;
+}
+
+auto BINAPI_NAMESPACE::ws::WSSpotMultiplexer::plannedStreams(std::size_t connections) const -> std::vector<std::set<std::string>>
+{
+    std::vector<std::set<std::string>> planned(connections);
+    for (const auto &[symbol, streams] : m_symbols)
+    {
+        const auto connection = m_assignment.find(symbol);
+        if (connection != m_assignment.end() && connection->second < connections)
+            planned[connection->second].insert(streams.begin(), streams.end());
+    }
+    return planned;
+}
+
+auto BINAPI_NAMESPACE::ws::WSSpotMultiplexer::rebalance() -> void
+{
+    std::size_t total = 0;
+    std::map<std::string, std::size_t> counts;
+    for (const auto &[symbol, streams] : m_symbols)
+    {
+        counts.emplace(symbol, streams.size());
+        total += streams.size();
+    }
+
+    // A quarter of every connection is kept free, so that new streams of a symbol fit in its connection
+    const std::size_t perConnection = std::max<std::size_t>(1, m_streamsPerConnection * 3 / 4);
+    const std::size_t target        = total == 0 ? 0 : std::max(m_minConnections, (total + perConnection - 1) / perConnection);
+
+    if (target != m_shards.size())
+    {
+        // Rendezvous hashing: the symbols that change connection are mostly the ones ranked first on the
+        // connections added, or assigned to the connections removed
+        m_assignment = assign(counts, target, perConnection);
+    }
+    else
+    {
+        std::vector<std::size_t> loads(target, 0);
+        for (const auto &[symbol, connection] : m_assignment)
+            loads[connection] += counts.at(symbol);
+
+        for (const auto &[symbol, count] : counts)
+        {
+            if (!m_assignment.contains(symbol))
+                m_assignment.emplace(symbol, pick(symbol, count, loads, perConnection));
+        }
+    }
+
+    while (m_shards.size() < target)
+    {
+        auto shard = std::make_unique<Shard>(*this, m_shards.size(), m_reactor);
+        shard->setStreamMetrics(m_streamMetrics);
+        if (!m_url.empty())
+            shard->setHost(m_url, m_port);
+        shard->start();
+        m_shards.push_back(std::move(shard));
+    }
+
+    // The connections left over carry nothing now. They are closed once their streams are confirmed on the others
+    while (m_shards.size() > target)
+    {
+        m_leaving.push_back(std::move(m_shards.back()));
+        m_shards.pop_back();
+    }
+
+    const auto planned = plannedStreams(target);
+    std::unordered_map<std::string, std::pair<const Shard *, int>> subscribed;
+    for (std::size_t connection = 0; connection < target; ++connection)
+    {
+        auto [request, added] = m_shards[connection]->subscribeTo(planned[connection]);
+        for (auto &stream : added)
+            subscribed.emplace(std::move(stream), std::pair<const Shard *, int> { m_shards[connection].get(), request });
+    }
+
+    // The moved streams are unsubscribed from the old connection when the new one confirms them; the others at once
+    const auto release = [this, &subscribed](Shard &shard, const std::set<std::string> &streams) {
+        std::vector<std::string> removed;
+        for (auto &stream : shard.release(streams))
+        {
+            const auto moved = subscribed.find(stream);
+            if (moved == subscribed.end())
+                removed.push_back(std::move(stream));
+            else
+                m_handovers[moved->second].push_back({ &shard, std::move(stream) });
+        }
+        shard.drop(std::move(removed));
+    };
+
+    for (std::size_t connection = 0; connection < target; ++connection)
+        release(*m_shards[connection], planned[connection]);
+    for (const auto &shard : m_leaving)
+        release(*shard, {});
+
+    closeLeaving();
+}
+
+auto BINAPI_NAMESPACE::ws::WSSpotMultiplexer::subscribed(Shard &shard, int request, bool success) -> void
+{
+    std::vector<std::string> abandoned;
+    {
+        std::scoped_lock lock(m_mutex);
+
+        // Failed or not, the streams moved are not received from their old connection anymore
+        const auto handovers = m_handovers.extract({ &shard, request });
+        if (!handovers.empty())
+            completeHandovers(handovers.mapped());
+
+        // The streams of a failed request are subscribed again by rebalance(), up to subscriptionAttempts times
+        const auto streams = shard.answered(request, success);
+        for (const auto &stream : streams)
+        {
+            if (success)
+                m_failures.erase(stream);
+            else if (++m_failures[stream] >= subscriptionAttempts)
+            {
+                forget(stream);
+                abandoned.push_back(stream);
+            }
+        }
+
+        if (!success && !streams.empty())
+            rebalance();
+        else
+            closeLeaving();
+    }
+
+    if (!abandoned.empty())
+        subscriptionFailed(abandoned);
+}
+
+auto BINAPI_NAMESPACE::ws::WSSpotMultiplexer::completeHandovers(const std::vector<Handover> &handovers) -> void
+{
+    std::map<Shard *, std::vector<std::string>> released;
+    for (const auto &[from, stream] : handovers)
+        released[from].push_back(stream);
+
+    for (auto &[shard, streams] : released)
+        shard->drop(std::move(streams));
+}
+
+auto BINAPI_NAMESPACE::ws::WSSpotMultiplexer::closeLeaving() -> void
+{
+    const auto waiting = [this](const Shard *shard) {
+        return std::ranges::any_of(m_handovers, [shard](const auto &handovers) {
+            return std::ranges::any_of(handovers.second, [shard](const Handover &handover) { return handover.from == shard; });
+        });
+    };
+
+    // Closing a connection completes the streams it was moving, which may let another one close
+    const auto next = [this, &waiting] { return std::ranges::find_if_not(m_leaving, [&waiting](const auto &shard) { return waiting(shard.get()); }); };
+    for (auto leaving = next(); leaving != m_leaving.end(); leaving = next())
+    {
+        // The requests of the connection are not answered anymore: the streams they moved are unsubscribed now
+        Shard *shard = leaving->get();
+        for (auto handovers = m_handovers.begin(); handovers != m_handovers.end();)
+        {
+            if (handovers->first.first == shard)
+            {
+                completeHandovers(handovers->second);
+                handovers = m_handovers.erase(handovers);
+            }
+            else
+                ++handovers;
+        }
+
+        // Closing does not wait. It is destroyed by reap()
+        shard->terminate();
+        m_retired.push_back(std::move(*leaving));
+        m_leaving.erase(leaving);
+    }
+}
+
+void BINAPI_NAMESPACE::ws::WSSpotMultiplexer::connected([[maybe_unused]] std::size_t connection)
+{
+}
+
+void BINAPI_NAMESPACE::ws::WSSpotMultiplexer::close([[maybe_unused]] std::size_t connection)
+{
+}
+
+void BINAPI_NAMESPACE::ws::WSSpotMultiplexer::connectionError([[maybe_unused]] std::size_t connection)
+{
+}
+
+void BINAPI_NAMESPACE::ws::WSSpotMultiplexer::subscriptionFailed([[maybe_unused]] const std::vector<std::string> &streams)
+{
+}
+
+void BINAPI_NAMESPACE::ws::WSSpotMultiplexer::kline([[maybe_unused]] const std::string &symbol, [[maybe_unused]] uint64_t eventTime, [[maybe_unused]] BinanceTimeIntervals interval, [[maybe_unused]] const Candlestick &cs)
+{
+}
+
+void BINAPI_NAMESPACE::ws::WSSpotMultiplexer::individualSymbolMiniTicker([[maybe_unused]] const std::string &symbol, [[maybe_unused]] uint64_t eventTime, [[maybe_unused]] const StreamIndividualSymbolMiniTicker &ticker)
+{
+}
+
+void BINAPI_NAMESPACE::ws::WSSpotMultiplexer::allMarketMiniTickers([[maybe_unused]] const std::multimap<std::string, std::pair<uint64_t, StreamMarketMiniTickers>> &mm)
+{
+}
+
+void BINAPI_NAMESPACE::ws::WSSpotMultiplexer::individualSymbolTicker([[maybe_unused]] const std::string &symbol, [[maybe_unused]] uint64_t eventTime, [[maybe_unused]] const StreamIndividualSymbolTicker &ticker)
+{
+}
+
+void BINAPI_NAMESPACE::ws::WSSpotMultiplexer::allMarketTickers([[maybe_unused]] const std::multimap<std::string, std::pair<uint64_t, StreamMarketTickers>> &mm)
+{
+}
+
+void BINAPI_NAMESPACE::ws::WSSpotMultiplexer::bookTicker([[maybe_unused]] const std::string &symbol, [[maybe_unused]] uint64_t eventTime, [[maybe_unused]] const StreamBookTicker &ticker)
+{
+}
+
+void BINAPI_NAMESPACE::ws::WSSpotMultiplexer::depthUpdate([[maybe_unused]] const std::string &symbol, [[maybe_unused]] uint64_t eventTime, [[maybe_unused]] const StreamDepthUpdate &sdp)
+{
+}
+
+void BINAPI_NAMESPACE::ws::WSSpotMultiplexer::sharedDepthUpdate(const std::string &symbol, uint64_t eventTime, Snapshot<StreamDepthUpdate> sdp)
+{
+    depthUpdate(symbol, eventTime, *sdp);
+}
+
+void BINAPI_NAMESPACE::ws::WSSpotMultiplexer::aggregateTradeStream([[maybe_unused]] const std::string &symbol, [[maybe_unused]] uint64_t eventTime, [[maybe_unused]] const StreamAggregateTrade &as)
+{
+}
+
+void BINAPI_NAMESPACE::ws::WSSpotMultiplexer::sequenceGap([[maybe_unused]] const std::string &symbol, [[maybe_unused]] SequencedStream stream, [[maybe_unused]] const SequenceGap &gap)
+{
+}
@@ -0,0 +1,251 @@
+////////////////////////////////////////////////////////////////////////////////
+// Created by Ricardo Romero on 17/10/2026 for BinanceAPI.
+// Copyright (c) 2026. Ricardo Romero
+// All rights reserved.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "WSSubscriptions.hpp"
+
+#include <algorithm>
+
+BINAPI_NAMESPACE::ws::WSSubscriptions::WSSubscriptions(std::function<void()> wake, std::size_t streamsPerMessage) :
+    m_wake { std::move(wake) },
+    m_streamsPerMessage { std::max<std::size_t>(1, streamsPerMessage) }
+{
+}
+
+auto BINAPI_NAMESPACE::ws::WSSubscriptions::subscribe(const std::vector<std::string> &streams) -> Ticket
+{
+    return enqueue(Method::subscribe, streams);
+}
+
+auto BINAPI_NAMESPACE::ws::WSSubscriptions::unsubscribe(const std::vector<std::string> &streams) -> Ticket
+{
+    return enqueue(Method::unsubscribe, streams);
+}
+
+auto BINAPI_NAMESPACE::ws::WSSubscriptions::enqueue(Method method, const std::vector<std::string> &streams) -> Ticket
+{
+    Ticket ticket;
+    {
+        std::scoped_lock lock(m_mutex);
+        ticket.id = m_nextRequest++;
+
+        auto &request     = m_requests[ticket.id];
+        request.method    = method;
+        request.remaining = streams.size();
+        ticket.confirmed  = request.promise.get_future();
+
+        if (streams.empty())
+        {
+            request.promise.set_value(true);
+            m_requests.erase(ticket.id);
+            return ticket;
+        }
+
+        for (const auto &stream : streams)
+        {
+            m_queue.push_back({ method, stream, ticket.id });
+            m_states[stream] = { method == Method::subscribe ? State::pending : State::unsubscribing, ticket.id };
+        }
+    }
+
+    if (m_wake)
+        m_wake();
+    return ticket;
+}
+
+auto BINAPI_NAMESPACE::ws::WSSubscriptions::nextMessage() -> std::optional<std::string>
+{
+    std::scoped_lock lock(m_mutex);
+    if (m_queue.empty())
+        return std::nullopt;
+
+    // A stream subscribed and then unsubscribed must be sent in that order: a message only takes the
+    // operations with the method of the first one
+    Message message { .method = m_queue.front().method, .operations = {} };
+    while (!m_queue.empty() && m_queue.front().method == message.method && message.operations.size() < m_streamsPerMessage)
+    {
+        message.operations.push_back(std::move(m_queue.front()));
+        m_queue.pop_front();
+    }
+
+    const int id = m_nextMessage++;
+
+    std::string text = message.method == Method::subscribe ? R"({"method":"SUBSCRIBE","params":[)" : R"({"method":"UNSUBSCRIBE","params":[)";
+    for (std::size_t i = 0; i < message.operations.size(); ++i)
+    {
+        if (i > 0)
+            text += ',';
+        text += '"';
+        text += message.operations[i].stream;
+        text += '"';
+    }
+    text += R"(],"id":)";
+    text += std::to_string(id);
+    text += '}';
+
+    m_inFlight.emplace(id, std::move(message));
+    return text;
+}
+
+auto BINAPI_NAMESPACE::ws::WSSubscriptions::confirm(int id, bool success) -> std::optional<std::vector<Completion>>
+{
+    std::scoped_lock lock(m_mutex);
+    const auto message = m_inFlight.find(id);
+    if (message == m_inFlight.end())
+        return std::nullopt;
+
+    std::vector<Completion> completions;
+    for (const auto &operation : message->second.operations)
+    {
+        // The stream may have been requested again after this message was sent: the last request decides the state
+        const auto state = m_states.find(operation.stream);
+        auto request     = m_requests.find(operation.request);
+        if (state != m_states.end() && state->second.request == operation.request)
+        {
+            if (message->second.method == Method::subscribe)
+            {
+                if (success)
+                    state->second.state = State::active;
+                else if (request != m_requests.end())
+                {
+                    // Failed until the request is completed
+                    state->second.state = State::failed;
+                    request->second.failed.push_back(operation.stream);
+                }
+                else
+                    m_states.erase(state);
+            }
+            else if (success)
+                m_states.erase(state);
+            else
+                state->second.state = State::active;
+        }
+
+        if (request == m_requests.end())
+            continue;
+
+        request->second.success = request->second.success && success;
+        if (--request->second.remaining == 0)
+        {
+            // The failed streams are reported with the request: the server does not keep them
+            for (const auto &stream : request->second.failed)
+            {
+                const auto failed = m_states.find(stream);
+                if (failed != m_states.end() && failed->second.state == State::failed && failed->second.request == request->first)
+                    m_states.erase(failed);
+            }
+
+            request->second.promise.set_value(request->second.success);
+            completions.push_back({ request->second.method, request->first, request->second.success });
+            m_requests.erase(request);
+        }
+    }
+
+    m_inFlight.erase(message);
+    return completions;
+}
+
+auto BINAPI_NAMESPACE::ws::WSSubscriptions::resubscribe() -> std::vector<Completion>
+{
+    std::vector<std::string> wanted;
+    std::vector<Completion> completions;
+    {
+        std::scoped_lock lock(m_mutex);
+
+        m_queue.clear();
+        m_inFlight.clear();
+
+        std::erase_if(m_states, [](const auto &state) { return state.second.state == State::unsubscribing; });
+
+        // Streams of each request still waiting for an answer. The rest were answered or requested again
+        std::unordered_map<int, std::size_t> remaining;
+        for (auto &[stream, current] : m_states)
+        {
+            if (current.state == State::active)
+                current = { State::pending, 0 };
+            if (current.state == State::pending)
+            {
+                wanted.push_back(stream);
+                ++remaining[current.request];
+            }
+        }
+
+        // The order of the subscriptions does not matter, but the messages are easier to follow sorted
+        std::ranges::sort(wanted);
+        for (const auto &stream : wanted)
+            m_queue.push_back({ Method::subscribe, stream, m_states[stream].request });
+
+        for (auto request = m_requests.begin(); request != m_requests.end();)
+        {
+            const auto streams        = remaining.find(request->first);
+            request->second.remaining = streams == remaining.end() ? 0 : streams->second;
+            if (request->second.remaining > 0)
+            {
+                ++request;
+                continue;
+            }
+
+            request->second.promise.set_value(request->second.success);
+            completions.push_back({ request->second.method, request->first, request->second.success });
+            request = m_requests.erase(request);
+        }
+
+        // The failed streams of the requests completed are reported with them
+        std::erase_if(m_states, [this](const auto &state) { return state.second.state == State::failed && !m_requests.contains(state.second.request); });
+    }
+
+    if (!wanted.empty() && m_wake)
+        m_wake();
+
+    return completions;
+}
+
+auto BINAPI_NAMESPACE::ws::WSSubscriptions::reset() -> std::vector<std::string>
+{
+    std::scoped_lock lock(m_mutex);
+
+    std::vector<std::string> wanted;
+    for (const auto &[stream, current] : m_states)
+    {
+        if (current.state == State::active || current.state == State::pending)
+            wanted.push_back(stream);
+    }
+
+    for (auto &[id, request] : m_requests)
+        request.promise.set_value(false);
+
+    m_queue.clear();
+    m_requests.clear();
+    m_inFlight.clear();
+    m_states.clear();
+
+    return wanted;
+}
+
+auto BINAPI_NAMESPACE::ws::WSSubscriptions::state(const std::string &stream) const -> std::optional<State>
+{
+    std::scoped_lock lock(m_mutex);
+    const auto state = m_states.find(stream);
+    return state == m_states.end() ? std::nullopt : std::optional<State> { state->second.state };
+}
+
+auto BINAPI_NAMESPACE::ws::WSSubscriptions::streams(State state) const -> std::vector<std::string>
+{
+    std::scoped_lock lock(m_mutex);
+    std::vector<std::string> streams;
+    for (const auto &[stream, current] : m_states)
+    {
+        if (current.state == state)
+            streams.push_back(stream);
+    }
+    std::ranges::sort(streams);
+    return streams;
+}
+
+auto BINAPI_NAMESPACE::ws::WSSubscriptions::queued() const -> std::size_t
+{
+    std::scoped_lock lock(m_mutex);
+    return m_queue.size();
+}
@@ -5,34 +5,33 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "WSThread.hpp"
+#include <algorithm>
 #include <random>
+#include <stdexcept>
 
 #include <fmt/color.h>
 #include <fmt/core.h>
 
-BINAPI_NAMESPACE::ws::WSThread::WSThread(std::string url, std::string endPoint, int32_t port) :
+BINAPI_NAMESPACE::ws::WSThread::WSThread(std::string url, std::string endPoint, int32_t port, WSReactor &reactor) :
+    m_reactor { reactor },
     m_url { std::move(url) },
     m_endPoint { std::move(endPoint) },
     m_port { port }
 {
-    m_jsonData.reserve(1024 * 1024);
+    m_message.reserve(1024 * 1024);
+}
 
-    // Init protocol
-    m_protocols[0] = { "wsProtocol", WSThread::eventManager, 0, 65535, 0, nullptr, 0 };
-    m_protocols[1] = { nullptr, nullptr, 0, 0, 0, nullptr, 0 };
-    // lws_set_log_level(LLL_THREAD | LLL_USER | LLL_ERR | LLL_WARN | LLL_NOTICE | LLL_INFO, nullptr);
-    lws_set_log_level(0, nullptr);
+BINAPI_NAMESPACE::ws::WSThread::~WSThread()
+{
+    // No callback reaches the object from now on
+    if (m_connection != 0)
+        m_reactor.detach(m_connection);
 }
-BINAPI_NAMESPACE::ws::WSThread::~WSThread() = default;
 
 auto BINAPI_NAMESPACE::ws::WSThread::sendData(const std::string &msg) -> void
 {
-    char *str = new char[msg.size() + LWS_PRE + 1];
-    memset(str, 0, msg.size() + LWS_PRE);
-    strcpy(str + LWS_PRE, msg.c_str());
-    lws_write(m_lws, reinterpret_cast<unsigned char *>(str) + LWS_PRE, msg.size(), LWS_WRITE_TEXT);
-    // All previous calls are C functions and do not throw, so we can be assured that delete is going to be called
-    delete[] str;
+    // Written by the service thread of the connection
+    m_reactor.send(m_connection, msg);
 }
 
 auto BINAPI_NAMESPACE::ws::WSThread::randNumber() -> int
@@ -53,22 +52,90 @@ auto BINAPI_NAMESPACE::ws::WSThread::isTerminated() -> bool
     return m_terminate.load();
 }
 
+auto BINAPI_NAMESPACE::ws::WSThread::isReconnecting() -> bool
+{
+    return m_reconnecting.load();
+}
+
 auto BINAPI_NAMESPACE::ws::WSThread::setPingTimer(uint64_t timer) -> void
 {
     m_pingTimer = timer;
 }
 
+auto BINAPI_NAMESPACE::ws::WSThread::setMessageRate(uint32_t messagesPerSecond) -> void
+{
+    m_messageRate = messagesPerSecond;
+}
+
+auto BINAPI_NAMESPACE::ws::WSThread::setReconnection(bool enabled, std::chrono::milliseconds initialDelay, std::chrono::milliseconds maximumDelay) -> void
+{
+    m_reconnect    = enabled;
+    m_initialDelay = std::max(initialDelay, std::chrono::milliseconds(1));
+    m_maximumDelay = std::max(maximumDelay, m_initialDelay);
+}
+
+void BINAPI_NAMESPACE::ws::WSThread::reconnecting([[maybe_unused]] uint32_t attempt, [[maybe_unused]] std::chrono::milliseconds delay) noexcept
+{
+}
+
+auto BINAPI_NAMESPACE::ws::WSThread::nextMessage() -> std::optional<std::string>
+{
+    return std::nullopt;
+}
+
+auto BINAPI_NAMESPACE::ws::WSThread::requestMessage() -> void
+{
+    if (m_connection != 0)
+        m_reactor.wake(m_connection);
+}
+
+auto BINAPI_NAMESPACE::ws::WSThread::disconnected([[maybe_unused]] bool reconnecting) noexcept -> void
+{
+}
+
+auto BINAPI_NAMESPACE::ws::WSThread::pull() -> std::optional<std::string>
+{
+    return nextMessage();
+}
+
 void BINAPI_NAMESPACE::ws::WSThread::terminate()
 {
+    // Under the lock, so a reconnection is not opened after the connection is closed
+    std::scoped_lock lock(m_finishedMutex);
+    m_stop      = true;
     m_terminate = true;
 
-    if (m_context)
-        lws_cancel_service(m_context);
+    if (m_connection != 0)
+        m_reactor.close(m_connection);
+}
+
+auto BINAPI_NAMESPACE::ws::WSThread::getMessage() noexcept -> std::span<char>
+{
+    return { m_message.data(), m_message.size() };
+}
+
+auto BINAPI_NAMESPACE::ws::WSThread::getTimings() const noexcept -> const StreamTimings &
+{
+    return m_timings;
+}
+
+auto BINAPI_NAMESPACE::ws::WSThread::eventParsed(std::string_view symbol, std::string_view event, uint64_t eventTime) -> void
+{
+    m_timings.eventTime = eventTime;
+    m_timings.parsed    = std::chrono::steady_clock::now();
+
+    if (m_streamMetrics == nullptr)
+        return;
+
+    m_streamName.assign(symbol);
+    m_streamName.push_back('@');
+    m_streamName.append(event);
+    m_streamMetrics->recordParsed(m_streamName, m_timings);
 }
 
-auto BINAPI_NAMESPACE::ws::WSThread::getJsonData() const -> const std::string &
+auto BINAPI_NAMESPACE::ws::WSThread::setStreamMetrics(StreamMetrics *metrics) -> void
 {
-    return m_jsonData;
+    m_streamMetrics = metrics;
 }
 
 auto binapi::ws::WSThread::setEndPoint(const std::string &endpoint) -> void
@@ -76,57 +143,111 @@ auto binapi::ws::WSThread::setEndPoint(const std::string &endpoint) -> void
     m_endPoint = endpoint;
 }
 
+auto BINAPI_NAMESPACE::ws::WSThread::setHost(const std::string &url, int32_t port) -> void
+{
+    m_url  = url;
+    m_port = port;
+}
+
 auto BINAPI_NAMESPACE::ws::WSThread::run() -> void
 {
-    if (m_running)
-        throw(std::runtime_error("WebSocket already running"));
+    start();
+    wait();
+}
+
+auto BINAPI_NAMESPACE::ws::WSThread::start() -> void
+{
+    {
+        std::scoped_lock lock(m_finishedMutex);
+        if (m_running || !m_finished)
+            throw(std::runtime_error("WebSocket already running"));
+
+        m_finished = false;
+        m_stop     = false;
+    }
 
     m_terminate = false;
+    m_receiving = false;
+    m_attempt   = 0;
 
-    if (m_context != nullptr)
-        lws_context_destroy(m_context);
+    m_connection = m_reactor.connect(endpoint(), this);
+}
 
-    // Init Context
-    lws_context_creation_info info {};                   /*C++ Initialization just to get rid of clang-tidy and clang warnings of uninitialized variables*/
-    memset(&info, 0, sizeof(lws_context_creation_info)); // Proper zero initialization of a C struct
+auto BINAPI_NAMESPACE::ws::WSThread::endpoint() const -> WSReactor::Endpoint
+{
+    return { .address = m_url, .path = m_endPoint, .port = m_port, .ssl = true, .messagesPerSecond = m_messageRate };
+}
+
+auto BINAPI_NAMESPACE::ws::WSThread::reconnectionDelay() -> std::chrono::milliseconds
+{
+    thread_local std::mt19937_64 generator { std::random_device {}() };
 
-    info.options   = LWS_SERVER_OPTION_DO_SSL_GLOBAL_INIT;
-    info.port      = CONTEXT_PORT_NO_LISTEN; /* we do not run any server */
-    info.protocols = m_protocols;
-    // info.fd_limit_per_thread = 1 + 1 + 1;
+    // min(initial * 2^attempt, maximum), without overflowing
+    auto delay = m_initialDelay;
+    for (uint32_t i = 0; i < m_attempt && delay < m_maximumDelay; ++i)
+        delay *= 2;
+    delay = std::min(delay, m_maximumDelay);
 
-    m_context = lws_create_context(&info);
+    std::uniform_int_distribution<std::chrono::milliseconds::rep> jitter(delay.count() / 2, delay.count());
+    return std::chrono::milliseconds(jitter(generator));
+}
 
-    lws_client_connect_info ccinfo {};
-    memset(&ccinfo, 0, sizeof(lws_client_connect_info));
-    ccinfo.context        = m_context;
-    ccinfo.address        = m_url.c_str();
-    ccinfo.port           = m_port;
-    ccinfo.path           = m_endPoint.c_str();
-    ccinfo.host           = lws_canonical_hostname(m_context);
-    ccinfo.origin         = "origin";
-    ccinfo.protocol       = m_protocols[0].name;
-    ccinfo.userdata       = reinterpret_cast<void *>(this);
-    ccinfo.ssl_connection = LCCSCF_USE_SSL | LCCSCF_ALLOW_SELFSIGNED | LCCSCF_SKIP_SERVER_CERT_HOSTNAME_CHECK;
+auto BINAPI_NAMESPACE::ws::WSThread::wait() -> void
+{
+    // The connection is finished by a service thread. If it is this one, it would wait for itself
+    if (WSReactor::isServiceThread())
+        throw std::logic_error("WSThread::wait called from a WebSocket service thread");
 
-    m_lws                 = lws_client_connect_via_info(&ccinfo);
+    std::unique_lock lock(m_finishedMutex);
+    m_finishedCondition.wait(lock, [this] { return m_finished; });
+}
 
-    if (m_lws == nullptr)
-        throw std::runtime_error("failed to connect");
+auto BINAPI_NAMESPACE::ws::WSThread::finished() noexcept -> void
+{
+    m_running = false;
 
-    while (!m_terminate)
+    if (m_reconnect)
     {
-        lws_service(m_context, 0 /*As documentation denotes it, this value is deprecated and must be zero*/);
+        bool stop = false;
+        {
+            std::scoped_lock lock(m_finishedMutex);
+            stop = m_stop;
+        }
+
+        if (!stop)
+        {
+            const auto delay = reconnectionDelay();
+            ++m_attempt;
+            m_reconnecting = true;
+
+            disconnected(true);
+            reconnecting(m_attempt, delay);
+
+            std::scoped_lock lock(m_finishedMutex);
+            if (!m_stop)
+            {
+                // The new connection reports to this same object, no one waiting in wait() is released
+                m_terminate  = false;
+                m_receiving  = false;
+                m_connection = m_reactor.connect(endpoint(), this, delay);
+                return;
+            }
+        }
     }
-    lws_context_destroy(m_context);
-    m_context = nullptr;
-    m_running = false;
+
+    m_reconnecting = false;
+    m_terminate    = true;
+
+    disconnected(false);
+
+    // Notified with the lock held: the object can be destroyed as soon as wait() returns
+    std::scoped_lock lock(m_finishedMutex);
+    m_finished = true;
+    m_finishedCondition.notify_all();
 }
 
-auto BINAPI_NAMESPACE::ws::WSThread::eventManager(struct lws *wsi, lws_callback_reasons reason, void *user, void *in, size_t len) -> int
+auto BINAPI_NAMESPACE::ws::WSThread::event(lws *wsi, lws_callback_reasons reason, void *in, std::size_t len) -> int
 {
-    auto client = reinterpret_cast<BINAPI_NAMESPACE::ws::WSThread *>(user);
-
 #ifdef __clang__
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wswitch-enum"
@@ -134,32 +255,53 @@ auto BINAPI_NAMESPACE::ws::WSThread::eventManager(struct lws *wsi, lws_callback_
     switch (reason)
     {
         case LWS_CALLBACK_CLIENT_ESTABLISHED:
-            lws_callback_on_writable(wsi);
-            if (client)
-            {
-                if (client->m_pingTimer > 0)
-                    lws_set_timer_usecs(wsi, static_cast<lws_usec_t>(client->m_pingTimer) * LWS_USEC_PER_SEC);
+            if (m_pingTimer > 0)
+                lws_set_timer_usecs(wsi, static_cast<lws_usec_t>(m_pingTimer) * LWS_USEC_PER_SEC);
 
-                client->m_running = true;
-                client->connected();
-            }
+            m_attempt      = 0;
+            m_reconnecting = false;
+            m_running      = true;
+            connected();
             break;
 
         case LWS_CALLBACK_CLIENT_RECEIVE:
             {
-                // std::string msg = std::string(reinterpret_cast<char *>(in), len);
+                // A message may come in several callbacks: in WebSocket fragments, or in pieces of the receive
+                // buffer when a frame is bigger than it. The pieces are appended to a buffer that is reused
+                if (!m_receiving)
+                {
+                    m_message.clear();
+                    m_overflow = false;
+
+                    m_timings                = StreamTimings {};
+                    m_timings.received       = std::chrono::system_clock::now();
+                    m_timings.receivedSteady = std::chrono::steady_clock::now();
+                }
+
+                const bool final = lws_is_final_fragment(wsi) != 0;
+                m_receiving      = !final;
+
+                if (!m_overflow && m_message.size() + len > maxMessageSize)
+                {
+                    fmt::print(fmt::fg(fmt::color::red), "STREAM ERROR: ");
+                    fmt::print("Message larger than {} bytes was dropped\n", maxMessageSize);
+                    m_overflow = true;
+                    m_message.clear();
+                }
+
+                if (!m_overflow)
+                    m_message.append(reinterpret_cast<const char *>(in), len);
+
+                if (!final || m_overflow)
+                    break;
 
-                if (client)
+                if (lws_frame_is_binary(wsi))
+                {
+                    fmt::print("LWS received binary data and was ignored.\n");
+                }
+                else
                 {
-                    if (lws_frame_is_binary(wsi))
-                    {
-                        fmt::print("LWS received binary data and was ignored.\n");
-                    }
-                    else
-                    {
-                        client->m_jsonData = std::string { reinterpret_cast<char *>(in), len };
-                        client->receivedData();
-                    }
+                    receivedData();
                 }
             }
             break;
@@ -169,35 +311,29 @@ auto BINAPI_NAMESPACE::ws::WSThread::eventManager(struct lws *wsi, lws_callback_
 
         case LWS_CALLBACK_CLOSED:
         case LWS_CALLBACK_CLIENT_CLOSED:
-            if (client)
-            {
-                // Set proper flags to allow reconnection
-                client->m_running   = false;
-                client->m_terminate = true;
+            // Set proper flags to allow reconnection
+            m_running   = false;
+            m_terminate = true;
 
-                client->close();
-            }
+            close();
             break;
         case LWS_CALLBACK_CLIENT_CONNECTION_ERROR:
-            if (client)
-            {
-                client->m_running   = false;
-                client->m_terminate = true;
-                client->connectionError();
-            }
+            m_running   = false;
+            m_terminate = true;
+            connectionError();
             break;
 
         case LWS_CALLBACK_TIMER:
-            if (client && client->m_pingTimer)
+            if (m_pingTimer)
             {
                 uint8_t ping[LWS_PRE + 125];
                 int m = lws_write(wsi, ping + LWS_PRE, 0, LWS_WRITE_PING);
                 if (m < 0)
-                    client->pingSent(false);
+                    pingSent(false);
                 else
-                    client->pingSent(true);
+                    pingSent(true);
 
-                lws_set_timer_usecs(wsi, static_cast<lws_usec_t>(client->m_pingTimer * LWS_USEC_PER_SEC));
+                lws_set_timer_usecs(wsi, static_cast<lws_usec_t>(m_pingTimer * LWS_USEC_PER_SEC));
             }
             break;
 
@@ -18,6 +18,7 @@
 #include <CentaurPlugin.hpp>
 #include <QLabel>
 #include <QMouseEvent>
+#include <mutex>
 
 namespace CENTAUR_PLUGIN_NAMESPACE
 {
@@ -75,7 +76,6 @@ namespace CENTAUR_PLUGIN_NAMESPACE
 
     private:
         std::unique_ptr<CandleSpotMarketWS> m_candleWS { nullptr };
-        std::thread m_spotWSThread;
         std::map<int, QString> m_wsIds;
 
     protected:
@@ -103,6 +103,7 @@ namespace CENTAUR_PLUGIN_NAMESPACE
         void close() override;
         void connectionError() override;
         void pingSent(bool success) noexcept override;
+        void reconnecting(uint32_t attempt, std::chrono::milliseconds delay) noexcept override;
 
     protected:
         void subscribe(bool status, int id) override;
@@ -113,6 +114,8 @@ namespace CENTAUR_PLUGIN_NAMESPACE
         CENTAUR_INTERFACE_NAMESPACE::ILogger *m_logger { nullptr };
         BinanceCS *m_obj { nullptr };
         std::promise<void> m_connected;
+        // The connection is reopened when lost: only the first attempt unblocks the plugin
+        std::once_flag m_connectedOnce;
     };
 
 } // namespace CENTAUR_PLUGIN_NAMESPACE
@@ -121,7 +121,7 @@ void cen::plugin::BinanceCS::acquire(const PluginInformation &pi, const QString
     {
         // Handle SPOT
         m_symbolsHandled[id] = { symbol, frame }; // The UI makes sure this id is unique across all plugins, symbols amd timeframes
-        if (m_spotWSThread.joinable() && m_candleWS)
+        if (m_candleWS)
         {
             logInfo("BinanceCS", QString("Attempting to add %1 to the KLine WS").arg(symbol));
             //         auto subsVar = m_candleWS->subscribeKline(symbol.toStdString(), BinanceCS::mapIntervalFromUIToAPI(frame));
@@ -158,10 +158,10 @@ void cen::plugin::BinanceCS::disengage(const uuid &id, uint64_t lastTimeframeSta
         logWarn("BinanceCS", "The KLine SPOT WebSocket thread will be stopped because the candle list is empty.");
 
         // Stop the thread instead
-        if (m_spotWSThread.joinable() && m_candleWS)
+        if (m_candleWS)
         {
             m_candleWS->terminate();
-            m_spotWSThread.join();
+            m_candleWS->wait();
         }
         m_candleWS.reset();
         logWarn("BinanceCS", "The Spot KLine WebSocket thread stopped.");
@@ -245,10 +245,10 @@ void cen::plugin::BinanceCS::reframe(cen::plugin::ICandleView::TimeFrame frame)
 void cen::plugin::BinanceCS::startCandleThread(const QString &symbol, BINAPI_NAMESPACE::BinanceTimeIntervals interval)
 {
     logTrace("BinanceCS", "BinanceSpotPlugin::runMarketWS");
-    if (m_spotWSThread.joinable())
+    if (m_candleWS)
     {
         m_candleWS->terminate();
-        m_spotWSThread.join();
+        m_candleWS->wait();
     }
 
     m_candleWS.reset();
@@ -264,10 +264,9 @@ void cen::plugin::BinanceCS::startCandleThread(const QString &symbol, BINAPI_NAM
 
     m_candleWS->setEndPoint(ep);
 
-    m_spotWSThread = std::thread([&] {
-        logInfo("BinanceCS", "Spot WebSocket thread created.");
-        m_candleWS->run();
-    });
+    // The connection is serviced by the shared reactor of the library
+    m_candleWS->start();
+    logInfo("BinanceCS", "Spot WebSocket connection started.");
 
     future.wait();
     logInfo("BinanceCS", "The main thread is unblocked");
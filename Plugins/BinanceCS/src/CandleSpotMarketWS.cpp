@@ -19,6 +19,7 @@ CENTAUR_PLUGIN_NAMESPACE::CandleSpotMarketWS::CandleSpotMarketWS(std::promise<vo
 {
     qRegisterMetaType<binapi::BinanceTimeIntervals>("binapi::BinanceTimeIntervals");
     qRegisterMetaType<binapi::Candlestick>("binapi::Candlestick");
+    setReconnection(true);
 }
 
 CENTAUR_PLUGIN_NAMESPACE::CandleSpotMarketWS::~CandleSpotMarketWS() = default;
@@ -38,7 +39,7 @@ void CENTAUR_PLUGIN_NAMESPACE::CandleSpotMarketWS::connected()
         m_logger->info("CandleSpotMarketWS", "Binance Spot for candles WebSocket is connected");
     }
 
-    m_connected.set_value();
+    std::call_once(m_connectedOnce, [this] { m_connected.set_value(); });
 }
 
 void CENTAUR_PLUGIN_NAMESPACE::CandleSpotMarketWS::close()
@@ -51,7 +52,13 @@ void CENTAUR_PLUGIN_NAMESPACE::CandleSpotMarketWS::connectionError()
     if (m_logger)
         m_logger->error("CandleSpotMarketWS", "Binance Spot for candles WebSockets failed to connect");
 
-    m_connected.set_value();
+    std::call_once(m_connectedOnce, [this] { m_connected.set_value(); });
+}
+
+void CENTAUR_PLUGIN_NAMESPACE::CandleSpotMarketWS::reconnecting(uint32_t attempt, std::chrono::milliseconds delay) noexcept
+{
+    if (m_logger)
+        m_logger->warning("CandleSpotMarketWS", QString("Binance Spot for candles WebSocket lost. Reconnecting in %1 ms (attempt %2)").arg(delay.count()).arg(attempt));
 }
 
 void CENTAUR_PLUGIN_NAMESPACE::CandleSpotMarketWS::subscribe(bool status, int id)
@@ -14,24 +14,38 @@
 #define CENTAUR_BINANCESPOT_HPP
 
 #include "BinanceAPI.hpp"
+#include "ChannelReceiver.hpp"
 #include "WSSpotBinanceAPI.hpp"
 #include <CentaurInterface.hpp>
 #include <CentaurPlugin.hpp>
 #include <QDate>
 #include <QIcon>
 #include <QMap>
-#include <QMetaType>
 #include <QObject>
 #include <QPair>
 #include <QThread>
+#include <QTimer>
+#include <exception>
+#include <filesystem>
 #include <future>
 #include <memory>
-#include <thread>
+#include <mutex>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 
 BEGIN_CENTAUR_NAMESPACE
 
+/// \brief Order book event passed from the WebSocket thread to the plugin thread
+struct SpotDepthEvent
+{
+    std::string symbol;
+    uint64_t eventTime { 0 };
+    /// Shared with the parser, never copied. Null when updates of the symbol were lost
+    BINAPI_NAMESPACE::Snapshot<BINAPI_NAMESPACE::StreamDepthUpdate> update;
+    BINAPI_NAMESPACE::StreamTimings timings;
+};
+
 class SpotMarketWS;
 class BinanceSpotPlugin : public QObject,
                           public CENTAUR_PLUGIN_NAMESPACE::IExchange
@@ -98,7 +112,6 @@ public:
 public slots:
     void onTickerUpdate(const QString &symbol, quint64 receivedTime, double price) noexcept;
     void onSubscription(bool subscribe, bool status, int id) noexcept;
-    void onDepthUpdate(const QString &symbol, quint64 eventTime, const binapi::StreamDepthUpdate &sdp) noexcept;
     void onSpotStatus() noexcept;
     void onCoinInformation() noexcept;
     void onSpotDepositHistory() noexcept;
@@ -114,6 +127,20 @@ public slots:
 public:
     void setExchangeInformation(const BINAPI_NAMESPACE::SPOT::ExchangeInformation &data);
 
+    // Order book events, delivered by SpotMarketWS in batches
+public:
+    void onDepthEvent(SpotDepthEvent &&event) noexcept;
+    void onDepthBatch() noexcept;
+
+protected:
+    void publishOrderbooks() noexcept;
+    void emitOrderbook(const QString &symbol, const BINAPI_NAMESPACE::Snapshot<BINAPI_NAMESPACE::BookTop> &top) noexcept;
+    void requestOrderbookSnapshot(const QString &symbol) noexcept;
+    void onOrderbookSnapshot(const QString &symbol, uint64_t request, const BINAPI_NAMESPACE::SPOT::OrderBook &snapshot) noexcept;
+    void onOrderbookSnapshotError(const QString &symbol, uint64_t request, const std::exception_ptr &error) noexcept;
+    void onDepthGap(const QString &symbol) noexcept;
+    void logDepthLatency(const QString &symbol) noexcept;
+
 signals:
     void snTickerUpdate(const QString &symbol, const QString &sourceUUID, quint64 receivedTime, double price);
     void snOrderbookUpdate(const QString &source, const QString &symbol, quint64 receivedTime, const QMap<qreal, QPair<qreal, qreal>> &bids, const QMap<qreal, QPair<qreal, qreal>> &asks);
@@ -128,7 +155,6 @@ private:
     CENTAUR_INTERFACE_NAMESPACE::ILogger *m_logger { nullptr };
     CENTAUR_INTERFACE_NAMESPACE::IConfiguration *m_config { nullptr };
     std::unique_ptr<SpotMarketWS> m_spotWS { nullptr };
-    std::unique_ptr<std::thread> m_spotWSThread { nullptr };
 
 protected:
     CENTAUR_PLUGIN_NAMESPACE::StringIconVector m_symbols;
@@ -138,6 +164,11 @@ private:
     BINAPI_NAMESPACE::SPOT::ExchangeInformation m_exchInfo;
     BINAPI_NAMESPACE::BinanceLimits m_limits;
     BINAPI_NAMESPACE::BinanceKeys m_keys;
+    // Calls made out of the plugin thread, e.g. the orderbook snapshots. Declared after m_bAPI, m_limits and m_keys,
+    // which its calls use, so it is destroyed before them
+    std::unique_ptr<BINAPI_NAMESPACE::BinanceAPISpotAsync> m_asyncAPI { nullptr };
+    // Reference data of the last session, e.g. the exchange information
+    std::filesystem::path m_cacheSnapshot;
 
     // SEVEN-DAY CACHE CHART
 private:
@@ -147,7 +178,27 @@ private:
 protected:
     std::map<int, QString> m_wsIds;
     std::unordered_set<QString> m_symbolsWatch;
-    std::unordered_map<QString, std::pair<bool, uint64_t>> m_symbolOrderbookSnapshot;
+    // The book of a watched symbol and the publication of its top levels
+    struct OrderbookFeed
+    {
+        OrderbookFeed()                      = default;
+        OrderbookFeed(const OrderbookFeed &) = delete;
+
+        BINAPI_NAMESPACE::OrderBook book;
+        BINAPI_NAMESPACE::BookConflator conflator { book };
+        // Of the last diff applied
+        BINAPI_NAMESPACE::StreamTimings timings {};
+    };
+    std::unordered_map<QString, OrderbookFeed> m_orderbooks;
+    // Snapshot in flight of each symbol and the wait after a failed one. A result whose request is not in flight is from
+    // an orderbook stopped or reopened since
+    BINAPI_NAMESPACE::OrderBookSnapshots m_snapshots;
+    // Time between two updates of the orderbook dialog. Zero updates it with every diff
+    std::chrono::milliseconds m_orderbookInterval { 200 };
+    // Publishes the changes conflated since the last update of the dialog, when it is due
+    QTimer *m_orderbookTimer;
+    // Latency of the events of the streams, from the exchange to the orderbook dialog
+    BINAPI_NAMESPACE::StreamMetrics m_streamMetrics;
 
 protected:
     BINAPI_NAMESPACE::AllCoinsInformation m_coinInformation;
@@ -177,23 +228,33 @@ public:
     void close() override;
     void connectionError() override;
     void pingSent(bool success) noexcept override;
+    void reconnecting(uint32_t attempt, std::chrono::milliseconds delay) noexcept override;
 
 protected:
     void subscribe(bool status, int id) override;
     void unsubscribe(bool status, int id) override;
     void individualSymbolMiniTicker(const std::string &symbol, uint64_t eventTime, const BINAPI_NAMESPACE::StreamIndividualSymbolMiniTicker &ticker) override;
-    void depthUpdate(const std::string &symbol, uint64_t eventTime, const BINAPI_NAMESPACE::StreamDepthUpdate &sdp) override;
+    void sharedDepthUpdate(const std::string &symbol, uint64_t eventTime, BINAPI_NAMESPACE::Snapshot<BINAPI_NAMESPACE::StreamDepthUpdate> sdp) override;
+    void sequenceGap(const std::string &symbol, BINAPI_NAMESPACE::ws::SequencedStream stream, const BINAPI_NAMESPACE::ws::SequenceGap &gap) override;
+
+private:
+    void pushDepthEvent(const std::string &symbol, uint64_t eventTime, BINAPI_NAMESPACE::Snapshot<BINAPI_NAMESPACE::StreamDepthUpdate> sdp);
 
 private:
     CENTAUR_INTERFACE_NAMESPACE::ILogger *m_logger { nullptr };
     BinanceSpotPlugin *m_obj { nullptr };
     std::promise<void> m_connected;
+    // The connection is reopened when lost: only the first attempt unblocks runMarketWS
+    std::once_flag m_connectedOnce;
+    // Order book updates, drained by the plugin thread once per batch
+    BINAPI_NAMESPACE::MPSCChannel<SpotDepthEvent> m_depthChannel { 4096 };
+    std::unique_ptr<ChannelReceiver<BINAPI_NAMESPACE::MPSCChannel<SpotDepthEvent>>> m_depthReceiver;
+    // Symbols whose updates were dropped because the channel was full. Only used by the WebSocket thread
+    std::unordered_set<std::string> m_depthLost;
 };
 
 END_CENTAUR_NAMESPACE
 
-Q_DECLARE_METATYPE(BINAPI_NAMESPACE::StreamDepthUpdate)
-
 // Helper macros
 #define logInfo(x, y) \
     m_logger->info(x, y)
@@ -0,0 +1,74 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+// Created by Ricardo Romero on 17/10/26.
+// Copyright (c) 2026 Ricardo Romero.  All rights reserved.
+//
+
+#pragma once
+
+#ifndef __cplusplus
+#error "C++ compiler needed"
+#endif /*__cplusplus*/
+
+#ifndef CENTAUR_CHANNELRECEIVER_HPP
+#define CENTAUR_CHANNELRECEIVER_HPP
+
+#include "Centaur.hpp"
+#include <QMetaObject>
+#include <QObject>
+#include <functional>
+#include <memory>
+
+BEGIN_CENTAUR_NAMESPACE
+
+/// \brief Delivers the events of a binapi channel (SPSCChannel or MPSCChannel) in the thread that creates the receiver.
+/// The channel wakes the thread with one queued call per batch, not per event: the call drains every event pushed
+/// until then and signals the end of the batch, so the consumer can refresh once what changed.
+/// \remarks Create and destroy it in the consumer thread, before the producers start and after they stop
+template <typename Channel>
+class ChannelReceiver final
+{
+public:
+    using Event = typename Channel::value_type;
+
+    /// \param channel The channel to drain. Must outlive the receiver
+    /// \param onEvent Called with every event, in order
+    /// \param onBatch Called after the events of a batch
+    ChannelReceiver(Channel &channel, std::function<void(Event &&)> onEvent, std::function<void()> onBatch = {}) :
+        m_channel { channel },
+        m_onEvent { std::move(onEvent) },
+        m_onBatch { std::move(onBatch) },
+        m_context { std::make_unique<QObject>() }
+    {
+        // The calls queued on the context are discarded when it is destroyed
+        m_channel.setWake([this, context = m_context.get()] {
+            QMetaObject::invokeMethod(context, [this] { drain(); }, Qt::QueuedConnection);
+        });
+    }
+
+    ~ChannelReceiver()
+    {
+        m_channel.setWake({});
+    }
+
+    ChannelReceiver(const ChannelReceiver &)                     = delete;
+    auto operator=(const ChannelReceiver &) -> ChannelReceiver & = delete;
+
+public:
+    /// \brief Deliver the events pushed until now
+    auto drain() -> void
+    {
+        if (m_channel.drain(m_onEvent) > 0 && m_onBatch)
+            m_onBatch();
+    }
+
+private:
+    Channel &m_channel;
+    std::function<void(Event &&)> m_onEvent;
+    std::function<void()> m_onBatch;
+    std::unique_ptr<QObject> m_context;
+};
+
+END_CENTAUR_NAMESPACE
+
+#endif // CENTAUR_CHANNELRECEIVER_HPP
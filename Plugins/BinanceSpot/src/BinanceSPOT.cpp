@@ -10,22 +10,34 @@
 CENTAUR_NAMESPACE::BinanceSpotPlugin::BinanceSpotPlugin(QObject *parent) :
     QObject(parent),
     m_spotWS { nullptr },
+    m_orderbookTimer { new QTimer(this) },
     m_statusAction { new QAction(this) }
 {
     m_sevenDayLastUpdate = QDate::currentDate();
 
     connect(m_statusAction, &QAction::triggered, this, &BinanceSpotPlugin::onStatusButtonClicked);
+
+    m_orderbookTimer->setSingleShot(true);
+    connect(m_orderbookTimer, &QTimer::timeout, this, &BinanceSpotPlugin::publishOrderbooks);
 }
 
 CENTAUR_NAMESPACE::BinanceSpotPlugin::~BinanceSpotPlugin()
 {
-    if (m_spotWSThread != nullptr && m_spotWSThread->joinable())
+    // The calls still queued are dropped: their results would be delivered to a plugin that is going away.
+    // The ones running finish before the API is destroyed
+    if (m_asyncAPI != nullptr)
+        m_asyncAPI->getExecutor().discardPending();
+    m_asyncAPI.reset();
+
+    if (m_spotWS != nullptr)
     {
         m_spotWS->terminate();
-        m_spotWSThread->join();
+        m_spotWS->wait();
     }
-    m_spotWSThread.reset();
     m_spotWS.reset();
+
+    if (m_bAPI != nullptr && !m_cacheSnapshot.empty())
+        m_bAPI->getResponseCache()->saveSnapshot(m_cacheSnapshot);
 }
 
 /*
@@ -16,6 +16,7 @@
 #include "Protocol.hpp"
 #include <QApplication>
 #include <QMessageBox>
+#include <algorithm>
 #include <rapidjson/istreamwrapper.h>
 #include <stdexcept>
 
@@ -88,6 +89,19 @@
 
 namespace
 {
+    // Levels of each side sent to the orderbook dialog
+    constexpr std::size_t g_orderbookLevels = 50;
+
+    // Threads a single candle backfill may start at most
+    constexpr long long g_maxBackfillWorkers = 16;
+
+    // How long a REST call waits for the weight before failing. Meanwhile the scheduler of the limits serves the
+    // interactive calls before the background ones
+    constexpr std::chrono::seconds g_waitForCapacity { 2 };
+
+    using BINAPI_NAMESPACE::RequestPriority;
+    using BINAPI_NAMESPACE::RequestPriorityScope;
+
     BINAPI_NAMESPACE::BinanceTimeIntervals mapIntervalFromUIToAPI(cen::plugin::TimeFrame tf)
     {
         switch (tf)
@@ -189,12 +203,36 @@ bool CENTAUR_NAMESPACE::BinanceSpotPlugin::initialization() noexcept
         return false;
     }
 
+    // Updates per second of the orderbook dialogs. Zero updates them with every diff
+    if (pluginSettings.HasMember("orderbookRefreshRate") && pluginSettings["orderbookRefreshRate"].IsUint())
+    {
+        const unsigned rate = pluginSettings["orderbookRefreshRate"].GetUint();
+        m_orderbookInterval = rate == 0 ? std::chrono::milliseconds { 0 } : std::chrono::milliseconds { 1000 / std::min(rate, 1000u) };
+    }
+
     m_bAPI = std::make_unique<BINAPI_NAMESPACE::BinanceAPISpot>(&m_keys, &m_limits);
+    // Two workers: an orderbook snapshot never waits behind another one
+    m_asyncAPI = std::make_unique<BINAPI_NAMESPACE::BinanceAPISpotAsync>(m_bAPI.get(), 2);
+
+    // Within their time to live, the cached responses make the calls unnecessary
+    m_cacheSnapshot = std::filesystem::path { configurationFileName }.replace_extension(".cache");
+    if (m_bAPI->getResponseCache()->loadSnapshot(m_cacheSnapshot))
+        logInfo("BinanceSpotPlugin", "Binance SPOT cached responses loaded");
 
     try
     {
         m_bAPI->ping();
 
+        // The latency of the streams is measured against the clock of the exchange. The shortest of a few calls is used
+        for (int sample = 0; sample < 3; ++sample)
+        {
+            C_UNUSED const auto serverTime = m_bAPI->checkServerTime();
+        }
+        m_streamMetrics.setClockOffset(m_bAPI->getClockOffset());
+        logInfo("BinanceSpotPlugin", QString("Binance SPOT clock offset: ##00FFFF#%1# ms. Round trip: %2 ms")
+                                         .arg(static_cast<double>(m_bAPI->getClockOffset()->offset().value_or(std::chrono::microseconds { 0 }).count()) / 1000.0)
+                                         .arg(static_cast<double>(m_bAPI->getClockOffset()->roundTrip().value_or(std::chrono::microseconds { 0 }).count()) / 1000.0));
+
         if (!m_bAPI->getExchangeStatus())
         {
             logError("BinanceSpotPlugin", "Binance Server is under maintenance");
@@ -209,6 +247,7 @@ bool CENTAUR_NAMESPACE::BinanceSpotPlugin::initialization() noexcept
         m_limits.setAPIRequestsLimits(m_exchInfo.limitWeight.limit, m_exchInfo.limitWeight.seconds);
         m_limits.setAPIOrderLimitLow(m_exchInfo.limitOrderSecond.limit, m_exchInfo.limitOrderSecond.seconds);
         m_limits.setAPIOrderLimitHigh(m_exchInfo.limitOrderDay.limit, m_exchInfo.limitOrderDay.seconds);
+        m_limits.setWaitForCapacity(g_waitForCapacity);
 
         logInfo("BinanceSpotPlugin", "Binance SPOT limits changed.");
 
@@ -271,12 +310,11 @@ void CENTAUR_NAMESPACE::BinanceSpotPlugin::runMarketWS(const QString &symbol) no
 {
     logTrace("BinanceSpotPlugin", "BinanceSpotPlugin::runMarketWS");
 
-    if (m_spotWSThread && m_spotWSThread->joinable())
+    if (m_spotWS)
     {
         m_spotWS->terminate();
-        m_spotWSThread->join();
+        m_spotWS->wait();
     }
-    m_spotWSThread.reset();
     m_spotWS.reset();
 
     std::promise<void> connected;
@@ -289,11 +327,11 @@ void CENTAUR_NAMESPACE::BinanceSpotPlugin::runMarketWS(const QString &symbol) no
     const std::string ep = m_spotWS->constructEndPoint(std::get<std::string>(ticker));
 
     m_spotWS->setEndPoint(ep);
+    m_spotWS->setStreamMetrics(&m_streamMetrics);
 
-    m_spotWSThread = std::make_unique<std::thread>([&] {
-        logInfo("BinanceSpotPlugin", "Spot WebSocket thread created.");
-        m_spotWS->run();
-    });
+    // The connection is serviced by the shared reactor of the library
+    m_spotWS->start();
+    logInfo("BinanceSpotPlugin", "Spot WebSocket connection started.");
 
     future.wait();
 
@@ -313,7 +351,7 @@ QPair<bool, QPixmap> CENTAUR_NAMESPACE::BinanceSpotPlugin::addSymbolToWatchlist(
 
     logInfo("BinanceSpotPlugin", QString("Attempting to add %1 to the watchlist").arg(name));
 
-    if (!m_spotWSThread || !m_spotWS) // The WS is not running
+    if (!m_spotWS) // The WS is not running
     {
         logInfo("BinanceSpotPlugin", "Adding the symbol will attempt to run a websocket.");
         // Start the thread and specify the new data
@@ -358,12 +396,11 @@ void CENTAUR_NAMESPACE::BinanceSpotPlugin::removeSymbolFromWatchlist(const QStri
         logWarn("BinanceSpotPlugin", "The Spot WebSocket thread will be stopped because the watchlist is empty.");
 
         // Stop the thread instead
-        if (m_spotWSThread != nullptr && m_spotWSThread->joinable())
+        if (m_spotWS != nullptr)
         {
             m_spotWS->terminate();
-            m_spotWSThread->join();
+            m_spotWS->wait();
         }
-        m_spotWSThread.reset();
         m_spotWS.reset();
         logWarn("BinanceSpotPlugin", "The Spot WebSocket thread stopped.");
     }
@@ -428,7 +465,13 @@ void CENTAUR_NAMESPACE::BinanceSpotPlugin::updateOrderbook(const QString &symbol
         logInfo("BinanceSpotPlugin", QString("Orderbook subscription event id for %1 is %2").arg(symbol).arg(id));
     }
 
-    m_symbolOrderbookSnapshot[symbol] = { false, 0 };
+    // Synchronized with a snapshot when the first diff arrives. A snapshot requested for the previous book is discarded
+    m_orderbooks.erase(symbol);
+    m_snapshots.erase(symbol.toStdString());
+    auto &feed = m_orderbooks.try_emplace(symbol).first->second;
+    feed.conflator.subscribe(g_orderbookLevels, m_orderbookInterval, [this, symbol](const BINAPI_NAMESPACE::Snapshot<BINAPI_NAMESPACE::BookTop> &top) {
+        emitOrderbook(symbol, top);
+    });
 }
 
 void CENTAUR_NAMESPACE::BinanceSpotPlugin::stopOrderbook(const QString &symbol) noexcept
@@ -447,80 +490,202 @@ void CENTAUR_NAMESPACE::BinanceSpotPlugin::stopOrderbook(const QString &symbol)
     logInfo("BinanceSpotPlugin", QString("Orderbook unsubscribe event id for %1 is %2").arg(symbol).arg(id));
     m_wsIds[id] = symbol;
 
-    m_symbolOrderbookSnapshot.erase(symbol);
+    m_orderbooks.erase(symbol);
+    m_snapshots.erase(symbol.toStdString());
+    logDepthLatency(symbol);
 }
 
-void CENTAUR_NAMESPACE::BinanceSpotPlugin::onDepthUpdate(const QString &symbol, quint64 eventTime, const BINAPI_NAMESPACE::StreamDepthUpdate &sdp) noexcept
+void CENTAUR_NAMESPACE::BinanceSpotPlugin::requestOrderbookSnapshot(const QString &symbol) noexcept
 {
-    /*
-    Open a stream to wss://stream.binance.com:9443/ws/bnbbtc@@depth.
-    Buffer the events you receive from the stream.
-    Get a depth snapshot from https://api.binance.com/api/v3/depth?symbol=BNBBTC&limit=1000 .
-    Drop any event where u is <= lastUpdateId in the snapshot.
-    The first processed event should have U <= lastUpdateId+1 AND u >= lastUpdateId+1.
-    While listening to the stream, each new event's U should be equal to the previous event's u+1.
-    The data in each event is the absolute quantity for a price level.
-    If the quantity is 0, remove the price level.
-    Receiving an event that removes a price level that is not in your local order book can happen and is normal.
-    */
+    // Nothing while one is in flight or the wait after a failed one did not elapse: the retry is scheduled by the failure
+    const auto next = m_snapshots.request(symbol.toStdString());
+    if (!next.has_value())
+        return;
+    const uint64_t request = *next;
+
+    // The REST call runs in a worker: the other symbols keep being updated meanwhile.
+    // The result is handled in the plugin thread; the calls queued on the plugin are discarded if it is destroyed first
+    m_asyncAPI->submit(
+        [symbol = symbol.toStdString()](BINAPI_NAMESPACE::BinanceAPISpot &api) {
+            // The book is shown to the user as soon as the snapshot arrives
+            const RequestPriorityScope priority { RequestPriority::interactive };
+            return api.getOrderBook(symbol, 1000);
+        },
+        [this, symbol, request](BINAPI_NAMESPACE::SPOT::OrderBook snapshot) {
+            QMetaObject::invokeMethod(
+                this, [this, symbol, request, snapshot = std::move(snapshot)] { onOrderbookSnapshot(symbol, request, snapshot); }, Qt::QueuedConnection);
+        },
+        [this, symbol, request](std::exception_ptr error) {
+            QMetaObject::invokeMethod(
+                this, [this, symbol, request, error] { onOrderbookSnapshotError(symbol, request, error); }, Qt::QueuedConnection);
+        });
+}
 
-    const auto &[snap, lastUpdate] = m_symbolOrderbookSnapshot[symbol];
-    uint64_t lastUpdateId          = lastUpdate;
-    if (!snap)
+void CENTAUR_NAMESPACE::BinanceSpotPlugin::onOrderbookSnapshot(const QString &symbol, uint64_t request, const BINAPI_NAMESPACE::SPOT::OrderBook &snapshot) noexcept
+{
+    if (!m_snapshots.completed(symbol.toStdString(), request))
+        return;
+
+    auto orderbook = m_orderbooks.find(symbol);
+    if (orderbook == m_orderbooks.end())
+        return;
+
+    // The dialog is refreshed with the next diff
+    if (orderbook->second.book.snapshot(snapshot))
     {
-        // Take the snapshot
+        logInfo("BinanceSpotPlugin", QString("Orderbook snapshot successfully taken for %1").arg(symbol));
+        return;
+    }
 
-        BINAPI_NAMESPACE::BinanceAPISpot api(nullptr, nullptr);
+    // Updates were lost after the snapshot was taken: the book keeps the newer diffs for the next one
+    logWarn("BinanceSpotPlugin", QString("Orderbook snapshot of %1 is older than the buffered updates. Requesting a new one").arg(symbol));
+    requestOrderbookSnapshot(symbol);
+}
 
-        try
-        {
-            auto orderbook                    = m_bAPI->getOrderBook(symbol.toStdString(), 1000);
-            m_symbolOrderbookSnapshot[symbol] = { true, lastUpdateId };
-            lastUpdateId                      = orderbook.lastUpdateId;
-            logInfo("BinanceSpotPlugin", QString("Orderbook snapshot successfully taken for %1").arg(symbol));
-        } catch (const BINAPI_NAMESPACE::APIException &ex)
-        {
-            CATCH_API_EXCEPTION()
-            return;
-        }
+void CENTAUR_NAMESPACE::BinanceSpotPlugin::onOrderbookSnapshotError(const QString &symbol, uint64_t request, const std::exception_ptr &error) noexcept
+{
+    // On 429 and 418 the limits keep the Retry-After of the response
+    const auto now = std::chrono::steady_clock::now();
+    if (!m_snapshots.failed(symbol.toStdString(), request, now, m_limits.getRetryAfter()))
+        return;
+
+    try
+    {
+        std::rethrow_exception(error);
+    } catch (const BINAPI_NAMESPACE::APIException &ex)
+    {
+        CATCH_API_EXCEPTION()
+    } catch (const std::exception &ex)
+    {
+        logError("BinanceSpotPlugin", QString("Orderbook snapshot of %1 failed: %2").arg(symbol, ex.what()));
     }
 
-    if (sdp.finalUpdateId <= lastUpdateId)
+    // The diffs are still buffered meanwhile. The retry is not left to them: the stream of a quiet symbol may not send any
+    const auto retryAt = m_snapshots.retryAt(symbol.toStdString());
+    if (!retryAt.has_value())
+        return;
+
+    const auto delay = std::chrono::ceil<std::chrono::milliseconds>(*retryAt - now);
+    logWarn("BinanceSpotPlugin", QString("Orderbook snapshot of %1 will be requested again in %2 ms").arg(symbol).arg(delay.count()));
+    QTimer::singleShot(delay, Qt::PreciseTimer, this, [this, symbol] {
+        // The book may have been stopped, or reopened and synchronized, meanwhile
+        const auto orderbook = m_orderbooks.find(symbol);
+        if (orderbook != m_orderbooks.end() && !orderbook->second.book.synchronized())
+            requestOrderbookSnapshot(symbol);
+    });
+}
+
+void CENTAUR_NAMESPACE::BinanceSpotPlugin::onDepthEvent(SpotDepthEvent &&event) noexcept
+{
+    const QString symbol = QString::fromStdString(event.symbol);
+
+    if (event.update == nullptr)
     {
-        logWarn("BinanceSpotPlugin", QString("Orderbook event ignored for %1").arg(symbol));
+        onDepthGap(symbol);
         return;
     }
 
-    QMap<qreal, QPair<qreal, qreal>> bids, asks;
+    // Events of a symbol no longer watched may still be in the channel
+    auto orderbook = m_orderbooks.find(symbol);
+    if (orderbook == m_orderbooks.end())
+        return;
 
-    for (const auto &[price, quantity] : sdp.bids)
-    {
-        if (quantity > 0.0)
-        {
-            const double total = price * quantity;
+    event.timings.dispatched = std::chrono::steady_clock::now();
+    m_streamMetrics.recordDispatched(event.symbol + "@depthUpdate", event.timings);
 
-            bids[price] = { quantity, total };
-        }
+    auto &feed = orderbook->second;
+    switch (feed.book.update(event.update))
+    {
+        case BINAPI_NAMESPACE::OrderBookStatus::applied:
+            break;
+        case BINAPI_NAMESPACE::OrderBookStatus::stale:
+            return;
+        case BINAPI_NAMESPACE::OrderBookStatus::outOfSync:
+            logWarn("BinanceSpotPlugin", QString("Orderbook updates lost for %1. Taking a new snapshot").arg(symbol));
+            C_FALLTHROUGH;
+        case BINAPI_NAMESPACE::OrderBookStatus::buffered:
+            // Nothing to display until the snapshot arrives
+            requestOrderbookSnapshot(symbol);
+            return;
     }
 
-    for (const auto &[price, quantity] : sdp.asks)
-    {
-        if (quantity > 0.0)
-        {
-            const double total = price * quantity;
+    // The dialog gets the latest book when its interval elapses, see publishOrderbooks
+    feed.timings = event.timings;
+    feed.conflator.changed(event.eventTime);
+}
 
-            asks[price] = { quantity, total };
-        }
+void CENTAUR_NAMESPACE::BinanceSpotPlugin::onDepthBatch() noexcept
+{
+    publishOrderbooks();
+}
+
+void CENTAUR_NAMESPACE::BinanceSpotPlugin::publishOrderbooks() noexcept
+{
+    // However fast the diffs arrive, the dialog of each book is refreshed at most once per interval
+    const auto now = std::chrono::steady_clock::now();
+    std::optional<std::chrono::steady_clock::time_point> next;
+    for (auto &[symbol, feed] : m_orderbooks)
+    {
+        if (const auto due = feed.conflator.poll(now); due.has_value())
+            next = next.has_value() ? std::min(*next, *due) : *due;
     }
 
-    emit snOrderbookUpdate(getUUIDString(), symbol, eventTime, bids, asks);
+    if (next.has_value())
+        m_orderbookTimer->start(std::chrono::ceil<std::chrono::milliseconds>(*next - now));
+}
+
+void CENTAUR_NAMESPACE::BinanceSpotPlugin::emitOrderbook(const QString &symbol, const BINAPI_NAMESPACE::Snapshot<BINAPI_NAMESPACE::BookTop> &top) noexcept
+{
+    QMap<qreal, QPair<qreal, qreal>> bids, asks;
+
+    for (const auto &[price, quantity] : top->bids)
+        bids[price] = { quantity, price * quantity };
+
+    for (const auto &[price, quantity] : top->asks)
+        asks[price] = { quantity, price * quantity };
 
-    m_symbolOrderbookSnapshot[symbol] = { true, sdp.finalUpdateId };
+    // The dialog is connected directly: it is updated when emit returns
+    emit snOrderbookUpdate(getUUIDString(), symbol, top->eventTime, bids, asks);
+
+    const auto feed = m_orderbooks.find(symbol);
+    if (feed != m_orderbooks.end())
+        m_streamMetrics.recordRendered(symbol.toStdString() + "@depthUpdate", feed->second.timings, std::chrono::steady_clock::now());
+}
+
+void CENTAUR_NAMESPACE::BinanceSpotPlugin::logDepthLatency(const QString &symbol) noexcept
+{
+    const auto metrics = m_streamMetrics.snapshot(symbol.toStdString() + "@depthUpdate");
+    if (!metrics.has_value() || metrics->events == 0)
+        return;
+
+    const auto stage = [&metrics](BINAPI_NAMESPACE::StreamStage stage) {
+        const auto &latency = metrics->stage(stage);
+        return QString("%1/%2").arg(static_cast<double>(latency.percentile(0.5).count()) / 1000.0).arg(static_cast<double>(latency.percentile(0.99).count()) / 1000.0);
+    };
+
+    logInfo("BinanceSpotPlugin", QString("Orderbook latency of %1 in %2 events, p50/p99 ms. Network: %3. Parse: %4. Dispatch: %5. Render: %6. Total: %7")
+                                     .arg(symbol)
+                                     .arg(metrics->events)
+                                     .arg(stage(BINAPI_NAMESPACE::StreamStage::network), stage(BINAPI_NAMESPACE::StreamStage::parse), stage(BINAPI_NAMESPACE::StreamStage::dispatch),
+                                         stage(BINAPI_NAMESPACE::StreamStage::render), stage(BINAPI_NAMESPACE::StreamStage::total)));
+}
+
+void CENTAUR_NAMESPACE::BinanceSpotPlugin::onDepthGap(const QString &symbol) noexcept
+{
+    auto orderbook = m_orderbooks.find(symbol);
+    if (orderbook == m_orderbooks.end())
+        return;
+
+    // Updates were lost: the book buffers the diffs until a new snapshot arrives
+    logWarn("BinanceSpotPlugin", QString("Orderbook updates lost for %1. Taking a new snapshot").arg(symbol));
+    orderbook->second.book.reset();
+    requestOrderbookSnapshot(symbol);
 }
 
 void CENTAUR_NAMESPACE::BinanceSpotPlugin::onSpotStatus() noexcept
 {
     logTrace("BinanceSpotPlugin", "BinanceSpotPlugin::onSpotStatus");
+    const RequestPriorityScope priority { RequestPriority::interactive };
     QString message;
     try
     {
@@ -539,6 +704,7 @@ void CENTAUR_NAMESPACE::BinanceSpotPlugin::onSpotStatus() noexcept
 void CENTAUR_NAMESPACE::BinanceSpotPlugin::onCoinInformation() noexcept
 {
     logTrace("BinanceSpotPlugin", "BinanceSpotPlugin::onCoinInformation");
+    const RequestPriorityScope priority { RequestPriority::interactive };
     QApplication::setOverrideCursor(QCursor(Qt::BusyCursor));
     if (m_coinInformation.empty())
     {
@@ -638,6 +804,7 @@ QList<QAction *> CENTAUR_NAMESPACE::BinanceSpotPlugin::dynamicWatchListMenuItems
 void CENTAUR_NAMESPACE::BinanceSpotPlugin::onDisplayBaseAssetInfo(const QString &asset) noexcept
 {
     logTrace("BinanceSpotPlugin", "BinanceSpotPlugin::onDisplayBaseAssetInfo");
+    const RequestPriorityScope priority { RequestPriority::interactive };
     QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
     if (m_coinInformation.empty())
     {
@@ -662,6 +829,7 @@ void CENTAUR_NAMESPACE::BinanceSpotPlugin::onDisplayBaseAssetInfo(const QString
 void CENTAUR_NAMESPACE::BinanceSpotPlugin::onDisplayCoinAssetDepositAddress(const QString &asset) noexcept
 {
     logTrace("BinanceSpotPlugin", "BinanceSpotPlugin::onDisplayCoinAssetDepositAddress");
+    const RequestPriorityScope priority { RequestPriority::interactive };
     QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
     if (m_coinInformation.empty())
     {
@@ -683,6 +851,7 @@ void CENTAUR_NAMESPACE::BinanceSpotPlugin::onDisplayCoinAssetDepositAddress(cons
 void CENTAUR_NAMESPACE::BinanceSpotPlugin::onDisplayAssetDetail(const QString &asset) noexcept
 {
     logTrace("BinanceSpotPlugin", "BinanceSpotPlugin::onDisplayAssetDetail");
+    const RequestPriorityScope priority { RequestPriority::interactive };
 
     try
     {
@@ -699,6 +868,7 @@ void CENTAUR_NAMESPACE::BinanceSpotPlugin::onDisplayAssetDetail(const QString &a
 void CENTAUR_NAMESPACE::BinanceSpotPlugin::onShowFees(const QString &symbol) noexcept
 {
     logTrace("BinanceSpotPlugin", "BinanceSpotPlugin::onShowFees");
+    const RequestPriorityScope priority { RequestPriority::interactive };
     QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
     if (m_fees.empty())
     {
@@ -760,6 +930,8 @@ QList<std::pair<quint64, qreal>> cen::BinanceSpotPlugin::get7dayData(const QStri
     const auto todayMS = binapi::BinanceAPI::getTime();
     const auto today   = (todayMS - (todayMS % dayMS));
 
+    // Fills the cache of the day in the background
+    const RequestPriorityScope priority { RequestPriority::background };
     auto data = m_bAPI->candlestickData(symbol.toStdString(),
         binapi::BinanceTimeIntervals::i1d,
         today - dayMS * 7,
@@ -805,19 +977,30 @@ QList<QPair<CENTAUR_PLUGIN_NAMESPACE::IExchange::Timestamp, CENTAUR_PLUGIN_NAMES
 {
     const auto interval = mapIntervalFromUIToAPI(frame);
 
-    uint64_t total;
-    auto data = BINAPI_NAMESPACE::BinanceAPI::getCandlesTimesAndLimits(interval, static_cast<uint64_t>(start), static_cast<uint64_t>(end), total);
+    // The backfill shares the limits of the plugin: its chunks are background calls, so they leave the weight to the
+    // snapshots and the calls of the user
+    BINAPI_NAMESPACE::BinanceAPISpot spot { nullptr, &m_limits };
 
-    BINAPI_NAMESPACE::BinanceLimits limits;
-    BINAPI_NAMESPACE::BinanceAPISpot spot { nullptr, &limits };
+    // One worker per 1000-candle chunk, so the whole backfill takes about the time of the slowest chunk.
+    // Each chunk weighs one; the workers never exceed the weight the limits have left, since the extra ones would only wait.
+    // Past g_maxBackfillWorkers the chunks run in waves
+    uint64_t totalExpected = 0;
+    const auto chunks      = BINAPI_NAMESPACE::BinanceAPI::getCandlesTimesAndLimits(interval, static_cast<uint64_t>(start), static_cast<uint64_t>(end), totalExpected);
+    const auto requests    = static_cast<long long>(std::count_if(chunks.begin(), chunks.end(), [](const auto &chunk) { return std::get<2>(chunk) > 0; }));
+    const auto available   = m_limits.getMaxAPIRequestWeight() - m_limits.getAPIRequests();
+    const auto workers     = std::clamp(std::min(requests, available), 1LL, g_maxBackfillWorkers);
+
+    BINAPI_NAMESPACE::BinanceAPISpotAsync asyncSpot { &spot, static_cast<std::size_t>(workers) };
 
     try
     {
+        const auto sym = symbol.toStdString();
+        auto chunks    = asyncSpot.candlesByPeriod(sym, interval, static_cast<uint64_t>(start), static_cast<uint64_t>(end));
+
         QList<QPair<Timestamp, cen::plugin::CandleData>> cd;
-        for (const auto &i : data)
+        for (auto &chunk : chunks)
         {
-            auto sym     = symbol.toStdString();
-            auto candles = spot.candlestickData(sym.c_str(), interval, std::get<0>(i), std::get<1>(i), std::get<2>(i));
+            const auto candles = chunk.get();
 
             for (const auto &candle : candles)
             {
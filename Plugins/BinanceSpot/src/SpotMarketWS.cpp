@@ -11,15 +11,22 @@ CENTAUR_NAMESPACE::SpotMarketWS::SpotMarketWS(std::promise<void> connected) :
     m_connected { std::move(connected) }
 
 {
-    qRegisterMetaType<binapi::StreamDepthUpdate>("binapi::StreamDepthUpdate");
+    setReconnection(true);
 }
 
+// The owner terminates and waits for the connection first: no event is pushed while the receiver is destroyed
 CENTAUR_NAMESPACE::SpotMarketWS::~SpotMarketWS() = default;
 
 void CENTAUR_NAMESPACE::SpotMarketWS::initialize(BinanceSpotPlugin *obj, CENTAUR_INTERFACE_NAMESPACE::ILogger *logger)
 {
     m_obj    = obj;
     m_logger = logger;
+
+    // Order book updates reach the plugin thread in batches: one queued call drains all the updates received until then
+    m_depthReceiver = std::make_unique<ChannelReceiver<BINAPI_NAMESPACE::MPSCChannel<SpotDepthEvent>>>(
+        m_depthChannel,
+        [obj](SpotDepthEvent &&event) { obj->onDepthEvent(std::move(event)); },
+        [obj] { obj->onDepthBatch(); });
 }
 
 void CENTAUR_NAMESPACE::SpotMarketWS::connected()
@@ -31,7 +38,7 @@ void CENTAUR_NAMESPACE::SpotMarketWS::connected()
         m_logger->info("SpotMarketWS", "Binance Spot WebSocket is connected");
     }
 
-    m_connected.set_value();
+    std::call_once(m_connectedOnce, [this] { m_connected.set_value(); });
 }
 
 void CENTAUR_NAMESPACE::SpotMarketWS::close()
@@ -44,7 +51,13 @@ void CENTAUR_NAMESPACE::SpotMarketWS::connectionError()
     if (m_logger)
         m_logger->error("spotWS", "Binance Spot WebSocket failed to connect");
 
-    m_connected.set_value();
+    std::call_once(m_connectedOnce, [this] { m_connected.set_value(); });
+}
+
+void CENTAUR_NAMESPACE::SpotMarketWS::reconnecting(uint32_t attempt, std::chrono::milliseconds delay) noexcept
+{
+    if (m_logger)
+        m_logger->warning("SpotMarketWS", QString("Binance Spot WebSocket lost. Reconnecting in %1 ms (attempt %2)").arg(delay.count()).arg(attempt));
 }
 
 void CENTAUR_NAMESPACE::SpotMarketWS::subscribe(bool status, int id)
@@ -81,15 +94,35 @@ void CENTAUR_NAMESPACE::SpotMarketWS::individualSymbolMiniTicker(const std::stri
         Q_ARG(double, static_cast<double>(ticker.closePrice)));
 }
 
-void CENTAUR_NAMESPACE::SpotMarketWS::depthUpdate(const std::string &symbol, uint64_t eventTime, const BINAPI_NAMESPACE::StreamDepthUpdate &sdp)
+void CENTAUR_NAMESPACE::SpotMarketWS::sharedDepthUpdate(const std::string &symbol, uint64_t eventTime, BINAPI_NAMESPACE::Snapshot<BINAPI_NAMESPACE::StreamDepthUpdate> sdp)
 {
     // m_logger->trace("SpotMarketWS", " SpotMarketWS::depthUpdate");
 
-    QMetaObject::invokeMethod(m_obj->getPluginObject(), "onDepthUpdate",
-        Qt::QueuedConnection,
-        Q_ARG(QString, QString(symbol.c_str())),
-        Q_ARG(quint64, static_cast<quint64>(eventTime)),
-        Q_ARG(binapi::StreamDepthUpdate, sdp));
+    pushDepthEvent(symbol, eventTime, std::move(sdp));
+}
+
+void CENTAUR_NAMESPACE::SpotMarketWS::sequenceGap(const std::string &symbol, BINAPI_NAMESPACE::ws::SequencedStream stream, C_UNUSED const BINAPI_NAMESPACE::ws::SequenceGap &gap)
+{
+    if (stream != BINAPI_NAMESPACE::ws::SequencedStream::depthUpdate)
+        return;
+
+    // Pushed before the update that follows the gap, so the order book is synchronized again with it
+    pushDepthEvent(symbol, 0, nullptr);
+}
+
+void CENTAUR_NAMESPACE::SpotMarketWS::pushDepthEvent(const std::string &symbol, uint64_t eventTime, BINAPI_NAMESPACE::Snapshot<BINAPI_NAMESPACE::StreamDepthUpdate> sdp)
+{
+    if (m_depthLost.contains(symbol))
+    {
+        // The plugin is told about the dropped updates before it receives the next one
+        if (!m_depthChannel.push({ symbol, 0, nullptr, {} }))
+            return;
+        m_depthLost.erase(symbol);
+    }
+
+    // The channel is full when the plugin thread falls behind: the update is lost and the order book must be taken again
+    if (!m_depthChannel.push({ symbol, eventTime, std::move(sdp), getTimings() }))
+        m_depthLost.insert(symbol);
 }
 
 void cen::SpotMarketWS::pingSent(bool success) noexcept
@@ -0,0 +1,93 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+// Created by Ricardo Romero on 17/10/26.
+// Copyright (c) 2026 Ricardo Romero.  All rights reserved.
+//
+
+#pragma once
+
+#ifndef CENTAUR_HEXENCODER_HPP
+#define CENTAUR_HEXENCODER_HPP
+
+#include "Centaur.hpp"
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CENTAUR_HEX_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define CENTAUR_HEX_NEON 1
+#endif
+
+namespace CENTAUR_NAMESPACE
+{
+    /// \brief Lowercase hexadecimal characters of the bytes, one at a time
+    ///
+    /// \param data Bytes to encode
+    /// \param size Number of bytes
+    /// \param out At least 2 * size chars. No null character is written
+    inline void hexEncodeScalar(const uint8_t *data, std::size_t size, char *out) noexcept
+    {
+        constexpr char digits[] = "0123456789abcdef";
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            out[2 * i]     = digits[data[i] >> 4];
+            out[2 * i + 1] = digits[data[i] & 0x0f];
+        }
+    }
+
+    /// \brief Lowercase hexadecimal characters of the bytes. 16 bytes are encoded at a time with SSE2 or NEON
+    /// and the remainder with hexEncodeScalar
+    ///
+    /// \param data Bytes to encode
+    /// \param size Number of bytes
+    /// \param out At least 2 * size chars. No null character is written
+    inline void hexEncode(const uint8_t *data, std::size_t size, char *out) noexcept
+    {
+        std::size_t i = 0;
+
+#if defined(CENTAUR_HEX_SSE2)
+        const __m128i mask    = _mm_set1_epi8(0x0f);
+        const __m128i nine    = _mm_set1_epi8(9);
+        const __m128i zero    = _mm_set1_epi8('0');
+        const __m128i letters = _mm_set1_epi8('a' - '0' - 10);
+
+        // Nibbles to characters: '0' + n, plus the gap to 'a' where n > 9
+        const auto digits = [&](__m128i nibbles) noexcept {
+            const __m128i isLetter = _mm_cmpgt_epi8(nibbles, nine);
+            return _mm_add_epi8(_mm_add_epi8(nibbles, zero), _mm_and_si128(isLetter, letters));
+        };
+
+        for (; i + 16 <= size; i += 16)
+        {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+            const __m128i high  = digits(_mm_and_si128(_mm_srli_epi16(bytes, 4), mask));
+            const __m128i low   = digits(_mm_and_si128(bytes, mask));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 2 * i), _mm_unpacklo_epi8(high, low));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 2 * i + 16), _mm_unpackhi_epi8(high, low));
+        }
+#elif defined(CENTAUR_HEX_NEON)
+        constexpr uint8_t table[16] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f' };
+        const uint8x16_t digits     = vld1q_u8(table);
+        const uint8x16_t mask       = vdupq_n_u8(0x0f);
+
+        for (; i + 16 <= size; i += 16)
+        {
+            const uint8x16_t bytes = vld1q_u8(data + i);
+
+            uint8x16x2_t characters;
+            characters.val[0] = vqtbl1q_u8(digits, vshrq_n_u8(bytes, 4));
+            characters.val[1] = vqtbl1q_u8(digits, vandq_u8(bytes, mask));
+            // Interleaves the high and low characters
+            vst2q_u8(reinterpret_cast<uint8_t *>(out + 2 * i), characters);
+        }
+#endif
+
+        hexEncodeScalar(data + i, size - i, out + 2 * i);
+    }
+} // namespace CENTAUR_NAMESPACE
+
+#endif // CENTAUR_HEXENCODER_HPP
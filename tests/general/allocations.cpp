@@ -0,0 +1,192 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+// Created by Ricardo Romero on 17/10/26.
+// Copyright (c) 2026 Ricardo Romero.  All rights reserved.
+//
+// Heap allocations of the BinanceAPI parsing paths.
+// This file is its own executable: malloc is replaced for the whole process, so no other test runs with it.
+// CMake only builds it with glibc and without sanitizers
+
+#include "binance_api_data.hpp"
+
+#include <BinanceAPI.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <rapidjson/memorystream.h>
+
+#include <cstdint>
+#include <string>
+
+#if !defined(__GLIBC__)
+#error "The allocation count tests require glibc"
+#endif /*!defined(__GLIBC__)*/
+
+namespace
+{
+    thread_local bool g_countAllocations { false };
+    thread_local uint64_t g_allocations { 0 };
+} // namespace
+
+// glibc lets the executable replace malloc and reach the real one through __libc_*, so the allocations made inside
+// rapidjson and the library are counted too. Only the calling thread is counted and only inside countAllocations
+extern "C"
+{
+    void *__libc_malloc(std::size_t size);
+    void *__libc_calloc(std::size_t count, std::size_t size);
+    void *__libc_realloc(void *ptr, std::size_t size);
+
+    void *malloc(std::size_t size) noexcept
+    {
+        g_allocations += g_countAllocations;
+        return __libc_malloc(size);
+    }
+
+    void *calloc(std::size_t count, std::size_t size) noexcept
+    {
+        g_allocations += g_countAllocations;
+        return __libc_calloc(count, size);
+    }
+
+    void *realloc(void *ptr, std::size_t size) noexcept
+    {
+        g_allocations += g_countAllocations;
+        return __libc_realloc(ptr, size);
+    }
+}
+
+namespace
+{
+    template <typename Function>
+    auto countAllocations(Function &&function) -> uint64_t
+    {
+        g_allocations      = 0;
+        g_countAllocations = true;
+        function();
+        g_countAllocations = false;
+        return g_allocations;
+    }
+} // namespace
+
+TEST_CASE("BinanceAPI: Arena documents allocation count")
+{
+    SECTION("candlestickData with 1000 candles")
+    {
+        const std::string json = makeKlines(1000);
+
+        const auto typed = [&json]() {
+            std::string error;
+            binapi::local::CandlestickHandler handler(1000);
+            binapi::local::parseTyped(json, handler, nullptr, error);
+            return handler.take();
+        };
+
+        // The reader as it was before the arena: its stack grows from the heap on every call
+        const uint64_t heapReader = countAllocations([&json]() {
+            binapi::local::CandlestickHandler handler(1000);
+            rapidjson::MemoryStream stream(json.data(), json.size());
+            rapidjson::Reader reader;
+            reader.Parse(stream, handler);
+            CHECK(handler.take().size() == 1000);
+        });
+
+        // Warm the arena of the thread
+        (void)typed();
+        (void)typed();
+        const uint64_t arenaReader = countAllocations([&typed]() { CHECK(typed().size() == 1000); });
+
+        INFO("candlestickData(1000) allocations: " << heapReader << " before, " << arenaReader << " with the arena");
+        // Only the vector of the candles. The reader stack is in the arena
+        CHECK(arenaReader <= 1);
+        CHECK(arenaReader < heapReader);
+    }
+
+    SECTION("tickerPriceChangeStatistics24hr with all the symbols")
+    {
+        const std::string json = makeTicker24hr(2000);
+        std::string body;
+
+        TickerMap heapTickers;
+        uint64_t heapParse       = 0;
+        const uint64_t heapTotal = countAllocations([&]() {
+            heapParse = g_allocations;
+            rapidjson::Document document;
+            document.Parse(json.c_str());
+            heapParse = g_allocations - heapParse;
+            readTicker24hr(document, heapTickers);
+        });
+
+        // Warm the arena of the thread. The buffer grows on the use after the response that outgrew it
+        for (int i = 0; i < 2; ++i)
+        {
+            body = json;
+            (void)binapi::local::ResponseDocument(std::move(body));
+        }
+
+        body = json;
+        TickerMap arenaTickers;
+        uint64_t arenaParse       = 0;
+        const uint64_t arenaTotal = countAllocations([&]() {
+            arenaParse = g_allocations;
+            binapi::local::ResponseDocument document(std::move(body));
+            arenaParse = g_allocations - arenaParse;
+            arenaTickers.reserve(document.Size());
+            readTicker24hr(document.root(), arenaTickers);
+        });
+
+        CHECK(arenaTickers.size() == heapTickers.size());
+        CHECK(arenaTickers.at("SYM1999").lastPrice == heapTickers.at("SYM1999").lastPrice);
+
+        INFO("tickerPriceChangeStatistics24hr(2000 symbols) allocations: parse " << heapParse << " -> " << arenaParse << ", total " << heapTotal << " -> " << arenaTotal);
+        // Only the parser stack is taken from the heap
+        CHECK(arenaParse <= 1);
+        // The DOM of 2000 tickers does not fit in one 64 KiB chunk of the default allocator
+        CHECK(heapParse >= 10);
+        // One node per symbol and the buckets of the map
+        CHECK(arenaTotal <= arenaTickers.size() + 2);
+        CHECK(arenaTotal < heapTotal);
+    }
+}
+
+TEST_CASE("BinanceAPI: Depth levels allocation count")
+{
+    rapidjson::Document depth;
+    depth.Parse(g_recordedDepthUpdate.data(), g_recordedDepthUpdate.size());
+    REQUIRE_FALSE(depth.HasParseError());
+
+    const uint64_t allocations = countAllocations([&depth]() {
+        const auto levels = binapi::jsonToPriceLevels(depth["b"]);
+        CHECK(levels.size() == 9);
+    });
+    // One block for all the levels, instead of a node per level
+    CHECK(allocations == 1);
+}
+
+TEST_CASE("BinanceAPI: WebSocket messages parsed in situ allocation count")
+{
+    // A message as big as !ticker@arr, received in pieces into a buffer that is reused, as WSThread does
+    const std::string json = makeTicker24hr(2000);
+    std::string buffer;
+    buffer.reserve(json.size());
+
+    const auto receive = [&json, &buffer]() {
+        buffer.clear();
+        for (std::size_t offset = 0; offset < json.size(); offset += 4096)
+            buffer.append(json, offset, 4096);
+    };
+
+    // Warm the arena of the thread. The buffer grows on the use after the message that outgrew it
+    for (int i = 0; i < 3; ++i)
+    {
+        receive();
+        (void)binapi::local::ResponseDocument(buffer.data(), buffer.size());
+    }
+
+    receive();
+    const uint64_t allocations = countAllocations([&buffer]() {
+        binapi::local::ResponseDocument document(buffer.data(), buffer.size());
+        CHECK(document.Size() == 2000);
+    });
+
+    INFO("!ticker@arr(2000 symbols) allocations: " << allocations);
+    // Only the parser stack is taken from the heap
+    CHECK(allocations <= 1);
+}
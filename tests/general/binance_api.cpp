@@ -0,0 +1,3118 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+// Created by Ricardo Romero on 17/10/26.
+// Copyright (c) 2026 Ricardo Romero.  All rights reserved.
+//
+
+#include "binance_api_data.hpp"
+#include "mock_https_server.hpp"
+#include "mock_ws_server.hpp"
+
+#include <BinanceAPI.hpp>
+#include <HexEncoder.hpp>
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <openssl/hmac.h>
+#include <rapidjson/memorystream.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace
+{
+    auto makeSchema(const char *json) -> std::unique_ptr<rapidjson::SchemaDocument>
+    {
+        rapidjson::Document document;
+        document.Parse(json);
+        return std::make_unique<rapidjson::SchemaDocument>(document);
+    }
+
+    auto makeRequest(std::string_view endPoint) -> binapi::local::BinanceAPIRequest
+    {
+        return binapi::local::BinanceAPIRequest {
+            .callWeight  = 1,
+            .endPoint    = endPoint,
+            .http        = binapi::local::HTTPRequest::GET,
+            .isOrderCall = false,
+            .docSchema   = makeSchema(R"({"type":"object"})"),
+            .errorSchema = makeSchema(R"({"type":"object","required":["code","msg"]})"),
+            .isSAPI      = false
+        };
+    }
+
+    /// Exposes the protected request machinery against an arbitrary base URL
+    class MockBinanceAPI : public binapi::BinanceAPI
+    {
+    public:
+        MockBinanceAPI(std::string_view url, binapi::BinanceLimits *limits) :
+            BinanceAPI(url, "centaur-tests", nullptr, limits)
+        {
+            getConnectionPool()->setVerifySsl(false);
+        }
+
+        auto call(const binapi::local::BinanceAPIRequest &req, const binapi::eparams &params = {}) -> binapi::local::ResponseDocument
+        {
+            return request(req, params);
+        }
+
+        auto callTyped(const binapi::local::BinanceAPIRequest &req, binapi::local::TypedHandler &handler, const binapi::eparams &params = {}) -> void
+        {
+            request(req, params, handler);
+        }
+    };
+
+    auto unlimited() -> binapi::BinanceLimits &
+    {
+        static binapi::BinanceLimits limits;
+        limits.setAPIRequestsLimits(std::numeric_limits<long long>::max() / 2, 60);
+        return limits;
+    }
+} // namespace
+
+TEST_CASE("BinanceAPI: Connection pool reuses keep-alive sessions")
+{
+    tests::MockHTTPSServer server;
+    const std::string url = server.url();
+    const auto req        = makeRequest("/api/v3/ping");
+
+    MockBinanceAPI api(url, &unlimited());
+    for (int i = 0; i < 10; ++i)
+        CHECK_NOTHROW(api.call(req));
+
+    const auto stats = api.getConnectionPool()->getStatistics();
+    CHECK(stats.checkouts == 10);
+    CHECK(stats.created == 1);
+    CHECK(stats.reused == 9);
+    CHECK(stats.transfers == 10);
+    CHECK(stats.handshakes == 1);
+    CHECK(server.connections() == 1);
+}
+
+TEST_CASE("BinanceAPI: Connection pool concurrent checkout")
+{
+    tests::MockHTTPSServer server;
+    const std::string url = server.url();
+    const auto req        = makeRequest("/api/v3/ping");
+
+    MockBinanceAPI api(url, &unlimited());
+    api.getConnectionPool()->setMaxSessions(2);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([&] {
+            for (int i = 0; i < 5; ++i)
+                api.call(req);
+        });
+    for (auto &th : threads)
+        th.join();
+
+    const auto stats = api.getConnectionPool()->getStatistics();
+    CHECK(stats.transfers == 20);
+    CHECK(stats.created <= 2);
+    CHECK(stats.handshakes <= 2);
+}
+
+TEST_CASE("BinanceAPI: Connection pool benchmark")
+{
+    tests::MockHTTPSServer server;
+    const std::string url = server.url();
+    const auto req        = makeRequest("/api/v3/ping");
+
+    BENCHMARK("REST call cold (new TCP + TLS handshake)")
+    {
+        MockBinanceAPI api(url, &unlimited());
+        return api.call(req).IsObject();
+    };
+
+    MockBinanceAPI warm(url, &unlimited());
+    warm.call(req);
+    BENCHMARK("REST call warm (keep-alive session)")
+    {
+        return warm.call(req).IsObject();
+    };
+}
+
+TEST_CASE("BinanceAPI: Asynchronous candle backfill runs the chunks concurrently")
+{
+    using namespace std::chrono_literals;
+
+    // Every request is held until all the chunks are in flight: it only completes at once if they run concurrently
+    constexpr std::size_t workers = 8;
+    std::mutex mutex;
+    std::condition_variable arrived;
+    std::size_t inFlight = 0, peak = 0;
+    std::vector<std::string> requestLines;
+
+    tests::MockHTTPSServer server([&](std::string_view requestLine) {
+        std::unique_lock<std::mutex> lock(mutex);
+        requestLines.emplace_back(requestLine);
+        peak = std::max(peak, ++inFlight);
+        arrived.notify_all();
+        arrived.wait_for(lock, 2s, [&] { return peak >= workers; });
+        --inFlight;
+        return tests::MockResponse { .body = R"([[1499040000000,"0.01634790","0.80000000","0.01575800","0.01577100","148976.11427815",1499644799999,"2434.19055334",308,"1756.87402397","28.46694368","0"]])" };
+    });
+    const std::string url = server.url();
+
+    binapi::BinanceAPISpot spot(url, "centaur-tests", nullptr, &unlimited());
+    spot.getConnectionPool()->setVerifySsl(false);
+    binapi::BinanceAPISpotAsync async(&spot, workers);
+
+    // A fixed range of one minute candles, aligned to the minute
+    const uint64_t start = 1'600'000'020'000ull;
+
+    SECTION("8 chunks of 1000 candles")
+    {
+        // The empty trailing chunk of getCandlesTimesAndLimits is not requested
+        auto chunks = async.candlesByPeriod("BTCUSDT", binapi::BinanceTimeIntervals::i1m, start, start + 8'000ull * 60'000ull);
+        REQUIRE(chunks.size() == 8);
+        for (auto &chunk : chunks)
+            CHECK(chunk.get().size() == 1);
+
+        CHECK(peak == workers);
+        CHECK(server.requests() == 8);
+    }
+
+    SECTION("The trailing chunk asks for the candles left")
+    {
+        auto chunks = async.candlesByPeriod("BTCUSDT", binapi::BinanceTimeIntervals::i1m, start, start + 7'030ull * 60'000ull);
+        REQUIRE(chunks.size() == 8);
+        for (auto &chunk : chunks)
+            CHECK(chunk.get().size() == 1);
+
+        CHECK(peak == workers);
+        std::lock_guard<std::mutex> lock(mutex);
+        CHECK(std::ranges::count_if(requestLines, [](const std::string &line) { return line.find("limit=1000") != std::string::npos; }) == 7);
+        CHECK(std::ranges::count_if(requestLines, [](const std::string &line) { return line.find("limit=30&") != std::string::npos; }) == 1);
+    }
+}
+
+namespace
+{
+    // Recorded from wss://stream.binance.com:9443/ws/btcusdt@kline_1m
+    constexpr std::string_view g_recordedKline = R"({"e":"kline","E":1665792000456,"s":"BTCUSDT","k":{"t":1665791940000,"T":1665791999999,"s":"BTCUSDT",)"
+                                                 R"("i":"1m","f":1962841201,"L":1962842411,"o":"19139.55000000","c":"19143.21000000","h":"19146.90000000",)"
+                                                 R"("l":"19137.02000000","v":"61.71536000","n":1211,"x":false,"q":"1181238.29446570","V":"30.81223000",)"
+                                                 R"("Q":"589763.90873519","B":"0"}})";
+
+    template <typename Parse>
+    auto sumDepth(const rapidjson::Document &document, Parse &&parse) -> double
+    {
+        double sum = 0.0;
+        for (const auto &side : { "b", "a" })
+        {
+            for (const auto &level : document[side].GetArray())
+                sum += parse(level[0]) + parse(level[1]);
+        }
+        return sum;
+    }
+
+    template <typename Parse>
+    auto sumKline(const rapidjson::Document &document, Parse &&parse) -> double
+    {
+        const auto &k = document["k"];
+        double sum    = 0.0;
+        for (const auto &field : { "o", "c", "h", "l", "v", "q", "V", "Q" })
+            sum += parse(k[field]);
+        return sum;
+    }
+
+    auto parseStod(const rapidjson::Value &value) -> double
+    {
+        return std::stod(std::string { value.GetString(), value.GetStringLength() });
+    }
+
+    auto parseFast(const rapidjson::Value &value) -> double
+    {
+        return binapi::jsonToDouble(value);
+    }
+} // namespace
+
+TEST_CASE("BinanceAPI: Request executor discards the pending tasks")
+{
+    binapi::RequestExecutor executor { 1 };
+
+    // The only worker is held, so the next task waits for it
+    std::promise<void> started;
+    std::promise<void> release;
+    auto running = executor.submit([&started, held = release.get_future().share()] {
+        started.set_value();
+        held.wait();
+        return 1;
+    });
+    started.get_future().wait();
+
+    std::atomic_bool ran { false };
+    auto pending = executor.submit([&ran] { ran = true; return 2; });
+    CHECK(executor.getPending() == 1);
+
+    CHECK(executor.discardPending() == 1);
+    CHECK(executor.getPending() == 0);
+    try
+    {
+        pending.get();
+        FAIL("The future of a discarded task has no value");
+    } catch (const std::future_error &error)
+    {
+        CHECK(error.code() == std::future_errc::broken_promise);
+    }
+
+    // The task running is not interrupted
+    release.set_value();
+    CHECK(running.get() == 1);
+    CHECK_FALSE(ran);
+}
+
+TEST_CASE("BinanceAPI: Decimal parser")
+{
+    CHECK(binapi::parseDecimal("19143.21000000") == std::stod("19143.21000000"));
+    CHECK(binapi::parseDecimal("-0.00000001") == std::stod("-0.00000001"));
+    CHECK(binapi::parseDecimal("0") == 0.0);
+    CHECK(binapi::parseDecimal("1e-5") == std::stod("1e-5"));
+    CHECK(binapi::parseDecimal("92233720368547758070.5") == std::stod("92233720368547758070.5"));
+    CHECK_THROWS_AS(binapi::parseDecimal(""), std::invalid_argument);
+    CHECK_THROWS_AS(binapi::parseDecimal("-"), std::invalid_argument);
+    CHECK_THROWS_AS(binapi::parseDecimal("1.2.3"), std::invalid_argument);
+    CHECK_THROWS_AS(binapi::parseDecimal("abc"), std::invalid_argument);
+
+    // What std::stod accepted before the decimal
+    CHECK(binapi::parseDecimal("+19143.21") == 19143.21);
+    CHECK(binapi::parseDecimal("+1e-5") == std::stod("+1e-5"));
+    CHECK(binapi::parseDecimal(" 0.5") == 0.5);
+    CHECK(binapi::parseDecimal("\t\n-2.25") == -2.25);
+    CHECK(binapi::parseDecimal("  +92233720368547758070.5") == std::stod("92233720368547758070.5"));
+    CHECK_THROWS_AS(binapi::parseDecimal("+-1"), std::invalid_argument);
+    CHECK_THROWS_AS(binapi::parseDecimal(" "), std::invalid_argument);
+    CHECK_THROWS_AS(binapi::parseDecimal(" +"), std::invalid_argument);
+    // Trailing characters are not ignored as std::stod did
+    CHECK_THROWS_AS(binapi::parseDecimal("0.5 "), std::invalid_argument);
+    CHECK_THROWS_AS(binapi::parseDecimal("0.5x"), std::invalid_argument);
+
+    rapidjson::Document depth, kline;
+    depth.Parse(g_recordedDepthUpdate.data(), g_recordedDepthUpdate.size());
+    kline.Parse(g_recordedKline.data(), g_recordedKline.size());
+
+    CHECK(sumDepth(depth, parseFast) == sumDepth(depth, parseStod));
+    CHECK(sumKline(kline, parseFast) == sumKline(kline, parseStod));
+}
+
+TEST_CASE("BinanceAPI: Decimal parser benchmark")
+{
+    rapidjson::Document depth, kline;
+    depth.Parse(g_recordedDepthUpdate.data(), g_recordedDepthUpdate.size());
+    kline.Parse(g_recordedKline.data(), g_recordedKline.size());
+
+    BENCHMARK("depthUpdate std::stod")
+    {
+        return sumDepth(depth, parseStod);
+    };
+
+    BENCHMARK("depthUpdate jsonToDouble")
+    {
+        return sumDepth(depth, parseFast);
+    };
+
+    BENCHMARK("kline std::stod")
+    {
+        return sumKline(kline, parseStod);
+    };
+
+    BENCHMARK("kline jsonToDouble")
+    {
+        return sumKline(kline, parseFast);
+    };
+}
+
+TEST_CASE("BinanceAPI: Fixed point decimals")
+{
+    using binapi::DecimalScale;
+    using binapi::FixedDecimal;
+
+    SECTION("Scales from the exchange filters")
+    {
+        CHECK(DecimalScale::fromString("0.01000000") == DecimalScale { 2, 1 });
+        CHECK(DecimalScale::fromString("0.05000000") == DecimalScale { 2, 5 });
+        CHECK(DecimalScale::fromString("10.00000000") == DecimalScale { 0, 10 });
+        CHECK(DecimalScale::fromString("0.00000000") == DecimalScale { 8, 0 });
+        CHECK(DecimalScale::fromDouble(0.00001) == DecimalScale { 5, 1 });
+    }
+
+    SECTION("Parsing and formatting")
+    {
+        const auto price = FixedDecimal::parse("19143.21000000", DecimalScale { 2, 1 });
+        CHECK(price.raw() == 1914321);
+        CHECK(price.toString() == "19143.21");
+        CHECK(FixedDecimal::parse("-0.00000001", 8).toString() == "-0.00000001");
+        CHECK(FixedDecimal::parse("1.005", 2).raw() == 101);
+        CHECK(FixedDecimal::parse("-1.005", 2).raw() == -101);
+        CHECK_THROWS_AS(FixedDecimal::parse("1.2.3", 2), std::invalid_argument);
+        CHECK_THROWS_AS(FixedDecimal::parse("92233720368547758070", 2), std::out_of_range);
+    }
+
+    SECTION("Arithmetic")
+    {
+        const auto a = FixedDecimal::parse("1.5", 1);
+        const auto b = FixedDecimal::parse("0.25", 2);
+        CHECK((a + b).toString() == "1.75");
+        CHECK((b - a).toString() == "-1.25");
+        CHECK(a == FixedDecimal::parse("1.50", 2));
+        CHECK(b < a);
+        CHECK(FixedDecimal::multiply(FixedDecimal::parse("19143.21", 2), FixedDecimal::parse("0.00522", 8), 8).toString() == "99.92755620");
+        CHECK(FixedDecimal::parse("1.07", 2).roundToStep({ 2, 5 }).toString() == "1.05");
+        CHECK(FixedDecimal::parse("0.12349", 5).truncateToStep({ 3, 2 }).toString() == "0.122");
+    }
+
+    SECTION("Book levels are exact keys")
+    {
+        rapidjson::Document depth;
+        depth.Parse(g_recordedDepthUpdate.data(), g_recordedDepthUpdate.size());
+
+        const DecimalScale tick { 2, 1 };
+        std::map<FixedDecimal, FixedDecimal> bids;
+        for (const auto &level : depth["b"].GetArray())
+            bids[binapi::jsonToFixed(level[0], tick)] = binapi::jsonToFixed(level[1], DecimalScale { 8, 1 });
+
+        CHECK(bids.size() == depth["b"].Size());
+        CHECK(bids.rbegin()->first.toString() == "19143.21");
+        CHECK(bids.at(FixedDecimal::parse("19142.98", tick)).toString() == "0.01071000");
+    }
+
+    SECTION("Equal values hash the same at any scale")
+    {
+        const auto value  = FixedDecimal::parse("1.5", 1);
+        const auto scaled = FixedDecimal::parse("1.50", 2);
+        REQUIRE(value == scaled);
+        CHECK(std::hash<FixedDecimal> {}(value) == std::hash<FixedDecimal> {}(scaled));
+        CHECK(std::hash<FixedDecimal> {}(FixedDecimal::parse("0", 0)) == std::hash<FixedDecimal> {}(FixedDecimal::parse("0.000", 3)));
+
+        std::unordered_set<FixedDecimal> levels { value, FixedDecimal::parse("-20", 0) };
+        CHECK(levels.contains(scaled));
+        CHECK(levels.contains(FixedDecimal::parse("-20.00", 2)));
+        CHECK_FALSE(levels.contains(FixedDecimal::parse("1.05", 2)));
+    }
+}
+
+namespace
+{
+    constexpr std::string_view g_recordedSymbol = R"({"symbol":"BTCUSDT","status":"TRADING","baseAsset":"BTC","baseAssetPrecision":8,"quoteAsset":"USDT","quotePrecision":8,)"
+                                                  R"("quoteAssetPrecision":8,"baseCommissionPrecision":8,"quoteCommissionPrecision":8,"orderTypes":["LIMIT","LIMIT_MAKER","MARKET",)"
+                                                  R"("STOP_LOSS_LIMIT","TAKE_PROFIT_LIMIT"],"icebergAllowed":true,"ocoAllowed":true,"quoteOrderQtyMarketAllowed":true,)"
+                                                  R"("allowTrailingStop":true,"cancelReplaceAllowed":true,"isSpotTradingAllowed":true,"isMarginTradingAllowed":true,)"
+                                                  R"("filters":[{"filterType":"PRICE_FILTER","minPrice":"0.01000000","maxPrice":"1000000.00000000","tickSize":"0.01000000"},)"
+                                                  R"({"filterType":"PERCENT_PRICE","multiplierUp":"5","multiplierDown":"0.2","avgPriceMins":5},)"
+                                                  R"({"filterType":"LOT_SIZE","minQty":"0.00001000","maxQty":"9000.00000000","stepSize":"0.00001000"},)"
+                                                  R"({"filterType":"MIN_NOTIONAL","minNotional":"10.00000000","applyToMarket":true,"avgPriceMins":5},)"
+                                                  R"({"filterType":"ICEBERG_PARTS","limit":10},{"filterType":"MARKET_LOT_SIZE","minQty":"0.00000000","maxQty":"120.00000000",)"
+                                                  R"("stepSize":"0.00000000"},{"filterType":"TRAILING_DELTA","minTrailingAboveDelta":10,"maxTrailingAboveDelta":2000},)"
+                                                  R"({"filterType":"MAX_NUM_ORDERS","maxNumOrders":200},{"filterType":"MAX_NUM_ALGO_ORDERS","maxNumAlgoOrders":5}],)"
+                                                  R"("permissions":["SPOT","MARGIN","TRD_GRP_004"],"defaultSelfTradePreventionMode":"NONE"})";
+
+    /// exchangeInfo with count copies of the recorded symbol
+    auto makeExchangeInformation(std::size_t count) -> std::string
+    {
+        std::string json = R"({"timezone":"UTC","serverTime":1665792000000,"rateLimits":[{"rateLimitType":"REQUEST_WEIGHT","interval":"MINUTE",)"
+                           R"("intervalNum":1,"limit":1200},{"rateLimitType":"ORDERS","interval":"SECOND","intervalNum":10,"limit":50},)"
+                           R"({"rateLimitType":"ORDERS","interval":"DAY","intervalNum":1,"limit":160000}],"exchangeFilters":[],"symbols":[)";
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            std::string symbol { g_recordedSymbol };
+            symbol.replace(symbol.find("BTCUSDT"), 7, "SYM" + std::to_string(i));
+            json.append(i == 0 ? "" : ",").append(symbol);
+        }
+        return json.append("]}");
+    }
+
+    /// The DOM reading done before the typed parsers existed, kept for the benchmark
+    auto domExchangeInformation(const std::string &json, const rapidjson::SchemaDocument &schema) -> std::size_t
+    {
+        rapidjson::Document document;
+        document.Parse(json.c_str());
+        rapidjson::SchemaValidator validator(schema);
+        document.Accept(validator);
+
+        std::size_t filters = 0;
+        for (const auto &symbol : document["symbols"].GetArray())
+        {
+            for (const auto &filter : symbol["filters"].GetArray())
+            {
+                if (filter.HasMember("tickSize"))
+                    filters += binapi::jsonToDouble(filter["tickSize"]) > 0;
+            }
+        }
+        return filters;
+    }
+} // namespace
+
+TEST_CASE("BinanceAPI: Typed parsers")
+{
+    std::string error;
+
+    SECTION("Exchange information")
+    {
+        binapi::local::ExchangeInformationHandler handler;
+        REQUIRE(binapi::local::parseTyped(makeExchangeInformation(2), handler, nullptr, error));
+        const auto info = handler.take();
+
+        CHECK(info.timezone == "UTC");
+        CHECK(info.limitWeight.limit == 1200);
+        CHECK(info.limitWeight.seconds == 60);
+        CHECK(info.limitOrderSecond.seconds == 10);
+        CHECK(info.limitOrderDay.limit == 160000);
+        REQUIRE(info.symbols.size() == 2);
+
+        const auto &symbol = info.symbols.at("SYM1");
+        CHECK(symbol.baseAsset == "BTC");
+        CHECK(symbol.status == binapi::SPOT::TradingStatus::Trading);
+        CHECK(symbol.orderType.count() == 5);
+        CHECK(symbol.permissions.count() == 2);
+        CHECK(symbol.eifPrice.tickSize == 0.01);
+        CHECK(symbol.eifPrice.tickScale == binapi::DecimalScale { 2, 1 });
+        CHECK(symbol.eifLotSize.stepScale == binapi::DecimalScale { 5, 1 });
+        CHECK(symbol.eifMinNotional.applyToMarket);
+        CHECK(symbol.eifMaxNumOrders.maxNumOrders == 200);
+    }
+
+    SECTION("Candlesticks")
+    {
+        binapi::local::CandlestickHandler handler;
+        REQUIRE(binapi::local::parseTyped(R"([[1499040000000,"0.01634790","0.80000000","0.01575800","0.01577100","148976.11427815",1499644799999,)"
+                                          R"("2434.19055334",308,"1756.87402397","28.46694368","0"]])",
+            handler, nullptr, error));
+        const auto candles = handler.take();
+        REQUIRE(candles.size() == 1);
+        CHECK(candles[0].openTime == 1499040000000ull);
+        CHECK(candles[0].high == 0.8);
+        CHECK(candles[0].numberOfTrades == 308);
+        CHECK(candles[0].takerQuoteAssetVolume == 28.46694368);
+    }
+
+    SECTION("Structure is checked with no schema")
+    {
+        binapi::local::CandlestickHandler candles;
+        CHECK_FALSE(binapi::local::parseTyped(R"({"code":-1121,"msg":"Invalid symbol."})", candles, nullptr, error));
+        binapi::local::CandlestickHandler incomplete;
+        CHECK_FALSE(binapi::local::parseTyped(R"([[1499040000000,"0.01634790"]])", incomplete, nullptr, error));
+        binapi::local::ExchangeInformationHandler info;
+        CHECK_FALSE(binapi::local::parseTyped(R"({"code":-1121,"msg":"Invalid symbol."})", info, nullptr, error));
+    }
+}
+
+TEST_CASE("BinanceAPI: Typed parsers through the REST layer")
+{
+    std::atomic_bool invalidSymbol { false };
+    tests::MockHTTPSServer server([&](std::string_view) {
+        if (invalidSymbol)
+            return tests::MockResponse { .body = R"({"code":-1121,"msg":"Invalid symbol."})" };
+        return tests::MockResponse { .body = R"([[1499040000000,"0.01634790","0.80000000","0.01575800","0.01577100","148976.11427815",1499644799999,"2434.19055334",308,"1756.87402397","28.46694368","0"]])" };
+    });
+    const std::string url = server.url();
+
+    binapi::BinanceAPISpot spot(url, "centaur-tests", nullptr, &unlimited());
+    spot.getConnectionPool()->setVerifySsl(false);
+
+    for (const auto validation : { binapi::SchemaValidation::full, binapi::SchemaValidation::sampled, binapi::SchemaValidation::off })
+    {
+        spot.setSchemaValidation(validation, 2);
+        CHECK(spot.getSchemaValidation() == validation);
+        for (int i = 0; i < 3; ++i)
+            CHECK(spot.candlestickData("BTCUSDT", binapi::BinanceTimeIntervals::i1m, 0, 0, 1).size() == 1);
+    }
+
+    // Error bodies are reported as API errors whatever the validation mode
+    invalidSymbol = true;
+    try
+    {
+        (void)spot.candlestickData("BTCUSDT", binapi::BinanceTimeIntervals::i1m, 0, 0, 1);
+        FAIL("APIException expected");
+    } catch (const binapi::APIException &ex)
+    {
+        CHECK(ex.type() == binapi::APIException::Type::api);
+    }
+}
+
+TEST_CASE("BinanceAPI: Typed parsers benchmark")
+{
+    const std::string json = makeExchangeInformation(2000);
+    const auto schema      = makeSchema(R"({"type":"object","required":["timezone","symbols"],"properties":{"symbols":{"type":"array","items":{"type":"object"}}}})");
+
+    BENCHMARK("exchangeInfo DOM + SchemaValidator")
+    {
+        return domExchangeInformation(json, *schema);
+    };
+
+    BENCHMARK("exchangeInfo typed handler + schema in the same pass")
+    {
+        std::string error;
+        binapi::local::ExchangeInformationHandler handler;
+        binapi::local::parseTyped(json, handler, schema.get(), error);
+        return handler.take().symbols.size();
+    };
+
+    BENCHMARK("exchangeInfo typed handler, validation off")
+    {
+        std::string error;
+        binapi::local::ExchangeInformationHandler handler;
+        binapi::local::parseTyped(json, handler, nullptr, error);
+        return handler.take().symbols.size();
+    };
+}
+
+TEST_CASE("BinanceAPI: Arena documents")
+{
+    std::string json = makeTicker24hr(3);
+
+    const auto before = binapi::local::ResponseArena::getStatistics();
+    {
+        binapi::local::ResponseDocument document(std::move(json));
+        REQUIRE_FALSE(document.HasParseError());
+        REQUIRE(document.Size() == 3);
+        CHECK(binapi::jsonToView(document[2]["symbol"]) == "SYM2");
+        CHECK(binapi::jsonToDouble(document[0]["lastPrice"]) == 4.000002);
+
+        // A second response alive at the same time takes its own arena
+        binapi::local::ResponseDocument error(R"({"code":-1121,"msg":"Invalid symbol."})");
+        CHECK(binapi::jsonToView(error["msg"]) == "Invalid symbol.");
+        CHECK(binapi::jsonToView(document[1]["symbol"]) == "SYM1");
+
+        // The arena moves along with the DOM
+        const binapi::local::ResponseDocument moved(std::move(document));
+        CHECK(binapi::jsonToView(moved.root()[0]["symbol"]) == "SYM0");
+    }
+
+    binapi::local::ResponseDocument invalid(R"([{"symbol":)");
+    CHECK(invalid.HasParseError());
+
+    // The DOM can not be moved into a plain document, which would outlive the arena
+    static_assert(!std::is_constructible_v<rapidjson::Document, binapi::local::ResponseDocument &&>);
+    static_assert(!std::is_convertible_v<binapi::local::ResponseDocument &, rapidjson::Value &>);
+
+    const auto after = binapi::local::ResponseArena::getStatistics();
+    CHECK(after.responses - before.responses == 3);
+    CHECK(after.reused - before.reused >= 1);
+
+    SECTION("The buffer grows to the largest response")
+    {
+        const auto grown = binapi::local::ResponseArena::getStatistics().grown;
+        for (int i = 0; i < 3; ++i)
+        {
+            binapi::local::ResponseDocument document(makeTicker24hr(2000));
+            CHECK(document.Size() == 2000);
+        }
+        // Only the first large response can outgrow the buffer
+        CHECK(binapi::local::ResponseArena::getStatistics().grown - grown <= 1);
+    }
+}
+
+TEST_CASE("BinanceAPI: Depth levels")
+{
+    rapidjson::Document depth;
+    depth.Parse(g_recordedDepthUpdate.data(), g_recordedDepthUpdate.size());
+
+    const auto bids = binapi::jsonToPriceLevels(depth["b"]);
+    const auto asks = binapi::jsonToPriceLevels(depth["a"]);
+    REQUIRE(bids.size() == 9);
+    REQUIRE(asks.size() == 8);
+
+    // In the order received, removed levels included
+    CHECK(bids.front().price == 19143.21);
+    CHECK(bids.front().quantity == 0.00522);
+    CHECK(bids[1].quantity == 0.0);
+    CHECK(bids.back().price == 19138.56);
+    CHECK(asks.front().price == 19143.22);
+    CHECK(asks.back().price == 19146.33);
+    CHECK(std::ranges::is_sorted(bids, std::greater<> {}, &binapi::PriceLevel::price));
+    CHECK(std::ranges::is_sorted(asks, std::less<> {}, &binapi::PriceLevel::price));
+}
+
+TEST_CASE("BinanceAPI: Sliding window limits")
+{
+    using namespace std::chrono_literals;
+    using clock = binapi::SlidingWindowLimit::clock;
+
+    // Aligned to the minute, as the windows of the server
+    const clock::time_point minute { std::chrono::seconds { 1'700'000'040 } };
+
+    SECTION("No more than the limit in any window")
+    {
+        binapi::SlidingWindowLimit limit(10, 60s);
+        CHECK(limit.tryAcquire(6, minute) == 0ns);
+        CHECK(limit.tryAcquire(4, minute + 30s) == 0ns);
+        CHECK(limit.used(minute + 30s) == 10);
+
+        // The weight taken at the start of the minute leaves the window a minute later
+        const auto wait = limit.tryAcquire(5, minute + 40s);
+        CHECK(wait == 20s);
+        CHECK(limit.used(minute + 40s) == 10);
+        CHECK(limit.waitFor(5, minute + 40s) == 20s);
+        CHECK(limit.waitFor(5, minute + 60s) == 0ns);
+        CHECK(limit.used(minute + 40s) == 10);
+        CHECK(limit.tryAcquire(5, minute + 60s) == 0ns);
+        CHECK(limit.tryAcquire(11, minute + 60s) == std::chrono::nanoseconds::max());
+    }
+
+    SECTION("Server counts")
+    {
+        binapi::SlidingWindowLimit limit(1200, 60s);
+        CHECK(limit.tryAcquire(100, minute + 10s) == 0ns);
+
+        // Stale reports only make the count grow
+        limit.synchronize(40, false, minute + 20s);
+        CHECK(limit.used(minute + 20s) == 100);
+        limit.synchronize(1150, false, minute + 20s);
+        CHECK(limit.used(minute + 20s) == 1150);
+        CHECK(limit.tryAcquire(100, minute + 20s) != 0ns);
+
+        // A new server window: the previous one no longer counts
+        limit.synchronize(1, true, minute + 61s);
+        CHECK(limit.used(minute + 61s) == 1);
+        CHECK(limit.tryAcquire(1199, minute + 61s) == 0ns);
+    }
+
+    SECTION("Retry-After blocks the requests")
+    {
+        binapi::BinanceLimits limits;
+        limits.setAPIRequestsLimits(1200, 60);
+        CHECK(limits.tryAcquire(1, false) == 0ns);
+        binapi::BinanceLimits::Admission(limits, 1, false).completed(cpr::Header { { "Retry-After", "30" } }, 429);
+        CHECK(limits.tryAcquire(1, false) > 29s);
+    }
+
+    SECTION("Headers re-synchronize the limits")
+    {
+        binapi::BinanceLimits limits;
+        limits.setAPIRequestsLimits(1200, 60);
+        limits.setAPIOrderLimitLow(50, 10);
+        limits.setAPIOrderLimitHigh(160000, 86400);
+
+        CHECK(limits.tryAcquire(1, true) == 0ns);
+        binapi::BinanceLimits::Admission(limits, 1, true).completed(cpr::Header { { "x-mbx-used-weight-1m", "1190" }, { "X-MBX-ORDER-COUNT-10S", "50" }, { "X-MBX-ORDER-COUNT-1D", "7" } }, 200);
+        CHECK(limits.getAPIRequests() >= 1190);
+        CHECK(limits.getAPIOrdersLow() == 50);
+        CHECK(limits.getAPIOrdersHigh() >= 7);
+
+        CHECK(limits.tryAcquire(1, true) != 0ns);
+        CHECK(limits.tryAcquire(20, false) != 0ns);
+        CHECK(limits.tryAcquire(5, false) == 0ns);
+    }
+
+    SECTION("Only the calls alive are in flight")
+    {
+        binapi::BinanceLimits limits;
+        limits.setAPIRequestsLimits(1200, 60);
+
+        // The legacy entry points take the weight but never start a call
+        for (int i = 0; i < 10; ++i)
+        {
+            CHECK(limits.secureCall(10));
+            CHECK(limits.secureOrderCall(1));
+        }
+
+        // A call that threw before completing ends when its Admission is destroyed
+        CHECK(limits.tryAcquire(10, false) == 0ns);
+        try
+        {
+            const binapi::BinanceLimits::Admission failed(limits, 10, false);
+            throw std::runtime_error("transfer failed");
+        } catch (const std::runtime_error &)
+        {
+        }
+
+        // So the next response is the only one in flight and may lower the count
+        CHECK(limits.getAPIRequests() >= 110);
+        CHECK(limits.tryAcquire(1, false) == 0ns);
+        binapi::BinanceLimits::Admission(limits, 1, false).completed(cpr::Header { { "x-mbx-used-weight-1m", "3" } }, 200);
+        CHECK(limits.getAPIRequests() < 110);
+
+        // With another call in flight a lower count is ignored
+        CHECK(limits.tryAcquire(2, false) == 0ns);
+        const binapi::BinanceLimits::Admission pending(limits, 1, false);
+        binapi::BinanceLimits::Admission(limits, 1, false).completed(cpr::Header { { "x-mbx-used-weight-1m", "1" } }, 200);
+        CHECK(limits.getAPIRequests() >= 3);
+    }
+
+    SECTION("Acquire waits for the capacity")
+    {
+        binapi::BinanceLimits limits;
+        limits.setAPIRequestsLimits(2, 1);
+        CHECK(limits.acquire(2, false, std::chrono::steady_clock::now()));
+        CHECK_FALSE(limits.acquire(1, false, std::chrono::steady_clock::now() + 10ms));
+
+        const auto start = std::chrono::steady_clock::now();
+        CHECK(limits.acquire(1, false, start + 3s));
+        CHECK(std::chrono::steady_clock::now() - start <= 1100ms);
+    }
+}
+
+TEST_CASE("BinanceAPI: Limits follow the server through the REST layer")
+{
+    std::atomic_int used { 0 };
+    tests::MockHTTPSServer server([&](std::string_view) {
+        return tests::MockResponse { .body = R"({})", .headers = { { "X-MBX-USED-WEIGHT-1M", std::to_string(used += 10) } } };
+    });
+
+    binapi::BinanceLimits limits;
+    limits.setAPIRequestsLimits(20, 60);
+    limits.setWaitForCapacity(std::chrono::milliseconds { 0 });
+
+    MockBinanceAPI api(server.url(), &limits);
+    const auto req = makeRequest("/api/v3/ping");
+
+    // Other clients on the same IP use 9 of every 10 weight units counted by the server
+    CHECK_NOTHROW(api.call(req));
+    CHECK(limits.getAPIRequests() == 10);
+    CHECK_NOTHROW(api.call(req));
+    CHECK(limits.getAPIRequests() == 20);
+    CHECK_THROWS_AS(api.call(req), binapi::APIException);
+}
+
+TEST_CASE("BinanceAPI: Request scheduler")
+{
+    using namespace std::chrono_literals;
+    using binapi::RequestPriority;
+
+    binapi::BinanceLimits limits;
+    auto &scheduler = limits.getScheduler();
+
+    // Take the whole request weight, so the calls of the next second have to wait
+    const auto fill = [&]() {
+        while (scheduler.admit(1, false, RequestPriority::trading, 0, std::chrono::steady_clock::now()))
+        {
+        }
+    };
+
+    SECTION("Every class leaves the reserved weight to the ones above")
+    {
+        limits.setAPIRequestsLimits(100, 60);
+        const auto now = std::chrono::steady_clock::now();
+
+        int admitted[3] {};
+        for (const auto priority : { RequestPriority::background, RequestPriority::interactive, RequestPriority::trading })
+        {
+            while (scheduler.admit(1, false, priority, 1, now))
+                ++admitted[static_cast<int>(priority)];
+        }
+
+        CHECK(admitted[static_cast<int>(RequestPriority::background)] == 80);
+        CHECK(admitted[static_cast<int>(RequestPriority::interactive)] == 10);
+        CHECK(admitted[static_cast<int>(RequestPriority::trading)] == 10);
+        CHECK(scheduler.getMetrics(RequestPriority::background).rejected == 1);
+    }
+
+    SECTION("Interactive calls go before the queued background calls")
+    {
+        limits.setAPIRequestsLimits(10, 1);
+        fill();
+
+        // Once the window clears there is room for the two interactive calls only
+        const auto deadline = std::chrono::steady_clock::now() + 1500ms;
+        std::atomic_int background { 0 };
+        std::atomic_int interactive { 0 };
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; ++i)
+            threads.emplace_back([&]() { background += scheduler.admit(4, false, RequestPriority::background, 1, deadline); });
+        std::this_thread::sleep_for(50ms);
+        for (int i = 0; i < 2; ++i)
+            threads.emplace_back([&]() { interactive += scheduler.admit(4, false, RequestPriority::interactive, 2, deadline); });
+        std::this_thread::sleep_for(50ms);
+
+        CHECK(scheduler.getQueueDepth(RequestPriority::background) == 4);
+        CHECK(scheduler.getQueueDepth(RequestPriority::interactive) == 2);
+
+        for (auto &thread : threads)
+            thread.join();
+
+        CHECK(interactive == 2);
+        CHECK(background == 0);
+
+        const auto metrics = scheduler.getMetrics(RequestPriority::interactive);
+        CHECK(metrics.depth == 0);
+        CHECK(metrics.maxDepth == 2);
+        CHECK(metrics.delayed == 2);
+        CHECK(scheduler.getMetrics(RequestPriority::background).rejected == 4);
+    }
+
+    SECTION("Clients of the same class share the capacity")
+    {
+        limits.setAPIRequestsLimits(4, 1);
+        scheduler.setReservedShare(RequestPriority::trading, 0.0);
+        scheduler.setReservedShare(RequestPriority::interactive, 0.0);
+        fill();
+
+        // The first client queues all its calls before the second one arrives
+        const auto deadline = std::chrono::steady_clock::now() + 1500ms;
+        std::atomic_int first { 0 };
+        std::atomic_int second { 0 };
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 6; ++i)
+            threads.emplace_back([&]() { first += scheduler.admit(1, false, RequestPriority::background, 1, deadline); });
+        std::this_thread::sleep_for(50ms);
+        for (int i = 0; i < 6; ++i)
+            threads.emplace_back([&]() { second += scheduler.admit(1, false, RequestPriority::background, 2, deadline); });
+
+        for (auto &thread : threads)
+            thread.join();
+
+        CHECK(first == 2);
+        CHECK(second == 2);
+    }
+
+    SECTION("An order held by the order count does not block the calls behind it")
+    {
+        limits.setAPIRequestsLimits(100, 60);
+        limits.setAPIOrderLimitLow(1, 2);
+        REQUIRE(limits.tryAcquire(1, true) == 0ns);
+        CHECK(limits.getOrdersWait(1) > 0ns);
+
+        // The order waits up to two seconds for the count; the weight is there for anything else
+        std::atomic_bool order { false };
+        std::thread trading([&]() { order = scheduler.admit(1, true, RequestPriority::trading, 1, std::chrono::steady_clock::now() + 3s); });
+        for (int i = 0; i < 200 && scheduler.getQueueDepth(RequestPriority::trading) == 0; ++i)
+            std::this_thread::sleep_for(5ms);
+        REQUIRE(scheduler.getQueueDepth(RequestPriority::trading) == 1);
+
+        CHECK(scheduler.admit(1, false, RequestPriority::interactive, 2, std::chrono::steady_clock::now() + 500ms));
+        CHECK(scheduler.admit(1, false, RequestPriority::background, 2, std::chrono::steady_clock::now() + 500ms));
+        CHECK(scheduler.getQueueDepth(RequestPriority::trading) == 1);
+
+        trading.join();
+        CHECK(order);
+        CHECK(scheduler.getMetrics(RequestPriority::trading).delayed == 1);
+    }
+
+    SECTION("Priority of the REST calls")
+    {
+        tests::MockHTTPSServer server([](std::string_view) { return tests::MockResponse { .body = R"({})" }; });
+
+        limits.setAPIRequestsLimits(10, 60);
+        MockBinanceAPI api(server.url(), &limits);
+        const auto req = makeRequest("/api/v3/ping");
+
+        {
+            const binapi::RequestPriorityScope scope { RequestPriority::background };
+            for (int i = 0; i < 8; ++i)
+                CHECK_NOTHROW(api.call(req));
+            CHECK_THROWS_AS(api.call(req), binapi::APIException);
+        }
+
+        // Outside the scope the calls are interactive and may take the reserved weight
+        CHECK(api.getDefaultPriority() == RequestPriority::interactive);
+        CHECK_NOTHROW(api.call(req));
+        CHECK(scheduler.getMetrics(RequestPriority::background).admitted == 8);
+        CHECK(scheduler.getMetrics(RequestPriority::interactive).admitted == 1);
+    }
+}
+
+TEST_CASE("BinanceAPI: Request signing")
+{
+    char signature[binapi::local::HMACSigner::signatureSize + 1] {};
+
+    SECTION("RFC 4231")
+    {
+        binapi::local::HMACSigner("Jefe").sign("what do ya want for nothing?", signature);
+        CHECK(std::string_view { signature } == "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+
+        // Keys longer than a block are hashed first
+        binapi::local::HMACSigner(std::string(131, '\xaa')).sign("Test Using Larger Than Block-Size Key - Hash Key First", signature);
+        CHECK(std::string_view { signature } == "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54");
+    }
+
+    SECTION("Signed endpoint example of the Binance documentation")
+    {
+        auto &signer = binapi::local::HMACSigner::forThread("NhqPtmdSJYdKjVHjA7PZj4Mge3R5YNiP1e3UZjInClVN65XAbvqqM6A7H5fATj0j");
+        signer.sign("symbol=LTCBTC&side=BUY&type=LIMIT&timeInForce=GTC&quantity=1&price=0.1&recvWindow=5000&timestamp=1499827319559", signature);
+        CHECK(std::string_view { signature } == "c8db56825ae71d6d79447849e617115f4a920fa2acdcab2b053c4b2838bd6b71");
+
+        // The signer is reused for the same key and a different one is made for other keys
+        CHECK(&binapi::local::HMACSigner::forThread("NhqPtmdSJYdKjVHjA7PZj4Mge3R5YNiP1e3UZjInClVN65XAbvqqM6A7H5fATj0j") == &signer);
+        CHECK(&binapi::local::HMACSigner::forThread("Jefe") != &signer);
+    }
+
+    SECTION("Vectorized hexadecimal encoding")
+    {
+        std::array<uint8_t, 100> bytes {};
+        for (std::size_t i = 0; i < bytes.size(); ++i)
+            bytes[i] = static_cast<uint8_t>(i * 37 + 11);
+
+        for (std::size_t size = 0; size <= bytes.size(); ++size)
+        {
+            std::string vectorized(2 * size, ' ');
+            std::string scalar(2 * size, ' ');
+            cen::hexEncode(bytes.data(), size, vectorized.data());
+            cen::hexEncodeScalar(bytes.data(), size, scalar.data());
+            CHECK(vectorized == scalar);
+        }
+
+        const uint8_t digest[] = { 0x00, 0x09, 0x0a, 0x0f, 0x10, 0x99, 0xa0, 0xff, 0x5b, 0xdc, 0xc1, 0x46, 0xbf, 0x60, 0x75, 0x4e, 0x6a };
+        std::string hex(2 * sizeof(digest), ' ');
+        cen::hexEncode(digest, sizeof(digest), hex.data());
+        CHECK(hex == "00090a0f1099a0ff5bdcc146bf60754e6a");
+    }
+}
+
+TEST_CASE("BinanceAPI: Request signing benchmark")
+{
+    const std::string key   = "NhqPtmdSJYdKjVHjA7PZj4Mge3R5YNiP1e3UZjInClVN65XAbvqqM6A7H5fATj0j";
+    const std::string query = "symbol=BTCUSDT&side=BUY&type=LIMIT&timeInForce=GTC&quantity=0.00100000&price=30000.00000000&recvWindow=5000&timestamp=1700000000000";
+
+    BENCHMARK("One-shot HMAC + per-byte hexadecimal")
+    {
+        char signature[binapi::local::HMACSigner::signatureSize + 1] {};
+        unsigned int size  = 0;
+        const auto *digest  = ::HMAC(EVP_sha256(), key.data(), static_cast<int>(key.size()), reinterpret_cast<const unsigned char *>(query.data()), query.size(), nullptr, &size);
+        cen::hexEncodeScalar(digest, size, signature);
+        return signature[0];
+    };
+
+    BENCHMARK("HMACSigner with the pads precomputed")
+    {
+        char signature[binapi::local::HMACSigner::signatureSize + 1] {};
+        binapi::local::HMACSigner::forThread(key).sign(query, signature);
+        return signature[0];
+    };
+
+    std::array<uint8_t, 32> digest {};
+    for (std::size_t i = 0; i < digest.size(); ++i)
+        digest[i] = static_cast<uint8_t>(i * 73);
+
+    BENCHMARK("Hexadecimal of a digest, per byte")
+    {
+        char hex[64];
+        cen::hexEncodeScalar(digest.data(), digest.size(), hex);
+        return hex[63];
+    };
+
+    BENCHMARK("Hexadecimal of a digest, vectorized")
+    {
+        char hex[64];
+        cen::hexEncode(digest.data(), digest.size(), hex);
+        return hex[63];
+    };
+}
+
+TEST_CASE("BinanceAPI: Response cache")
+{
+    using namespace std::chrono_literals;
+
+    SECTION("Keys")
+    {
+        using binapi::ResponseCache;
+
+        // Parameter order, timestamp, recvWindow and signature do not matter
+        const auto key = ResponseCache::makeKey("/api/v3/exchangeInfo", { { "symbol", "BTCUSDT" }, { "permissions", "SPOT" } }, {});
+        CHECK(key == ResponseCache::makeKey("/api/v3/exchangeInfo", { { "permissions", "SPOT" }, { "timestamp", "1" }, { "symbol", "BTCUSDT" } }, {}));
+        CHECK(key != ResponseCache::makeKey("/api/v3/exchangeInfo", { { "symbol", "ETHUSDT" }, { "permissions", "SPOT" } }, {}));
+
+        // Signed calls are kept per account and the API key is not part of the key
+        const auto signed1 = ResponseCache::makeKey("/sapi/v1/asset/tradeFee", { { "recvWindow", "5000" } }, "first-api-key");
+        const auto signed2 = ResponseCache::makeKey("/sapi/v1/asset/tradeFee", { { "recvWindow", "10000" } }, "second-api-key");
+        CHECK(signed1 != signed2);
+        CHECK(signed1.find("first-api-key") == std::string::npos);
+    }
+
+    SECTION("Time to live")
+    {
+        binapi::ResponseCache cache;
+        const auto now = binapi::ResponseCache::clock::now();
+
+        // Without a time to live nothing is used
+        cache.store("/api/v3/exchangeInfo", "key", "{}", {}, {}, now);
+        CHECK(cache.find("/api/v3/exchangeInfo", "key", 10, now).body == nullptr);
+
+        cache.setTimeToLive("/api/v3/exchangeInfo", 1h);
+        CHECK(cache.find("/api/v3/exchangeInfo", "key", 10, now + 59min).body != nullptr);
+        CHECK(cache.find("/api/v3/exchangeInfo", "key", 10, now + 61min).body == nullptr);
+
+        const auto metrics = cache.getMetrics("/api/v3/exchangeInfo");
+        CHECK(metrics.hits == 1);
+        CHECK(metrics.misses == 2);
+        CHECK(metrics.weightSaved == 10);
+
+        cache.invalidate("/api/v3/exchangeInfo");
+        CHECK(cache.size() == 0);
+    }
+
+    SECTION("Calls within the time to live are not made")
+    {
+        tests::MockHTTPSServer server([](std::string_view) { return tests::MockResponse { .body = R"({"symbols":[]})" }; });
+        MockBinanceAPI api(server.url(), &unlimited());
+        api.getResponseCache()->setTimeToLive("/api/v3/exchangeInfo", 1h);
+
+        const auto req = makeRequest("/api/v3/exchangeInfo");
+        for (int i = 0; i < 5; ++i)
+        {
+            const auto document = api.call(req);
+            CHECK(document.HasMember("symbols"));
+        }
+
+        CHECK(server.requests() == 1);
+        CHECK(api.getResponseCache()->getMetrics().hits == 4);
+    }
+
+    SECTION("Expired responses are revalidated")
+    {
+        std::atomic_int calls { 0 };
+        tests::MockHTTPSServer server([&](std::string_view) {
+            if (calls++ == 0)
+                return tests::MockResponse { .body = R"({"symbols":[]})", .headers = { { "ETag", R"("v1")" } } };
+            return tests::MockResponse { .status = 304, .body = {} };
+        });
+        MockBinanceAPI api(server.url(), &unlimited());
+        auto *cache = api.getResponseCache();
+        cache->setTimeToLive("/api/v3/exchangeInfo", 1h);
+
+        const auto req = makeRequest("/api/v3/exchangeInfo");
+        CHECK_NOTHROW(api.call(req));
+
+        // Moves the stored time past the time to live
+        const auto key = binapi::ResponseCache::makeKey(req.endPoint, {}, {});
+        CHECK(cache->revalidated(req.endPoint, key, binapi::ResponseCache::clock::now() - 2h) != nullptr);
+
+        const auto document = api.call(req);
+        CHECK(document.HasMember("symbols"));
+        CHECK(server.requests() == 2);
+        CHECK(cache->getMetrics(req.endPoint).revalidated == 2);
+
+        // Renewed by the 304
+        CHECK_NOTHROW(api.call(req));
+        CHECK(server.requests() == 2);
+    }
+
+    SECTION("Snapshots")
+    {
+        const auto path = std::filesystem::temp_directory_path() / "centaur-tests-response-cache.bin";
+        const auto now  = binapi::ResponseCache::clock::now();
+
+        binapi::ResponseCache cache;
+        cache.store("/api/v3/exchangeInfo", "/api/v3/exchangeInfo?", R"({"symbols":[]})", R"("v1")", {}, now);
+        cache.store("/sapi/v1/asset/tradeFee", binapi::ResponseCache::makeKey("/sapi/v1/asset/tradeFee", {}, "api-key"), "[]", {}, {}, now);
+
+        // Account data is left out unless asked for
+        REQUIRE(cache.saveSnapshot(path));
+        binapi::ResponseCache loaded;
+        REQUIRE(loaded.loadSnapshot(path));
+        CHECK(loaded.size() == 1);
+
+        REQUIRE(cache.saveSnapshot(path, true));
+        REQUIRE(loaded.loadSnapshot(path));
+        CHECK(loaded.size() == 2);
+
+        loaded.setTimeToLive("/api/v3/exchangeInfo", 1h);
+        const auto lookup = loaded.find("/api/v3/exchangeInfo", "/api/v3/exchangeInfo?", 10, now + 1min);
+        REQUIRE(lookup.body != nullptr);
+        CHECK(*lookup.body == R"({"symbols":[]})");
+
+        // Truncated files are rejected as a whole
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+        binapi::ResponseCache truncated;
+        CHECK_FALSE(truncated.loadSnapshot(path));
+        CHECK(truncated.size() == 0);
+
+        std::filesystem::remove(path);
+    }
+}
+
+TEST_CASE("BinanceAPI: Request coalescing")
+{
+    using namespace std::chrono_literals;
+
+    std::atomic_bool release { false };
+    tests::MockHTTPSServer server([&](std::string_view requestLine) {
+        // Holds the first call until every other one is waiting for it
+        while (requestLine.find("symbol=BTCUSDT") != std::string_view::npos && !release)
+            std::this_thread::sleep_for(1ms);
+        return tests::MockResponse { .body = R"({"symbol":"BTCUSDT"})" };
+    });
+
+    MockBinanceAPI api(server.url(), &unlimited());
+    auto *coalescer = api.getRequestCoalescer();
+
+    auto req       = makeRequest("/api/v3/ticker/24hr");
+    req.callWeight = 2;
+
+    SECTION("Identical calls share one transfer")
+    {
+        constexpr int callers = 8;
+
+        std::atomic_int parsed { 0 };
+        std::vector<std::thread> threads;
+        for (int i = 0; i < callers; ++i)
+        {
+            threads.emplace_back([&] {
+                const auto document = api.call(req, { { "symbol", "BTCUSDT" } });
+                parsed += document.HasMember("symbol");
+            });
+        }
+
+        while (coalescer->getMetrics().coalesced < callers - 1)
+            std::this_thread::sleep_for(1ms);
+        release = true;
+
+        for (auto &thread : threads)
+            thread.join();
+
+        CHECK(parsed == callers);
+        CHECK(server.requests() == 1);
+        CHECK(coalescer->inFlight() == 0);
+
+        const auto metrics = coalescer->getMetrics(req.endPoint);
+        CHECK(metrics.transferred == 1);
+        CHECK(metrics.weightSaved == 2 * (callers - 1));
+    }
+
+    SECTION("Calls one after the other are all transferred")
+    {
+        CHECK_NOTHROW(api.call(req, { { "symbol", "ETHUSDT" } }));
+        CHECK_NOTHROW(api.call(req, { { "symbol", "ETHUSDT" } }));
+        CHECK(server.requests() == 2);
+        CHECK(coalescer->getMetrics().coalesced == 0);
+    }
+
+    SECTION("A call only waits for an identical call of its class or a higher one")
+    {
+        using binapi::RequestPriority;
+
+        binapi::RequestCoalescer flights;
+        const auto respond = [](std::string text) {
+            cpr::Response response;
+            response.text = std::move(text);
+            return response;
+        };
+
+        // A background call still in flight, e.g. waiting for its weight
+        std::promise<void> started;
+        std::promise<void> finish;
+        std::thread background([&] {
+            CHECK(flights.run("/api/v3/depth", "key", 1, RequestPriority::background, [&] {
+                started.set_value();
+                finish.get_future().wait();
+                return respond("background");
+            }).text == "background");
+        });
+        started.get_future().wait();
+
+        // The interactive call makes its own transfer, and a later background call joins it
+        std::promise<void> joined;
+        std::thread follower;
+        const auto interactive = flights.run("/api/v3/depth", "key", 1, RequestPriority::interactive, [&] {
+            CHECK(flights.inFlight() == 2);
+            follower = std::thread([&] {
+                CHECK(flights.run("/api/v3/depth", "key", 1, RequestPriority::background, [&] { return respond("transferred"); }).text == "interactive");
+            });
+            while (flights.getMetrics().coalesced == 0)
+                std::this_thread::sleep_for(1ms);
+            return respond("interactive");
+        });
+        CHECK(interactive.text == "interactive");
+
+        follower.join();
+        finish.set_value();
+        background.join();
+
+        CHECK(flights.inFlight() == 0);
+        CHECK(flights.getMetrics().transferred == 2);
+        CHECK(flights.getMetrics().coalesced == 1);
+    }
+}
+
+TEST_CASE("BinanceAPI: Request metrics")
+{
+    using namespace std::chrono_literals;
+    using binapi::LatencyHistogram;
+    using binapi::RequestPhase;
+
+    SECTION("Histogram buckets")
+    {
+        for (std::size_t bucket = 1; bucket < LatencyHistogram::bucketCount; ++bucket)
+            CHECK(LatencyHistogram::lowerBound(bucket) == LatencyHistogram::upperBound(bucket - 1) + 1);
+
+        // 16 buckets per power of two: 6.25% at most
+        for (uint64_t value : { 31ull, 32ull, 1000ull, 123456ull, 99999999ull })
+        {
+            const auto bucket = LatencyHistogram::bucketOf(value);
+            CHECK(LatencyHistogram::lowerBound(bucket) <= value);
+            CHECK(LatencyHistogram::upperBound(bucket) >= value);
+            CHECK(static_cast<double>(LatencyHistogram::upperBound(bucket) - value) <= 0.0625 * static_cast<double>(value));
+        }
+
+        CHECK(LatencyHistogram::bucketOf(std::numeric_limits<uint64_t>::max()) == LatencyHistogram::bucketCount - 1);
+    }
+
+    SECTION("Percentiles")
+    {
+        LatencyHistogram histogram;
+        for (int i = 1; i <= 1000; ++i)
+            histogram.record(std::chrono::microseconds { i * 100 });
+
+        const auto snapshot = histogram.snapshot();
+        CHECK(snapshot.count == 1000);
+        CHECK(snapshot.max == 100'000);
+        CHECK(snapshot.mean() == 50'050us);
+        CHECK(snapshot.percentile(0.5) >= 50'000us);
+        CHECK(snapshot.percentile(0.5) <= 53'125us);
+        CHECK(snapshot.percentile(1.0) == 100'000us);
+    }
+
+    SECTION("Calls through the REST layer")
+    {
+        tests::MockHTTPSServer server([](std::string_view requestLine) {
+            if (requestLine.find("symbol=UNKNOWN") != std::string_view::npos)
+                return tests::MockResponse { .status = 400, .body = R"({"code":-1121,"msg":"Invalid symbol."})" };
+            return tests::MockResponse { .body = R"({})" };
+        });
+
+        MockBinanceAPI api(server.url(), &unlimited());
+        auto req       = makeRequest("/api/v3/ticker/price");
+        req.callWeight = 2;
+
+        CHECK_NOTHROW(api.call(req, { { "symbol", "BTCUSDT" } }));
+        CHECK_NOTHROW(api.call(req, { { "symbol", "BTCUSDT" } }));
+        CHECK_THROWS_AS(api.call(req, { { "symbol", "UNKNOWN" } }), binapi::APIException);
+
+        const auto metrics = api.getRequestMetrics()->snapshot(req.endPoint);
+        REQUIRE(metrics.has_value());
+        CHECK(metrics->transfers == 3);
+        CHECK(metrics->weight == 6);
+        CHECK(metrics->errorCount(binapi::APIException::Type::http2) == 1);
+        CHECK(metrics->phase(RequestPhase::total).count == 3);
+        CHECK(metrics->phase(RequestPhase::parse).count == 2);
+
+        // Only the first call made the TLS handshake
+        const auto &tls = metrics->phase(RequestPhase::tls);
+        CHECK(tls.count == 3);
+        CHECK(tls.max > 0);
+        CHECK(tls.percentile(0.5) == 0us);
+
+        CHECK_FALSE(api.getRequestMetrics()->snapshot("/api/v3/depth").has_value());
+    }
+
+    SECTION("A typed call read again as a document is parsed once")
+    {
+        tests::MockHTTPSServer server([](std::string_view) {
+            return tests::MockResponse { .body = R"({"code":-1121,"msg":"Invalid symbol."})" };
+        });
+
+        MockBinanceAPI api(server.url(), &unlimited());
+        const auto req = makeRequest("/api/v3/klines");
+
+        binapi::local::CandlestickHandler handler;
+        CHECK_THROWS_AS(api.callTyped(req, handler), binapi::APIException);
+
+        const auto metrics = api.getRequestMetrics()->snapshot(req.endPoint);
+        REQUIRE(metrics.has_value());
+        CHECK(metrics->errorCount(binapi::APIException::Type::api) == 1);
+        CHECK(metrics->phase(RequestPhase::total).count == 1);
+        CHECK(metrics->phase(RequestPhase::parse).count == 1);
+    }
+}
+
+TEST_CASE("BinanceAPI: WebSocket messages parsed in situ")
+{
+    // A message as big as !ticker@arr, received in pieces into a buffer that is reused, as WSThread does
+    const std::string json = makeTicker24hr(2000);
+    std::string buffer;
+    buffer.reserve(json.size());
+
+    const auto receive = [&json, &buffer]() {
+        buffer.clear();
+        for (std::size_t offset = 0; offset < json.size(); offset += 4096)
+            buffer.append(json, offset, 4096);
+    };
+
+    receive();
+    {
+        binapi::local::ResponseDocument document(buffer.data(), buffer.size());
+        REQUIRE_FALSE(document.HasParseError());
+        REQUIRE(document.Size() == 2000);
+
+        // The strings point into the message
+        const auto symbol = binapi::jsonToView(document[1999]["symbol"]);
+        CHECK(symbol == "SYM1999");
+        CHECK(symbol.data() >= buffer.data());
+        CHECK(symbol.data() < buffer.data() + buffer.size());
+    }
+}
+
+namespace
+{
+    /// Records the events of a WSReactor connection
+    class RecordingHandler final : public binapi::ws::WSReactor::Handler
+    {
+    public:
+        auto event([[maybe_unused]] lws *wsi, lws_callback_reasons reason, void *in, std::size_t len) -> int override
+        {
+            ++events;
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wswitch-enum"
+#endif /*__clang__*/
+            switch (reason)
+            {
+                case LWS_CALLBACK_CLIENT_ESTABLISHED: ++established; break;
+                case LWS_CALLBACK_CLIENT_CONNECTION_ERROR: ++errors; break;
+                case LWS_CALLBACK_CLIENT_RECEIVE:
+                    {
+                        std::scoped_lock lock(m_mutex);
+                        m_received.emplace_back(static_cast<const char *>(in), len);
+                    }
+                    break;
+                default: break;
+            }
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif /*__clang__*/
+            return 0;
+        }
+
+        auto finished() noexcept -> void override { ++finishedCount; }
+
+        auto pull() -> std::optional<std::string> override
+        {
+            std::scoped_lock lock(m_mutex);
+            if (m_outgoing.empty())
+                return std::nullopt;
+            auto message = std::move(m_outgoing.front());
+            m_outgoing.erase(m_outgoing.begin());
+            return message;
+        }
+
+        /// Messages returned by pull
+        auto queue(std::vector<std::string> messages) -> void
+        {
+            std::scoped_lock lock(m_mutex);
+            m_outgoing.insert(m_outgoing.end(), messages.begin(), messages.end());
+        }
+
+        auto received() const -> std::vector<std::string>
+        {
+            std::scoped_lock lock(m_mutex);
+            return m_received;
+        }
+
+    public:
+        std::atomic_int events { 0 };
+        std::atomic_int established { 0 };
+        std::atomic_int errors { 0 };
+        std::atomic_int finishedCount { 0 };
+
+    private:
+        mutable std::mutex m_mutex;
+        std::vector<std::string> m_received;
+        std::vector<std::string> m_outgoing;
+    };
+
+    /// A stream of the mock server
+    class TestStream final : public binapi::ws::WSThread
+    {
+    public:
+        TestStream(const tests::MockWSServer &server, binapi::ws::WSReactor &reactor) :
+            WSThread(server.host(), "/ws", server.port(), reactor) { }
+
+        ~TestStream() override
+        {
+            terminate();
+            wait();
+        }
+
+        auto connected() -> void override
+        {
+            ++connections;
+            if (onConnected)
+                onConnected(*this);
+        }
+        auto close() -> void override { ++closes; }
+        auto connectionError() -> void override { ++errors; }
+        void pingSent([[maybe_unused]] bool success) noexcept override { }
+
+        void reconnecting(uint32_t attempt, std::chrono::milliseconds delay) noexcept override
+        {
+            std::scoped_lock lock(m_mutex);
+            m_attempts.emplace_back(attempt, delay);
+        }
+
+        auto attempts() const -> std::vector<std::pair<uint32_t, std::chrono::milliseconds>>
+        {
+            std::scoped_lock lock(m_mutex);
+            return m_attempts;
+        }
+
+        auto received() const -> std::vector<std::string>
+        {
+            std::scoped_lock lock(m_mutex);
+            return m_received;
+        }
+
+        using WSThread::sendData;
+
+    protected:
+        auto receivedData() -> void override
+        {
+            const auto message = getMessage();
+            std::scoped_lock lock(m_mutex);
+            m_received.emplace_back(message.data(), message.size());
+        }
+
+    public:
+        /// Called from connected(), on the service thread
+        std::function<void(TestStream &)> onConnected;
+        std::atomic_int connections { 0 };
+        std::atomic_int closes { 0 };
+        std::atomic_int errors { 0 };
+
+    private:
+        mutable std::mutex m_mutex;
+        std::vector<std::pair<uint32_t, std::chrono::milliseconds>> m_attempts;
+        std::vector<std::string> m_received;
+    };
+} // namespace
+
+TEST_CASE("BinanceAPI: WebSocket reactor")
+{
+    using namespace std::chrono_literals;
+    using binapi::ws::WSReactor;
+    using tests::waitUntil;
+
+    tests::MockWSServer server([](std::string_view message) { return std::vector<std::string> { "echo:" + std::string { message } }; });
+    // Destroyed after the reactor, which may be calling it until then
+    RecordingHandler handler;
+    WSReactor reactor { 1 };
+    const WSReactor::Endpoint endpoint { .address = server.host(), .path = "/ws", .port = server.port() };
+
+    SECTION("Connect, send, receive and close")
+    {
+        const auto id = reactor.connect(endpoint, &handler);
+        REQUIRE(waitUntil([&handler] { return handler.established == 1; }));
+        CHECK(reactor.connections() == 1);
+
+        CHECK(reactor.send(id, "hello"));
+        REQUIRE(waitUntil([&handler] { return !handler.received().empty(); }));
+        CHECK(handler.received() == std::vector<std::string> { "echo:hello" });
+        CHECK(server.messages() == std::vector<std::string> { "hello" });
+
+        reactor.close(id);
+        REQUIRE(waitUntil([&handler] { return handler.finishedCount == 1; }));
+        CHECK(reactor.connections() == 0);
+        CHECK(waitUntil([&server] { return server.open() == 0; }));
+        CHECK_FALSE(reactor.send(id, "late"));
+    }
+
+    SECTION("Messages pulled from the handler")
+    {
+        // Asked for as soon as the connection is established
+        handler.queue({ "a", "b" });
+        const auto id = reactor.connect(endpoint, &handler);
+        REQUIRE(waitUntil([&server] { return server.messages().size() == 2; }));
+
+        handler.queue({ "c" });
+        reactor.wake(id);
+        REQUIRE(waitUntil([&server] { return server.messages().size() == 3; }));
+        CHECK(server.messages() == std::vector<std::string> { "a", "b", "c" });
+
+        reactor.close(id);
+        CHECK(waitUntil([&handler] { return handler.finishedCount == 1; }));
+    }
+
+    SECTION("A connection lost is finished")
+    {
+        reactor.connect(endpoint, &handler);
+        REQUIRE(waitUntil([&handler] { return handler.established == 1; }));
+
+        server.dropAll();
+        REQUIRE(waitUntil([&handler] { return handler.finishedCount == 1; }));
+        CHECK(reactor.connections() == 0);
+    }
+
+    SECTION("A connection that fails to open is finished")
+    {
+        server.setRefusing(true);
+        reactor.connect(endpoint, &handler);
+        REQUIRE(waitUntil([&handler] { return handler.finishedCount == 1; }));
+        CHECK(handler.errors == 1);
+        CHECK(handler.established == 0);
+        CHECK(reactor.connections() == 0);
+    }
+
+    SECTION("A detached connection does not call its handler again")
+    {
+        const auto id = reactor.connect(endpoint, &handler);
+        REQUIRE(waitUntil([&handler] { return handler.established == 1; }));
+
+        reactor.detach(id);
+        const int events = handler.events;
+        server.broadcast("ignored");
+
+        REQUIRE(waitUntil([&reactor] { return reactor.connections() == 0; }));
+        CHECK(waitUntil([&server] { return server.open() == 0; }));
+        CHECK(handler.events == events);
+        CHECK(handler.finishedCount == 0);
+        CHECK(handler.received().empty());
+    }
+
+    SECTION("A delayed connection opens when its delay expires")
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const auto id    = reactor.connect(endpoint, &handler, 300ms);
+        CHECK(reactor.connections() == 1);
+
+        std::this_thread::sleep_for(100ms);
+        CHECK(server.connections() == 0);
+
+        REQUIRE(waitUntil([&handler] { return handler.established == 1; }));
+        CHECK(std::chrono::steady_clock::now() - start >= 300ms);
+        CHECK(server.connections() == 1);
+
+        reactor.close(id);
+        CHECK(waitUntil([&handler] { return handler.finishedCount == 1; }));
+    }
+
+    SECTION("A delayed connection closed before its delay finishes at once")
+    {
+        const auto id    = reactor.connect(endpoint, &handler, 1h);
+        const auto start = std::chrono::steady_clock::now();
+        reactor.close(id);
+
+        REQUIRE(waitUntil([&handler] { return handler.finishedCount == 1; }));
+        CHECK(std::chrono::steady_clock::now() - start < 1s);
+        CHECK(handler.established == 0);
+        CHECK(reactor.connections() == 0);
+        CHECK(server.connections() == 0);
+    }
+
+    SECTION("A connection closed while connecting finishes at once")
+    {
+        // The handshake never completes, so only the close can end the connection before the connect timeout
+        server.setStalling(true);
+        const auto id = reactor.connect(endpoint, &handler);
+        REQUIRE(waitUntil([&server] { return server.stalled() == 1; }));
+
+        const auto start = std::chrono::steady_clock::now();
+        reactor.close(id);
+
+        REQUIRE(waitUntil([&handler] { return handler.finishedCount == 1; }));
+        CHECK(std::chrono::steady_clock::now() - start < 1s);
+        CHECK(handler.established == 0);
+        CHECK(reactor.connections() == 0);
+    }
+
+    SECTION("A delayed connection detached before its delay never opens")
+    {
+        const auto id = reactor.connect(endpoint, &handler, 100ms);
+        reactor.detach(id);
+
+        REQUIRE(waitUntil([&reactor] { return reactor.connections() == 0; }));
+        std::this_thread::sleep_for(200ms);
+        CHECK(server.connections() == 0);
+        CHECK(handler.events == 0);
+        CHECK(handler.finishedCount == 0);
+    }
+
+    SECTION("Waiting for a connection from a callback throws")
+    {
+        std::atomic_bool threw { false };
+        TestStream stream(server, reactor);
+        stream.onConnected = [&threw](TestStream &self) {
+            try
+            {
+                self.wait();
+            }
+            catch (const std::logic_error &)
+            {
+                threw = true;
+            }
+        };
+
+        stream.start();
+        REQUIRE(waitUntil([&stream] { return stream.connections == 1; }));
+        CHECK(threw);
+
+        stream.terminate();
+        stream.wait();
+        CHECK_FALSE(stream.isRunning());
+    }
+}
+
+TEST_CASE("BinanceAPI: Stream reconnection")
+{
+    using namespace std::chrono_literals;
+    using tests::waitUntil;
+
+    tests::MockWSServer server([](std::string_view message) { return std::vector<std::string> { "echo:" + std::string { message } }; });
+    binapi::ws::WSReactor reactor { 1 };
+    TestStream stream(server, reactor);
+
+    // Bounds of the n-th delay: between half and all of min(initial * 2^(n - 1), maximum)
+    const auto inBounds = [](uint32_t attempt, std::chrono::milliseconds delay, std::chrono::milliseconds initial, std::chrono::milliseconds maximum) {
+        auto bound = initial;
+        for (uint32_t i = 1; i < attempt && bound < maximum; ++i)
+            bound *= 2;
+        bound = std::min(bound, maximum);
+        return delay >= bound / 2 && delay <= bound;
+    };
+
+    SECTION("A connection lost is opened again after a delay")
+    {
+        stream.setReconnection(true, 200ms, 1s);
+        stream.start();
+        REQUIRE(waitUntil([&stream] { return stream.connections == 1; }));
+
+        server.dropAll();
+        REQUIRE(waitUntil([&stream] { return stream.attempts().size() == 1; }));
+        const auto [attempt, delay] = stream.attempts().front();
+        CHECK(attempt == 1);
+        CHECK(inBounds(attempt, delay, 200ms, 1s));
+        CHECK(stream.isReconnecting());
+        CHECK(stream.closes == 1);
+
+        // WSThread::finished asked the reactor for a delayed connection: nothing is opened before the delay
+        const auto lost = std::chrono::steady_clock::now();
+        REQUIRE(waitUntil([&stream] { return stream.connections == 2; }));
+        CHECK(std::chrono::steady_clock::now() - lost >= delay - 20ms);
+        CHECK(server.connections() == 2);
+        CHECK_FALSE(stream.isReconnecting());
+
+        // The same object receives from the new connection
+        stream.sendData("again");
+        CHECK(waitUntil([&stream] { return stream.received() == std::vector<std::string> { "echo:again" }; }));
+    }
+
+    SECTION("The delays grow while the connection fails and start over once it is established")
+    {
+        stream.setReconnection(true, 20ms, 80ms);
+        stream.start();
+        REQUIRE(waitUntil([&stream] { return stream.connections == 1; }));
+
+        server.setRefusing(true);
+        server.dropAll();
+        REQUIRE(waitUntil([&stream] { return stream.attempts().size() >= 4; }));
+        server.setRefusing(false);
+        REQUIRE(waitUntil([&stream] { return stream.connections == 2; }));
+
+        const auto failing = stream.attempts();
+        CHECK(stream.errors >= 3);
+        for (std::size_t i = 0; i < failing.size(); ++i)
+        {
+            CHECK(failing[i].first == i + 1);
+            CHECK(inBounds(failing[i].first, failing[i].second, 20ms, 80ms));
+        }
+
+        // Established: the next loss is the first attempt again
+        server.dropAll();
+        REQUIRE(waitUntil([&stream, &failing] { return stream.attempts().size() == failing.size() + 1; }));
+        CHECK(stream.attempts().back().first == 1);
+        CHECK(inBounds(1, stream.attempts().back().second, 20ms, 80ms));
+        CHECK(waitUntil([&stream] { return stream.connections == 3; }));
+    }
+
+    SECTION("Terminating while waiting to reconnect does not wait for the delay")
+    {
+        stream.setReconnection(true, 1h, 1h);
+        stream.start();
+        REQUIRE(waitUntil([&stream] { return stream.connections == 1; }));
+
+        server.dropAll();
+        REQUIRE(waitUntil([&stream] { return stream.isReconnecting(); }));
+
+        const auto start = std::chrono::steady_clock::now();
+        stream.terminate();
+        stream.wait();
+        CHECK(std::chrono::steady_clock::now() - start < 1s);
+        CHECK_FALSE(stream.isReconnecting());
+        CHECK(server.connections() == 1);
+    }
+
+    SECTION("Without reconnection a connection lost is finished")
+    {
+        stream.start();
+        REQUIRE(waitUntil([&stream] { return stream.connections == 1; }));
+
+        server.dropAll();
+        stream.wait();
+        CHECK(stream.attempts().empty());
+        CHECK(stream.isTerminated());
+    }
+}
+
+namespace
+{
+    // Stream messages in the proportions of a session subscribed to depth, trades, book tickers, klines and mark prices
+    auto makeMixedStream(std::size_t size) -> std::string
+    {
+        constexpr std::array<std::string_view, 16> events { "depthUpdate", "aggTrade", "depthUpdate", "bookTicker", "depthUpdate", "aggTrade",
+            "kline", "depthUpdate", "bookTicker", "markPriceUpdate", "depthUpdate", "aggTrade", "24hrMiniTicker", "depthUpdate", "continuous_kline", "24hrTicker" };
+        constexpr std::array<std::string_view, 5> intervals { "1m", "5m", "15m", "1h", "1d" };
+
+        std::string json = "[";
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            const auto event = events[i % events.size()];
+            json.append(i == 0 ? "" : ",").append(R"({"e":")").append(event).append(R"(","E":)").append(std::to_string(1660000000000 + i)).append(R"(,"s":"BTCUSDT")");
+            if (event == "kline" || event == "continuous_kline")
+                json.append(R"(,"k":{"i":")").append(intervals[i % intervals.size()]).append(R"("})");
+            json.append("}");
+        }
+        return json.append("]");
+    }
+
+    // The dispatch of the parsers before the tables: a string per message and a chain of comparisons
+    auto dispatchWithStrings(const rapidjson::Value &messages) -> std::size_t
+    {
+        std::size_t sum = 0;
+        for (const auto &value : messages.GetArray())
+        {
+            std::string type { value["e"].GetString(), value["e"].GetStringLength() };
+            if (type == "aggTrade")
+                sum += 1;
+            else if (type == "markPriceUpdate")
+                sum += 2;
+            else if (type == "kline" || type == "continuous_kline")
+            {
+                std::string interval { value["k"]["i"].GetString(), value["k"]["i"].GetStringLength() };
+                if (interval == "1m")
+                    sum += 3;
+                else if (interval == "3m")
+                    sum += 4;
+                else if (interval == "5m")
+                    sum += 5;
+                else if (interval == "15m")
+                    sum += 6;
+                else if (interval == "30m")
+                    sum += 7;
+                else if (interval == "1h")
+                    sum += 8;
+                else if (interval == "2h")
+                    sum += 9;
+                else if (interval == "4h")
+                    sum += 10;
+                else if (interval == "6h")
+                    sum += 11;
+                else if (interval == "8h")
+                    sum += 12;
+                else if (interval == "12h")
+                    sum += 13;
+                else if (interval == "1d")
+                    sum += 14;
+                else if (interval == "3d")
+                    sum += 15;
+                else if (interval == "1w")
+                    sum += 16;
+                else if (interval == "1M")
+                    sum += 17;
+            }
+            else if (type == "24hrMiniTicker")
+                sum += 18;
+            else if (type == "24hrTicker")
+                sum += 19;
+            else if (type == "bookTicker")
+                sum += 20;
+            else if (type == "forceOrder")
+                sum += 21;
+            else if (type == "depthUpdate")
+                sum += 22;
+        }
+        return sum;
+    }
+
+    auto dispatchWithTables(const rapidjson::Value &messages) -> std::size_t
+    {
+        using binapi::ws::StreamEvent;
+
+        std::size_t sum = 0;
+        for (const auto &value : messages.GetArray())
+        {
+            switch (binapi::ws::streamEventOf(binapi::jsonToView(value["e"])))
+            {
+                case StreamEvent::aggTrade: sum += 1; break;
+                case StreamEvent::markPriceUpdate: sum += 2; break;
+                case StreamEvent::kline:
+                case StreamEvent::continuousKline:
+                    if (const auto interval = binapi::ws::timeIntervalOf(binapi::jsonToView(value["k"]["i"])); interval.has_value())
+                        sum += 3 + static_cast<std::size_t>(*interval);
+                    break;
+                case StreamEvent::miniTicker: sum += 18; break;
+                case StreamEvent::ticker: sum += 19; break;
+                case StreamEvent::bookTicker: sum += 20; break;
+                case StreamEvent::forceOrder: sum += 21; break;
+                case StreamEvent::depthUpdate: sum += 22; break;
+                default: break;
+            }
+        }
+        return sum;
+    }
+} // namespace
+
+TEST_CASE("BinanceAPI: Stream event dispatch tables")
+{
+    using binapi::BinanceTimeIntervals;
+    using binapi::ws::StreamEvent;
+
+    SECTION("Events")
+    {
+        CHECK(binapi::ws::streamEventOf("aggTrade") == StreamEvent::aggTrade);
+        CHECK(binapi::ws::streamEventOf("trade") == StreamEvent::trade);
+        CHECK(binapi::ws::streamEventOf("kline") == StreamEvent::kline);
+        CHECK(binapi::ws::streamEventOf("continuous_kline") == StreamEvent::continuousKline);
+        CHECK(binapi::ws::streamEventOf("24hrMiniTicker") == StreamEvent::miniTicker);
+        CHECK(binapi::ws::streamEventOf("24hrTicker") == StreamEvent::ticker);
+        CHECK(binapi::ws::streamEventOf("bookTicker") == StreamEvent::bookTicker);
+        CHECK(binapi::ws::streamEventOf("depthUpdate") == StreamEvent::depthUpdate);
+        CHECK(binapi::ws::streamEventOf("markPriceUpdate") == StreamEvent::markPriceUpdate);
+        CHECK(binapi::ws::streamEventOf("forceOrder") == StreamEvent::forceOrder);
+        CHECK(binapi::ws::streamEventOf("nav") == StreamEvent::nav);
+        CHECK(binapi::ws::streamEventOf("compositeIndex") == StreamEvent::compositeIndex);
+
+        // Same length, first and last character as known events, and empty names
+        CHECK(binapi::ws::streamEventOf("") == StreamEvent::unknown);
+        CHECK(binapi::ws::streamEventOf("bookTicke") == StreamEvent::unknown);
+        CHECK(binapi::ws::streamEventOf("kxxxe") == StreamEvent::unknown);
+        CHECK(binapi::ws::streamEventOf("depthupdate") == StreamEvent::unknown);
+        CHECK(binapi::ws::streamEventOf("ACCOUNT_UPDATE") == StreamEvent::unknown);
+
+        static_assert(binapi::ws::streamEventOf("depthUpdate") == StreamEvent::depthUpdate);
+    }
+
+    SECTION("Intervals")
+    {
+        constexpr std::array<std::pair<std::string_view, BinanceTimeIntervals>, 15> intervals { {
+            { "1m", BinanceTimeIntervals::i1m },
+            { "3m", BinanceTimeIntervals::i3m },
+            { "5m", BinanceTimeIntervals::i5m },
+            { "15m", BinanceTimeIntervals::i15m },
+            { "30m", BinanceTimeIntervals::i30m },
+            { "1h", BinanceTimeIntervals::i1h },
+            { "2h", BinanceTimeIntervals::i2h },
+            { "4h", BinanceTimeIntervals::i4h },
+            { "6h", BinanceTimeIntervals::i6h },
+            { "8h", BinanceTimeIntervals::i8h },
+            { "12h", BinanceTimeIntervals::i12h },
+            { "1d", BinanceTimeIntervals::i1d },
+            { "3d", BinanceTimeIntervals::i3d },
+            { "1w", BinanceTimeIntervals::i1w },
+            { "1M", BinanceTimeIntervals::i1M },
+        } };
+
+        for (const auto &[name, interval] : intervals)
+        {
+            INFO(name);
+            CHECK(binapi::ws::timeIntervalOf(name) == interval);
+        }
+
+        CHECK_FALSE(binapi::ws::timeIntervalOf("").has_value());
+        CHECK_FALSE(binapi::ws::timeIntervalOf("2M").has_value());
+        CHECK_FALSE(binapi::ws::timeIntervalOf("1s").has_value());
+        CHECK_FALSE(binapi::ws::timeIntervalOf("15h").has_value());
+    }
+
+    SECTION("Both dispatches agree on a recorded stream")
+    {
+        const std::string json = makeMixedStream(1000);
+        rapidjson::Document messages;
+        messages.Parse(json.data(), json.size());
+        REQUIRE_FALSE(messages.HasParseError());
+
+        CHECK(dispatchWithTables(messages) == dispatchWithStrings(messages));
+    }
+}
+
+TEST_CASE("BinanceAPI: Stream event dispatch tables benchmark")
+{
+    const std::string json = makeMixedStream(10000);
+    rapidjson::Document messages;
+    messages.Parse(json.data(), json.size());
+
+    BENCHMARK("Mixed stream, std::string + if/else chains")
+    {
+        return dispatchWithStrings(messages);
+    };
+
+    BENCHMARK("Mixed stream, perfect hash tables")
+    {
+        return dispatchWithTables(messages);
+    };
+}
+
+TEST_CASE("BinanceAPI: Stream multiplexer assignment")
+{
+    using binapi::ws::WSSpotMultiplexer;
+
+    SECTION("Symbols of the streams")
+    {
+        CHECK(WSSpotMultiplexer::symbolOf("btcusdt@depth@100ms") == "btcusdt");
+        CHECK(WSSpotMultiplexer::symbolOf("btcusdt@aggTrade") == "btcusdt");
+        CHECK(WSSpotMultiplexer::symbolOf("ethusdt@kline_1m") == "ethusdt");
+        CHECK(WSSpotMultiplexer::symbolOf("!miniTicker@arr") == "!miniTicker@arr");
+        CHECK(WSSpotMultiplexer::symbolOf("btcusdt") == "btcusdt");
+    }
+
+    // Depth and trades of 1500 symbols
+    std::map<std::string, std::size_t> symbols;
+    for (int i = 0; i < 1500; ++i)
+        symbols.emplace("sym" + std::to_string(i) + "usdt", 2);
+
+    SECTION("Every connection is below its capacity and none is much busier")
+    {
+        constexpr std::size_t connections = 5;
+        constexpr std::size_t capacity    = 1024;
+
+        const auto assignment = WSSpotMultiplexer::assign(symbols, connections, capacity);
+        REQUIRE(assignment.size() == symbols.size());
+
+        std::vector<std::size_t> loads(connections, 0);
+        for (const auto &[symbol, connection] : assignment)
+        {
+            REQUIRE(connection < connections);
+            loads[connection] += symbols.at(symbol);
+        }
+
+        for (const auto load : loads)
+        {
+            CHECK(load <= capacity);
+            CHECK(load > 3000 / connections / 2);
+        }
+    }
+
+    SECTION("Adding a connection only moves the symbols it takes")
+    {
+        // Plenty of room, so the capacity does not move anything
+        const auto before = WSSpotMultiplexer::assign(symbols, 4, 4096);
+        const auto after  = WSSpotMultiplexer::assign(symbols, 5, 4096);
+
+        std::size_t moved = 0;
+        for (const auto &[symbol, connection] : after)
+        {
+            if (connection != before.at(symbol))
+            {
+                CHECK(connection == 4);
+                ++moved;
+            }
+        }
+
+        // About a fifth of the symbols
+        CHECK(moved > symbols.size() / 10);
+        CHECK(moved < symbols.size() * 3 / 10);
+    }
+
+    SECTION("The assignment does not depend on the instance")
+    {
+        CHECK(WSSpotMultiplexer::assign(symbols, 3, 1024) == WSSpotMultiplexer::assign(symbols, 3, 1024));
+        CHECK(WSSpotMultiplexer::assign({}, 3, 1024).empty());
+        CHECK(WSSpotMultiplexer::assign(symbols, 0, 1024).empty());
+    }
+}
+
+namespace
+{
+    /// aggTrade streams of the symbols [first, last)
+    auto tradeStreams(int first, int last) -> std::vector<std::string>
+    {
+        std::vector<std::string> streams;
+        for (int i = first; i < last; ++i)
+            streams.push_back("sym" + std::to_string(i) + "usdt@aggTrade");
+        return streams;
+    }
+
+    /// Answers every (un)subscription with success, as Binance does
+    auto answerSubscriptions(std::string_view message) -> std::vector<std::string>
+    {
+        const auto id = message.substr(message.rfind(R"("id":)") + 5);
+        return { R"({"result":null,"id":)" + std::string { id.substr(0, id.find('}')) } + "}" };
+    }
+
+    /// A multiplexer of the mock server, with room for 6 streams per connection
+    class TestMultiplexer final : public binapi::ws::WSSpotMultiplexer
+    {
+    public:
+        TestMultiplexer(const tests::MockWSServer &server, binapi::ws::WSReactor &reactor) :
+            WSSpotMultiplexer(1, 8, reactor)
+        {
+            setHost(server.host(), server.port());
+        }
+
+        ~TestMultiplexer() override
+        {
+            terminate();
+        }
+
+    public:
+        /// Called from connected(), on the service thread
+        std::function<void(TestMultiplexer &, std::size_t)> onConnected;
+        /// Called from subscriptionFailed(), on the service thread
+        std::function<void(const std::vector<std::string> &)> onSubscriptionFailed;
+
+    protected:
+        void connected(std::size_t connection) override
+        {
+            if (onConnected)
+                onConnected(*this, connection);
+        }
+
+        void subscriptionFailed(const std::vector<std::string> &streams) override
+        {
+            if (onSubscriptionFailed)
+                onSubscriptionFailed(streams);
+        }
+    };
+} // namespace
+
+TEST_CASE("BinanceAPI: Stream multiplexer rebalance")
+{
+    using tests::waitUntil;
+
+    tests::MockWSServer server(answerSubscriptions);
+    binapi::ws::WSReactor reactor { 1 };
+    TestMultiplexer multiplexer(server, reactor);
+
+    // Positions, in the messages received by the server, of the requests of method with the stream
+    const auto positions = [&server](std::string_view method, const std::string &stream) {
+        const auto messages = server.messages();
+        std::vector<std::size_t> found;
+        for (std::size_t i = 0; i < messages.size(); ++i)
+        {
+            if (messages[i].find(R"("method":")" + std::string { method } + '"') != std::string::npos && messages[i].find('"' + stream + '"') != std::string::npos)
+                found.push_back(i);
+        }
+        return found;
+    };
+
+    multiplexer.subscribe(tradeStreams(0, 6));
+    CHECK(multiplexer.connections() == 1);
+    REQUIRE(waitUntil([&positions] { return positions("SUBSCRIBE", "sym5usdt@aggTrade").size() == 1; }));
+
+    SECTION("Growing fills the connections up to three quarters of their capacity")
+    {
+        multiplexer.subscribe(tradeStreams(6, 12));
+        REQUIRE(multiplexer.connections() == 2);
+        CHECK(multiplexer.streams() == 12);
+        CHECK(multiplexer.streams(0) + multiplexer.streams(1) == 12);
+        CHECK(multiplexer.streams(0) <= 6);
+        CHECK(multiplexer.streams(1) <= 6);
+        CHECK(waitUntil([&server] { return server.open() == 2; }));
+    }
+
+    SECTION("A moved symbol is subscribed on its new connection before it is unsubscribed from the old one")
+    {
+        multiplexer.subscribe(tradeStreams(6, 12));
+
+        std::vector<std::string> moved;
+        for (const auto &stream : tradeStreams(0, 6))
+        {
+            if (multiplexer.connectionOf(stream) == 1u)
+                moved.push_back(stream);
+        }
+        REQUIRE_FALSE(moved.empty());
+
+        for (const auto &stream : moved)
+        {
+            REQUIRE(waitUntil([&positions, &stream] { return !positions("UNSUBSCRIBE", stream).empty(); }));
+            const auto subscriptions = positions("SUBSCRIBE", stream);
+            REQUIRE(subscriptions.size() == 2);
+            CHECK(subscriptions[1] < positions("UNSUBSCRIBE", stream).front());
+        }
+
+        // The symbols that stay are not touched
+        for (const auto &stream : tradeStreams(0, 6))
+        {
+            if (multiplexer.connectionOf(stream) == 0u)
+                CHECK(positions("SUBSCRIBE", stream).size() == 1);
+        }
+    }
+
+    SECTION("Shrinking closes the connection left over once its streams are moved")
+    {
+        multiplexer.subscribe(tradeStreams(6, 12));
+        REQUIRE(waitUntil([&server] { return server.open() == 2; }));
+
+        multiplexer.unsubscribe(tradeStreams(3, 12));
+        CHECK(multiplexer.connections() == 1);
+        CHECK(multiplexer.streams() == 3);
+        CHECK(multiplexer.streams(0) == 3);
+        for (const auto &stream : tradeStreams(0, 3))
+            CHECK(multiplexer.connectionOf(stream) == 0u);
+
+        CHECK(waitUntil([&server] { return server.open() == 1; }));
+
+        // And grows again
+        multiplexer.subscribe(tradeStreams(3, 12));
+        CHECK(multiplexer.connections() == 2);
+        CHECK(waitUntil([&server] { return server.open() == 2; }));
+    }
+
+    SECTION("A connection lost subscribes its streams again")
+    {
+        for (const auto &stream : tradeStreams(0, 6))
+            REQUIRE(waitUntil([&positions, &stream] { return positions("SUBSCRIBE", stream).size() == 1; }));
+
+        server.dropAll();
+        for (const auto &stream : tradeStreams(0, 6))
+            CHECK(waitUntil([&positions, &stream] { return positions("SUBSCRIBE", stream).size() == 2; }));
+        CHECK(server.connections() == 2);
+        CHECK(multiplexer.connections() == 1);
+    }
+
+    SECTION("A callback can remove its own connection")
+    {
+        // The shard can not be destroyed in its own callback: it is closed there and destroyed later
+        multiplexer.onConnected = [](TestMultiplexer &self, std::size_t connection) {
+            if (connection == 1)
+                self.unsubscribe(tradeStreams(3, 12));
+        };
+        multiplexer.subscribe(tradeStreams(6, 12));
+
+        REQUIRE(waitUntil([&multiplexer] { return multiplexer.connections() == 1; }));
+        CHECK(multiplexer.streams(0) == 3);
+        CHECK(waitUntil([&server] { return server.open() == 1; }));
+        CHECK(waitUntil([&positions] { return !positions("UNSUBSCRIBE", "sym4usdt@aggTrade").empty(); }));
+    }
+}
+
+TEST_CASE("BinanceAPI: Stream multiplexer subscription failures")
+{
+    using namespace std::chrono_literals;
+    using tests::waitUntil;
+
+    const std::string rejected { "badusdt@aggTrade" };
+
+    // Subscriptions of the rejected stream answered with an error, before they are accepted
+    std::atomic_int rejections { 0 };
+    tests::MockWSServer server([&rejections, &rejected](std::string_view message) -> std::vector<std::string> {
+        if (message.find(R"("method":"SUBSCRIBE")") == std::string_view::npos || message.find('"' + rejected + '"') == std::string_view::npos || rejections-- <= 0)
+            return answerSubscriptions(message);
+
+        const auto id = message.substr(message.rfind(R"("id":)") + 5);
+        return { R"({"error":{"code":2,"msg":"Invalid request"},"id":)" + std::string { id.substr(0, id.find('}')) } + "}" };
+    });
+    binapi::ws::WSReactor reactor { 1 };
+    TestMultiplexer multiplexer(server, reactor);
+
+    std::mutex failedMutex;
+    std::vector<std::string> failed;
+    multiplexer.onSubscriptionFailed = [&failedMutex, &failed](const std::vector<std::string> &streams) {
+        std::scoped_lock lock(failedMutex);
+        failed.insert(failed.end(), streams.begin(), streams.end());
+    };
+    const auto failedStreams = [&failedMutex, &failed] {
+        std::scoped_lock lock(failedMutex);
+        return failed;
+    };
+
+    // SUBSCRIBE messages received by the server with the stream
+    const auto subscriptions = [&server](const std::string &stream) {
+        const auto messages = server.messages();
+        return static_cast<std::size_t>(std::ranges::count_if(messages, [&stream](const std::string &message) {
+            return message.find(R"("method":"SUBSCRIBE")") != std::string::npos && message.find('"' + stream + '"') != std::string::npos;
+        }));
+    };
+
+    multiplexer.subscribe(tradeStreams(0, 3));
+    REQUIRE(waitUntil([&subscriptions] { return subscriptions("sym2usdt@aggTrade") == 1; }));
+
+    SECTION("A rejected subscription is sent again")
+    {
+        rejections = 1;
+        multiplexer.subscribe(rejected);
+
+        REQUIRE(waitUntil([&subscriptions, &rejected] { return subscriptions(rejected) == 2; }));
+        std::this_thread::sleep_for(100ms);
+        CHECK(subscriptions(rejected) == 2);
+        CHECK(multiplexer.connectionOf(rejected) == 0u);
+        CHECK(multiplexer.streams(0) == 4);
+        CHECK(failedStreams().empty());
+    }
+
+    SECTION("A stream always rejected is forgotten")
+    {
+        rejections = 1000;
+        multiplexer.subscribe(rejected);
+
+        REQUIRE(waitUntil([&failedStreams] { return !failedStreams().empty(); }));
+        CHECK(failedStreams() == std::vector<std::string> { rejected });
+        CHECK(subscriptions(rejected) == binapi::ws::WSSpotMultiplexer::subscriptionAttempts);
+        CHECK_FALSE(multiplexer.connectionOf(rejected).has_value());
+        CHECK(multiplexer.streams() == 3);
+        CHECK(multiplexer.streams(0) == 3);
+    }
+}
+
+TEST_CASE("BinanceAPI: Stream subscriptions")
+{
+    using binapi::ws::WSSubscriptions;
+    using State = WSSubscriptions::State;
+
+    int wakes = 0;
+    WSSubscriptions subscriptions([&wakes] { ++wakes; }, 200);
+
+    SECTION("Requests made meanwhile go in one message")
+    {
+        std::vector<std::future<bool>> confirmed;
+        for (int i = 0; i < 300; ++i)
+            confirmed.push_back(subscriptions.subscribe({ "sym" + std::to_string(i) + "usdt@depth@100ms" }).confirmed);
+
+        CHECK(wakes == 300);
+        CHECK(subscriptions.queued() == 300);
+        CHECK(subscriptions.state("sym7usdt@depth@100ms") == State::pending);
+
+        const auto first  = subscriptions.nextMessage();
+        const auto second = subscriptions.nextMessage();
+        REQUIRE(first.has_value());
+        REQUIRE(second.has_value());
+        CHECK_FALSE(subscriptions.nextMessage().has_value());
+
+        CHECK(first->starts_with(R"({"method":"SUBSCRIBE","params":["sym0usdt@depth@100ms","sym1usdt@depth@100ms",)"));
+        CHECK(first->ends_with(R"("sym199usdt@depth@100ms"],"id":1})"));
+        CHECK(second->ends_with(R"("sym299usdt@depth@100ms"],"id":2})"));
+
+        const auto completions = subscriptions.confirm(1, true);
+        REQUIRE(completions.has_value());
+        CHECK(completions->size() == 200);
+        CHECK(confirmed[0].wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+        CHECK(confirmed[0].get());
+        CHECK(confirmed[250].wait_for(std::chrono::seconds(0)) == std::future_status::timeout);
+        CHECK(subscriptions.state("sym7usdt@depth@100ms") == State::active);
+
+        CHECK(subscriptions.confirm(2, false).has_value());
+        CHECK_FALSE(confirmed[250].get());
+        CHECK_FALSE(subscriptions.state("sym250usdt@depth@100ms").has_value());
+        CHECK(subscriptions.streams(State::failed).empty());
+
+        CHECK_FALSE(subscriptions.confirm(2, true).has_value());
+        CHECK_FALSE(subscriptions.confirm(77, true).has_value());
+    }
+
+    SECTION("A request answered in several messages")
+    {
+        WSSubscriptions small([] {}, 2);
+        auto ticket = small.subscribe({ "a@trade", "b@trade", "c@trade" });
+
+        REQUIRE(small.nextMessage() == R"({"method":"SUBSCRIBE","params":["a@trade","b@trade"],"id":1})");
+        REQUIRE(small.nextMessage() == R"({"method":"SUBSCRIBE","params":["c@trade"],"id":2})");
+
+        const auto first = small.confirm(1, true);
+        REQUIRE(first.has_value());
+        CHECK(first->empty());
+
+        const auto second = small.confirm(2, true);
+        REQUIRE(second.has_value());
+        REQUIRE(second->size() == 1);
+        CHECK(second->front().id == ticket.id);
+        CHECK(second->front().method == WSSubscriptions::Method::subscribe);
+        CHECK(ticket.confirmed.get());
+    }
+
+    SECTION("A rejected stream is forgotten once its request is reported")
+    {
+        WSSubscriptions small([] {}, 2);
+        auto ticket = small.subscribe({ "a@trade", "b@trade", "c@trade" });
+        REQUIRE(small.nextMessage().has_value());
+        REQUIRE(small.nextMessage().has_value());
+
+        REQUIRE(small.confirm(1, false).has_value());
+        CHECK(small.state("a@trade") == State::failed);
+        CHECK(small.streams(State::failed) == std::vector<std::string> { "a@trade", "b@trade" });
+
+        const auto completions = small.confirm(2, true);
+        REQUIRE(completions.has_value());
+        REQUIRE(completions->size() == 1);
+        CHECK_FALSE(completions->front().success);
+        CHECK_FALSE(ticket.confirmed.get());
+        CHECK_FALSE(small.state("a@trade").has_value());
+        CHECK(small.streams(State::failed).empty());
+        CHECK(small.state("c@trade") == State::active);
+    }
+
+    SECTION("Subscriptions and unsubscriptions keep their order")
+    {
+        subscriptions.subscribe({ "a@trade" });
+        subscriptions.subscribe({ "b@trade" });
+        subscriptions.unsubscribe({ "a@trade" });
+        subscriptions.subscribe({ "a@trade" });
+
+        CHECK(subscriptions.nextMessage() == R"({"method":"SUBSCRIBE","params":["a@trade","b@trade"],"id":1})");
+        CHECK(subscriptions.nextMessage() == R"({"method":"UNSUBSCRIBE","params":["a@trade"],"id":2})");
+        CHECK(subscriptions.nextMessage() == R"({"method":"SUBSCRIBE","params":["a@trade"],"id":3})");
+
+        // The answers to older requests do not change the state of a stream requested again
+        subscriptions.confirm(1, true);
+        subscriptions.confirm(2, true);
+        CHECK(subscriptions.state("a@trade") == State::pending);
+        CHECK(subscriptions.state("b@trade") == State::active);
+        subscriptions.confirm(3, true);
+        CHECK(subscriptions.state("a@trade") == State::active);
+
+        subscriptions.unsubscribe({ "b@trade" });
+        CHECK(subscriptions.state("b@trade") == State::unsubscribing);
+        subscriptions.nextMessage();
+        subscriptions.confirm(4, true);
+        CHECK_FALSE(subscriptions.state("b@trade").has_value());
+        CHECK(subscriptions.streams(State::active) == std::vector<std::string> { "a@trade" });
+    }
+
+    SECTION("Losing the connection fails the requests not answered")
+    {
+        subscriptions.subscribe({ "a@trade" });
+        subscriptions.nextMessage();
+        subscriptions.confirm(1, true);
+
+        auto sent   = subscriptions.subscribe({ "b@trade" });
+        auto queued = subscriptions.subscribe({ "c@trade" });
+        subscriptions.nextMessage();
+
+        const auto wanted = subscriptions.reset();
+        CHECK(std::set<std::string>(wanted.begin(), wanted.end()) == std::set<std::string> { "a@trade", "b@trade", "c@trade" });
+        CHECK_FALSE(sent.confirmed.get());
+        CHECK_FALSE(queued.confirmed.get());
+        CHECK(subscriptions.queued() == 0);
+        CHECK_FALSE(subscriptions.state("a@trade").has_value());
+    }
+
+    SECTION("A new connection subscribes again and keeps the requests")
+    {
+        subscriptions.subscribe({ "a@trade", "b@trade" });
+        subscriptions.nextMessage();
+        subscriptions.confirm(1, true);
+
+        auto sent         = subscriptions.subscribe({ "c@trade" });
+        auto unsubscribed = subscriptions.unsubscribe({ "b@trade" });
+        subscriptions.nextMessage();
+
+        const auto completions = subscriptions.resubscribe();
+        REQUIRE(completions.size() == 1);
+        CHECK(completions.front().id == unsubscribed.id);
+        CHECK(completions.front().method == WSSubscriptions::Method::unsubscribe);
+        CHECK(unsubscribed.confirmed.get());
+
+        CHECK(subscriptions.state("a@trade") == State::pending);
+        CHECK_FALSE(subscriptions.state("b@trade").has_value());
+        CHECK(subscriptions.nextMessage() == R"({"method":"SUBSCRIBE","params":["a@trade","c@trade"],"id":3})");
+        CHECK_FALSE(subscriptions.confirm(2, true).has_value());
+
+        const auto answered = subscriptions.confirm(3, true);
+        REQUIRE(answered.has_value());
+        REQUIRE(answered->size() == 1);
+        CHECK(answered->front().id == sent.id);
+        CHECK(sent.confirmed.get());
+        CHECK(subscriptions.streams(State::active) == std::vector<std::string> { "a@trade", "c@trade" });
+    }
+
+    SECTION("A new connection subscribes again the active, the sent and the queued streams")
+    {
+        subscriptions.subscribe({ "a@trade" });
+        subscriptions.nextMessage();
+        subscriptions.confirm(1, true);
+
+        auto sent = subscriptions.subscribe({ "b@trade" });
+        subscriptions.nextMessage();
+        auto queued = subscriptions.subscribe({ "c@trade" });
+        REQUIRE(subscriptions.queued() == 1);
+
+        CHECK(subscriptions.resubscribe().empty());
+        for (const auto &stream : { "a@trade", "b@trade", "c@trade" })
+            CHECK(subscriptions.state(stream) == State::pending);
+
+        // One message with all of them
+        CHECK(subscriptions.nextMessage() == R"({"method":"SUBSCRIBE","params":["a@trade","b@trade","c@trade"],"id":3})");
+        CHECK_FALSE(subscriptions.nextMessage().has_value());
+
+        const auto answered = subscriptions.confirm(3, true);
+        REQUIRE(answered.has_value());
+        CHECK(answered->size() == 2);
+        CHECK(sent.confirmed.get());
+        CHECK(queued.confirmed.get());
+        CHECK(subscriptions.streams(State::active) == std::vector<std::string> { "a@trade", "b@trade", "c@trade" });
+    }
+
+    SECTION("An empty request is confirmed at once")
+    {
+        auto ticket = subscriptions.subscribe({});
+        CHECK(ticket.confirmed.get());
+        CHECK_FALSE(subscriptions.nextMessage().has_value());
+    }
+}
+
+TEST_CASE("BinanceAPI: Stream sequence gaps")
+{
+    using binapi::ws::SequencedStream;
+    binapi::ws::WSSequences sequences;
+
+    // Spot depth updates: U is the final update id of the previous event plus one
+    CHECK_FALSE(sequences.received(SequencedStream::depthUpdate, "BTCUSDT", 99, 120).has_value());
+    CHECK_FALSE(sequences.received(SequencedStream::depthUpdate, "BTCUSDT", 120, 135).has_value());
+    CHECK_FALSE(sequences.received(SequencedStream::depthUpdate, "ETHUSDT", 9, 10).has_value());
+
+    const auto gap = sequences.received(SequencedStream::depthUpdate, "BTCUSDT", 150, 160);
+    REQUIRE(gap.has_value());
+    CHECK(gap->lastReceived == 135);
+    CHECK(gap->follows == 150);
+    CHECK_FALSE(sequences.received(SequencedStream::depthUpdate, "BTCUSDT", 160, 161).has_value());
+
+    // The trades of a symbol are tracked apart from its depth
+    CHECK_FALSE(sequences.received(SequencedStream::aggregateTrade, "BTCUSDT", 4, 5).has_value());
+    CHECK(sequences.received(SequencedStream::aggregateTrade, "BTCUSDT", 6, 7).has_value());
+    CHECK(sequences.last(SequencedStream::aggregateTrade, "BTCUSDT") == 7);
+    CHECK(sequences.last(SequencedStream::depthUpdate, "BTCUSDT") == 161);
+
+    sequences.forget(SequencedStream::depthUpdate, "BTCUSDT");
+    CHECK_FALSE(sequences.received(SequencedStream::depthUpdate, "BTCUSDT", 500, 510).has_value());
+
+    sequences.clear();
+    CHECK_FALSE(sequences.last(SequencedStream::depthUpdate, "ETHUSDT").has_value());
+}
+
+TEST_CASE("BinanceAPI: Event channels")
+{
+    SECTION("Single producer channel keeps the order and drops when full")
+    {
+        std::size_t wakes = 0;
+        binapi::SPSCChannel<int> channel(5, [&wakes] { ++wakes; });
+        CHECK(channel.capacity() == 8);
+
+        for (int i = 0; i < 8; ++i)
+            CHECK(channel.push(i));
+        CHECK_FALSE(channel.push(8));
+        CHECK(channel.dropped() == 1);
+        CHECK(channel.size() == 8);
+        // Once per batch
+        CHECK(wakes == 1);
+
+        std::vector<int> received;
+        CHECK(channel.drain([&received](int value) { received.push_back(value); }) == 8);
+        CHECK(received == std::vector<int> { 0, 1, 2, 3, 4, 5, 6, 7 });
+        CHECK_FALSE(channel.pop().has_value());
+
+        CHECK(channel.push(9));
+        CHECK(channel.push(10));
+        CHECK(wakes == 2);
+    }
+
+    SECTION("Payloads are shared, not copied")
+    {
+        binapi::SPSCChannel<binapi::Snapshot<binapi::StreamDepthUpdate>> channel(4);
+        auto update = binapi::makeSnapshot<binapi::StreamDepthUpdate>(binapi::StreamDepthUpdate { 0, 10, 20, 0, { { 1.0, 2.0 } }, {} });
+        const auto *address = update.get();
+
+        CHECK(channel.push(update));
+        CHECK(update.use_count() == 2);
+
+        auto received = channel.pop();
+        REQUIRE(received.has_value());
+        CHECK(received->get() == address);
+        // The channel does not keep the payload alive
+        update.reset();
+        CHECK(received->use_count() == 1);
+    }
+
+    SECTION("Multiple producer channel keeps the order of every producer")
+    {
+        constexpr int producers = 4;
+        constexpr int events    = 20'000;
+
+        std::atomic<std::size_t> wakes { 0 };
+        binapi::MPSCChannel<std::pair<int, int>> channel(1024, [&wakes] { wakes.fetch_add(1); });
+        CHECK(channel.capacity() == 1024);
+
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p)
+            threads.emplace_back([&channel, p] {
+                for (int i = 0; i < events; ++i)
+                    while (!channel.push({ p, i }))
+                        std::this_thread::yield();
+            });
+
+        std::array<int, producers> next {};
+        bool ordered       = true;
+        std::size_t total  = 0;
+        const auto receive = [&](std::pair<int, int> &&event) {
+            ordered = ordered && event.second == next[static_cast<std::size_t>(event.first)];
+            ++next[static_cast<std::size_t>(event.first)];
+        };
+        while (total < producers * events)
+            total += channel.drain(receive);
+
+        for (auto &thread : threads)
+            thread.join();
+
+        CHECK(ordered);
+        CHECK(total == producers * events);
+        CHECK(wakes.load() >= 1);
+        CHECK(wakes.load() <= total);
+    }
+}
+
+TEST_CASE("BinanceAPI: Stream latency metrics")
+{
+    using namespace std::chrono_literals;
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    using std::chrono::milliseconds;
+
+    const std::chrono::system_clock::time_point local { milliseconds { 1'700'000'000'000 } };
+    const auto exchangeTime = [](std::chrono::system_clock::time_point time) {
+        return static_cast<uint64_t>(duration_cast<milliseconds>(time.time_since_epoch()).count());
+    };
+
+    binapi::ClockOffset clock;
+    CHECK_FALSE(clock.offset().has_value());
+
+    SECTION("The clock offset comes from the sample with the shortest round trip")
+    {
+        // The server is 500 ms ahead. It answered in the middle of the round trip
+        clock.sample(exchangeTime(local + 10ms + 500ms), local, local + 20ms);
+        CHECK(clock.offset() == microseconds { 500ms });
+        CHECK(clock.roundTrip() == microseconds { 20ms });
+
+        clock.sample(exchangeTime(local + 50ms + 450ms), local, local + 100ms);
+        CHECK(clock.offset() == microseconds { 500ms });
+
+        clock.sample(exchangeTime(local + 2ms + 505ms), local, local + 4ms);
+        CHECK(clock.offset() == microseconds { 505ms });
+        CHECK(clock.roundTrip() == microseconds { 4ms });
+        CHECK(clock.toLocal(exchangeTime(local + 505ms)) == local);
+
+        // Only the last samples are kept
+        for (std::size_t i = 0; i < binapi::ClockOffset::samplesKept; ++i)
+            clock.sample(exchangeTime(local + 25ms + 400ms), local, local + 50ms);
+        CHECK(clock.offset() == microseconds { 400ms });
+    }
+
+    SECTION("Every stage is recorded by stream")
+    {
+        binapi::StreamMetrics metrics;
+        clock.sample(exchangeTime(local + 10ms + 500ms), local, local + 20ms);
+
+        const auto start = std::chrono::steady_clock::now();
+        binapi::StreamTimings timings;
+        timings.eventTime      = exchangeTime(local + 1s);
+        timings.received       = clock.toLocal(timings.eventTime) + 30ms;
+        timings.receivedSteady = start;
+        timings.parsed         = start + 200us;
+
+        // Without the clock offset the network stage is not known
+        metrics.recordParsed("BTCUSDT@depthUpdate", timings);
+        metrics.setClockOffset(&clock);
+        metrics.recordParsed("BTCUSDT@depthUpdate", timings);
+
+        timings.dispatched = start + 1ms;
+        metrics.recordDispatched("BTCUSDT@depthUpdate", timings);
+        metrics.recordRendered("BTCUSDT@depthUpdate", timings, start + 3ms);
+
+        const auto btc = metrics.snapshot("BTCUSDT@depthUpdate");
+        REQUIRE(btc.has_value());
+        CHECK(btc->events == 2);
+        CHECK(btc->stage(binapi::StreamStage::network).count == 1);
+        CHECK(btc->stage(binapi::StreamStage::network).mean() == microseconds { 30ms });
+        CHECK(btc->stage(binapi::StreamStage::parse).count == 2);
+        CHECK(btc->stage(binapi::StreamStage::parse).mean() == 200us);
+        CHECK(btc->stage(binapi::StreamStage::dispatch).mean() == 800us);
+        CHECK(btc->stage(binapi::StreamStage::render).mean() == microseconds { 2ms });
+        CHECK(btc->stage(binapi::StreamStage::total).mean() == microseconds { 33ms });
+
+        // Drawn without being dispatched: the render stage starts when parsed
+        timings.dispatched = {};
+        metrics.recordRendered("ETHUSDT@depthUpdate", timings, start + 1ms);
+        CHECK(metrics.snapshot("ETHUSDT@depthUpdate")->stage(binapi::StreamStage::render).mean() == 800us);
+
+        CHECK_FALSE(metrics.snapshot("BNBUSDT@depthUpdate").has_value());
+        const auto all = metrics.snapshot();
+        REQUIRE(all.size() == 2);
+        CHECK(all[0].stream == "BTCUSDT@depthUpdate");
+        CHECK(all[1].stream == "ETHUSDT@depthUpdate");
+    }
+}
+
+namespace
+{
+    using DepthStream = std::vector<binapi::Snapshot<binapi::StreamDepthUpdate>>;
+
+    // Shaped as a recorded BTCUSDT @depth@100ms stream: 0.01 tick, a walking mid price, 20 to 60 levels changed per
+    // diff, most of them near the top of the book, and a quarter of them removed
+    auto makeDepthStream(std::size_t diffs, uint64_t firstUpdateId) -> DepthStream
+    {
+        std::mt19937_64 random { 20221015 };
+        std::geometric_distribution<int64_t> distance { 0.02 };
+        std::uniform_int_distribution<int> levels { 20, 60 };
+        std::uniform_int_distribution<int64_t> walk { -3, 3 };
+        std::uniform_real_distribution<double> quantity { 0.0001, 2.0 };
+        std::bernoulli_distribution removed { 0.25 };
+        std::bernoulli_distribution bid { 0.5 };
+
+        DepthStream stream;
+        int64_t mid       = 1'914'321;
+        uint64_t updateId = firstUpdateId;
+        for (std::size_t i = 0; i < diffs; ++i)
+        {
+            mid += walk(random);
+
+            binapi::StreamDepthUpdate diff {};
+            diff.finalUpdateIdLastStream = updateId - 1;
+            diff.firstUpdateId           = updateId;
+
+            // The exchange sends every level once, best price first
+            std::map<double, double, std::greater<>> bids;
+            std::map<double, double> asks;
+            const int changed = levels(random);
+            for (int level = 0; level < changed; ++level)
+            {
+                const double size = removed(random) ? 0.0 : quantity(random);
+                if (bid(random))
+                    bids[static_cast<double>(mid - 1 - distance(random)) * 0.01] = size;
+                else
+                    asks[static_cast<double>(mid + distance(random)) * 0.01] = size;
+            }
+            for (const auto &[price, size] : bids)
+                diff.bids.push_back({ .price = price, .quantity = size });
+            for (const auto &[price, size] : asks)
+                diff.asks.push_back({ .price = price, .quantity = size });
+
+            updateId += static_cast<uint64_t>(changed);
+            diff.finalUpdateId = updateId - 1;
+            stream.push_back(binapi::makeSnapshot<binapi::StreamDepthUpdate>(std::move(diff)));
+        }
+        return stream;
+    }
+
+    auto makeBookSnapshot(uint64_t lastUpdateId, std::size_t levels) -> binapi::SPOT::OrderBook
+    {
+        binapi::SPOT::OrderBook book { .lastUpdateId = lastUpdateId, .asks = {}, .bids = {} };
+        for (std::size_t level = 0; level < levels; ++level)
+        {
+            book.bids.push_back({ .price = static_cast<double>(1'914'320 - static_cast<int64_t>(level)) * 0.01, .quantity = 1.0 });
+            book.asks.push_back({ .price = static_cast<double>(1'914'321 + static_cast<int64_t>(level)) * 0.01, .quantity = 1.0 });
+        }
+        return book;
+    }
+
+    // The book as the plugin kept it: a node per level
+    struct MapBook
+    {
+        std::map<double, double, std::greater<>> bids;
+        std::map<double, double> asks;
+
+        explicit MapBook(const binapi::SPOT::OrderBook &book)
+        {
+            for (const auto &level : book.bids)
+                bids[level.price] = level.quantity;
+            for (const auto &level : book.asks)
+                asks[level.price] = level.quantity;
+        }
+
+        auto apply(const binapi::StreamDepthUpdate &diff) -> void
+        {
+            const auto set = [](auto &side, double price, double quantity) {
+                if (quantity > 0.0)
+                    side[price] = quantity;
+                else
+                    side.erase(price);
+            };
+            for (const auto &[price, quantity] : diff.bids)
+                set(bids, price, quantity);
+            for (const auto &[price, quantity] : diff.asks)
+                set(asks, price, quantity);
+        }
+    };
+
+    auto depthDiff(uint64_t first, uint64_t last, std::vector<binapi::PriceLevel> bids, std::vector<binapi::PriceLevel> asks) -> binapi::Snapshot<binapi::StreamDepthUpdate>
+    {
+        return binapi::makeSnapshot<binapi::StreamDepthUpdate>(binapi::StreamDepthUpdate {
+            .transactionTime         = 0,
+            .firstUpdateId           = first,
+            .finalUpdateId           = last,
+            .finalUpdateIdLastStream = first - 1,
+            .bids                    = std::move(bids),
+            .asks                    = std::move(asks) });
+    }
+} // namespace
+
+TEST_CASE("BinanceAPI: Order book")
+{
+    using binapi::OrderBookStatus;
+
+    SECTION("The levels are sorted with the best price first")
+    {
+        binapi::OrderBookSide bids { binapi::BookSide::bids };
+        binapi::OrderBookSide asks { binapi::BookSide::asks };
+        CHECK_FALSE(bids.best().has_value());
+
+        for (const double price : { 10.0, 12.0, 11.0, 9.0 })
+        {
+            bids.set(price, price / 10.0);
+            asks.set(price + 3.0, price / 10.0);
+        }
+        CHECK(bids.best()->price == 12.0);
+        CHECK(asks.best()->price == 12.0);
+
+        std::vector<double> prices;
+        for (const auto &level : bids.top(3))
+            prices.push_back(level.price);
+        CHECK(prices == std::vector<double> { 12.0, 11.0, 10.0 });
+
+        prices.clear();
+        for (const auto &level : asks)
+            prices.push_back(level.price);
+        CHECK(prices == std::vector<double> { 12.0, 13.0, 14.0, 15.0 });
+
+        // Zero removes the level, even if there is none
+        bids.set(12.0, 0.0);
+        bids.set(50.0, 0.0);
+        bids.set(10.0, 4.0);
+        CHECK(bids.size() == 3);
+        CHECK(bids.best()->price == 11.0);
+        CHECK(bids.quantity(10.0) == 4.0);
+        CHECK(bids.quantity(12.0) == 0.0);
+        CHECK(std::ranges::distance(bids.top(10)) == 3);
+    }
+
+    SECTION("Diffs are buffered until the snapshot and the older ones dropped")
+    {
+        binapi::OrderBook book;
+        CHECK(book.update(depthDiff(95, 100, { { 9.0, 1.0 } }, {})) == OrderBookStatus::buffered);
+        CHECK(book.update(depthDiff(101, 104, { { 10.0, 2.0 } }, { { 11.0, 0.0 } })) == OrderBookStatus::buffered);
+        CHECK(book.update(depthDiff(105, 110, {}, { { 12.0, 3.0 } })) == OrderBookStatus::buffered);
+        CHECK_FALSE(book.synchronized());
+
+        // Contains 103: the first diff applied is the one with 101..104
+        binapi::SPOT::OrderBook snapshot { .lastUpdateId = 102, .asks = { { 11.0, 1.0 }, { 13.0, 1.0 } }, .bids = { { 10.0, 1.0 }, { 8.0, 1.0 } } };
+        CHECK(book.snapshot(snapshot));
+        CHECK(book.synchronized());
+        CHECK(book.lastUpdateId() == 110);
+        CHECK(book.buffered() == 0);
+        CHECK(book.bestBid()->quantity == 2.0);
+        CHECK(book.bestAsk()->price == 12.0);
+        CHECK(book.bids().quantity(9.0) == 0.0);
+
+        CHECK(book.update(depthDiff(108, 110, {}, {})) == OrderBookStatus::stale);
+        CHECK(book.update(depthDiff(111, 111, { { 8.0, 0.0 } }, {})) == OrderBookStatus::applied);
+        CHECK(book.bids().size() == 1);
+    }
+
+    SECTION("A snapshot older than the diffs is refused")
+    {
+        binapi::OrderBook book;
+        CHECK(book.update(depthDiff(120, 130, {}, {})) == OrderBookStatus::buffered);
+
+        CHECK_FALSE(book.snapshot(makeBookSnapshot(100, 5)));
+        CHECK_FALSE(book.synchronized());
+        CHECK(book.bids().empty());
+        CHECK(book.buffered() == 1);
+
+        CHECK(book.snapshot(makeBookSnapshot(125, 5)));
+        CHECK(book.lastUpdateId() == 130);
+    }
+
+    SECTION("A lost diff makes the book wait for a new snapshot")
+    {
+        binapi::OrderBook book;
+        CHECK(book.snapshot(makeBookSnapshot(100, 5)));
+        CHECK(book.update(depthDiff(101, 105, {}, {})) == OrderBookStatus::applied);
+
+        CHECK(book.update(depthDiff(110, 112, { { 1.0, 1.0 } }, {})) == OrderBookStatus::outOfSync);
+        CHECK_FALSE(book.synchronized());
+        CHECK(book.asks().empty());
+        CHECK(book.buffered() == 1);
+
+        CHECK(book.update(depthDiff(113, 113, {}, {})) == OrderBookStatus::buffered);
+        CHECK(book.snapshot(makeBookSnapshot(111, 5)));
+        CHECK(book.lastUpdateId() == 113);
+        CHECK(book.bids().quantity(1.0) == 1.0);
+    }
+
+    SECTION("Futures diffs are chained by the previous final update id")
+    {
+        binapi::OrderBook book { binapi::OrderBookSequencing::futures };
+        CHECK(book.update(depthDiff(95, 100, {}, {})) == OrderBookStatus::buffered);
+        CHECK(book.update(depthDiff(101, 104, {}, {})) == OrderBookStatus::buffered);
+
+        CHECK(book.snapshot(makeBookSnapshot(100, 5)));
+        CHECK(book.lastUpdateId() == 104);
+
+        auto skipped = depthDiff(200, 210, {}, {});
+        CHECK(book.update(depthDiff(105, 120, {}, {})) == OrderBookStatus::applied);
+        CHECK(book.update(skipped) == OrderBookStatus::outOfSync);
+    }
+
+    SECTION("The buffer keeps the newest diffs")
+    {
+        binapi::OrderBook book { binapi::OrderBookSequencing::spot, 2 };
+        for (uint64_t id = 1; id <= 5; ++id)
+            CHECK(book.update(depthDiff(id, id, {}, {})) == OrderBookStatus::buffered);
+        CHECK(book.buffered() == 2);
+        CHECK(book.snapshot(makeBookSnapshot(3, 5)));
+        CHECK(book.lastUpdateId() == 5);
+    }
+
+    SECTION("A recorded stream gives the same book as a map")
+    {
+        const auto snapshot = makeBookSnapshot(1000, 1000);
+        const auto stream   = makeDepthStream(2000, 1001);
+
+        binapi::OrderBook book;
+        MapBook reference { snapshot };
+        REQUIRE(book.snapshot(snapshot));
+        for (const auto &diff : stream)
+        {
+            REQUIRE(book.update(diff) == OrderBookStatus::applied);
+            reference.apply(*diff);
+        }
+
+        REQUIRE(book.bids().size() == reference.bids.size());
+        REQUIRE(book.asks().size() == reference.asks.size());
+        CHECK(std::ranges::equal(book.bids(), reference.bids, [](const binapi::PriceLevel &level, const auto &entry) { return level.price == entry.first && level.quantity == entry.second; }));
+        CHECK(std::ranges::equal(book.asks(), reference.asks, [](const binapi::PriceLevel &level, const auto &entry) { return level.price == entry.first && level.quantity == entry.second; }));
+    }
+}
+
+TEST_CASE("BinanceAPI: Order book snapshot requests")
+{
+    using namespace std::chrono_literals;
+    const auto now = binapi::OrderBookSnapshots::clock::now();
+
+    binapi::OrderBookSnapshots snapshots { 500ms, 4s };
+
+    SECTION("One request per symbol is in flight")
+    {
+        const auto first = snapshots.request("BTCUSDT", now);
+        REQUIRE(first.has_value());
+        CHECK_FALSE(snapshots.request("BTCUSDT", now).has_value());
+        CHECK(snapshots.pending("BTCUSDT") == first);
+
+        // Other symbols are not held by it
+        const auto other = snapshots.request("ETHUSDT", now);
+        REQUIRE(other.has_value());
+        CHECK(*other != *first);
+
+        CHECK(snapshots.completed("BTCUSDT", *first));
+        CHECK_FALSE(snapshots.pending("BTCUSDT").has_value());
+        CHECK(snapshots.request("BTCUSDT", now).has_value());
+    }
+
+    SECTION("The results of a request made before the book was stopped or reopened are discarded")
+    {
+        const auto stopped = snapshots.request("BTCUSDT", now);
+        REQUIRE(stopped.has_value());
+        snapshots.erase("BTCUSDT");
+        CHECK_FALSE(snapshots.completed("BTCUSDT", *stopped));
+
+        const auto failed = snapshots.request("BTCUSDT", now);
+        REQUIRE(failed.has_value());
+        snapshots.erase("BTCUSDT");
+        CHECK_FALSE(snapshots.failed("BTCUSDT", *failed, now));
+        CHECK_FALSE(snapshots.retryAt("BTCUSDT").has_value());
+
+        // The reopened book has its own request. The old results do not take its place
+        const auto reopened = snapshots.request("BTCUSDT", now);
+        REQUIRE(reopened.has_value());
+        CHECK(*reopened != *stopped);
+        CHECK(*reopened != *failed);
+        CHECK_FALSE(snapshots.completed("BTCUSDT", *stopped));
+        CHECK_FALSE(snapshots.failed("BTCUSDT", *failed, now));
+        CHECK(snapshots.pending("BTCUSDT") == reopened);
+        CHECK(snapshots.completed("BTCUSDT", *reopened));
+    }
+
+    SECTION("A failed request is retried after a delay that doubles with every failure")
+    {
+        auto time = now;
+        for (const auto delay : { 500ms, 1000ms, 2000ms, 4000ms, 4000ms })
+        {
+            const auto request = snapshots.request("BTCUSDT", time);
+            REQUIRE(request.has_value());
+            CHECK(snapshots.failed("BTCUSDT", *request, time));
+            CHECK(snapshots.retryAt("BTCUSDT") == time + delay);
+
+            // Not on the next diff
+            CHECK_FALSE(snapshots.request("BTCUSDT", time).has_value());
+            CHECK_FALSE(snapshots.request("BTCUSDT", time + delay - 1ms).has_value());
+            time += delay;
+        }
+
+        // A snapshot received forgets the failures
+        const auto request = snapshots.request("BTCUSDT", time);
+        REQUIRE(request.has_value());
+        CHECK(snapshots.completed("BTCUSDT", *request));
+        CHECK_FALSE(snapshots.retryAt("BTCUSDT").has_value());
+
+        const auto next = snapshots.request("BTCUSDT", time);
+        REQUIRE(next.has_value());
+        CHECK(snapshots.failed("BTCUSDT", *next, time));
+        CHECK(snapshots.retryAt("BTCUSDT") == time + 500ms);
+    }
+
+    SECTION("Retry-After is honoured when it is longer than the delay")
+    {
+        binapi::BinanceLimits limits;
+        limits.setAPIRequestsLimits(1200, 60);
+        CHECK(limits.getRetryAfter() == 0ns);
+        binapi::BinanceLimits::Admission(limits, 1, false).completed(cpr::Header { { "Retry-After", "30" } }, 429);
+        const auto retryAfter = limits.getRetryAfter();
+        CHECK(retryAfter > 29s);
+        CHECK(retryAfter <= 30s);
+
+        const auto request = snapshots.request("BTCUSDT", now);
+        REQUIRE(request.has_value());
+        CHECK(snapshots.failed("BTCUSDT", *request, now, retryAfter));
+        CHECK(snapshots.retryAt("BTCUSDT") == now + retryAfter);
+        CHECK_FALSE(snapshots.request("BTCUSDT", now + 4s).has_value());
+        CHECK(snapshots.request("BTCUSDT", now + retryAfter).has_value());
+    }
+}
+
+TEST_CASE("BinanceAPI: Order book conflation")
+{
+    using namespace std::chrono_literals;
+    using binapi::OrderBookStatus;
+
+    binapi::OrderBook book;
+    binapi::BookConflator conflator { book };
+    REQUIRE(book.snapshot(makeBookSnapshot(100, 50)));
+
+    std::vector<binapi::Snapshot<binapi::BookTop>> ui, strategy;
+    const auto uiId = conflator.subscribe(20, 200ms, [&ui](const binapi::Snapshot<binapi::BookTop> &top) { ui.push_back(top); });
+    conflator.subscribe(5, 0ms, [&strategy](const binapi::Snapshot<binapi::BookTop> &top) { strategy.push_back(top); });
+    CHECK(conflator.subscribers() == 2);
+
+    const auto start     = binapi::BookConflator::clock::now();
+    const double bestBid = static_cast<double>(1'914'320) * 0.01;
+    const double bestAsk = static_cast<double>(1'914'321) * 0.01;
+
+    SECTION("Every subscriber is updated at its own rate with the latest book")
+    {
+        // Ten diffs in 100ms: the strategy gets all of them, the dialog the first one and, 200ms later, the last one
+        for (uint64_t id = 101; id <= 110; ++id)
+        {
+            const auto now = start + (id - 101) * 10ms;
+            REQUIRE(book.update(depthDiff(id, id, { { bestBid, static_cast<double>(id) } }, {})) == OrderBookStatus::applied);
+            conflator.changed(1665792000000 + id, now);
+            conflator.poll(now);
+        }
+        REQUIRE(strategy.size() == 10);
+        CHECK(strategy.back()->lastUpdateId == 110);
+        CHECK(strategy.back()->bids.size() == 5);
+        CHECK(strategy.back()->bids.front().quantity == 110.0);
+
+        REQUIRE(ui.size() == 1);
+        CHECK(ui.front()->lastUpdateId == 101);
+        CHECK(ui.front()->bids.size() == 20);
+        CHECK(ui.front()->asks.front().price == bestAsk);
+
+        const auto next = conflator.poll(start + 150ms);
+        REQUIRE(next.has_value());
+        CHECK(*next == start + 200ms);
+        CHECK(ui.size() == 1);
+
+        CHECK_FALSE(conflator.poll(start + 200ms).has_value());
+        REQUIRE(ui.size() == 2);
+        CHECK(ui.back()->lastUpdateId == 110);
+        CHECK(ui.back()->eventTime == 1665792000110);
+        CHECK(ui.back()->bids.front().quantity == 110.0);
+
+        // Nothing changed since
+        CHECK_FALSE(conflator.poll(start + 1s).has_value());
+        CHECK(ui.size() == 2);
+    }
+
+    SECTION("Subscribers updated together with the same levels share the snapshot")
+    {
+        std::vector<binapi::Snapshot<binapi::BookTop>> other;
+        conflator.subscribe(20, 500ms, [&other](const binapi::Snapshot<binapi::BookTop> &top) { other.push_back(top); });
+
+        REQUIRE(book.update(depthDiff(101, 101, {}, {})) == OrderBookStatus::applied);
+        conflator.changed(0, start);
+        conflator.poll(start);
+        REQUIRE(ui.size() == 1);
+        REQUIRE(other.size() == 1);
+        CHECK(ui.front() == other.front());
+        CHECK(ui.front() != strategy.front());
+    }
+
+    SECTION("A book waiting for a snapshot is not published")
+    {
+        REQUIRE(book.update(depthDiff(101, 101, {}, {})) == OrderBookStatus::applied);
+        conflator.changed(0, start);
+        REQUIRE(book.update(depthDiff(150, 151, {}, {})) == OrderBookStatus::outOfSync);
+
+        CHECK_FALSE(conflator.poll(start + 1s).has_value());
+        CHECK(ui.empty());
+
+        REQUIRE(book.snapshot(makeBookSnapshot(150, 50)));
+        REQUIRE(book.update(depthDiff(152, 152, {}, {})) == OrderBookStatus::applied);
+        conflator.changed(0, start + 2s);
+        conflator.poll(start + 2s);
+        REQUIRE(ui.size() == 1);
+        CHECK(ui.front()->lastUpdateId == 152);
+    }
+
+    SECTION("An unsubscribed subscriber is not updated")
+    {
+        conflator.unsubscribe(uiId);
+        CHECK(conflator.subscribers() == 1);
+
+        REQUIRE(book.update(depthDiff(101, 101, {}, {})) == OrderBookStatus::applied);
+        conflator.changed(0, start);
+        CHECK_FALSE(conflator.poll(start + 1s).has_value());
+        CHECK(ui.empty());
+        CHECK(strategy.size() == 1);
+    }
+}
+
+TEST_CASE("BinanceAPI: Order book benchmark")
+{
+    const auto snapshot = makeBookSnapshot(1000, 1000);
+    const auto stream   = makeDepthStream(1000, 1001);
+
+    BENCHMARK("1000 diffs of @depth@100ms, std::map")
+    {
+        MapBook book { snapshot };
+        for (const auto &diff : stream)
+            book.apply(*diff);
+        return book.bids.begin()->first + book.asks.begin()->first;
+    };
+
+    BENCHMARK("1000 diffs of @depth@100ms, OrderBook")
+    {
+        binapi::OrderBook book;
+        book.snapshot(snapshot);
+        for (const auto &diff : stream)
+            book.update(diff);
+        return book.bestBid()->price + book.bestAsk()->price;
+    };
+
+    binapi::OrderBook book;
+    book.snapshot(snapshot);
+    for (const auto &diff : stream)
+        book.update(diff);
+    MapBook reference { snapshot };
+    for (const auto &diff : stream)
+        reference.apply(*diff);
+
+    BENCHMARK("Top 20 levels, std::map")
+    {
+        double total = 0.0;
+        auto level   = reference.bids.begin();
+        for (int i = 0; i < 20 && level != reference.bids.end(); ++i, ++level)
+            total += level->second;
+        return total;
+    };
+
+    BENCHMARK("Top 20 levels, OrderBook")
+    {
+        double total = 0.0;
+        for (const auto &level : book.bids().top(20))
+            total += level.quantity;
+        return total;
+    };
+}
@@ -0,0 +1,78 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+// Created by Ricardo Romero on 17/10/26.
+// Copyright (c) 2026 Ricardo Romero.  All rights reserved.
+//
+// Recorded payloads shared by the BinanceAPI tests and the allocation count tests
+
+#pragma once
+
+#ifndef CENTAUR_TESTS_BINANCE_API_DATA_HPP
+#define CENTAUR_TESTS_BINANCE_API_DATA_HPP
+
+#include <BinanceAPI.hpp>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace
+{
+    // Recorded from wss://stream.binance.com:9443/ws/btcusdt@depth@100ms
+    constexpr std::string_view g_recordedDepthUpdate = R"({"e":"depthUpdate","E":1665792000123,"s":"BTCUSDT","U":30134823871,"u":30134823912,)"
+                                                       R"("b":[["19143.21000000","0.00522000"],["19143.20000000","0.00000000"],["19143.05000000","0.16280000"],)"
+                                                       R"(["19142.98000000","0.01071000"],["19142.31000000","0.06530000"],["19141.00000000","0.41380000"],)"
+                                                       R"(["19140.12000000","1.20000000"],["19139.87000000","0.00000000"],["19138.56000000","0.26124000"]],)"
+                                                       R"("a":[["19143.22000000","3.12960000"],["19143.25000000","0.00000000"],["19143.40000000","0.01436000"],)"
+                                                       R"(["19143.66000000","0.10442000"],["19144.01000000","0.52240000"],["19144.72000000","0.00000000"],)"
+                                                       R"(["19145.00000000","2.08400000"],["19146.33000000","0.00731000"]]})";
+
+    constexpr std::string_view g_recordedCandle = R"([1499040000000,"0.01634790","0.80000000","0.01575800","0.01577100","148976.11427815",1499644799999,)"
+                                                  R"("2434.19055334",308,"1756.87402397","28.46694368","0"])";
+
+    constexpr std::string_view g_recordedTicker24hr = R"({"symbol":"BTCUSDT","priceChange":"-94.99999800","priceChangePercent":"-95.960","weightedAvgPrice":"0.29628482",)"
+                                                      R"("prevClosePrice":"0.10002000","lastPrice":"4.00000200","lastQty":"200.00000000","bidPrice":"4.00000000",)"
+                                                      R"("bidQty":"100.00000000","askPrice":"4.00000200","askQty":"100.00000000","openPrice":"99.00000000",)"
+                                                      R"("highPrice":"100.00000000","lowPrice":"0.10000000","volume":"8913.30000000","quoteVolume":"15.30000000",)"
+                                                      R"("openTime":1499783499040,"closeTime":1499869899040,"firstId":28385,"lastId":28460,"count":76})";
+
+    /// /api/v3/klines with count candles
+    inline auto makeKlines(std::size_t count) -> std::string
+    {
+        std::string json = "[";
+        for (std::size_t i = 0; i < count; ++i)
+            json.append(i == 0 ? "" : ",").append(g_recordedCandle);
+        return json.append("]");
+    }
+
+    /// /api/v3/ticker/24hr with count symbols
+    inline auto makeTicker24hr(std::size_t count) -> std::string
+    {
+        std::string json = "[";
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            std::string ticker { g_recordedTicker24hr };
+            ticker.replace(ticker.find("BTCUSDT"), 7, "SYM" + std::to_string(i));
+            json.append(i == 0 ? "" : ",").append(ticker);
+        }
+        return json.append("]");
+    }
+
+    using TickerMap = std::unordered_map<binapi::sym_t, binapi::SPOT::TickerPriceChangeStatistics>;
+
+    /// The reading of BinanceAPISpot::tickerPriceChangeStatistics24hr
+    inline auto readTicker24hr(const rapidjson::Value &array, TickerMap &tickers) -> void
+    {
+        for (const auto &data : array.GetArray())
+        {
+            auto &ticker     = tickers[binapi::sym_t { binapi::jsonToView(data["symbol"]) }];
+            ticker.openTime  = data["openTime"].GetUint64();
+            ticker.count     = data["count"].GetInt64();
+            ticker.lastPrice = binapi::jsonToDouble(data["lastPrice"]);
+            ticker.volume    = binapi::jsonToDouble(data["volume"]);
+        }
+    }
+} // namespace
+
+#endif /*CENTAUR_TESTS_BINANCE_API_DATA_HPP*/
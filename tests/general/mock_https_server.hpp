@@ -0,0 +1,197 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+// Created by Ricardo Romero on 17/10/26.
+// Copyright (c) 2026 Ricardo Romero.  All rights reserved.
+//
+// Minimal HTTPS/1.1 keep-alive server used to test and benchmark the REST layer without touching the exchange
+
+#pragma once
+
+#ifndef CENTAUR_TESTS_MOCK_HTTPS_SERVER_HPP
+#define CENTAUR_TESTS_MOCK_HTTPS_SERVER_HPP
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+
+namespace tests
+{
+    /// Server context with a throw-away self-signed certificate; clients must disable the peer verification
+    inline auto makeSelfSignedContext() -> SSL_CTX *
+    {
+        EVP_PKEY *key = EVP_EC_gen("P-256");
+        X509 *cert    = X509_new();
+        ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+        X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+        X509_gmtime_adj(X509_getm_notAfter(cert), 3600);
+        X509_set_pubkey(cert, key);
+        X509_NAME *name = X509_get_subject_name(cert);
+        X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char *>("127.0.0.1"), -1, -1, 0);
+        X509_set_issuer_name(cert, name);
+        X509_sign(cert, key, EVP_sha256());
+
+        SSL_CTX *ctx = SSL_CTX_new(TLS_server_method());
+        SSL_CTX_use_certificate(ctx, cert);
+        SSL_CTX_use_PrivateKey(ctx, key);
+
+        X509_free(cert);
+        EVP_PKEY_free(key);
+        return ctx;
+    }
+
+    struct MockResponse
+    {
+        int status { 200 };
+        std::string body { "{}" };
+        std::vector<std::pair<std::string, std::string>> headers {};
+    };
+
+    class MockHTTPSServer final
+    {
+    public:
+        using Handler = std::function<MockResponse(std::string_view requestLine)>;
+
+        explicit MockHTTPSServer(Handler handler = {}) :
+            m_handler { std::move(handler) },
+            m_ctx { makeSelfSignedContext() }
+        {
+            m_listen = ::socket(AF_INET, SOCK_STREAM, 0);
+            int yes  = 1;
+            ::setsockopt(m_listen, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+            sockaddr_in address {};
+            address.sin_family      = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            address.sin_port        = 0;
+            if (::bind(m_listen, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || ::listen(m_listen, 64) != 0)
+                throw std::runtime_error("mock server: could not listen");
+
+            socklen_t length = sizeof(address);
+            ::getsockname(m_listen, reinterpret_cast<sockaddr *>(&address), &length);
+            m_port = ntohs(address.sin_port);
+
+            m_acceptThread = std::thread([this] { acceptLoop(); });
+        }
+
+        ~MockHTTPSServer()
+        {
+            m_stop = true;
+            m_acceptThread.join();
+            ::close(m_listen);
+            {
+                std::lock_guard<std::mutex> lock(m_clientsMutex);
+                for (auto fd : m_clients)
+                    ::shutdown(fd, SHUT_RDWR);
+            }
+            for (auto &th : m_clientThreads)
+                th.join();
+            for (auto fd : m_clients)
+                ::close(fd);
+            SSL_CTX_free(m_ctx);
+        }
+
+    public:
+        auto url() const -> std::string { return "https://127.0.0.1:" + std::to_string(m_port); }
+        auto connections() const noexcept -> uint64_t { return m_connections.load(); }
+        auto requests() const noexcept -> uint64_t { return m_requests.load(); }
+
+    private:
+        auto acceptLoop() -> void
+        {
+            while (!m_stop)
+            {
+                pollfd pfd { m_listen, POLLIN, 0 };
+                if (::poll(&pfd, 1, 50) <= 0)
+                    continue;
+
+                const int fd = ::accept(m_listen, nullptr, nullptr);
+                if (fd < 0)
+                    continue;
+
+                ++m_connections;
+                {
+                    std::lock_guard<std::mutex> lock(m_clientsMutex);
+                    m_clients.push_back(fd);
+                }
+                m_clientThreads.emplace_back([this, fd] { serve(fd); });
+            }
+        }
+
+        auto serve(int fd) -> void
+        {
+            SSL *ssl = SSL_new(m_ctx);
+            SSL_set_fd(ssl, fd);
+
+            if (SSL_accept(ssl) == 1)
+            {
+                std::string buffer;
+                char chunk[4096];
+                for (;;)
+                {
+                    const auto end = buffer.find("\r\n\r\n");
+                    if (end == std::string::npos)
+                    {
+                        const int read = SSL_read(ssl, chunk, sizeof(chunk));
+                        if (read <= 0)
+                            break;
+                        buffer.append(chunk, static_cast<std::size_t>(read));
+                        continue;
+                    }
+
+                    const std::string_view requestLine { buffer.data(), buffer.find("\r\n") };
+                    ++m_requests;
+                    const MockResponse response = m_handler ? m_handler(requestLine) : MockResponse {};
+
+                    std::string reply = "HTTP/1.1 " + std::to_string(response.status) + (response.status == 200 ? " OK" : " ERROR") + "\r\n"
+                                      + "Content-Type: application/json;charset=UTF-8\r\n"
+                                      + "Content-Length: " + std::to_string(response.body.size()) + "\r\n"
+                                      + "Connection: keep-alive\r\n";
+                    for (const auto &[header, value] : response.headers)
+                        reply += header + ": " + value + "\r\n";
+                    reply += "\r\n" + response.body;
+
+                    if (SSL_write(ssl, reply.data(), static_cast<int>(reply.size())) <= 0)
+                        break;
+
+                    buffer.erase(0, end + 4);
+                }
+            }
+
+            SSL_free(ssl);
+            // The descriptor is closed by the destructor, so it can not be reused while the server is alive
+            ::shutdown(fd, SHUT_RDWR);
+        }
+
+    private:
+        Handler m_handler;
+        SSL_CTX *m_ctx { nullptr };
+        int m_listen { -1 };
+        uint16_t m_port { 0 };
+        std::atomic_bool m_stop { false };
+        std::atomic_uint64_t m_connections { 0 };
+        std::atomic_uint64_t m_requests { 0 };
+        std::thread m_acceptThread;
+        std::vector<std::thread> m_clientThreads;
+        std::mutex m_clientsMutex;
+        std::vector<int> m_clients;
+    };
+} // namespace tests
+
+#endif /*CENTAUR_TESTS_MOCK_HTTPS_SERVER_HPP*/
@@ -0,0 +1,378 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+// Created by Ricardo Romero on 17/10/26.
+// Copyright (c) 2026 Ricardo Romero.  All rights reserved.
+//
+// Minimal WSS server used to test the stream connections without touching the exchange
+
+#pragma once
+
+#ifndef CENTAUR_TESTS_MOCK_WS_SERVER_HPP
+#define CENTAUR_TESTS_MOCK_WS_SERVER_HPP
+
+#include "mock_https_server.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <memory>
+#include <optional>
+
+#include <openssl/sha.h>
+
+namespace tests
+{
+    /// Polls predicate until it holds or timeout expires
+    template <typename Predicate>
+    auto waitUntil(Predicate &&predicate, std::chrono::milliseconds timeout = std::chrono::seconds { 5 }) -> bool
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!predicate())
+        {
+            if (std::chrono::steady_clock::now() >= deadline)
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds { 5 });
+        }
+        return true;
+    }
+
+    class MockWSServer final
+    {
+    public:
+        /// Receives every text message of a client and returns the messages sent back to it
+        using Handler = std::function<std::vector<std::string>(std::string_view message)>;
+
+        explicit MockWSServer(Handler handler = {}) :
+            m_handler { std::move(handler) },
+            m_ctx { makeSelfSignedContext() }
+        {
+            m_listen = ::socket(AF_INET, SOCK_STREAM, 0);
+            int yes  = 1;
+            ::setsockopt(m_listen, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+            sockaddr_in address {};
+            address.sin_family      = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            address.sin_port        = 0;
+            if (::bind(m_listen, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || ::listen(m_listen, 64) != 0)
+                throw std::runtime_error("mock server: could not listen");
+
+            socklen_t length = sizeof(address);
+            ::getsockname(m_listen, reinterpret_cast<sockaddr *>(&address), &length);
+            m_port = ntohs(address.sin_port);
+
+            m_acceptThread = std::thread([this] { acceptLoop(); });
+        }
+
+        ~MockWSServer()
+        {
+            m_stop = true;
+            m_acceptThread.join();
+            ::close(m_listen);
+            dropAll();
+            for (auto &th : m_clientThreads)
+                th.join();
+            for (const auto &client : m_clients)
+                ::close(client->fd);
+            SSL_CTX_free(m_ctx);
+        }
+
+    public:
+        auto host() const -> std::string { return "127.0.0.1"; }
+        auto port() const noexcept -> int32_t { return m_port; }
+        /// Handshakes completed
+        auto connections() const noexcept -> uint64_t { return m_connections.load(); }
+        /// Clients connected right now
+        auto open() const noexcept -> uint64_t { return m_open.load(); }
+        /// Close frames received
+        auto closeFrames() const noexcept -> uint64_t { return m_closeFrames.load(); }
+
+        /// Text messages received from all the clients, in order
+        auto messages() const -> std::vector<std::string>
+        {
+            std::lock_guard<std::mutex> lock(m_messagesMutex);
+            return m_messages;
+        }
+
+        /// Send a text message to every client connected
+        auto broadcast(std::string_view message) -> void
+        {
+            std::lock_guard<std::mutex> lock(m_clientsMutex);
+            for (const auto &client : m_clients)
+                send(*client, 0x1, message);
+        }
+
+        /// Drop every client without a close frame, as a lost connection
+        auto dropAll() -> void
+        {
+            std::lock_guard<std::mutex> lock(m_clientsMutex);
+            for (const auto &client : m_clients)
+                ::shutdown(client->fd, SHUT_RDWR);
+        }
+
+        /// Close the new connections before the handshake, so the clients fail to connect
+        auto setRefusing(bool refusing) noexcept -> void { m_refusing = refusing; }
+
+        /// Accept the new connections but never answer them, so the clients hang in the handshake
+        auto setStalling(bool stalling) noexcept -> void { m_stalling = stalling; }
+        /// Connections accepted and left unanswered
+        auto stalled() const noexcept -> uint64_t { return m_stalled.load(); }
+
+    private:
+        struct Client
+        {
+            int fd { -1 };
+            SSL *ssl { nullptr };
+            // SSL objects can not read and write from two threads at once
+            std::mutex mutex;
+            bool upgraded { false };
+        };
+
+        auto acceptLoop() -> void
+        {
+            while (!m_stop)
+            {
+                pollfd pfd { m_listen, POLLIN, 0 };
+                if (::poll(&pfd, 1, 20) <= 0)
+                    continue;
+
+                const int fd = ::accept(m_listen, nullptr, nullptr);
+                if (fd < 0)
+                    continue;
+
+                if (m_refusing)
+                {
+                    ::close(fd);
+                    continue;
+                }
+
+                auto client = std::make_shared<Client>();
+                client->fd  = fd;
+                {
+                    std::lock_guard<std::mutex> lock(m_clientsMutex);
+                    m_clients.push_back(client);
+                }
+                // Kept open until the server is destroyed
+                if (m_stalling)
+                {
+                    ++m_stalled;
+                    continue;
+                }
+                m_clientThreads.emplace_back([this, client] { serve(*client); });
+            }
+        }
+
+        static auto lower(std::string_view text) -> std::string
+        {
+            std::string result { text };
+            std::transform(result.begin(), result.end(), result.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            return result;
+        }
+
+        /// Value of a header of the upgrade request
+        static auto header(std::string_view request, std::string_view name) -> std::optional<std::string>
+        {
+            const auto text  = lower(request);
+            const auto start = text.find("\r\n" + lower(name) + ":");
+            if (start == std::string::npos)
+                return std::nullopt;
+
+            auto first      = start + name.size() + 3;
+            const auto last = text.find("\r\n", first);
+            while (first < last && request[first] == ' ')
+                ++first;
+            return std::string { request.substr(first, last - first) };
+        }
+
+        static auto acceptKey(const std::string &key) -> std::string
+        {
+            const std::string text = key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+            std::array<unsigned char, SHA_DIGEST_LENGTH> digest {};
+            SHA1(reinterpret_cast<const unsigned char *>(text.data()), text.size(), digest.data());
+
+            std::array<unsigned char, 4 * ((SHA_DIGEST_LENGTH + 2) / 3) + 1> encoded {};
+            const int length = EVP_EncodeBlock(encoded.data(), digest.data(), static_cast<int>(digest.size()));
+            return { reinterpret_cast<const char *>(encoded.data()), static_cast<std::size_t>(length) };
+        }
+
+        auto send(Client &client, uint8_t opcode, std::string_view payload) -> bool
+        {
+            std::string frame;
+            frame.push_back(static_cast<char>(0x80 | opcode));
+            if (payload.size() < 126)
+                frame.push_back(static_cast<char>(payload.size()));
+            else if (payload.size() <= 0xffff)
+            {
+                frame.push_back(static_cast<char>(126));
+                frame.push_back(static_cast<char>(payload.size() >> 8));
+                frame.push_back(static_cast<char>(payload.size() & 0xff));
+            }
+            else
+            {
+                frame.push_back(static_cast<char>(127));
+                for (int shift = 56; shift >= 0; shift -= 8)
+                    frame.push_back(static_cast<char>((payload.size() >> shift) & 0xff));
+            }
+            frame.append(payload);
+
+            std::lock_guard<std::mutex> lock(client.mutex);
+            return client.upgraded && SSL_write(client.ssl, frame.data(), static_cast<int>(frame.size())) > 0;
+        }
+
+        /// Read what is available. False when the connection is gone
+        auto read(Client &client, std::string &buffer) -> bool
+        {
+            pollfd pfd { client.fd, POLLIN, 0 };
+            if (SSL_pending(client.ssl) == 0 && ::poll(&pfd, 1, 20) <= 0)
+                return !m_stop;
+
+            char chunk[4096];
+            std::lock_guard<std::mutex> lock(client.mutex);
+            const int read = SSL_read(client.ssl, chunk, sizeof(chunk));
+            if (read <= 0)
+                return false;
+            buffer.append(chunk, static_cast<std::size_t>(read));
+            return true;
+        }
+
+        auto handshake(Client &client, std::string &buffer) -> bool
+        {
+            std::size_t end = std::string::npos;
+            while ((end = buffer.find("\r\n\r\n")) == std::string::npos)
+            {
+                if (!read(client, buffer) || m_stop)
+                    return false;
+            }
+
+            const std::string_view request { buffer.data(), end + 2 };
+            const auto key = header(request, "Sec-WebSocket-Key");
+            if (!key.has_value())
+                return false;
+
+            std::string reply = "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Accept: " + acceptKey(*key) + "\r\n";
+            if (const auto protocol = header(request, "Sec-WebSocket-Protocol"); protocol.has_value())
+                reply += "Sec-WebSocket-Protocol: " + *protocol + "\r\n";
+            reply += "\r\n";
+            buffer.erase(0, end + 4);
+
+            std::lock_guard<std::mutex> lock(client.mutex);
+            if (SSL_write(client.ssl, reply.data(), static_cast<int>(reply.size())) <= 0)
+                return false;
+            client.upgraded = true;
+            return true;
+        }
+
+        auto serve(Client &client) -> void
+        {
+            client.ssl = SSL_new(m_ctx);
+            SSL_set_fd(client.ssl, client.fd);
+
+            std::string buffer;
+            if (SSL_accept(client.ssl) == 1 && handshake(client, buffer))
+            {
+                ++m_connections;
+                ++m_open;
+
+                bool alive = true;
+                while (alive && !m_stop)
+                {
+                    // Client frames: FIN and opcode, masked length, mask and payload
+                    if (buffer.size() < 2)
+                    {
+                        alive = read(client, buffer);
+                        continue;
+                    }
+
+                    const auto opcode = static_cast<uint8_t>(buffer[0]) & 0x0f;
+                    uint64_t length   = static_cast<uint8_t>(buffer[1]) & 0x7f;
+                    std::size_t size  = 2;
+                    if (length == 126)
+                        size += 2;
+                    else if (length == 127)
+                        size += 8;
+                    if (buffer.size() < size)
+                    {
+                        alive = read(client, buffer);
+                        continue;
+                    }
+                    if (length >= 126)
+                    {
+                        length = 0;
+                        for (std::size_t i = 2; i < size; ++i)
+                            length = (length << 8) | static_cast<uint8_t>(buffer[i]);
+                    }
+                    if (buffer.size() < size + 4 + length)
+                    {
+                        alive = read(client, buffer);
+                        continue;
+                    }
+
+                    std::string payload = buffer.substr(size + 4, length);
+                    for (std::size_t i = 0; i < payload.size(); ++i)
+                        payload[i] = static_cast<char>(payload[i] ^ buffer[size + i % 4]);
+                    buffer.erase(0, size + 4 + length);
+
+                    switch (opcode)
+                    {
+                        case 0x1:
+                            {
+                                {
+                                    std::lock_guard<std::mutex> lock(m_messagesMutex);
+                                    m_messages.push_back(payload);
+                                }
+                                if (m_handler)
+                                {
+                                    for (const auto &reply : m_handler(payload))
+                                        send(client, 0x1, reply);
+                                }
+                            }
+                            break;
+                        case 0x8:
+                            ++m_closeFrames;
+                            send(client, 0x8, payload.substr(0, 2));
+                            alive = false;
+                            break;
+                        case 0x9:
+                            send(client, 0xA, payload);
+                            break;
+                        default:
+                            break;
+                    }
+                }
+
+                --m_open;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(client.mutex);
+                client.upgraded = false;
+                SSL_free(client.ssl);
+                client.ssl = nullptr;
+            }
+            // The descriptor is closed by the destructor, so it can not be reused while the server is alive
+            ::shutdown(client.fd, SHUT_RDWR);
+        }
+
+    private:
+        Handler m_handler;
+        SSL_CTX *m_ctx { nullptr };
+        int m_listen { -1 };
+        int32_t m_port { 0 };
+        std::atomic_bool m_stop { false };
+        std::atomic_bool m_refusing { false };
+        std::atomic_bool m_stalling { false };
+        std::atomic_uint64_t m_stalled { 0 };
+        std::atomic_uint64_t m_connections { 0 };
+        std::atomic_uint64_t m_open { 0 };
+        std::atomic_uint64_t m_closeFrames { 0 };
+        std::thread m_acceptThread;
+        std::vector<std::thread> m_clientThreads;
+        mutable std::mutex m_clientsMutex;
+        std::vector<std::shared_ptr<Client>> m_clients;
+        mutable std::mutex m_messagesMutex;
+        std::vector<std::string> m_messages;
+    };
+} // namespace tests
+
+#endif /*CENTAUR_TESTS_MOCK_WS_SERVER_HPP*/
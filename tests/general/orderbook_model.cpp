@@ -0,0 +1,180 @@
+/////////////////////////////////////////////////////////////////////////////////////
+//
+// Created by Ricardo Romero on 17/10/26.
+// Copyright (c) 2026 Ricardo Romero.  All rights reserved.
+//
+// Changes signaled by the model of the orderbook dialog
+
+#include <OrderbookModel.hpp>
+#include <QAbstractItemModelTester>
+#include <QSignalSpy>
+#include <catch2/catch_test_macros.hpp>
+
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using Levels = QMap<qreal, QPair<qreal, qreal>>;
+
+    /// Levels with a quantity of 1 and prices from first down to last
+    auto makeLevels(int first, int last) -> Levels
+    {
+        Levels levels;
+        for (int price = first; price >= last; --price)
+            levels.insert(price, { 1.0, static_cast<qreal>(price) });
+        return levels;
+    }
+
+    struct ChangedRange
+    {
+        int firstRow;
+        int lastRow;
+        int firstColumn;
+        int lastColumn;
+
+        auto operator==(const ChangedRange &) const -> bool = default;
+    };
+
+    /// The ranges of the dataChanged signals recorded by spy for role
+    auto changed(const QSignalSpy &spy, int role) -> std::vector<ChangedRange>
+    {
+        std::vector<ChangedRange> ranges;
+        for (const auto &arguments : spy)
+        {
+            if (!qvariant_cast<QList<int>>(arguments.at(2)).contains(role))
+                continue;
+
+            const auto topLeft     = qvariant_cast<QModelIndex>(arguments.at(0));
+            const auto bottomRight = qvariant_cast<QModelIndex>(arguments.at(1));
+            ranges.push_back({ topLeft.row(), bottomRight.row(), topLeft.column(), bottomRight.column() });
+        }
+        return ranges;
+    }
+} // namespace
+
+TEST_CASE("Orderbook model")
+{
+    using cen::OrderbookModel;
+    constexpr int DepthRole = OrderbookModel::DepthRole;
+
+    OrderbookModel model { OrderbookModel::Side::bid, { "Price", "Amount", "Total" } };
+    QAbstractItemModelTester tester { &model, QAbstractItemModelTester::FailureReportingMode::Fatal };
+
+    // Ten levels from 100 down to 91: the side has a quantity of 10 and the depth is relative to 16
+    Levels levels = makeLevels(100, 91);
+    CHECK(model.update(levels));
+    REQUIRE(model.rowCount() == 10);
+    CHECK(model.depthScale() == 16.0);
+    CHECK(model.index(0, 0).data().toString() == "$ 100.00000");
+    CHECK(model.index(0, 2).data(DepthRole).toReal() == 1.0 / 16.0);
+    CHECK(model.index(9, 2).data(DepthRole).toReal() == 10.0 / 16.0);
+
+    QSignalSpy dataChanged { &model, &QAbstractItemModel::dataChanged };
+    QSignalSpy rowsInserted { &model, &QAbstractItemModel::rowsInserted };
+    QSignalSpy rowsRemoved { &model, &QAbstractItemModel::rowsRemoved };
+
+    SECTION("The same levels signal nothing")
+    {
+        CHECK_FALSE(model.update(levels));
+        CHECK(dataChanged.isEmpty());
+    }
+
+    SECTION("One changed row signals only that row")
+    {
+        levels[95].second = 1000;
+        CHECK_FALSE(model.update(levels));
+
+        CHECK(changed(dataChanged, Qt::DisplayRole) == std::vector<ChangedRange> { { 5, 5, 0, 2 } });
+        CHECK(changed(dataChanged, DepthRole).empty());
+        CHECK(model.index(5, 2).data().toString() == "$ 1,000.00000");
+    }
+
+    SECTION("Consecutive changed rows are signaled together")
+    {
+        for (const int price : { 99, 98, 95, 94, 93 })
+            levels[price].second = 1000;
+        CHECK_FALSE(model.update(levels));
+
+        CHECK(changed(dataChanged, Qt::DisplayRole) == std::vector<ChangedRange> { { 1, 2, 0, 2 }, { 5, 7, 0, 2 } });
+        CHECK(changed(dataChanged, DepthRole).empty());
+    }
+
+    SECTION("A small change of the best level does not repaint the depth column")
+    {
+        levels[100].first = 1.001;
+        CHECK_FALSE(model.update(levels));
+
+        CHECK(changed(dataChanged, Qt::DisplayRole) == std::vector<ChangedRange> { { 0, 0, 0, 2 } });
+        CHECK(changed(dataChanged, DepthRole).empty());
+    }
+
+    SECTION("A change of the best level moves the depth of the levels behind it")
+    {
+        levels[100].first = 2;
+        CHECK_FALSE(model.update(levels));
+
+        CHECK(changed(dataChanged, Qt::DisplayRole) == std::vector<ChangedRange> { { 0, 0, 0, 2 } });
+        CHECK(changed(dataChanged, DepthRole) == std::vector<ChangedRange> { { 0, 9, 2, 2 } });
+        CHECK(model.depthScale() == 16.0);
+        CHECK(model.index(9, 2).data(DepthRole).toReal() == 11.0 / 16.0);
+    }
+
+    SECTION("Growing rows are inserted at the end")
+    {
+        levels = makeLevels(100, 89);
+        CHECK(model.update(levels));
+
+        REQUIRE(rowsInserted.size() == 1);
+        CHECK(rowsInserted.front().at(1).toInt() == 10);
+        CHECK(rowsInserted.front().at(2).toInt() == 11);
+        CHECK(rowsRemoved.isEmpty());
+
+        // The rows that were already there keep their level and their depth
+        CHECK(changed(dataChanged, Qt::DisplayRole) == std::vector<ChangedRange> { { 10, 11, 0, 2 } });
+        CHECK(changed(dataChanged, DepthRole) == std::vector<ChangedRange> { { 10, 11, 2, 2 } });
+        CHECK(model.index(11, 0).data().toString() == "$ 89.00000");
+    }
+
+    SECTION("Shrinking rows are removed from the end")
+    {
+        levels = makeLevels(100, 92);
+        CHECK(model.update(levels));
+
+        REQUIRE(rowsRemoved.size() == 1);
+        CHECK(rowsRemoved.front().at(1).toInt() == 9);
+        CHECK(rowsRemoved.front().at(2).toInt() == 9);
+        CHECK(rowsInserted.isEmpty());
+        CHECK(dataChanged.isEmpty());
+        CHECK(model.rowCount() == 9);
+    }
+
+    SECTION("The depth scale changes when the side crosses a power of two")
+    {
+        levels = makeLevels(100, 94);
+        CHECK(model.update(levels));
+
+        REQUIRE(rowsRemoved.size() == 1);
+        CHECK(rowsRemoved.front().at(1).toInt() == 7);
+        CHECK(rowsRemoved.front().at(2).toInt() == 9);
+        CHECK(model.depthScale() == 8.0);
+        CHECK(changed(dataChanged, Qt::DisplayRole).empty());
+        CHECK(changed(dataChanged, DepthRole) == std::vector<ChangedRange> { { 0, 6, 2, 2 } });
+        CHECK(model.index(6, 2).data(DepthRole).toReal() == 7.0 / 8.0);
+    }
+
+    SECTION("An empty side removes every row")
+    {
+        CHECK(model.update({}));
+
+        REQUIRE(rowsRemoved.size() == 1);
+        CHECK(rowsRemoved.front().at(1).toInt() == 0);
+        CHECK(rowsRemoved.front().at(2).toInt() == 9);
+        CHECK(model.rowCount() == 0);
+        CHECK(dataChanged.isEmpty());
+
+        CHECK(model.update(levels));
+        CHECK(model.rowCount() == 10);
+        CHECK(changed(dataChanged, Qt::DisplayRole) == std::vector<ChangedRange> { { 0, 9, 0, 2 } });
+    }
+}
@@ -15,6 +15,7 @@
 
 #include "TraderGlobals.hpp"
 #include <BinanceAPI.hpp>
+#include <atomic>
 
 namespace btrader
 {
@@ -50,8 +51,13 @@ namespace btrader::stream
         auto connectionError() -> void override;
         void pingSent(bool success) noexcept override;
 
+    private:
+        /// \brief Set m_started. The connection is opened again when lost, so connected() and connectionError() come more than once
+        auto setStarted() -> void;
+
     private:
         mutable std::promise<void> m_started;
+        std::atomic_bool m_startedSet { false };
         TraderApplication *m_app;
     };
 } // namespace btrader::stream
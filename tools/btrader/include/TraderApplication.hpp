@@ -40,7 +40,9 @@ CENTAUR_TOOL_WARN_PUSH
 CENTAUR_TOOL_WARN_OFF(weak-vtables)
 #endif /*__clang__*/
         // clang-format on
-        /// \brief Attempt reconnection every minute if the connection fails or is disconnected
+        /// \brief Attempt reconnection every minute if the connection fails or is disconnected.
+        /// This is the connection to the Centaur server, a CentaurClient with an lws context of its own, not a stream of the
+        /// WSReactor: WSThread::setReconnection does not apply to it. The streams of m_tickerStreams reconnect on their own
         struct Reconnection : public cen::tools::TimerEventMinutes<1>
         {
             inline explicit Reconnection(TraderApplication *app) :
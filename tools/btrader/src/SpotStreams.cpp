@@ -11,6 +11,7 @@
 btrader::stream::SpotStreams::SpotStreams() :
     BINAPI_NAMESPACE::ws::WSSpotBinanceAPI("")
 {
+    setReconnection(true);
 }
 
 btrader::stream::SpotStreams::SpotStreams(TraderApplication *app, const std::string &base, const std::string &quote) :
@@ -20,12 +21,20 @@ btrader::stream::SpotStreams::SpotStreams(TraderApplication *app, const std::str
     auto data     = subscribeIndividualMiniTicker(base + quote);
     auto endpoint = BINAPI_NAMESPACE::ws::WSSpotBinanceAPI::makeEndPoint(std::get<0>(data));
     setEndPoint(endpoint);
+    // A lost connection is opened again with the backoff of WSThread, until the application releases the streams
+    setReconnection(true);
+}
+
+auto btrader::stream::SpotStreams::setStarted() -> void
+{
+    if (!m_startedSet.exchange(true))
+        m_started.set_value();
 }
 
 auto btrader::stream::SpotStreams::connected() -> void
 {
     logInfo("SPOT Streams are connected.");
-    m_started.set_value();
+    setStarted();
 }
 
 auto btrader::stream::SpotStreams::close() -> void
@@ -36,7 +45,7 @@ auto btrader::stream::SpotStreams::close() -> void
 auto btrader::stream::SpotStreams::connectionError() -> void
 {
     logError("SPOT Streams could not connect with the Binance Servers");
-    m_started.set_value();
+    setStarted();
 }
 
 void btrader::stream::SpotStreams::pingSent(bool success) noexcept